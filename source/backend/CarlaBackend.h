@@ -239,6 +239,38 @@ static const uint PLUGIN_OPTION_SEND_ALL_SOUND_OFF = 0x100;
  */
 static const uint PLUGIN_OPTION_SEND_PROGRAM_CHANGES = 0x200;
 
+/*!
+ * Skip processing while the plugin inputs and outputs are silent.
+ * The plugin goes to sleep after its outputs have been silent for longer than its tail time,
+ * and is woken up as soon as audio or MIDI input arrives.
+ * @see ENGINE_OPTION_SILENCE_TAIL_TIME
+ */
+static const uint PLUGIN_OPTION_SLEEP_WHEN_SILENT = 0x400;
+
+/*!
+ * Process the plugin at a bigger internal block size than the engine, through audio and event FIFOs.
+ * Adds one internal block of latency (two when using a worker thread), which is compensated by the engine.
+ * Only used in rack and patchbay modes.
+ * @see ENGINE_OPTION_REBLOCK_SIZE and ENGINE_OPTION_REBLOCK_THREAD
+ */
+static const uint PLUGIN_OPTION_REBLOCK = 0x800;
+
+/*!
+ * Allow the engine to degrade the plugin while the DSP load stays over the limit,
+ * by lowering its update rate or polyphony, or by bypassing it.
+ * Plugins later in the list are degraded first, and restored last.
+ * @see ENGINE_OPTION_OVERLOAD_LIMIT and PluginDegradation
+ */
+static const uint PLUGIN_OPTION_EXPENDABLE = 0x1000;
+
+/*!
+ * Process the plugin at a multiple of the engine sample rate, through polyphase half-band filters.
+ * Reduces aliasing of non-linear plugins, at the cost of the filters latency, which is compensated by the engine.
+ * Only used in rack and patchbay modes, and for plugins with at most one MIDI input and output.
+ * @see ENGINE_OPTION_OVERSAMPLE_FACTOR
+ */
+static const uint PLUGIN_OPTION_OVERSAMPLE = 0x2000;
+
 /** @} */
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -954,7 +986,17 @@ typedef enum {
     /*!
      * The engine has crashed or malfunctioned and will no longer work.
      */
-    ENGINE_CALLBACK_QUIT = 39
+    ENGINE_CALLBACK_QUIT = 39,
+
+    /*!
+     * The engine degraded or restored a plugin because of its DSP load.
+     * @a pluginId Plugin Id
+     * @a value1   New degradation
+     * @a value2   Engine DSP load, in percent
+     * @a value3   Plugin DSP load, in percent
+     * @see PluginDegradation and PLUGIN_OPTION_EXPENDABLE
+     */
+    ENGINE_CALLBACK_PLUGIN_DEGRADED = 40
 
 } EngineCallbackOpcode;
 
@@ -1083,7 +1125,86 @@ typedef enum {
     /*!
      * Capture console output into debug callbacks.
      */
-    ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT = 18
+    ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT = 18,
+
+    /*!
+     * Minimum time of silence, in milliseconds, before a plugin using PLUGIN_OPTION_SLEEP_WHEN_SILENT goes to sleep.
+     * Plugin latency is added on top of this value.
+     * Default is 2000 (2 seconds).
+     */
+    ENGINE_OPTION_SILENCE_TAIL_TIME = 19,
+
+    /*!
+     * Lock all current and future process memory into RAM, avoiding page faults in the audio thread.
+     * Default is no.
+     * @note: Not available on Windows
+     */
+    ENGINE_OPTION_RT_MEMORY_LOCK = 20,
+
+    /*!
+     * CPU affinity for the engine realtime threads, as a bitmask of CPU cores.
+     * Default is 0 (no change).
+     * @note: Linux only
+     */
+    ENGINE_OPTION_RT_CPU_AFFINITY = 21,
+
+    /*!
+     * SCHED_FIFO priority for the engine realtime threads, from 1 to 99.
+     * Default is 0 (use the audio driver default).
+     * @note: Not available on Windows
+     */
+    ENGINE_OPTION_RT_PRIORITY = 22,
+
+    /*!
+     * Number of background threads used to load plugin bridges when loading a project.
+     * Plugins are still added to the engine in project order, once all of them are loaded.
+     * Default is 0 (load everything sequentially).
+     */
+    ENGINE_OPTION_PROJECT_LOAD_THREADS = 23,
+
+    /*!
+     * Number of extra threads used to process plugins in patchbay mode.
+     * Plugins that do not depend on each other are then processed at the same time.
+     * Default is 0 (process everything in the audio thread).
+     * @note: Offline rendering and rack mode always process plugins in order
+     */
+    ENGINE_OPTION_PROCESS_THREADS = 24,
+
+    /*!
+     * Internal block size, in frames, of plugins using PLUGIN_OPTION_REBLOCK.
+     * Plugins are processed directly when this is not bigger than the engine buffer size.
+     * Default is 1024.
+     */
+    ENGINE_OPTION_REBLOCK_SIZE = 25,
+
+    /*!
+     * Process the internal blocks of plugins using PLUGIN_OPTION_REBLOCK on a worker thread,
+     * spreading their cost over several engine cycles at the expense of one more block of latency.
+     * Default is no.
+     */
+    ENGINE_OPTION_REBLOCK_THREAD = 26,
+
+    /*!
+     * DSP load, in percent of the audio cycle, above which plugins using PLUGIN_OPTION_EXPENDABLE get degraded.
+     * They are restored once the load stays well below this value.
+     * Only used in rack and patchbay modes.
+     * Default is 0 (never degrade plugins).
+     */
+    ENGINE_OPTION_OVERLOAD_LIMIT = 27,
+
+    /*!
+     * Oversampling factor of plugins using PLUGIN_OPTION_OVERSAMPLE, either 2, 4 or 8.
+     * Combine with PLUGIN_OPTION_REBLOCK and ENGINE_OPTION_REBLOCK_THREAD to run the oversampled plugin on a worker thread.
+     * Default is 2.
+     */
+    ENGINE_OPTION_OVERSAMPLE_FACTOR = 28,
+
+    /*!
+     * Save the current project to the file in valueStr every value seconds.
+     * Plugins whose state did not change since they were last saved are not asked for it again.
+     * Default is 0 (no autosave).
+     */
+    ENGINE_OPTION_AUTOSAVE = 29
 
 } EngineOption;
 
@@ -1156,6 +1277,37 @@ typedef enum {
 
 } EngineTransportMode;
 
+/* ------------------------------------------------------------------------------------------------------------
+ * Plugin Degradation */
+
+/*!
+ * How a plugin is degraded by the engine to reduce the DSP load.
+ * @see PLUGIN_OPTION_EXPENDABLE and ENGINE_CALLBACK_PLUGIN_DEGRADED
+ */
+typedef enum {
+    /*!
+     * Plugin is processed normally.
+     */
+    PLUGIN_DEGRADATION_NONE = 0,
+
+    /*!
+     * Plugin is only processed every few cycles.
+     * Used for analysis plugins, which have audio inputs but no outputs.
+     */
+    PLUGIN_DEGRADATION_REDUCED_RATE = 1,
+
+    /*!
+     * Plugin polyphony parameter has been lowered.
+     */
+    PLUGIN_DEGRADATION_REDUCED_POLYPHONY = 2,
+
+    /*!
+     * Plugin is not processed, its audio inputs are passed through to its outputs.
+     */
+    PLUGIN_DEGRADATION_BYPASSED = 3
+
+} PluginDegradation;
+
 /* ------------------------------------------------------------------------------------------------------------
  * File Callback Opcode */
 
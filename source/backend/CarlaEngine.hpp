@@ -25,12 +25,16 @@ struct CarlaOscData;
 #endif
 
 namespace juce {
-class MemoryOutputStream;
+class OutputStream;
 class XmlDocument;
+class XmlElement;
 }
 
 CARLA_BACKEND_START_NAMESPACE
 
+class CarlaBinaryProjectReader;
+class CarlaBinaryProjectWriter;
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -234,6 +238,7 @@ struct CARLA_API EngineOptions {
 
     uint maxParameters;
     uint uiBridgesTimeout;
+    uint silenceTailTime;
     uint audioNumPeriods;
     uint audioBufferSize;
     uint audioSampleRate;
@@ -254,6 +259,22 @@ struct CARLA_API EngineOptions {
     bool preventBadBehaviour;
     uintptr_t frontendWinId;
 
+    bool rtMemoryLock;
+    uint rtCpuAffinity;
+    uint rtPriority;
+
+    uint projectLoadThreads;
+    uint processThreads;
+
+    uint reblockSize;
+    bool reblockThread;
+
+    uint overloadLimit;
+    uint oversampleFactor;
+
+    uint autosaveInterval;
+    const char* autosaveFilename;
+
 #ifndef DOXYGEN
     EngineOptions() noexcept;
     ~EngineOptions() noexcept;
@@ -540,8 +561,10 @@ public:
 #ifndef DOXYGEN
 protected:
     EngineEvent* fBuffer;
+    EngineEvent* fProcessBuffer; // used instead of fBuffer by the plugin side while re-blocking
     const EngineProcessMode kProcessMode;
     friend class CarlaPluginInstance;
+    friend class CarlaPlugin;
 
     CARLA_DECLARE_NON_COPY_CLASS(CarlaEngineEventPort)
 #endif
@@ -728,6 +751,14 @@ public:
      */
     uint getMaxPluginNumber() const noexcept;
 
+#ifndef BUILD_BRIDGE
+    /*!
+     * Current number of plugins asleep due to silence.
+     * @see PLUGIN_OPTION_SLEEP_WHEN_SILENT
+     */
+    uint getSleepingPluginCount() const noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Virtual, per-engine type calls
 
@@ -836,6 +867,33 @@ public:
      * Switch plugins with id @a idA and @a idB.
      */
     bool switchPlugins(const uint idA, const uint idB) noexcept;
+
+    /*!
+     * Load a plugin preset file as an inactive standby instance for plugin with id @a id.
+     * The running plugin is not touched, any previous standby of it gets replaced.
+     * Standby plugins do not take a plugin slot, but are not supported in multi-client mode.
+     * @see switchToStandbyPlugins()
+     */
+    bool loadStandbyPlugin(const uint id, const char* const filename);
+
+    /*!
+     * Remove the standby instance of plugin with id @a id, if any.
+     */
+    bool removeStandbyPlugin(const uint id);
+
+    /*!
+     * Replace all plugins that have a standby instance with it, all at once (ie, a scene change).
+     * In rack mode the old plugins are crossfaded out during @a crossfadeMs, otherwise the switch is immediate.
+     * @see ENGINE_CALLBACK_RELOAD_ALL
+     */
+    bool switchToStandbyPlugins(const uint crossfadeMs);
+
+    /*!
+     * Get the estimated memory used by the standby instance of plugin with id @a id, in bytes.
+     * This is the heap growth seen while loading it, so memory used by plugin bridge processes is not included.
+     * Returns 0 if there is no standby instance.
+     */
+    uint64_t getStandbyPluginMemoryUsage(const uint id) const noexcept;
 #endif
 
     /*!
@@ -865,13 +923,14 @@ public:
     bool loadFile(const char* const filename);
 
     /*!
-     * Load a project file.
+     * Load a project file, either XML (.carxp) or binary (.carbp).
      * @note Already loaded plugins are not removed; call removeAllPlugins() first if needed.
      */
     bool loadProject(const char* const filename);
 
     /*!
      * Save current project to a file.
+     * Files with a .carbp extension are saved in the binary project format.
      */
     bool saveProject(const char* const filename);
 
@@ -914,6 +973,26 @@ public:
      */
     const EngineTimeInfo& getTimeInfo() const noexcept;
 
+#ifndef BUILD_BRIDGE
+    /*!
+     * Get the total latency of the internal graph, in samples.
+     * This is the latency of its longest path, shorter paths get delayed to match it.
+     */
+    uint32_t getTotalLatency() const noexcept;
+#endif
+
+    /*!
+     * Get the CPU time used by each tick of the engine idle thread, in microseconds.
+     * This is an average over the last second.
+     */
+    uint32_t getIdleThreadTickTime() const noexcept;
+
+    /*!
+     * Get how late MIDI output events were sent, compared to the time matching their frame, in microseconds.
+     * This is the maximum over the last second, 0 for drivers that do not schedule MIDI output themselves.
+     */
+    virtual uint32_t getMidiOutJitter() const noexcept;
+
     // -------------------------------------------------------------------
     // Information (peaks)
 
@@ -1014,6 +1093,14 @@ public:
      */
     bool isAboutToClose() const noexcept;
 
+    /*!
+     * Check if the engine is loading a project using background loader threads.
+     * Plugins created during this time might not be running on the main thread,
+     * and must not call idle() or send idle callbacks.
+     * @see ENGINE_OPTION_PROJECT_LOAD_THREADS
+     */
+    bool isLoadingProjectInParallel() const noexcept;
+
     /*!
      * Tell the engine it's about to close.
      * This is used to prevent the engine thread(s) from reactivating.
@@ -1064,6 +1151,34 @@ public:
     EngineEvent* getInternalEventBuffer(const bool isInput) const noexcept;
 
 #ifndef BUILD_BRIDGE
+    /*!
+     * Update the internal graph delay compensation after @a plugin changed its latency.
+     * @note Non-RT call
+     */
+    void updatePluginLatency(CarlaPlugin* const plugin);
+
+    /*!
+     * Check if the internal graph total latency changed, and report it to the driver or host if so.
+     * This is called regularly by the engine thread.
+     * @note Non-RT call
+     */
+    void updateTotalLatency();
+
+    /*!
+     * Degrade expendable plugins if the internal graph DSP load stays over ENGINE_OPTION_OVERLOAD_LIMIT,
+     * or restore them once the load went down.
+     * This is called regularly by the engine thread.
+     * @note Non-RT call
+     */
+    void updateOverload();
+
+    /*!
+     * Save the project to the ENGINE_OPTION_AUTOSAVE file if its interval elapsed since the last save.
+     * This is called regularly by idle().
+     * @note Non-RT call
+     */
+    void updateAutosave();
+
     /*!
      * Virtual functions for handling external graph ports.
      */
@@ -1086,7 +1201,6 @@ protected:
     friend class CarlaPluginInstance;
     friend class EngineInternalGraph;
     friend class PendingRtEventsRunner;
-    friend class ScopedActionLock;
     friend class ScopedEngineEnvironmentLocker;
     friend class ScopedThreadStopper;
     friend struct PatchbayGraph;
@@ -1117,15 +1231,41 @@ protected:
      */
     void setPluginPeaks(const uint pluginId, float const inPeaks[2], float const outPeaks[2]) noexcept;
 
+#ifndef BUILD_BRIDGE
+    /*!
+     * Report to the driver or host that the internal graph total latency changed.
+     * Default implementation does nothing.
+     */
+    virtual void totalLatencyChanged(const uint32_t latency);
+#endif
+
     /*!
      * Common save project function for main engine and plugin.
+     * If @a binaryWriter is set plugin states are written to it, and referenced from the project document.
+     * If @a reuseUnchangedStates is set plugins whose state did not change since their last save are not asked for it again.
      */
-    void saveProjectInternal(juce::MemoryOutputStream& outStrm) const;
+    void saveProjectInternal(juce::OutputStream& outStrm, CarlaBinaryProjectWriter* const binaryWriter = nullptr,
+                             const bool reuseUnchangedStates = false) const;
+
+    /*!
+     * Save the project to a temporary file next to @a filename, replacing it once everything was written.
+     * @see saveProjectInternal()
+     */
+    bool saveProjectToFile(const char* const filename, const bool reuseUnchangedStates);
 
     /*!
      * Common load project function for main engine and plugin.
+     * @a binaryReader is used for plugin states referenced from a binary project document.
      */
-    bool loadProjectInternal(juce::XmlDocument& xmlDoc);
+    bool loadProjectInternal(juce::XmlDocument& xmlDoc, const CarlaBinaryProjectReader* const binaryReader = nullptr);
+
+#ifndef BUILD_BRIDGE
+    /*!
+     * Load all plugins of a project, bridges being loaded in background threads.
+     * Returns false if the engine is about to close.
+     */
+    bool loadProjectPluginsInParallel(const juce::XmlElement* const xmlElement, const CarlaBinaryProjectReader* const binaryReader);
+#endif
 
 #ifndef BUILD_BRIDGE
     // -------------------------------------------------------------------
@@ -1215,6 +1355,7 @@ public:
     void oscSend_control_note_on(const uint pluginId, const uint8_t channel, const uint8_t note, const uint8_t velo) const noexcept;
     void oscSend_control_note_off(const uint pluginId, const uint8_t channel, const uint8_t note) const noexcept;
     void oscSend_control_set_peaks(const uint pluginId) const noexcept;
+    void oscSend_control_send_queued() const noexcept; // parameter values and peaks are queued until this
     void oscSend_control_exit() const noexcept;
 #endif
 
@@ -387,6 +387,12 @@ CARLA_EXPORT bool carla_load_project(const char* filename);
  */
 CARLA_EXPORT bool carla_save_project(const char* filename);
 
+/*!
+ * Convert a project file between the XML (.carxp) and binary (.carbp) formats.
+ * The format of @a outFilename is the other one than @a inFilename, the engine does not need to be running.
+ */
+CARLA_EXPORT bool carla_convert_project(const char* inFilename, const char* outFilename);
+
 #ifndef BUILD_BRIDGE
 /*!
  * Connect two patchbay ports.
@@ -443,6 +449,12 @@ CARLA_EXPORT const CarlaTransportInfo* carla_get_transport_info();
  */
 CARLA_EXPORT uint32_t carla_get_current_plugin_count();
 
+/*!
+ * Current number of plugins asleep due to silence.
+ * @see PLUGIN_OPTION_SLEEP_WHEN_SILENT
+ */
+CARLA_EXPORT uint32_t carla_get_sleeping_plugin_count();
+
 /*!
  * Maximum number of loadable plugins allowed.
  * Returns 0 if engine is not started.
@@ -505,6 +517,33 @@ CARLA_EXPORT bool carla_replace_plugin(uint pluginId);
  * @param pluginIdB Plugin B
  */
 CARLA_EXPORT bool carla_switch_plugins(uint pluginIdA, uint pluginIdB);
+
+/*!
+ * Load a plugin preset file as an inactive standby instance for a plugin.
+ * The running plugin is not touched until carla_switch_to_standby_plugins() is called.
+ * Not supported in multi-client mode.
+ * @param pluginId Plugin
+ * @param filename Path to plugin preset
+ */
+CARLA_EXPORT bool carla_load_standby_plugin(uint pluginId, const char* filename);
+
+/*!
+ * Remove the standby instance of a plugin, if any.
+ * @param pluginId Plugin
+ */
+CARLA_EXPORT bool carla_remove_standby_plugin(uint pluginId);
+
+/*!
+ * Replace all plugins that have a standby instance with it, all at once.
+ * @param crossfadeMs Crossfade time in milliseconds, only used in rack mode
+ */
+CARLA_EXPORT bool carla_switch_to_standby_plugins(uint crossfadeMs);
+
+/*!
+ * Get the estimated memory used by the standby instance of a plugin, in bytes.
+ * @param pluginId Plugin
+ */
+CARLA_EXPORT uint64_t carla_get_standby_plugin_memory_usage(uint pluginId);
 #endif
 
 /*!
@@ -875,6 +914,18 @@ CARLA_EXPORT uint32_t carla_get_buffer_size();
  */
 CARLA_EXPORT double carla_get_sample_rate();
 
+/*!
+ * Get the CPU time used by each tick of the engine idle thread, in microseconds.
+ * This is an average over the last second.
+ */
+CARLA_EXPORT uint32_t carla_get_idle_thread_tick_time();
+
+/*!
+ * Get how late MIDI output events were sent, compared to the time matching their frame, in microseconds.
+ * This is the maximum over the last second, 0 for drivers that do not schedule MIDI output themselves.
+ */
+CARLA_EXPORT uint32_t carla_get_midi_out_jitter();
+
 /*!
  * Get the last error.
  */
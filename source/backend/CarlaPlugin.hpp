@@ -156,6 +156,13 @@ public:
      */
     virtual uint32_t getLatencyInFrames() const noexcept;
 
+    /*!
+     * Get the total latency of the plugin as processed by the engine, in sample frames.
+     * This is the plugin's own latency plus the one added by re-blocking.
+     * @see PLUGIN_OPTION_REBLOCK
+     */
+    uint32_t getProcessLatencyInFrames() const noexcept;
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -248,6 +255,12 @@ public:
      */
     bool isParameterOutput(const uint32_t parameterId) const noexcept;
 
+    /*!
+     * Find the first output parameter changed by process() starting at @a parameterId, and clear its changed state.
+     * Returns false if there are no more changed output parameters.
+     */
+    bool takeNextChangedOutputParameter(uint32_t& parameterId) noexcept;
+
     /*!
      * Get the MIDI program at @a index.
      *
@@ -390,10 +403,25 @@ public:
     /*!
      * Get the plugin's save state.
      * The plugin will automatically call prepareForSave() if requested.
+     * If @a encodeChunk is false the chunk is not base64 encoded but referenced as rawChunk,
+     * which is only valid until the plugin is used again.
+     * If @a reuseUnchanged is true the previous save state is returned as-is, unless isStateSaveOutdated().
      *
      * @see loadStateSave()
      */
-    const CarlaStateSave& getStateSave(const bool callPrepareForSave = true);
+    const CarlaStateSave& getStateSave(const bool callPrepareForSave = true, const bool encodeChunk = true, const bool reuseUnchanged = false);
+
+    /*!
+     * Drop the rawChunk reference of the last save state.
+     * Must be called once a save state taken with @a encodeChunk false has been used.
+     */
+    void clearStateSaveRawChunk() noexcept;
+
+    /*!
+     * Check if the plugin's state might have changed since getStateSave() was last called.
+     * Plugins keeping state the host does not see changing, like chunks, are always outdated.
+     */
+    virtual bool isStateSaveOutdated() const noexcept;
 
     /*!
      * Get the plugin's save state.
@@ -661,6 +689,89 @@ public:
      */
     virtual void offlineModeChanged(const bool isOffline);
 
+#ifndef BUILD_BRIDGE
+    /*!
+     * Check if the plugin is asleep and its process call can be skipped for this cycle.
+     * Audio in @a audioIn or MIDI in the default event input port wakes the plugin up.
+     * Always returns false if PLUGIN_OPTION_SLEEP_WHEN_SILENT is not enabled.
+     * When this returns true the caller must clear the plugin outputs instead of calling process().
+     * @note RT call
+     */
+    bool checkSleep(const float* const* const audioIn, const uint32_t frames) noexcept;
+
+    /*!
+     * Update the silence tracker after a process call.
+     * The plugin goes to sleep once its inputs and @a audioOut have been silent for longer than its tail time.
+     * @note RT call
+     */
+    void updateSleep(const float* const* const audioOut, const uint32_t frames) noexcept;
+
+    /*!
+     * Check if the plugin is currently asleep.
+     * @see PLUGIN_OPTION_SLEEP_WHEN_SILENT
+     */
+    bool isSleeping() const noexcept;
+
+    /*!
+     * Process call used by the rack and patchbay graphs.
+     * Applies the current degradation, then processes through processReblocked() while measuring the plugin DSP load.
+     * @note RT call
+     */
+    void processFromEngine(const float** const audioIn, float** const audioOut, const uint32_t frames);
+
+    /*!
+     * Get the plugin DSP load, in percent of the audio time it processed, smoothed over the calls to this function.
+     * @note Non-RT call, made regularly by the engine thread
+     */
+    float updateProcessLoad() noexcept;
+
+    /*!
+     * Get the current degradation of the plugin.
+     * @see PLUGIN_OPTION_EXPENDABLE
+     */
+    PluginDegradation getDegradation() const noexcept;
+
+    /*!
+     * Get the degradation that degrade() would apply next, PLUGIN_DEGRADATION_NONE if there is none left.
+     */
+    PluginDegradation getNextDegradation() const noexcept;
+
+    /*!
+     * Degrade the plugin one step further to reduce its DSP load.
+     * Returns false if there was nothing left to degrade.
+     */
+    bool degrade();
+
+    /*!
+     * Undo the last step done by degrade().
+     * Returns false if the plugin was not degraded.
+     */
+    bool restore();
+#endif
+
+    /*!
+     * Process the plugin through its re-blocking FIFOs, or call process() directly if not re-blocking.
+     * Events are read from the default event input port and written to the default event output port,
+     * shifted by the re-blocking latency.
+     * @a audioIn and @a audioOut may point to the same buffers.
+     * @see PLUGIN_OPTION_REBLOCK
+     * @note RT call
+     */
+    void processReblocked(const float** const audioIn, float** const audioOut, const uint32_t frames);
+
+    /*!
+     * Stop re-blocking until the next idle call, waiting for any block being processed.
+     * Must be called before bufferSizeChanged() when the engine buffer size changes.
+     */
+    void resetReblock() noexcept;
+
+    /*!
+     * Stop oversampling until the next idle call, returning true if it was active.
+     * The plugin is then running at its previous sample rate, the caller must let it know about the engine one.
+     * Must be called before bufferSizeChanged() and sampleRateChanged() when the engine buffer size or sample rate changes.
+     */
+    bool resetOversampling() noexcept;
+
     // -------------------------------------------------------------------
     // Misc
 
@@ -916,6 +1027,51 @@ protected:
     struct ProtectedData;
     ProtectedData* const pData;
 
+    // -------------------------------------------------------------------
+    // Re-blocking
+
+    /*!
+     * Create or remove the re-blocking FIFOs to match the current options, called during idle.
+     */
+    void updateReblock();
+
+    /*!
+     * Process one full internal block, from the audio thread or the re-blocking worker thread.
+     */
+    void processReblockJob(const uint32_t index);
+
+    /*!
+     * Wait for the block being processed by the worker thread, if any, and stop redirecting the event ports.
+     * Must be called with the master mutex locked.
+     */
+    void finishReblockJob() noexcept;
+
+    // -------------------------------------------------------------------
+    // Oversampling
+
+    /*!
+     * Create or remove the oversampling buffers to match the current options, called during idle.
+     * The plugin is told about its new sample rate and buffer size when they change.
+     */
+    void updateOversampling();
+
+    /*!
+     * Process the plugin at the oversampled rate, or call process() directly if not oversampling.
+     * Events of the default event ports are scaled to the oversampled rate and back.
+     */
+    void processOversampled(const float** const audioIn, float** const audioOut, const uint32_t frames);
+
+#ifndef BUILD_BRIDGE
+    // -------------------------------------------------------------------
+    // Overload degradation
+
+    /*!
+     * Set a parameter lowered or brought back by degrade() and restore(), which run in the engine thread.
+     * The UI gets the new value through uiIdle() if it needs the main thread.
+     */
+    void setDegradedParameterValue(const uint32_t parameterId, const float value) noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Helper classes
 
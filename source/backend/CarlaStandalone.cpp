@@ -26,6 +26,7 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
+#include "CarlaBinaryProjectUtils.hpp"
 
 #ifndef BUILD_BRIDGE
 # include "CarlaLogThread.hpp"
@@ -176,6 +177,15 @@ static void carla_engine_init_common()
     if (const char* const uiBridgesTimeout = std::getenv("ENGINE_OPTION_UI_BRIDGES_TIMEOUT"))
         gStandalone.engine->setOption(CB::ENGINE_OPTION_UI_BRIDGES_TIMEOUT, std::atoi(uiBridgesTimeout), nullptr);
 
+    if (const char* const rtMemoryLock = std::getenv("ENGINE_OPTION_RT_MEMORY_LOCK"))
+        gStandalone.engine->setOption(CB::ENGINE_OPTION_RT_MEMORY_LOCK, (std::strcmp(rtMemoryLock, "true") == 0) ? 1 : 0, nullptr);
+
+    if (const char* const rtCpuAffinity = std::getenv("ENGINE_OPTION_RT_CPU_AFFINITY"))
+        gStandalone.engine->setOption(CB::ENGINE_OPTION_RT_CPU_AFFINITY, std::atoi(rtCpuAffinity), nullptr);
+
+    if (const char* const rtPriority = std::getenv("ENGINE_OPTION_RT_PRIORITY"))
+        gStandalone.engine->setOption(CB::ENGINE_OPTION_RT_PRIORITY, std::atoi(rtPriority), nullptr);
+
     if (const char* const pathLADSPA = std::getenv("ENGINE_OPTION_PLUGIN_PATH_LADSPA"))
         gStandalone.engine->setOption(CB::ENGINE_OPTION_PLUGIN_PATH, CB::PLUGIN_LADSPA, pathLADSPA);
 
@@ -222,10 +232,23 @@ static void carla_engine_init_common()
     gStandalone.engine->setOption(CB::ENGINE_OPTION_UIS_ALWAYS_ON_TOP,     gStandalone.engineOptions.uisAlwaysOnTop      ? 1 : 0,        nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_MAX_PARAMETERS,        static_cast<int>(gStandalone.engineOptions.maxParameters),    nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_UI_BRIDGES_TIMEOUT,    static_cast<int>(gStandalone.engineOptions.uiBridgesTimeout), nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_SILENCE_TAIL_TIME,     static_cast<int>(gStandalone.engineOptions.silenceTailTime),  nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_RT_MEMORY_LOCK,        gStandalone.engineOptions.rtMemoryLock        ? 1 : 0,        nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_RT_CPU_AFFINITY,       static_cast<int>(gStandalone.engineOptions.rtCpuAffinity),    nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_RT_PRIORITY,           static_cast<int>(gStandalone.engineOptions.rtPriority),       nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_PROJECT_LOAD_THREADS,  static_cast<int>(gStandalone.engineOptions.projectLoadThreads), nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_PROCESS_THREADS,       static_cast<int>(gStandalone.engineOptions.processThreads),   nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_REBLOCK_SIZE,          static_cast<int>(gStandalone.engineOptions.reblockSize),      nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_REBLOCK_THREAD,        gStandalone.engineOptions.reblockThread       ? 1 : 0,        nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_OVERLOAD_LIMIT,        static_cast<int>(gStandalone.engineOptions.overloadLimit),    nullptr);
+    gStandalone.engine->setOption(CB::ENGINE_OPTION_OVERSAMPLE_FACTOR,     static_cast<int>(gStandalone.engineOptions.oversampleFactor), nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_NUM_PERIODS,     static_cast<int>(gStandalone.engineOptions.audioNumPeriods),  nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_BUFFER_SIZE,     static_cast<int>(gStandalone.engineOptions.audioBufferSize),  nullptr);
     gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_SAMPLE_RATE,     static_cast<int>(gStandalone.engineOptions.audioSampleRate),  nullptr);
 
+    if (gStandalone.engineOptions.autosaveFilename != nullptr && gStandalone.engineOptions.autosaveFilename[0] != '\0')
+        gStandalone.engine->setOption(CB::ENGINE_OPTION_AUTOSAVE,          static_cast<int>(gStandalone.engineOptions.autosaveInterval), gStandalone.engineOptions.autosaveFilename);
+
     if (gStandalone.engineOptions.audioDevice != nullptr)
         gStandalone.engine->setOption(CB::ENGINE_OPTION_AUDIO_DEVICE,      0, gStandalone.engineOptions.audioDevice);
 
@@ -616,6 +639,69 @@ void carla_set_engine_option(EngineOption option, int value, const char* valueSt
     case CB::ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT:
         gStandalone.logThreadEnabled = (value != 0);
         break;
+
+    case CB::ENGINE_OPTION_SILENCE_TAIL_TIME:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        gStandalone.engineOptions.silenceTailTime = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_RT_MEMORY_LOCK:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        gStandalone.engineOptions.rtMemoryLock = (value != 0);
+        break;
+
+    case CB::ENGINE_OPTION_RT_CPU_AFFINITY:
+        gStandalone.engineOptions.rtCpuAffinity = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_RT_PRIORITY:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 99,);
+        gStandalone.engineOptions.rtPriority = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_PROJECT_LOAD_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        gStandalone.engineOptions.projectLoadThreads = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_PROCESS_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        gStandalone.engineOptions.processThreads = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_REBLOCK_SIZE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 8192,);
+        gStandalone.engineOptions.reblockSize = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_REBLOCK_THREAD:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        gStandalone.engineOptions.reblockThread = (value != 0);
+        break;
+
+    case CB::ENGINE_OPTION_OVERLOAD_LIMIT:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 100,);
+        gStandalone.engineOptions.overloadLimit = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_OVERSAMPLE_FACTOR:
+        CARLA_SAFE_ASSERT_RETURN(value == 2 || value == 4 || value == 8,);
+        gStandalone.engineOptions.oversampleFactor = static_cast<uint>(value);
+        break;
+
+    case CB::ENGINE_OPTION_AUTOSAVE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+
+        if (gStandalone.engineOptions.autosaveFilename != nullptr)
+            delete[] gStandalone.engineOptions.autosaveFilename;
+
+        if (valueStr != nullptr && valueStr[0] != '\0')
+            gStandalone.engineOptions.autosaveFilename = carla_strdup_safe(valueStr);
+        else
+            gStandalone.engineOptions.autosaveFilename = nullptr;
+
+        gStandalone.engineOptions.autosaveInterval = static_cast<uint>(value);
+        break;
     }
 
     if (gStandalone.engine != nullptr)
@@ -675,6 +761,31 @@ bool carla_save_project(const char* filename)
     return false;
 }
 
+bool carla_convert_project(const char* inFilename, const char* outFilename)
+{
+    CARLA_SAFE_ASSERT_RETURN(inFilename != nullptr && inFilename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(outFilename != nullptr && outFilename[0] != '\0', false);
+    carla_debug("carla_convert_project(\"%s\", \"%s\")", inFilename, outFilename);
+
+    const juce::File inFile(juce::String::fromUTF8(inFilename));
+    const juce::File outFile(juce::String::fromUTF8(outFilename));
+
+    if (! inFile.existsAsFile())
+    {
+        gStandalone.lastError = "Requested file does not exist or is not a readable file";
+        return false;
+    }
+
+    const bool ok = CB::CarlaBinaryProjectReader::isBinaryProject(inFile)
+                  ? CB::carla_convert_project_to_xml(inFile, outFile)
+                  : CB::carla_convert_project_to_binary(inFile, outFile);
+
+    if (! ok)
+        gStandalone.lastError = "Failed to convert project file";
+
+    return ok;
+}
+
 #ifndef BUILD_BRIDGE
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -789,6 +900,16 @@ uint32_t carla_get_current_plugin_count()
     return 0;
 }
 
+uint32_t carla_get_sleeping_plugin_count()
+{
+#ifndef BUILD_BRIDGE
+    if (gStandalone.engine != nullptr)
+        return gStandalone.engine->getSleepingPluginCount();
+#endif
+
+    return 0;
+}
+
 uint32_t carla_get_max_plugin_number()
 {
     if (gStandalone.engine != nullptr)
@@ -885,6 +1006,51 @@ bool carla_switch_plugins(uint pluginIdA, uint pluginIdB)
     gStandalone.lastError = "Engine is not running";
     return false;
 }
+
+bool carla_load_standby_plugin(uint pluginId, const char* filename)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    carla_debug("carla_load_standby_plugin(%i, \"%s\")", pluginId, filename);
+
+    if (gStandalone.engine != nullptr)
+        return gStandalone.engine->loadStandbyPlugin(pluginId, filename);
+
+    carla_stderr2("Engine is not running");
+    gStandalone.lastError = "Engine is not running";
+    return false;
+}
+
+bool carla_remove_standby_plugin(uint pluginId)
+{
+    carla_debug("carla_remove_standby_plugin(%i)", pluginId);
+
+    if (gStandalone.engine != nullptr)
+        return gStandalone.engine->removeStandbyPlugin(pluginId);
+
+    carla_stderr2("Engine is not running");
+    gStandalone.lastError = "Engine is not running";
+    return false;
+}
+
+bool carla_switch_to_standby_plugins(uint crossfadeMs)
+{
+    carla_debug("carla_switch_to_standby_plugins(%u)", crossfadeMs);
+
+    if (gStandalone.engine != nullptr)
+        return gStandalone.engine->switchToStandbyPlugins(crossfadeMs);
+
+    carla_stderr2("Engine is not running");
+    gStandalone.lastError = "Engine is not running";
+    return false;
+}
+
+uint64_t carla_get_standby_plugin_memory_usage(uint pluginId)
+{
+    CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr, 0);
+    carla_debug("carla_get_standby_plugin_memory_usage(%i)", pluginId);
+
+    return gStandalone.engine->getStandbyPluginMemoryUsage(pluginId);
+}
 #endif
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -1876,6 +2042,22 @@ double carla_get_sample_rate()
     return gStandalone.engine->getSampleRate();
 }
 
+uint32_t carla_get_idle_thread_tick_time()
+{
+    CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr, 0);
+    carla_debug("carla_get_idle_thread_tick_time()");
+
+    return gStandalone.engine->getIdleThreadTickTime();
+}
+
+uint32_t carla_get_midi_out_jitter()
+{
+    CARLA_SAFE_ASSERT_RETURN(gStandalone.engine != nullptr, 0);
+    carla_debug("carla_get_midi_out_jitter()");
+
+    return gStandalone.engine->getMidiOutJitter();
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 const char* carla_get_last_error()
@@ -1931,6 +2113,7 @@ const char* carla_get_host_osc_url_udp()
 #include "CarlaPatchbayUtils.cpp"
 #include "CarlaPipeUtils.cpp"
 #include "CarlaStateUtils.cpp"
+#include "CarlaBinaryProjectUtils.cpp"
 #include "CarlaJuceEvents.cpp"
 
 // -------------------------------------------------------------------------------------------------------------------
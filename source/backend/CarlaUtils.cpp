@@ -611,7 +611,7 @@ const char* carla_get_supported_file_extensions()
     {
         retText =
         // Base types
-        "*.carxp;*.carxs"
+        "*.carxp;*.carxs;*.carbp"
         // MIDI files
         ";*.mid;*.midi"
 #ifdef HAVE_FLUIDSYNTH
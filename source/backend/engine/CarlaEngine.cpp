@@ -27,6 +27,7 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBinaryUtils.hpp"
+#include "CarlaBinaryProjectUtils.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaPipeUtils.hpp"
@@ -38,6 +39,10 @@
 #include "AppConfig.h"
 #include "juce_core/juce_core.h"
 
+#ifdef __GLIBC__
+# include <malloc.h>
+#endif
+
 using juce::Array;
 using juce::CharPointer_UTF8;
 using juce::File;
@@ -45,6 +50,8 @@ using juce::MemoryOutputStream;
 using juce::ScopedPointer;
 using juce::String;
 using juce::StringArray;
+using juce::TemporaryFile;
+using juce::Time;
 using juce::XmlDocument;
 using juce::XmlElement;
 
@@ -261,6 +268,23 @@ uint CarlaEngine::getMaxPluginNumber() const noexcept
     return pData->maxPluginNumber;
 }
 
+#ifndef BUILD_BRIDGE
+uint CarlaEngine::getSleepingPluginCount() const noexcept
+{
+    uint count = 0;
+
+    for (uint i=0; i < pData->curPluginCount; ++i)
+    {
+        CarlaPlugin* const plugin(pData->plugins[i].plugin);
+
+        if (plugin != nullptr && plugin->isEnabled() && plugin->isSleeping())
+            ++count;
+    }
+
+    return count;
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Virtual, per-engine type calls
 
@@ -274,6 +298,9 @@ bool CarlaEngine::close()
         removeAllPlugins();
     }
 
+    // the audio thread is stopped by now
+    pData->deleteRemovedPlugins(true);
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     if (pData->osc.isControlRegistered())
         oscSend_control_exit();
@@ -292,7 +319,6 @@ bool CarlaEngine::usesConstantBufferSize() const noexcept
 
 void CarlaEngine::idle() noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->nextAction.opcode == kEnginePostActionNull,); // FIXME REMOVE
     CARLA_SAFE_ASSERT_RETURN(pData->nextPluginId == pData->maxPluginNumber,);
     CARLA_SAFE_ASSERT_RETURN(getType() != kEngineTypePlugin,);
 
@@ -316,6 +342,16 @@ void CarlaEngine::idle() noexcept
 #ifdef HAVE_LIBLO
     pData->osc.idle();
 #endif
+
+    try {
+        pData->deleteRemovedPlugins(false);
+    } CARLA_SAFE_EXCEPTION("deleteRemovedPlugins");
+
+#ifndef BUILD_BRIDGE
+    try {
+        updateAutosave();
+    } CARLA_SAFE_EXCEPTION("updateAutosave");
+#endif
 }
 
 CarlaEngineClient* CarlaEngine::addClient(CarlaPlugin* const)
@@ -323,6 +359,75 @@ CarlaEngineClient* CarlaEngine::addClient(CarlaPlugin* const)
     return new CarlaEngineClient(*this);
 }
 
+// -----------------------------------------------------------------------
+// Plugin management helpers
+
+#ifndef BUILD_BRIDGE
+static CarlaString findBridgeBinary(const char* const binaryDir, const BinaryType btype)
+{
+    CarlaString bridgeBinary(binaryDir);
+
+    if (bridgeBinary.isEmpty())
+        return bridgeBinary;
+
+    if (btype == BINARY_NATIVE)
+    {
+# ifdef CARLA_OS_WIN
+        bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native.exe";
+# else
+        bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native";
+# endif
+    }
+    else
+    {
+        switch (btype)
+        {
+        case BINARY_POSIX32:
+            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix32";
+            break;
+        case BINARY_POSIX64:
+            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix64";
+            break;
+        case BINARY_WIN32:
+            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win32.exe";
+            break;
+        case BINARY_WIN64:
+            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win64.exe";
+            break;
+        default:
+            bridgeBinary.clear();
+            break;
+        }
+    }
+
+    if (! File(bridgeBinary.buffer()).existsAsFile())
+        bridgeBinary.clear();
+
+    return bridgeBinary;
+}
+#endif
+
+// returns null if the plugin can run in the current process mode
+static const char* getPluginCannotRunReason(const EngineProcessMode processMode, CarlaPlugin* const plugin)
+{
+    /**/ if (processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+    {
+        /**/ if (! plugin->canRunInRack())
+            return "Carla's rack mode can only work with Mono or Stereo plugins, sorry!";
+        else if (plugin->getCVInCount() > 0 || plugin->getCVInCount() > 0)
+            return "Carla's rack mode cannot work with plugins that have CV ports, sorry!";
+    }
+    else if (processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+    {
+        /**/ if (plugin->getMidiInCount() > 1 || plugin->getMidiOutCount() > 1)
+            return "Carla's patchbay mode cannot work with plugins that have multiple MIDI ports, sorry!";
+        else if (plugin->getCVInCount() > 0 || plugin->getCVInCount() > 0)
+            return "CV ports in patchbay mode is still TODO";
+    }
+
+    return nullptr;
+}
+
 // -----------------------------------------------------------------------
 // Plugin management
 
@@ -333,7 +438,6 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId <= pData->maxPluginNumber, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(btype != BINARY_NONE, "Invalid plugin binary mode");
     CARLA_SAFE_ASSERT_RETURN_ERR(ptype != PLUGIN_NONE, "Invalid plugin type");
     CARLA_SAFE_ASSERT_RETURN_ERR((filename != nullptr && filename[0] != '\0') || (label != nullptr && label[0] != '\0'), "Invalid plugin filename and label");
@@ -358,6 +462,11 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
     {
         id = pData->curPluginCount;
 
+#ifndef BUILD_BRIDGE
+        if (pData->loadingStandbyPlugin)
+            id = pData->maxPluginNumber;
+        else
+#endif
         if (id == pData->maxPluginNumber)
         {
             setLastError("Maximum number of plugins reached");
@@ -380,43 +489,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
     CarlaPlugin* plugin = nullptr;
 
 #ifndef BUILD_BRIDGE
-    CarlaString bridgeBinary(pData->options.binaryDir);
-
-    if (bridgeBinary.isNotEmpty())
-    {
-        if (btype == BINARY_NATIVE)
-        {
-# ifdef CARLA_OS_WIN
-            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native.exe";
-# else
-            bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-native";
-# endif
-        }
-        else
-        {
-            switch (btype)
-            {
-            case BINARY_POSIX32:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix32";
-                break;
-            case BINARY_POSIX64:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-posix64";
-                break;
-            case BINARY_WIN32:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win32.exe";
-                break;
-            case BINARY_WIN64:
-                bridgeBinary += CARLA_OS_SEP_STR "carla-bridge-win64.exe";
-                break;
-            default:
-                bridgeBinary.clear();
-                break;
-            }
-        }
-
-        if (! File(bridgeBinary.buffer()).existsAsFile())
-            bridgeBinary.clear();
-    }
+    const CarlaString bridgeBinary(findBridgeBinary(pData->options.binaryDir, btype));
 
     // Prefer bridges for some specific plugins
     bool preferBridges = pData->options.preferPluginBridges;
@@ -654,37 +727,9 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
 
     plugin->reload();
 
-    bool canRun = true;
-
-    /**/ if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
-    {
-        /**/ if (! plugin->canRunInRack())
-        {
-            setLastError("Carla's rack mode can only work with Mono or Stereo plugins, sorry!");
-            canRun = false;
-        }
-        else if (plugin->getCVInCount() > 0 || plugin->getCVInCount() > 0)
-        {
-            setLastError("Carla's rack mode cannot work with plugins that have CV ports, sorry!");
-            canRun = false;
-        }
-    }
-    else if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-    {
-        /**/ if (plugin->getMidiInCount() > 1 || plugin->getMidiOutCount() > 1)
-        {
-            setLastError("Carla's patchbay mode cannot work with plugins that have multiple MIDI ports, sorry!");
-            canRun = false;
-        }
-        else if (plugin->getCVInCount() > 0 || plugin->getCVInCount() > 0)
-        {
-            setLastError("CV ports in patchbay mode is still TODO");
-            canRun = false;
-        }
-    }
-
-    if (! canRun)
+    if (const char* const cannotRunReason = getPluginCannotRunReason(pData->options.processMode, plugin))
     {
+        setLastError(cannotRunReason);
         delete plugin;
         return false;
     }
@@ -714,7 +759,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
         const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
         const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
 
-        delete oldPlugin;
+        pData->deleteRemovedPlugin(oldPlugin, pData->commitPluginList(isRunning(), true));
 
         if (plugin->getHints() & PLUGIN_CAN_DRYWET)
             plugin->setDryWet(oldDryWet, true, true);
@@ -734,6 +779,8 @@ bool CarlaEngine::addPlugin(const BinaryType btype, const PluginType ptype,
         plugin->setEnabled(true);
 
         ++pData->curPluginCount;
+        pData->commitPluginList(isRunning(), false);
+
         callback(ENGINE_CALLBACK_PLUGIN_ADDED, id, 0, 0, 0.0f, plugin->getName());
 
 #ifndef BUILD_BRIDGE
@@ -755,7 +802,6 @@ bool CarlaEngine::removePlugin(const uint id)
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
     carla_debug("CarlaEngine::removePlugin(%i)", id);
 
@@ -770,8 +816,11 @@ bool CarlaEngine::removePlugin(const uint id)
     if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
         pData->graph.removePlugin(plugin);
 
-    const bool lockWait(isRunning() /*&& pData->options.processMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS*/);
-    const ScopedActionLock sal(this, kEnginePostActionRemovePlugin, id, 0, lockWait);
+    if (CarlaPlugin* const standby = pData->plugins[id].standby.plugin)
+        delete standby;
+
+    pData->doPluginRemove(id);
+    const bool canDelete = pData->commitPluginList(isRunning(), true);
 
     /*
     for (uint i=id; i < pData->curPluginCount; ++i)
@@ -789,9 +838,10 @@ bool CarlaEngine::removePlugin(const uint id)
 #else
     pData->curPluginCount = 0;
     carla_zeroStructs(pData->plugins, 1);
+    const bool canDelete = pData->commitPluginList(isRunning(), true);
 #endif
 
-    delete plugin;
+    pData->deleteRemovedPlugin(plugin, canDelete);
 
     callback(ENGINE_CALLBACK_PLUGIN_REMOVED, id, 0, 0, 0.0f, nullptr);
     return true;
@@ -802,7 +852,6 @@ bool CarlaEngine::removeAllPlugins()
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId == pData->maxPluginNumber, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     carla_debug("CarlaEngine::removeAllPlugins()");
 
     if (pData->curPluginCount == 0)
@@ -825,8 +874,8 @@ bool CarlaEngine::removeAllPlugins()
 # endif
 #endif
 
-    const bool lockWait(isRunning());
-    const ScopedActionLock sal(this, kEnginePostActionZeroCount, 0, 0, lockWait);
+    pData->curPluginCount = 0;
+    const bool canDelete = pData->commitPluginList(isRunning(), true);
 
     callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
 
@@ -836,10 +885,15 @@ bool CarlaEngine::removeAllPlugins()
 
         if (pluginData.plugin != nullptr)
         {
-            delete pluginData.plugin;
+            pData->deleteRemovedPlugin(pluginData.plugin, canDelete);
             pluginData.plugin = nullptr;
         }
 
+        if (pluginData.standby.plugin != nullptr)
+            delete pluginData.standby.plugin;
+
+        carla_zeroStruct(pluginData.standby);
+
         pluginData.insPeak[0]  = 0.0f;
         pluginData.insPeak[1]  = 0.0f;
         pluginData.outsPeak[0] = 0.0f;
@@ -857,7 +911,6 @@ const char* CarlaEngine::renamePlugin(const uint id, const char* const newName)
     CARLA_SAFE_ASSERT_RETURN_ERRN(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERRN(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERRN(pData->curPluginCount != 0, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERRN(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERRN(id < pData->curPluginCount, "Invalid plugin Id");
     CARLA_SAFE_ASSERT_RETURN_ERRN(newName != nullptr && newName[0] != '\0', "Invalid plugin name");
     carla_debug("CarlaEngine::renamePlugin(%i, \"%s\")", id, newName);
@@ -883,7 +936,6 @@ bool CarlaEngine::clonePlugin(const uint id)
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
     carla_debug("CarlaEngine::clonePlugin(%i)", id);
 
@@ -916,7 +968,6 @@ bool CarlaEngine::replacePlugin(const uint id) noexcept
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     carla_debug("CarlaEngine::replacePlugin(%i)", id);
 
     // might use this to reset
@@ -943,7 +994,6 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount >= 2, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(idA != idB, "Invalid operation, cannot switch plugin with itself");
     CARLA_SAFE_ASSERT_RETURN_ERR(idA < pData->curPluginCount, "Invalid plugin Id");
     CARLA_SAFE_ASSERT_RETURN_ERR(idB < pData->curPluginCount, "Invalid plugin Id");
@@ -962,8 +1012,8 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
     if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
         pData->graph.replacePlugin(pluginA, pluginB);
 
-    const bool lockWait(isRunning() /*&& pData->options.processMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS*/);
-    const ScopedActionLock sal(this, kEnginePostActionSwitchPlugins, idA, idB, lockWait);
+    pData->doPluginsSwitch(idA, idB);
+    pData->commitPluginList(isRunning(), false);
 
     // TODO
     /*
@@ -982,7 +1032,6 @@ CarlaPlugin* CarlaEngine::getPlugin(const uint id) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN_ERRN(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERRN(pData->curPluginCount != 0, "Invalid engine internal data");
-    CARLA_SAFE_ASSERT_RETURN_ERRN(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERRN(id < pData->curPluginCount, "Invalid plugin Id");
 
     return pData->plugins[id].plugin;
@@ -995,7 +1044,6 @@ CarlaPlugin* CarlaEngine::getPluginUnchecked(const uint id) const noexcept
 
 const char* CarlaEngine::getUniquePluginName(const char* const name) const
 {
-    CARLA_SAFE_ASSERT_RETURN(pData->nextAction.opcode == kEnginePostActionNull, nullptr);
     CARLA_SAFE_ASSERT_RETURN(name != nullptr && name[0] != '\0', nullptr);
     carla_debug("CarlaEngine::getUniquePluginName(\"%s\")", name);
 
@@ -1097,7 +1145,7 @@ bool CarlaEngine::loadFile(const char* const filename)
 
     // -------------------------------------------------------------------
 
-    if (extension == "carxp" || extension == "carxs")
+    if (extension == "carxp" || extension == "carxs" || extension == "carbp")
         return loadProject(filename);
 
     // -------------------------------------------------------------------
@@ -1184,6 +1232,16 @@ bool CarlaEngine::loadProject(const char* const filename)
     File file(jfilename);
     CARLA_SAFE_ASSERT_RETURN_ERR(file.existsAsFile(), "Requested file does not exist or is not a readable file");
 
+    if (CarlaBinaryProjectReader::isBinaryProject(file))
+    {
+        // plugin chunks are used straight from the mapped file
+        const CarlaBinaryProjectReader reader(file);
+        CARLA_SAFE_ASSERT_RETURN_ERR(reader.isValid(), "Failed to read binary project file");
+
+        XmlDocument xml(reader.getProjectXml());
+        return loadProjectInternal(xml, &reader);
+    }
+
     XmlDocument xml(file);
     return loadProjectInternal(xml);
 }
@@ -1193,17 +1251,55 @@ bool CarlaEngine::saveProject(const char* const filename)
     CARLA_SAFE_ASSERT_RETURN_ERR(filename != nullptr && filename[0] != '\0', "Invalid filename");
     carla_debug("CarlaEngine::saveProject(\"%s\")", filename);
 
-    MemoryOutputStream out;
-    saveProjectInternal(out);
+    if (saveProjectToFile(filename, false))
+        return true;
+
+    setLastError("Failed to write file");
+    return false;
+}
+
+bool CarlaEngine::saveProjectToFile(const char* const filename, const bool reuseUnchangedStates)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+
+#ifndef BUILD_BRIDGE
+    const ScopedValueSetter<bool> svs(pData->savingProject, true, false);
+#endif
 
     const String jfilename = String(CharPointer_UTF8(filename));
     File file(jfilename);
 
-    if (file.replaceWithData(out.getData(), out.getDataSize()))
-        return true;
+    // plugin states are streamed to disk as they are saved, the project file is only replaced once complete
+    TemporaryFile tempFile(file);
+    bool ok = false;
 
-    setLastError("Failed to write file");
-    return false;
+    {
+        ScopedPointer<juce::FileOutputStream> stream(tempFile.getFile().createOutputStream());
+
+        if (stream == nullptr || ! stream->openedOk())
+            return false;
+
+        if (file.hasFileExtension("carbp"))
+        {
+            CarlaBinaryProjectWriter writer(*stream);
+
+            MemoryOutputStream out;
+            saveProjectInternal(out, &writer, reuseUnchangedStates);
+            writer.writeProject(out);
+
+            ok = writer.finish();
+        }
+        else
+        {
+            saveProjectInternal(*stream, nullptr, reuseUnchangedStates);
+            ok = true;
+        }
+
+        stream->flush();
+        ok = ok && stream->getStatus().wasOk();
+    }
+
+    return ok && tempFile.overwriteTargetFileWithTemporary();
 }
 
 // -----------------------------------------------------------------------
@@ -1244,6 +1340,23 @@ const EngineTimeInfo& CarlaEngine::getTimeInfo() const noexcept
     return pData->timeInfo;
 }
 
+#ifndef BUILD_BRIDGE
+uint32_t CarlaEngine::getTotalLatency() const noexcept
+{
+    return pData->totalLatency;
+}
+#endif
+
+uint32_t CarlaEngine::getIdleThreadTickTime() const noexcept
+{
+    return pData->thread.getAverageTickTime();
+}
+
+uint32_t CarlaEngine::getMidiOutJitter() const noexcept
+{
+    return 0;
+}
+
 // -----------------------------------------------------------------------
 // Information (peaks)
 
@@ -1271,6 +1384,13 @@ void CarlaEngine::callback(const EngineCallbackOpcode action, const uint pluginI
         carla_debug("CarlaEngine::callback(%i:%s, %i, %i, %i, %f, \"%s\")", action, EngineCallbackOpcode2Str(action), pluginId, value1, value2, value3, valueStr);
 #endif
 
+#ifndef BUILD_BRIDGE
+    // the frontend does not know about plugins that are not added yet
+    if (((action >= ENGINE_CALLBACK_PLUGIN_ADDED && action <= ENGINE_CALLBACK_RELOAD_ALL) || action == ENGINE_CALLBACK_PLUGIN_DEGRADED)
+        && pData->isHiddenPluginId(pluginId))
+        return;
+#endif
+
 #ifdef BUILD_BRIDGE
     if (pData->isIdling)
 #else
@@ -1368,6 +1488,23 @@ const char* CarlaEngine::getLastError() const noexcept
 
 void CarlaEngine::setLastError(const char* const error) const noexcept
 {
+    // plugins might be loading in parallel
+    const CarlaMutexLocker cml(pData->lastErrorMutex);
+
+#ifndef BUILD_BRIDGE
+    for (uint i=0; i < pData->loaderErrorCount; ++i)
+    {
+        EngineLoaderError& loaderError(pData->loaderErrors[i]);
+
+        if (! pthread_equal(loaderError.thread, pthread_self()))
+            continue;
+
+        if (loaderError.error != nullptr)
+            *loaderError.error = error;
+        return;
+    }
+#endif
+
     pData->lastError = error;
 }
 
@@ -1379,6 +1516,15 @@ bool CarlaEngine::isAboutToClose() const noexcept
     return pData->aboutToClose;
 }
 
+bool CarlaEngine::isLoadingProjectInParallel() const noexcept
+{
+#ifndef BUILD_BRIDGE
+    return pData->loadingProjectInParallel;
+#else
+    return false;
+#endif
+}
+
 bool CarlaEngine::setAboutToClose() noexcept
 {
     carla_debug("CarlaEngine::setAboutToClose()");
@@ -1606,6 +1752,77 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
 
     case ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT:
         break;
+
+    case ENGINE_OPTION_SILENCE_TAIL_TIME:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.silenceTailTime = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_RT_MEMORY_LOCK:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.rtMemoryLock = (value != 0);
+        break;
+
+    case ENGINE_OPTION_RT_CPU_AFFINITY:
+        pData->options.rtCpuAffinity = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_RT_PRIORITY:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 99,);
+        pData->options.rtPriority = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_PROJECT_LOAD_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.projectLoadThreads = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_PROCESS_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.processThreads = static_cast<uint>(value);
+#ifndef BUILD_BRIDGE
+        if (pData->graph.isReady())
+            pData->graph.setProcessThreads(pData->options.processThreads);
+#endif
+        break;
+
+    // plugins pick up re-blocking changes on their next idle
+    case ENGINE_OPTION_REBLOCK_SIZE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 8192,);
+        pData->options.reblockSize = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_REBLOCK_THREAD:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.reblockThread = (value != 0);
+        break;
+
+    case ENGINE_OPTION_OVERLOAD_LIMIT:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 100,);
+        pData->options.overloadLimit = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_OVERSAMPLE_FACTOR:
+        CARLA_SAFE_ASSERT_RETURN(value == 2 || value == 4 || value == 8,);
+        pData->options.oversampleFactor = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_AUTOSAVE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+
+        if (pData->options.autosaveFilename != nullptr)
+            delete[] pData->options.autosaveFilename;
+
+        if (valueStr != nullptr && valueStr[0] != '\0')
+            pData->options.autosaveFilename = carla_strdup_safe(valueStr);
+        else
+            pData->options.autosaveFilename = nullptr;
+
+        pData->options.autosaveInterval = static_cast<uint>(value);
+#ifndef BUILD_BRIDGE
+        pData->lastAutosaveTime = 0;
+#endif
+        break;
     }
 }
 
@@ -1644,6 +1861,73 @@ EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexc
     return isInput ? pData->events.in : pData->events.out;
 }
 
+#ifndef BUILD_BRIDGE
+void CarlaEngine::updatePluginLatency(CarlaPlugin* const plugin)
+{
+    CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
+
+    if (! pData->graph.isReady())
+        return;
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+        pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
+        return;
+
+    pData->graph.updatePluginLatency(plugin);
+}
+
+void CarlaEngine::updateTotalLatency()
+{
+    const uint32_t latency(pData->graph.isReady() ? pData->graph.getLatency() : 0);
+
+    if (pData->totalLatency == latency)
+        return;
+
+    carla_debug("CarlaEngine::updateTotalLatency() - %u -> %u", pData->totalLatency, latency);
+
+    pData->totalLatency = latency;
+    totalLatencyChanged(latency);
+}
+
+void CarlaEngine::updateOverload()
+{
+    if (! pData->graph.isReady())
+        return;
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+        pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
+        return;
+
+    pData->overload.idle(this, pData->plugins, pData->curPluginCount, pData->options.overloadLimit);
+}
+
+void CarlaEngine::updateAutosave()
+{
+    const char* const filename(pData->options.autosaveFilename);
+
+    if (pData->options.autosaveInterval == 0 || filename == nullptr || filename[0] == '\0')
+        return;
+
+    // never save half-loaded projects, or from inside another save
+    if (pData->savingProject || pData->loadingProject || pData->isIdling > 0 || pData->aboutToClose)
+        return;
+
+    const uint32_t now(Time::getMillisecondCounter());
+
+    if (pData->lastAutosaveTime == 0)
+    {
+        pData->lastAutosaveTime = now;
+        return;
+    }
+
+    if (now - pData->lastAutosaveTime < pData->options.autosaveInterval * 1000)
+        return;
+
+    pData->lastAutosaveTime = now;
+
+    if (! saveProjectToFile(filename, true))
+        carla_stderr2("CarlaEngine::updateAutosave() - failed to write \"%s\"", filename);
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Internal stuff
 
@@ -1656,6 +1940,7 @@ void CarlaEngine::bufferSizeChanged(const uint32_t newBufferSize)
         pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
     {
         pData->graph.setBufferSize(newBufferSize);
+        pData->overload.reset();
     }
 #endif
 
@@ -1666,7 +1951,14 @@ void CarlaEngine::bufferSizeChanged(const uint32_t newBufferSize)
         CarlaPlugin* const plugin(pData->plugins[i].plugin);
 
         if (plugin != nullptr && plugin->isEnabled())
+        {
+            plugin->resetReblock();
+
+            if (plugin->resetOversampling())
+                plugin->sampleRateChanged(pData->sampleRate);
+
             plugin->bufferSizeChanged(newBufferSize);
+        }
     }
 
     callback(ENGINE_CALLBACK_BUFFER_SIZE_CHANGED, 0, static_cast<int>(newBufferSize), 0, 0.0f, nullptr);
@@ -1681,6 +1973,7 @@ void CarlaEngine::sampleRateChanged(const double newSampleRate)
         pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
     {
         pData->graph.setSampleRate(newSampleRate);
+        pData->overload.reset();
     }
 #endif
 
@@ -1691,7 +1984,10 @@ void CarlaEngine::sampleRateChanged(const double newSampleRate)
         CarlaPlugin* const plugin(pData->plugins[i].plugin);
 
         if (plugin != nullptr && plugin->isEnabled())
+        {
+            plugin->resetOversampling();
             plugin->sampleRateChanged(newSampleRate);
+        }
     }
 
     callback(ENGINE_CALLBACK_SAMPLE_RATE_CHANGED, 0, 0, 0, static_cast<float>(newSampleRate), nullptr);
@@ -1728,15 +2024,26 @@ void CarlaEngine::setPluginPeaks(const uint pluginId, float const inPeaks[2], fl
     pluginData.outsPeak[1] = outPeaks[1];
 }
 
-void CarlaEngine::saveProjectInternal(juce::MemoryOutputStream& outStream) const
+#ifndef BUILD_BRIDGE
+void CarlaEngine::totalLatencyChanged(const uint32_t)
+{
+}
+#endif
+
+void CarlaEngine::saveProjectInternal(juce::OutputStream& outStream, CarlaBinaryProjectWriter* const binaryWriter,
+                                      const bool reuseUnchangedStates) const
 {
-    // send initial prepareForSave first, giving time for bridges to act
+    // send initial prepareForSave first, giving time for bridges to act.
+    // bridges save at the same time, each in their own process, while waiting for the first one
     for (uint i=0; i < pData->curPluginCount; ++i)
     {
         CarlaPlugin* const plugin(pData->plugins[i].plugin);
 
         if (plugin != nullptr && plugin->isEnabled())
         {
+            if (reuseUnchangedStates && ! plugin->isStateSaveOutdated())
+                continue;
+
 #ifndef BUILD_BRIDGE
             // deactivate bridge client-side ping check, since some plugins block during save
             if (plugin->getHints() & PLUGIN_IS_BRIDGE)
@@ -1768,6 +2075,7 @@ void CarlaEngine::saveProjectInternal(juce::MemoryOutputStream& outStream) const
 
     outSettings << "  <MaxParameters>"       << String(options.maxParameters)    << "</MaxParameters>\n";
     outSettings << "  <UIBridgesTimeout>"    << String(options.uiBridgesTimeout) << "</UIBridgesTimeout>\n";
+    outSettings << "  <SilenceTailTime>"     << String(options.silenceTailTime)  << "</SilenceTailTime>\n";
 
     if (isPlugin)
     {
@@ -1793,7 +2101,9 @@ void CarlaEngine::saveProjectInternal(juce::MemoryOutputStream& outStream) const
         if (plugin != nullptr && plugin->isEnabled())
         {
             MemoryOutputStream outPlugin(4096), streamPlugin;
-            plugin->getStateSave(false).dumpToMemoryStream(streamPlugin);
+
+            if (binaryWriter == nullptr)
+                plugin->getStateSave(false, true, reuseUnchangedStates).dumpToMemoryStream(streamPlugin);
 
             outPlugin << "\n";
 
@@ -1803,9 +2113,20 @@ void CarlaEngine::saveProjectInternal(juce::MemoryOutputStream& outStream) const
             if (strBuf[0] != '\0')
                 outPlugin << " <!-- " << xmlSafeString(strBuf, true) << " -->\n";
 
-            outPlugin << " <Plugin>\n";
-            outPlugin << streamPlugin;
-            outPlugin << " </Plugin>\n";
+            if (binaryWriter != nullptr)
+            {
+                // raw chunk is written before the plugin is used again, and not kept after that
+                const uint32_t record = binaryWriter->writePluginState(plugin->getStateSave(false, false, reuseUnchangedStates));
+                plugin->clearStateSaveRawChunk();
+                outPlugin << " <Plugin Record='" << String(record) << "'/>\n";
+            }
+            else
+            {
+                outPlugin << " <Plugin>\n";
+                outPlugin << streamPlugin;
+                outPlugin << " </Plugin>\n";
+            }
+
             outStream << outPlugin;
         }
     }
@@ -1959,7 +2280,631 @@ static String findBinaryInCustomPath(const char* const searchPath, const char* c
     return String();
 }
 
-bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
+// resolve the plugin binary location when not found in the saved path, returns the 'extra' data for addPlugin
+static const void* prepareStateSaveForLoading(const EngineOptions& options, CarlaStateSave& stateSave, const PluginType ptype)
+{
+    const void* extraStuff    = nullptr;
+    static const char kTrue[] = "true";
+
+    switch (ptype)
+    {
+    case PLUGIN_GIG:
+    case PLUGIN_SF2:
+        if (CarlaString(stateSave.label).endsWith(" (16 outs)"))
+            extraStuff = kTrue;
+        // nobreak
+    case PLUGIN_LADSPA:
+    case PLUGIN_DSSI:
+    case PLUGIN_VST2:
+    case PLUGIN_VST3:
+    case PLUGIN_SFZ:
+        if (stateSave.binary != nullptr && stateSave.binary[0] != '\0' &&
+            ! (File::isAbsolutePath(stateSave.binary) && File(stateSave.binary).exists()))
+        {
+            const char* searchPath;
+
+            switch (ptype)
+            {
+            case PLUGIN_LADSPA: searchPath = options.pathLADSPA; break;
+            case PLUGIN_DSSI:   searchPath = options.pathDSSI;   break;
+            case PLUGIN_VST2:   searchPath = options.pathVST2;   break;
+            case PLUGIN_VST3:   searchPath = options.pathVST3;   break;
+            case PLUGIN_GIG:    searchPath = options.pathGIG;    break;
+            case PLUGIN_SF2:    searchPath = options.pathSF2;    break;
+            case PLUGIN_SFZ:    searchPath = options.pathSFZ;    break;
+            default:            searchPath = nullptr;                   break;
+            }
+
+            if (searchPath != nullptr && searchPath[0] != '\0')
+            {
+                carla_stderr("Plugin binary '%s' doesn't exist on this filesystem, let's look for it...",
+                             stateSave.binary);
+
+                String result = findBinaryInCustomPath(searchPath, stateSave.binary);
+
+                if (result.isEmpty())
+                {
+                    switch (ptype)
+                    {
+                    case PLUGIN_LADSPA: searchPath = std::getenv("LADSPA_PATH"); break;
+                    case PLUGIN_DSSI:   searchPath = std::getenv("DSSI_PATH");   break;
+                    case PLUGIN_VST2:   searchPath = std::getenv("VST_PATH");    break;
+                    case PLUGIN_VST3:   searchPath = std::getenv("VST3_PATH");   break;
+                    case PLUGIN_GIG:    searchPath = std::getenv("GIG_PATH");    break;
+                    case PLUGIN_SF2:    searchPath = std::getenv("SF2_PATH");    break;
+                    case PLUGIN_SFZ:    searchPath = std::getenv("SFZ_PATH");    break;
+                    default:            searchPath = nullptr;                    break;
+                    }
+
+                    if (searchPath != nullptr && searchPath[0] != '\0')
+                        result = findBinaryInCustomPath(searchPath, stateSave.binary);
+                }
+
+                if (result.isNotEmpty())
+                {
+                    delete[] stateSave.binary;
+                    stateSave.binary = carla_strdup(result.toRawUTF8());
+                    carla_stderr("Found it! :)");
+                }
+                else
+                {
+                    carla_stderr("Damn, we failed... :(");
+                }
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    return extraStuff;
+}
+
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+// Parallel project loading
+
+struct ProjectPluginLoad {
+    CarlaStateSave stateSave;
+    PluginType  ptype;
+    BinaryType  btype;
+    const void* extraStuff;
+    CarlaString bridgeBinary; // not empty means plugin is loaded in a background thread
+    CarlaPlugin* plugin;
+    CarlaString error;
+    uint32_t loadTime;
+
+    ProjectPluginLoad() noexcept
+        : stateSave(),
+          ptype(PLUGIN_NONE),
+          btype(BINARY_NONE),
+          extraStuff(nullptr),
+          bridgeBinary(),
+          plugin(nullptr),
+          error(),
+          loadTime(0) {}
+
+    CARLA_DECLARE_NON_COPY_STRUCT(ProjectPluginLoad)
+};
+
+class ProjectPluginLoader : public CarlaThread
+{
+public:
+    ProjectPluginLoader(CarlaEngine* const engine, const EngineProcessMode processMode,
+                        ProjectPluginLoad* const loads, const uint loadCount, const uint firstId,
+                        CarlaMutex& mutex, uint& nextLoad,
+                        CarlaMutex& errorMutex, EngineLoaderError& loaderError) noexcept
+        : CarlaThread("ProjectPluginLoader"),
+          kEngine(engine),
+          kProcessMode(processMode),
+          kLoads(loads),
+          kLoadCount(loadCount),
+          kFirstId(firstId),
+          fMutex(mutex),
+          fNextLoad(nextLoad),
+          fErrorMutex(errorMutex),
+          fLoaderError(loaderError) {}
+
+protected:
+    void run() override
+    {
+        {
+            const CarlaMutexLocker cml(fErrorMutex);
+            fLoaderError.thread = pthread_self();
+        }
+
+        for (; ! (shouldThreadExit() || kEngine->isAboutToClose());)
+        {
+            ProjectPluginLoad* load = nullptr;
+
+            {
+                const CarlaMutexLocker cml(fMutex);
+
+                for (; fNextLoad < kLoadCount && load == nullptr; ++fNextLoad)
+                {
+                    if (kLoads[fNextLoad].bridgeBinary.isNotEmpty())
+                        load = &kLoads[fNextLoad];
+                }
+            }
+
+            if (load == nullptr)
+                break;
+
+            {
+                const CarlaMutexLocker cml(fErrorMutex);
+                fLoaderError.error = &load->error;
+            }
+
+            const uint32_t startTime = Time::getMillisecondCounter();
+            const CarlaStateSave& stateSave(load->stateSave);
+
+            // a hidden id, unique among all loads, the final one is set when added to the engine
+            const CarlaPlugin::Initializer initializer = {
+                kEngine,
+                kFirstId + static_cast<uint>(load - kLoads),
+                stateSave.binary,
+                stateSave.name,
+                stateSave.label,
+                stateSave.uniqueId,
+                stateSave.options
+            };
+
+            CarlaPlugin* const plugin = CarlaPlugin::newBridge(initializer, load->btype, load->ptype, load->bridgeBinary);
+
+            if (plugin == nullptr)
+                continue;
+
+            plugin->reload();
+
+            if (const char* const cannotRunReason = getPluginCannotRunReason(kProcessMode, plugin))
+            {
+                load->error = cannotRunReason;
+                delete plugin;
+                continue;
+            }
+
+            // deactivate bridge client-side ping check, since some plugins block during load
+            plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "false", false);
+            plugin->loadStateSave(stateSave);
+
+            load->loadTime = Time::getMillisecondCounter() - startTime;
+            load->plugin   = plugin;
+        }
+
+        const CarlaMutexLocker cml(fErrorMutex);
+        fLoaderError.error = nullptr;
+    }
+
+private:
+    CarlaEngine* const kEngine;
+    const EngineProcessMode kProcessMode;
+    ProjectPluginLoad* const kLoads;
+    const uint kLoadCount;
+    const uint kFirstId;
+
+    CarlaMutex& fMutex;
+    uint& fNextLoad;
+
+    CarlaMutex& fErrorMutex;
+    EngineLoaderError& fLoaderError;
+
+    CARLA_DECLARE_NON_COPY_CLASS(ProjectPluginLoader)
+};
+
+bool CarlaEngine::loadProjectPluginsInParallel(const XmlElement* const xmlElement, const CarlaBinaryProjectReader* const binaryReader)
+{
+    CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, true);
+
+    uint loadCount = 0;
+
+    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (elem->getTagName().equalsIgnoreCase("plugin"))
+            ++loadCount;
+    }
+
+    if (loadCount == 0)
+        return true;
+
+    ProjectPluginLoad* const loads = new ProjectPluginLoad[loadCount];
+    uint bridgeCount = 0;
+
+    // parse all plugin states first, deciding which ones can be loaded in the background
+    {
+        uint i = 0;
+
+        for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+        {
+            if (! elem->getTagName().equalsIgnoreCase("plugin"))
+                continue;
+
+            ProjectPluginLoad& load(loads[i++]);
+
+            if (binaryReader != nullptr)
+                binaryReader->fillStateSave(load.stateSave, elem);
+            else
+                load.stateSave.fillFromXmlElement(elem);
+
+            CARLA_SAFE_ASSERT_CONTINUE(load.stateSave.type != nullptr);
+
+            load.ptype      = getPluginTypeFromString(load.stateSave.type);
+            load.btype      = getBinaryTypeFromFile(load.stateSave.binary);
+            load.extraStuff = prepareStateSaveForLoading(pData->options, load.stateSave, load.ptype);
+
+            if (load.ptype == PLUGIN_INTERNAL || load.btype == BINARY_NONE)
+                continue;
+            if (load.btype == BINARY_NATIVE && ! pData->options.preferPluginBridges)
+                continue;
+
+            load.bridgeBinary = findBridgeBinary(pData->options.binaryDir, load.btype);
+
+            if (load.bridgeBinary.isNotEmpty())
+                ++bridgeCount;
+        }
+    }
+
+    const uint threadCount = (bridgeCount < pData->options.projectLoadThreads) ? bridgeCount : pData->options.projectLoadThreads;
+    carla_stdout("Loading %u project plugins, %u of them in %u background threads", loadCount, bridgeCount, threadCount);
+
+    CarlaMutex loadMutex;
+    uint nextLoad = 0;
+
+    ProjectPluginLoader** const loaders = new ProjectPluginLoader*[threadCount > 0 ? threadCount : 1];
+    EngineLoaderError* const loaderErrors = new EngineLoaderError[threadCount > 0 ? threadCount : 1];
+    carla_zeroStructs(loaderErrors, threadCount > 0 ? threadCount : 1);
+
+    {
+        // new plugins stay hidden from the frontend and OSC until they get their final ids below
+        const ScopedValueSetter<bool> svs1(pData->loadingProjectInParallel, true, false);
+        const ScopedValueSetter<bool> svs2(pData->loadingHiddenPlugins, true, false);
+
+        {
+            const CarlaMutexLocker cml(pData->lastErrorMutex);
+            pData->loaderErrors     = loaderErrors;
+            pData->loaderErrorCount = threadCount;
+        }
+
+        for (uint i=0; i < threadCount; ++i)
+        {
+            loaders[i] = new ProjectPluginLoader(this, pData->options.processMode, loads, loadCount, pData->curPluginCount,
+                                                 loadMutex, nextLoad, pData->lastErrorMutex, loaderErrors[i]);
+            loaders[i]->startThread();
+        }
+
+        // load in-process plugins meanwhile, these need to be created on the main thread
+        for (uint i=0; i < loadCount && ! pData->aboutToClose; ++i)
+        {
+            ProjectPluginLoad& load(loads[i]);
+
+            if (load.ptype == PLUGIN_NONE || load.bridgeBinary.isNotEmpty())
+                continue;
+
+            callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+
+            const uint32_t startTime = Time::getMillisecondCounter();
+            const CarlaStateSave& stateSave(load.stateSave);
+
+            if (! addPlugin(load.btype, load.ptype, stateSave.binary, stateSave.name, stateSave.label,
+                            stateSave.uniqueId, load.extraStuff, stateSave.options))
+            {
+                load.error = getLastError();
+                continue;
+            }
+
+            // addPlugin parks the new plugin at the first free slot while loading a project
+            EnginePluginData& pluginData(pData->plugins[pData->curPluginCount]);
+            CarlaPlugin* const plugin = pluginData.plugin;
+            pluginData.plugin = nullptr;
+
+            CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr);
+
+            plugin->loadStateSave(stateSave);
+
+            load.loadTime = Time::getMillisecondCounter() - startTime;
+            load.plugin   = plugin;
+        }
+
+        // wait for background loads to finish
+        for (bool running = true; running;)
+        {
+            running = false;
+
+            for (uint i=0; i < threadCount; ++i)
+            {
+                if (loaders[i]->isThreadRunning())
+                {
+                    running = true;
+                    break;
+                }
+            }
+
+            if (! running)
+                break;
+
+            callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+            carla_msleep(20);
+        }
+
+        for (uint i=0; i < threadCount; ++i)
+            delete loaders[i];
+        delete[] loaders;
+
+        {
+            const CarlaMutexLocker cml(pData->lastErrorMutex);
+            pData->loaderErrors     = nullptr;
+            pData->loaderErrorCount = 0;
+        }
+
+        delete[] loaderErrors;
+    }
+
+    // add everything to the engine in project order
+    for (uint i=0; i < loadCount; ++i)
+    {
+        ProjectPluginLoad& load(loads[i]);
+        CarlaPlugin* const plugin = load.plugin;
+
+        if (plugin == nullptr)
+        {
+            if (load.error.isNotEmpty())
+                carla_stderr2("Failed to load plugin '%s', error was:\n%s",
+                              load.stateSave.name != nullptr ? load.stateSave.name : "", load.error.buffer());
+            continue;
+        }
+
+        if (pData->aboutToClose)
+        {
+            delete plugin;
+            continue;
+        }
+
+        const uint id = pData->curPluginCount;
+
+        if (id == pData->maxPluginNumber)
+        {
+            carla_stderr2("Failed to add plugin '%s', maximum number of plugins reached", plugin->getName());
+            delete plugin;
+            continue;
+        }
+
+        carla_stdout("Loaded plugin '%s' in %u ms%s", plugin->getName(), load.loadTime,
+                     load.bridgeBinary.isNotEmpty() ? " (background)" : "");
+
+        plugin->setId(id);
+
+# ifdef HAVE_LIBLO
+        // nothing was sent while hidden
+        plugin->registerToOscClient();
+# endif
+
+        EnginePluginData& pluginData(pData->plugins[id]);
+        pluginData.plugin      = plugin;
+        pluginData.insPeak[0]  = 0.0f;
+        pluginData.insPeak[1]  = 0.0f;
+        pluginData.outsPeak[0] = 0.0f;
+        pluginData.outsPeak[1] = 0.0f;
+
+        plugin->setEnabled(true);
+        ++pData->curPluginCount;
+
+        callback(ENGINE_CALLBACK_PLUGIN_ADDED, id, 0, 0, 0.0f, plugin->getName());
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.addPlugin(plugin);
+    }
+
+    delete[] loads;
+
+    // publish all new plugins to the audio thread at once
+    pData->commitPluginList(isRunning(), false);
+
+    return ! pData->aboutToClose;
+}
+
+// -----------------------------------------------------------------------
+// Standby plugins
+
+// current heap usage of this process, used to estimate the memory of standby plugins
+static uint64_t getHeapUsage() noexcept
+{
+#ifdef __GLIBC__
+# if __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info(mallinfo2());
+    return static_cast<uint64_t>(info.uordblks) + static_cast<uint64_t>(info.hblkhd);
+# else
+    const struct mallinfo info(mallinfo());
+    return static_cast<uint64_t>(static_cast<uint>(info.uordblks)) + static_cast<uint64_t>(static_cast<uint>(info.hblkhd));
+# endif
+#else
+    return 0;
+#endif
+}
+
+bool CarlaEngine::loadStandbyPlugin(const uint id, const char* const filename)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId == pData->maxPluginNumber, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
+    CARLA_SAFE_ASSERT_RETURN_ERR(filename != nullptr && filename[0] != '\0', "Invalid filename");
+    carla_debug("CarlaEngine::loadStandbyPlugin(%i, \"%s\")", id, filename);
+
+    // each plugin would be a visible client of its own, with its connections lost on switch
+    if (pData->options.processMode == ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS)
+    {
+        setLastError("Standby plugins are not supported in multi-client mode");
+        return false;
+    }
+
+    const String jfilename = String(CharPointer_UTF8(filename));
+    File file(jfilename);
+    CARLA_SAFE_ASSERT_RETURN_ERR(file.existsAsFile(), "Requested file does not exist or is not a readable file");
+
+    XmlDocument xml(file);
+    ScopedPointer<XmlElement> xmlElement(xml.getDocumentElement(true));
+    CARLA_SAFE_ASSERT_RETURN_ERR(xmlElement != nullptr, "Failed to parse preset file");
+    CARLA_SAFE_ASSERT_RETURN_ERR(xmlElement->getTagName().equalsIgnoreCase("carla-preset"), "Not a valid Carla preset file");
+
+    // completely load file
+    xmlElement = xml.getDocumentElement(false);
+    CARLA_SAFE_ASSERT_RETURN_ERR(xmlElement != nullptr, "Failed to completely parse preset file");
+
+    CarlaStateSave stateSave;
+    stateSave.fillFromXmlElement(xmlElement);
+    CARLA_SAFE_ASSERT_RETURN_ERR(stateSave.type != nullptr, "Invalid preset file");
+
+    const PluginType ptype(getPluginTypeFromString(stateSave.type));
+    const void* const extraStuff(prepareStateSaveForLoading(pData->options, stateSave, ptype));
+
+    const uint64_t heapUsageBefore(getHeapUsage());
+    CarlaPlugin* plugin;
+
+    {
+        // make addPlugin leave the new plugin on the spare slot, without adding it to the engine.
+        // the frontend and OSC only learn about it once switched in, under the id it replaces.
+        const ScopedValueSetter<bool> svs1(pData->loadingProject, true, false);
+        const ScopedValueSetter<bool> svs2(pData->loadingHiddenPlugins, true, false);
+        const ScopedValueSetter<bool> svs3(pData->loadingStandbyPlugin, true, false);
+
+        if (! addPlugin(getBinaryTypeFromFile(stateSave.binary), ptype, stateSave.binary,
+                        stateSave.name, stateSave.label, stateSave.uniqueId, extraStuff, stateSave.options))
+            return false;
+
+        EnginePluginData& spareSlotData(pData->plugins[pData->maxPluginNumber]);
+        plugin = spareSlotData.plugin;
+        spareSlotData.plugin = nullptr;
+
+        CARLA_SAFE_ASSERT_RETURN_ERR(plugin != nullptr, "Failed to get new plugin");
+
+        plugin->loadStateSave(stateSave);
+
+        // keep it idle until switched in
+        plugin->setActive(false, false, false);
+    }
+
+    const uint64_t heapUsageAfter(getHeapUsage());
+
+    EngineStandbyPlugin& standby(pData->plugins[id].standby);
+
+    if (standby.plugin != nullptr)
+        delete standby.plugin;
+
+    standby.plugin      = plugin;
+    standby.memoryUsage = heapUsageAfter > heapUsageBefore ? heapUsageAfter - heapUsageBefore : 0;
+    standby.active      = stateSave.active;
+
+    carla_stdout("Loaded standby plugin '%s' for plugin %u, using about " P_UINT64 " KiB",
+                 plugin->getName(), id, standby.memoryUsage / 1024);
+    return true;
+}
+
+bool CarlaEngine::removeStandbyPlugin(const uint id)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
+    carla_debug("CarlaEngine::removeStandbyPlugin(%i)", id);
+
+    EngineStandbyPlugin& standby(pData->plugins[id].standby);
+
+    if (standby.plugin != nullptr)
+        delete standby.plugin;
+
+    carla_zeroStruct(standby);
+    return true;
+}
+
+bool CarlaEngine::switchToStandbyPlugins(const uint crossfadeMs)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId == pData->maxPluginNumber, "Invalid engine internal data");
+    carla_debug("CarlaEngine::switchToStandbyPlugins(%u)", crossfadeMs);
+
+    const uint count(pData->curPluginCount);
+    uint switchCount = 0;
+
+    for (uint i=0; i < count; ++i)
+    {
+        if (pData->plugins[i].standby.plugin != nullptr)
+            ++switchCount;
+    }
+
+    if (switchCount == 0)
+    {
+        setLastError("There are no standby plugins to switch to");
+        return false;
+    }
+
+    // old plugins, indexed like the engine ones (null if not switched)
+    CarlaPlugin** const oldPlugins = new CarlaPlugin*[count];
+    carla_zeroPointers(oldPlugins, count);
+
+    const ScopedThreadStopper sts(this);
+
+    for (uint i=0; i < count; ++i)
+    {
+        EnginePluginData& pluginData(pData->plugins[i]);
+        CarlaPlugin* const newPlugin = pluginData.standby.plugin;
+
+        if (newPlugin == nullptr)
+            continue;
+
+        CarlaPlugin* const oldPlugin = pluginData.plugin;
+        CARLA_SAFE_ASSERT_CONTINUE(oldPlugin != nullptr);
+
+        newPlugin->setId(i);
+
+# ifdef HAVE_LIBLO
+        newPlugin->registerToOscClient();
+# endif
+
+        newPlugin->setActive(pluginData.standby.active, true, true);
+        newPlugin->setEnabled(true);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.replacePlugin(oldPlugin, newPlugin);
+
+        oldPlugins[i] = oldPlugin;
+
+        pluginData.plugin      = newPlugin;
+        pluginData.insPeak[0]  = 0.0f;
+        pluginData.insPeak[1]  = 0.0f;
+        pluginData.outsPeak[0] = 0.0f;
+        pluginData.outsPeak[1] = 0.0f;
+        carla_zeroStruct(pluginData.standby);
+    }
+
+    // rack mode processes plugins in series, the only place where the engine can crossfade them
+    const uint32_t fadeFrames = (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+                              ? static_cast<uint32_t>(pData->sampleRate * crossfadeMs / 1000.0)
+                              : 0;
+
+    const bool canDelete = pData->commitPluginListWithFade(isRunning(), oldPlugins, fadeFrames);
+
+    for (uint i=0; i < count; ++i)
+    {
+        if (oldPlugins[i] == nullptr)
+            continue;
+
+        pData->deleteRemovedPlugin(oldPlugins[i], canDelete);
+        callback(ENGINE_CALLBACK_RELOAD_ALL, i, 0, 0, 0.0f, nullptr);
+    }
+
+    delete[] oldPlugins;
+    return true;
+}
+
+uint64_t CarlaEngine::getStandbyPluginMemoryUsage(const uint id) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pData->plugins != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(id < pData->curPluginCount, 0);
+
+    return pData->plugins[id].standby.memoryUsage;
+}
+#endif
+
+bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc, const CarlaBinaryProjectReader* const binaryReader)
 {
     ScopedPointer<XmlElement> xmlElement(xmlDoc.getDocumentElement(true));
     CARLA_SAFE_ASSERT_RETURN_ERR(xmlElement != nullptr, "Failed to parse project file");
@@ -2036,6 +2981,11 @@ bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
                 option = ENGINE_OPTION_UI_BRIDGES_TIMEOUT;
                 value  = text.getIntValue();
             }
+            else if (tag.equalsIgnoreCase("silencetailtime"))
+            {
+                option = ENGINE_OPTION_SILENCE_TAIL_TIME;
+                value  = text.getIntValue();
+            }
             else if (isPlugin)
             {
                 /**/ if (tag.equalsIgnoreCase("LADSPA_PATH"))
@@ -2100,6 +3050,14 @@ bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
         return true;
 
     // handle plugins first
+#ifndef BUILD_BRIDGE
+    if (pData->options.projectLoadThreads > 0 && ! isPreset)
+    {
+        if (! loadProjectPluginsInParallel(xmlElement, binaryReader))
+            return true;
+    }
+    else
+#endif
     for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
     {
         const String& tagName(elem->getTagName());
@@ -2107,7 +3065,11 @@ bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
         if (isPreset || tagName.equalsIgnoreCase("plugin"))
         {
             CarlaStateSave stateSave;
-            stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem);
+
+            if (binaryReader != nullptr)
+                binaryReader->fillStateSave(stateSave, elem);
+            else
+                stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem);
 
             callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
 
@@ -2116,81 +3078,8 @@ bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
 
             CARLA_SAFE_ASSERT_CONTINUE(stateSave.type != nullptr);
 
-            const void* extraStuff    = nullptr;
-            static const char kTrue[] = "true";
-
             const PluginType ptype(getPluginTypeFromString(stateSave.type));
-
-            switch (ptype)
-            {
-            case PLUGIN_GIG:
-            case PLUGIN_SF2:
-                if (CarlaString(stateSave.label).endsWith(" (16 outs)"))
-                    extraStuff = kTrue;
-                // nobreak
-            case PLUGIN_LADSPA:
-            case PLUGIN_DSSI:
-            case PLUGIN_VST2:
-            case PLUGIN_VST3:
-            case PLUGIN_SFZ:
-                if (stateSave.binary != nullptr && stateSave.binary[0] != '\0' &&
-                    ! (File::isAbsolutePath(stateSave.binary) && File(stateSave.binary).exists()))
-                {
-                    const char* searchPath;
-
-                    switch (ptype)
-                    {
-                    case PLUGIN_LADSPA: searchPath = pData->options.pathLADSPA; break;
-                    case PLUGIN_DSSI:   searchPath = pData->options.pathDSSI;   break;
-                    case PLUGIN_VST2:   searchPath = pData->options.pathVST2;   break;
-                    case PLUGIN_VST3:   searchPath = pData->options.pathVST3;   break;
-                    case PLUGIN_GIG:    searchPath = pData->options.pathGIG;    break;
-                    case PLUGIN_SF2:    searchPath = pData->options.pathSF2;    break;
-                    case PLUGIN_SFZ:    searchPath = pData->options.pathSFZ;    break;
-                    default:            searchPath = nullptr;                   break;
-                    }
-
-                    if (searchPath != nullptr && searchPath[0] != '\0')
-                    {
-                        carla_stderr("Plugin binary '%s' doesn't exist on this filesystem, let's look for it...",
-                                     stateSave.binary);
-
-                        String result = findBinaryInCustomPath(searchPath, stateSave.binary);
-
-                        if (result.isEmpty())
-                        {
-                            switch (ptype)
-                            {
-                            case PLUGIN_LADSPA: searchPath = std::getenv("LADSPA_PATH"); break;
-                            case PLUGIN_DSSI:   searchPath = std::getenv("DSSI_PATH");   break;
-                            case PLUGIN_VST2:   searchPath = std::getenv("VST_PATH");    break;
-                            case PLUGIN_VST3:   searchPath = std::getenv("VST3_PATH");   break;
-                            case PLUGIN_GIG:    searchPath = std::getenv("GIG_PATH");    break;
-                            case PLUGIN_SF2:    searchPath = std::getenv("SF2_PATH");    break;
-                            case PLUGIN_SFZ:    searchPath = std::getenv("SFZ_PATH");    break;
-                            default:            searchPath = nullptr;                    break;
-                            }
-
-                            if (searchPath != nullptr && searchPath[0] != '\0')
-                                result = findBinaryInCustomPath(searchPath, stateSave.binary);
-                        }
-
-                        if (result.isNotEmpty())
-                        {
-                            delete[] stateSave.binary;
-                            stateSave.binary = carla_strdup(result.toRawUTF8());
-                            carla_stderr("Found it! :)");
-                        }
-                        else
-                        {
-                            carla_stderr("Damn, we failed... :(");
-                        }
-                    }
-                }
-                break;
-            default:
-                break;
-            }
+            const void* const extraStuff(prepareStateSaveForLoading(pData->options, stateSave, ptype));
 
             if (addPlugin(getBinaryTypeFromFile(stateSave.binary), ptype, stateSave.binary,
                           stateSave.name, stateSave.label, stateSave.uniqueId, extraStuff, stateSave.options))
@@ -2221,6 +3110,8 @@ bool CarlaEngine::loadProjectInternal(juce::XmlDocument& xmlDoc)
                     plugin->setEnabled(true);
 
                     ++pData->curPluginCount;
+                    pData->commitPluginList(isRunning(), false);
+
                     callback(ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0.0f, plugin->getName());
 
 #ifndef BUILD_BRIDGE
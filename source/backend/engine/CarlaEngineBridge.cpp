@@ -27,10 +27,6 @@
 #include "CarlaBridgeUtils.hpp"
 #include "CarlaMIDI.h"
 
-#ifdef __SSE2_MATH__
-# include <xmmintrin.h>
-#endif
-
 // must be last
 #include "jackbridge/JackBridge.hpp"
 
@@ -1075,11 +1071,13 @@ public:
                 File chunkFile(chunkFilePath);
                 CARLA_SAFE_ASSERT_BREAK(chunkFile.existsAsFile());
 
-                String chunkDataBase64(chunkFile.loadFileAsString());
+                MemoryBlock chunkDataBase64;
+                chunkFile.loadFileAsData(chunkDataBase64);
                 chunkFile.deleteFile();
-                CARLA_SAFE_ASSERT_BREAK(chunkDataBase64.isNotEmpty());
+                CARLA_SAFE_ASSERT_BREAK(chunkDataBase64.getSize() > 0);
 
-                std::vector<uint8_t> chunk(carla_getChunkFromBase64String(chunkDataBase64.toRawUTF8()));
+                std::vector<uint8_t> chunk(carla_getChunkFromBase64String(static_cast<const char*>(chunkDataBase64.getData()),
+                                                                          chunkDataBase64.getSize()));
 
                 plugin->setChunkData(chunk.data(), chunk.size());
                 break;
@@ -1154,7 +1152,7 @@ public:
                         filePath += ".CarlaChunk_";
                         filePath += fShmNonRtClientControl.filename.buffer() + 24;
 
-                        if (File(filePath).replaceWithText(dataBase64.buffer()))
+                        if (File(filePath).replaceWithData(dataBase64.buffer(), dataBase64.length()))
                         {
                             const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
 
@@ -1244,10 +1242,7 @@ public:
 protected:
     void run() override
     {
-#ifdef __SSE2_MATH__
-        // Set FTZ and DAZ flags
-        _mm_setcsr(_mm_getcsr() | 0x8040);
-#endif
+        pData->initRtThread();
 
         bool quitReceived = false;
 
@@ -201,6 +201,7 @@ EngineOptions::EngineOptions() noexcept
       uisAlwaysOnTop(true),
       maxParameters(MAX_DEFAULT_PARAMETERS),
       uiBridgesTimeout(4000),
+      silenceTailTime(2000),
       audioNumPeriods(2),
       audioBufferSize(512),
       audioSampleRate(44100),
@@ -216,7 +217,18 @@ EngineOptions::EngineOptions() noexcept
       binaryDir(nullptr),
       resourceDir(nullptr),
       preventBadBehaviour(false),
-      frontendWinId(0) {}
+      frontendWinId(0),
+      rtMemoryLock(false),
+      rtCpuAffinity(0),
+      rtPriority(0),
+      projectLoadThreads(0),
+      processThreads(0),
+      reblockSize(1024),
+      reblockThread(false),
+      overloadLimit(0),
+      oversampleFactor(2),
+      autosaveInterval(0),
+      autosaveFilename(nullptr) {}
 
 EngineOptions::~EngineOptions() noexcept
 {
@@ -285,6 +297,12 @@ EngineOptions::~EngineOptions() noexcept
         delete[] resourceDir;
         resourceDir = nullptr;
     }
+
+    if (autosaveFilename != nullptr)
+    {
+        delete[] autosaveFilename;
+        autosaveFilename = nullptr;
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -785,6 +785,23 @@ bool RackGraph::getGroupAndPortIdFromFullName(const char* const fullPortName, ui
     return extGraph.getGroupAndPortIdFromFullName(fullPortName, groupId, portId);
 }
 
+uint32_t RackGraph::getLatency() const noexcept
+{
+    uint32_t latency = 0;
+
+    for (uint i=0, count=kEngine->getCurrentPluginCount(); i < count; ++i)
+    {
+        CarlaPlugin* const plugin(kEngine->getPluginUnchecked(i));
+
+        if (plugin == nullptr || ! plugin->isEnabled())
+            continue;
+
+        latency += plugin->getProcessLatencyInFrames();
+    }
+
+    return latency;
+}
+
 void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inBufReal[2], float* outBuf[2], const uint32_t frames)
 {
     CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
@@ -798,6 +815,11 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     float inBuf1[frames];
     const float* inBuf[2] = { inBuf0, inBuf1 };
 
+    // output of plugins being faded out
+    float fadeBuf0[frames];
+    float fadeBuf1[frames];
+    float* fadeBuf[2] = { fadeBuf0, fadeBuf1 };
+
     // initialize audio inputs
     FloatVectorOperations::copy(inBuf0, inBufReal[0], iframes);
     FloatVectorOperations::copy(inBuf1, inBufReal[1], iframes);
@@ -816,9 +838,9 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     juce::Range<float> range;
 
     // process plugins
-    for (uint i=0; i < data->curPluginCount; ++i)
+    for (uint i=0, count=data->rtPlugins.rtGetCount(); i < count; ++i)
     {
-        CarlaPlugin* const plugin = data->plugins[i].plugin;
+        CarlaPlugin* const plugin = data->rtPlugins.rtGetPlugin(i);
 
         if (plugin == nullptr || ! plugin->isEnabled() || ! plugin->tryLock(isOffline))
             continue;
@@ -852,13 +874,44 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
             }
         }
 
+        // plugin being replaced gets the same input, its events output is discarded
+        CarlaPlugin* const fadingPlugin = data->rtPlugins.rtGetFadingPlugin(i);
+        const bool fading = fadingPlugin != nullptr && fadingPlugin->isEnabled() && fadingPlugin->tryLock(isOffline);
+
+        if (fading)
+        {
+            FloatVectorOperations::clear(fadeBuf0, iframes);
+            FloatVectorOperations::clear(fadeBuf1, iframes);
+
+            fadingPlugin->initBuffers();
+            fadingPlugin->processFromEngine(inBuf, fadeBuf, frames);
+            fadingPlugin->unlock();
+
+            if (fadingPlugin->getAudioInCount() == 0)
+            {
+                FloatVectorOperations::add(fadeBuf0, inBuf0, iframes);
+                FloatVectorOperations::add(fadeBuf1, inBuf1, iframes);
+            }
+
+            if (fadingPlugin->getAudioOutCount() == 1)
+                FloatVectorOperations::copy(fadeBuf1, fadeBuf0, iframes);
+
+            carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
+        }
+
         oldAudioInCount  = plugin->getAudioInCount();
         oldAudioOutCount = plugin->getAudioOutCount();
         oldMidiOutCount  = plugin->getMidiOutCount();
 
         // process
         plugin->initBuffers();
-        plugin->process(inBuf, outBuf, nullptr, nullptr, frames);
+
+        if (! plugin->checkSleep(inBuf, frames))
+        {
+            plugin->processFromEngine(inBuf, outBuf, frames);
+            plugin->updateSleep(outBuf, frames);
+        }
+
         plugin->unlock();
 
         // if plugin has no audio inputs, add input buffer
@@ -874,6 +927,18 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
             FloatVectorOperations::copy(outBuf[1], outBuf[0], iframes);
         }
 
+        // crossfade from the old plugin output
+        if (fading)
+        {
+            for (uint32_t j=0; j < frames; ++j)
+            {
+                const float gain(data->rtPlugins.rtGetFadeGain(j));
+
+                outBuf[0][j] = outBuf[0][j] * gain + fadeBuf0[j] * (1.0f - gain);
+                outBuf[1][j] = outBuf[1][j] * gain + fadeBuf1[j] * (1.0f - gain);
+            }
+        }
+
         // set peaks
         {
             EnginePluginData& pluginData(data->plugins[i]);
@@ -909,6 +974,8 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
 
         processed = true;
     }
+
+    data->rtPlugins.rtAdvanceFade(frames);
 }
 
 void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
@@ -1158,6 +1225,8 @@ public:
         setPlayConfigDetails(static_cast<int>(fPlugin->getAudioInCount()),
                              static_cast<int>(fPlugin->getAudioOutCount()),
                              getSampleRate(), getBlockSize());
+
+        setLatencySamples(static_cast<int>(fPlugin->getProcessLatencyInFrames()));
     }
 
     ~CarlaPluginInstance() override
@@ -1169,6 +1238,20 @@ public:
         fPlugin = nullptr;
     }
 
+    // returns true if latency changed and the graph needs to be rebuilt
+    bool updateLatency()
+    {
+        CARLA_SAFE_ASSERT_RETURN(fPlugin != nullptr, false);
+
+        const int latency(static_cast<int>(fPlugin->getProcessLatencyInFrames()));
+
+        if (getLatencySamples() == latency)
+            return false;
+
+        setLatencySamples(latency);
+        return true;
+    }
+
     // -------------------------------------------------------------------
 
     void* getPlatformSpecificData() noexcept override
@@ -1264,7 +1347,15 @@ public:
                 inPeaks[i] = carla_maxLimited<float>(std::abs(range.getStart()), std::abs(range.getEnd()), 1.0f);
             }
 
-            fPlugin->process(const_cast<const float**>(audioBuffers), audioBuffers, nullptr, nullptr, static_cast<uint32_t>(numSamples));
+            if (fPlugin->checkSleep(audioBuffers, static_cast<uint32_t>(numSamples)))
+            {
+                audio.clear();
+            }
+            else
+            {
+                fPlugin->processFromEngine(const_cast<const float**>(audioBuffers), audioBuffers, static_cast<uint32_t>(numSamples));
+                fPlugin->updateSleep(audioBuffers, static_cast<uint32_t>(numSamples));
+            }
 
             for (int i=static_cast<int>(jmin(fPlugin->getAudioOutCount(), 2U)); --i>=0;)
             {
@@ -1274,9 +1365,10 @@ public:
 
             kEngine->setPluginPeaks(fPlugin->getId(), inPeaks, outPeaks);
         }
-        else
+        else if (! fPlugin->checkSleep(nullptr, static_cast<uint32_t>(numSamples)))
         {
-            fPlugin->process(nullptr, nullptr, nullptr, nullptr, static_cast<uint32_t>(numSamples));
+            fPlugin->processFromEngine(nullptr, nullptr, static_cast<uint32_t>(numSamples));
+            fPlugin->updateSleep(nullptr, static_cast<uint32_t>(numSamples));
         }
 
         midi.clear();
@@ -1408,6 +1500,7 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine, const uint32_t ins, cons
     const double sampleRate(engine->getSampleRate());
 
     graph.setPlayConfigDetails(static_cast<int>(inputs), static_cast<int>(outputs), sampleRate, bufferSize);
+    graph.setNumRenderingThreads(static_cast<int>(engine->getOptions().processThreads));
     graph.prepareToPlay(sampleRate, bufferSize);
 
     audioBuffer.setSize(static_cast<int>(jmax(inputs, outputs)), bufferSize);
@@ -1513,6 +1606,11 @@ void PatchbayGraph::setOffline(const bool offline)
     graph.setNonRealtime(offline);
 }
 
+void PatchbayGraph::setProcessThreads(const uint threads)
+{
+    graph.setNumRenderingThreads(static_cast<int>(threads));
+}
+
 void PatchbayGraph::addPlugin(CarlaPlugin* const plugin)
 {
     CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
@@ -1632,6 +1730,28 @@ void PatchbayGraph::removeAllPlugins()
     }
 }
 
+void PatchbayGraph::updatePluginLatency(CarlaPlugin* const plugin)
+{
+    CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
+    carla_debug("PatchbayGraph::updatePluginLatency(%p)", plugin);
+
+    CarlaAudioProcessorGraph::Node* const node(graph.getNodeForId(plugin->getPatchbayNodeId()));
+    CARLA_SAFE_ASSERT_RETURN(node != nullptr,);
+
+    // the new rendering sequence (and its delay lines) is created in the juce message thread,
+    // the audio thread only swaps to it once ready
+    if (((CarlaPluginInstance*)node->getProcessor())->updateLatency())
+        graph.updateRenderingSequence();
+}
+
+uint32_t PatchbayGraph::getLatency() const noexcept
+{
+    const int latency(graph.getLatencySamples());
+    CARLA_SAFE_ASSERT_RETURN(latency >= 0, 0);
+
+    return static_cast<uint32_t>(latency);
+}
+
 bool PatchbayGraph::connect(const bool external, const uint groupA, const uint portA, const uint groupB, const uint portB, const bool sendCallback)
 {
     if (external)
@@ -2049,6 +2169,17 @@ void EngineInternalGraph::setOffline(const bool offline)
     }
 }
 
+void EngineInternalGraph::setProcessThreads(const uint threads)
+{
+    // plugins in rack mode are a single chain, there is nothing to run in parallel
+    if (fIsRack)
+        return;
+
+    // safe while audio runs, the graph only stops the old threads once the current cycle has returned
+    CARLA_SAFE_ASSERT_RETURN(fPatchbay != nullptr,);
+    fPatchbay->setProcessThreads(threads);
+}
+
 bool EngineInternalGraph::isReady() const noexcept
 {
     return fIsReady;
@@ -2068,8 +2199,16 @@ PatchbayGraph* EngineInternalGraph::getPatchbayGraph() const noexcept
     return fPatchbay;
 }
 
+static double getCycleSeconds(const int64_t startTicks) noexcept
+{
+    return static_cast<double>(juce::Time::getHighResolutionTicks() - startTicks)
+         / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+}
+
 void EngineInternalGraph::process(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
 {
+    const int64_t startTicks(juce::Time::getHighResolutionTicks());
+
     if (fIsRack)
     {
         CARLA_SAFE_ASSERT_RETURN(fRack != nullptr,);
@@ -2080,6 +2219,8 @@ void EngineInternalGraph::process(CarlaEngine::ProtectedData* const data, const
         CARLA_SAFE_ASSERT_RETURN(fPatchbay != nullptr,);
         fPatchbay->process(data, inBuf, outBuf, static_cast<int>(frames));
     }
+
+    data->overload.rtAddCycle(getCycleSeconds(startTicks), frames, data->sampleRate);
 }
 
 void EngineInternalGraph::processRack(CarlaEngine::ProtectedData* const data, const float* inBuf[2], float* outBuf[2], const uint32_t frames)
@@ -2087,7 +2228,11 @@ void EngineInternalGraph::processRack(CarlaEngine::ProtectedData* const data, co
     CARLA_SAFE_ASSERT_RETURN(fIsRack,);
     CARLA_SAFE_ASSERT_RETURN(fRack != nullptr,);
 
+    const int64_t startTicks(juce::Time::getHighResolutionTicks());
+
     fRack->process(data, inBuf, outBuf, frames);
+
+    data->overload.rtAddCycle(getCycleSeconds(startTicks), frames, data->sampleRate);
 }
 
 // -----------------------------------------------------------------------
@@ -2123,6 +2268,28 @@ void EngineInternalGraph::removeAllPlugins()
     fPatchbay->removeAllPlugins();
 }
 
+void EngineInternalGraph::updatePluginLatency(CarlaPlugin* const plugin)
+{
+    // rack mode has no parallel paths to compensate
+    if (fIsRack)
+        return;
+
+    CARLA_SAFE_ASSERT_RETURN(fPatchbay != nullptr,);
+    fPatchbay->updatePluginLatency(plugin);
+}
+
+uint32_t EngineInternalGraph::getLatency() const noexcept
+{
+    if (fIsRack)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fRack != nullptr, 0);
+        return fRack->getLatency();
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(fPatchbay != nullptr, 0);
+    return fPatchbay->getLatency();
+}
+
 bool EngineInternalGraph::isUsingExternal() const noexcept
 {
     if (fIsRack)
@@ -138,6 +138,9 @@ struct RackGraph {
     const char* const* getConnections() const noexcept;
     bool getGroupAndPortIdFromFullName(const char* const fullPortName, uint& groupId, uint& portId) const noexcept;
 
+    // sum of all enabled plugin latencies, rack is a serial chain
+    uint32_t getLatency() const noexcept;
+
     // the base, where plugins run
     void process(CarlaEngine::ProtectedData* const data, const float* inBufReal[2], float* outBuf[2], const uint32_t frames);
 
@@ -169,6 +172,7 @@ struct PatchbayGraph {
     void setBufferSize(const uint32_t bufferSize);
     void setSampleRate(const double sampleRate);
     void setOffline(const bool offline);
+    void setProcessThreads(const uint threads);
 
     void addPlugin(CarlaPlugin* const plugin);
     void replacePlugin(CarlaPlugin* const oldPlugin, CarlaPlugin* const newPlugin);
@@ -176,6 +180,10 @@ struct PatchbayGraph {
     void removePlugin(CarlaPlugin* const plugin);
     void removeAllPlugins();
 
+    // delay compensation, rebuilt asynchronously outside of the audio thread
+    void updatePluginLatency(CarlaPlugin* const plugin);
+    uint32_t getLatency() const noexcept;
+
     bool connect(const bool external, const uint groupA, const uint portA, const uint groupB, const uint portB, const bool sendCallback);
     bool disconnect(const uint connectionId);
     void disconnectInternalGroup(const uint groupId) noexcept;
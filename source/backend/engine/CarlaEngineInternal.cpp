@@ -18,8 +18,20 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaPlugin.hpp"
 
+#include "CarlaBackendUtils.hpp"
+
 #include "jackbridge/JackBridge.hpp"
 
+#ifdef __SSE2_MATH__
+# include <xmmintrin.h>
+#endif
+
+#ifdef CARLA_OS_UNIX
+# include <pthread.h>
+# include <sched.h>
+# include <sys/mman.h>
+#endif
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
@@ -341,34 +353,426 @@ EngineInternalTime::Hylia::~Hylia()
 #endif
 
 // -----------------------------------------------------------------------
-// NextAction
+// ScopedDenormalsDisable
+
+#if defined(__SSE2_MATH__)
+static inline uintptr_t getDenormalsState() noexcept
+{
+    return _mm_getcsr();
+}
+
+static inline void setDenormalsState(const uintptr_t state) noexcept
+{
+    _mm_setcsr(static_cast<uint>(state));
+}
+
+// FTZ (bit 15) and DAZ (bit 6)
+static const uintptr_t kDenormalsDisableMask = 0x8040;
+#elif defined(__aarch64__)
+static inline uintptr_t getDenormalsState() noexcept
+{
+    uintptr_t state;
+    asm volatile("mrs %0, fpcr" : "=r" (state));
+    return state;
+}
+
+static inline void setDenormalsState(const uintptr_t state) noexcept
+{
+    asm volatile("msr fpcr, %0" : : "ri" (state));
+}
+
+// FZ (bit 24)
+static const uintptr_t kDenormalsDisableMask = 1 << 24;
+#endif
+
+ScopedDenormalsDisable::ScopedDenormalsDisable() noexcept
+#if defined(__SSE2_MATH__) || defined(__aarch64__)
+    : oldState(getDenormalsState())
+{
+    setDenormalsState(oldState | kDenormalsDisableMask);
+}
+#else
+{
+}
+#endif
+
+ScopedDenormalsDisable::~ScopedDenormalsDisable() noexcept
+{
+#if defined(__SSE2_MATH__) || defined(__aarch64__)
+    setDenormalsState(oldState);
+#endif
+}
+
+void ScopedDenormalsDisable::setForCurrentThread() noexcept
+{
+#if defined(__SSE2_MATH__) || defined(__aarch64__)
+    setDenormalsState(getDenormalsState() | kDenormalsDisableMask);
+#endif
+}
+
+// -----------------------------------------------------------------------
+// EngineRtPluginList
+
+static void freeRtPluginSnapshot(EngineRtPluginSnapshot* const snapshot) noexcept
+{
+    delete[] snapshot->plugins;
+    delete[] snapshot->fadingOut;
+    delete snapshot;
+}
+
+EngineRtPluginList::EngineRtPluginList() noexcept
+    : fActive(nullptr),
+      fPending(nullptr),
+      fRetired(nullptr),
+      fLastGeneration(0),
+      fActiveGeneration(0),
+      fFadedGeneration(0),
+      fFadePosition(0) {}
+
+EngineRtPluginList::~EngineRtPluginList() noexcept
+{
+    clear();
+}
+
+uint EngineRtPluginList::publish(const EnginePluginData* const plugins, const uint count,
+                                 CarlaPlugin* const* const fadingOut, const uint32_t fadeFrames)
+{
+    const bool fading(fadingOut != nullptr && fadeFrames > 0 && count > 0);
+
+    EngineRtPluginSnapshot* const snapshot(new EngineRtPluginSnapshot);
+    snapshot->count       = count;
+    snapshot->generation  = ++fLastGeneration;
+    snapshot->plugins     = (count > 0) ? new CarlaPlugin*[count] : nullptr;
+    snapshot->fadingOut   = fading ? new CarlaPlugin*[count] : nullptr;
+    snapshot->fadeFrames  = fading ? fadeFrames : 0;
+    snapshot->nextRetired = nullptr;
+
+    for (uint i=0; i < count; ++i)
+        snapshot->plugins[i] = plugins[i].plugin;
+
+    if (fading)
+    {
+        for (uint i=0; i < count; ++i)
+            snapshot->fadingOut[i] = fadingOut[i];
+    }
+
+    // a snapshot still pending was never seen by the audio thread, it can go away right now
+    if (EngineRtPluginSnapshot* const old = __atomic_exchange_n(&fPending, snapshot, __ATOMIC_ACQ_REL))
+        freeRtPluginSnapshot(old);
+
+    return snapshot->generation;
+}
+
+uint EngineRtPluginList::getLastGeneration() const noexcept
+{
+    return fLastGeneration;
+}
+
+bool EngineRtPluginList::isGenerationActive(const uint generation) const noexcept
+{
+    // compare as signed to survive generation counter wrap-around
+    return static_cast<int>(__atomic_load_n(&fActiveGeneration, __ATOMIC_ACQUIRE) - generation) >= 0;
+}
+
+bool EngineRtPluginList::waitForGeneration(const uint generation, const uint timeoutInMs) const noexcept
+{
+    for (uint i=0; i < timeoutInMs; ++i)
+    {
+        if (isGenerationActive(generation))
+            return true;
+
+        carla_msleep(1);
+    }
+
+    return false;
+}
+
+bool EngineRtPluginList::waitForFade(const uint generation, const uint timeoutInMs) const noexcept
+{
+    for (uint i=0; i < timeoutInMs; ++i)
+    {
+        if (static_cast<int>(__atomic_load_n(&fFadedGeneration, __ATOMIC_ACQUIRE) - generation) >= 0)
+            return true;
+
+        carla_msleep(1);
+    }
+
+    return false;
+}
+
+void EngineRtPluginList::reclaim() noexcept
+{
+    for (EngineRtPluginSnapshot* snapshot = __atomic_exchange_n(&fRetired, (EngineRtPluginSnapshot*)nullptr, __ATOMIC_ACQUIRE);
+         snapshot != nullptr;)
+    {
+        EngineRtPluginSnapshot* const next(snapshot->nextRetired);
+        freeRtPluginSnapshot(snapshot);
+        snapshot = next;
+    }
+}
+
+void EngineRtPluginList::clear() noexcept
+{
+    reclaim();
+
+    if (fPending != nullptr)
+    {
+        freeRtPluginSnapshot(fPending);
+        fPending = nullptr;
+    }
+
+    if (fActive != nullptr)
+    {
+        freeRtPluginSnapshot(fActive);
+        fActive = nullptr;
+    }
+
+    fActiveGeneration = fLastGeneration;
+    fFadedGeneration  = fLastGeneration;
+    fFadePosition     = 0;
+}
+
+void EngineRtPluginList::rtUpdate() noexcept
+{
+    if (__atomic_load_n(&fPending, __ATOMIC_ACQUIRE) == nullptr)
+        return;
+
+    EngineRtPluginSnapshot* const snapshot(__atomic_exchange_n(&fPending, (EngineRtPluginSnapshot*)nullptr, __ATOMIC_ACQ_REL));
+
+    if (snapshot == nullptr)
+        return;
+
+    if (EngineRtPluginSnapshot* const old = fActive)
+    {
+        // push old snapshot into the retired stack.
+        // the non-RT side only ever takes the full stack, so this cannot suffer from ABA
+        EngineRtPluginSnapshot* head(__atomic_load_n(&fRetired, __ATOMIC_RELAXED));
+
+        do {
+            old->nextRetired = head;
+        } while (! __atomic_compare_exchange_n(&fRetired, &head, old, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    fActive       = snapshot;
+    fFadePosition = 0;
+
+    if (snapshot->fadingOut == nullptr)
+        __atomic_store_n(&fFadedGeneration, snapshot->generation, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&fActiveGeneration, snapshot->generation, __ATOMIC_RELEASE);
+}
 
-EngineNextAction::EngineNextAction() noexcept
-    : opcode(kEnginePostActionNull),
-      pluginId(0),
-      value(0),
-      mutex(false) {}
+uint EngineRtPluginList::rtGetCount() const noexcept
+{
+    return (fActive != nullptr) ? fActive->count : 0;
+}
 
-EngineNextAction::~EngineNextAction() noexcept
+CarlaPlugin* EngineRtPluginList::rtGetPlugin(const uint index) const noexcept
 {
-    CARLA_SAFE_ASSERT(opcode == kEnginePostActionNull);
+    CARLA_SAFE_ASSERT_RETURN(fActive != nullptr, nullptr);
+    CARLA_SAFE_ASSERT_RETURN(index < fActive->count, nullptr);
+
+    return fActive->plugins[index];
 }
 
-void EngineNextAction::ready() const noexcept
+CarlaPlugin* EngineRtPluginList::rtGetFadingPlugin(const uint index) const noexcept
 {
-    mutex.lock();
-    mutex.unlock();
+    if (fActive == nullptr || fActive->fadingOut == nullptr || fFadePosition >= fActive->fadeFrames)
+        return nullptr;
+
+    CARLA_SAFE_ASSERT_RETURN(index < fActive->count, nullptr);
+
+    return fActive->fadingOut[index];
 }
 
-void EngineNextAction::clearAndReset() noexcept
+float EngineRtPluginList::rtGetFadeGain(const uint32_t frame) const noexcept
 {
-    mutex.lock();
-    opcode   = kEnginePostActionNull;
-    pluginId = 0;
-    value    = 0;
-    mutex.unlock();
+    if (fActive == nullptr || fActive->fadingOut == nullptr)
+        return 1.0f;
+
+    const uint32_t position(fFadePosition + frame);
+
+    if (position >= fActive->fadeFrames)
+        return 1.0f;
+
+    return static_cast<float>(position) / static_cast<float>(fActive->fadeFrames);
 }
 
+void EngineRtPluginList::rtAdvanceFade(const uint32_t frames) noexcept
+{
+    if (fActive == nullptr || fActive->fadingOut == nullptr || fFadePosition >= fActive->fadeFrames)
+        return;
+
+    fFadePosition += frames;
+
+    if (fFadePosition >= fActive->fadeFrames)
+        __atomic_store_n(&fFadedGeneration, fActive->generation, __ATOMIC_RELEASE);
+}
+
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+// EngineOverloadGovernor
+
+// idle calls (of 25ms each) over the limit before degrading one plugin
+static const uint kOverloadDegradeTicks = 8;
+
+// idle calls well below the limit before restoring one plugin
+static const uint kOverloadRestoreTicks = 80;
+
+EngineOverloadGovernor::EngineOverloadGovernor() noexcept
+    : fLoadSum(0),
+      fLoadPeak(0),
+      fCycleCount(0),
+      fOverTicks(0),
+      fUnderTicks(0) {}
+
+void EngineOverloadGovernor::rtAddCycle(const double seconds, const uint32_t frames, const double sampleRate) noexcept
+{
+    if (frames == 0 || seconds <= 0.0)
+        return;
+
+    const uint load(static_cast<uint>(seconds * sampleRate / static_cast<double>(frames) * 10000.0));
+
+    __atomic_add_fetch(&fLoadSum, load, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&fCycleCount, 1, __ATOMIC_RELAXED);
+
+    if (load > __atomic_load_n(&fLoadPeak, __ATOMIC_RELAXED))
+        __atomic_store_n(&fLoadPeak, load, __ATOMIC_RELAXED);
+}
+
+void EngineOverloadGovernor::idle(CarlaEngine* const engine, const EnginePluginData* const plugins, const uint count, const uint limit)
+{
+    const uint loadSum(__atomic_exchange_n(&fLoadSum, 0, __ATOMIC_RELAXED));
+    const uint loadPeak(__atomic_exchange_n(&fLoadPeak, 0, __ATOMIC_RELAXED));
+    const uint cycleCount(__atomic_exchange_n(&fCycleCount, 0, __ATOMIC_RELAXED));
+
+    const float load(cycleCount > 0 ? static_cast<float>(loadSum) / static_cast<float>(cycleCount) / 100.0f : 0.0f);
+    const float peak(static_cast<float>(loadPeak) / 100.0f);
+
+    for (uint i=0; i < count; ++i)
+    {
+        CarlaPlugin* const plugin(plugins[i].plugin);
+
+        if (plugin == nullptr || ! plugin->isEnabled())
+            continue;
+
+        plugin->updateProcessLoad();
+
+        // restore everything when disabled, and plugins no longer marked as expendable
+        if (plugin->getDegradation() == PLUGIN_DEGRADATION_NONE)
+            continue;
+        if (limit != 0 && ! engine->isOffline() && (plugin->getOptionsEnabled() & PLUGIN_OPTION_EXPENDABLE) != 0)
+            continue;
+
+        while (plugin->restore())
+            report(engine, plugin, load, false);
+    }
+
+    if (limit == 0 || engine->isOffline() || cycleCount == 0)
+    {
+        fOverTicks = fUnderTicks = 0;
+        return;
+    }
+
+    const float flimit(static_cast<float>(limit));
+
+    if (load > flimit || peak >= 100.0f)
+    {
+        fUnderTicks = 0;
+
+        if (++fOverTicks < kOverloadDegradeTicks)
+            return;
+
+        fOverTicks = 0;
+
+        // cheapest degradation first, later plugins first among equals
+        CarlaPlugin* target = nullptr;
+        PluginDegradation targetDegradation = PLUGIN_DEGRADATION_NONE;
+
+        for (uint i=count; i-- > 0;)
+        {
+            CarlaPlugin* const plugin(plugins[i].plugin);
+
+            if (plugin == nullptr || ! plugin->isEnabled())
+                continue;
+            if ((plugin->getOptionsEnabled() & PLUGIN_OPTION_EXPENDABLE) == 0)
+                continue;
+
+            const PluginDegradation next(plugin->getNextDegradation());
+
+            if (next == PLUGIN_DEGRADATION_NONE)
+                continue;
+
+            if (target == nullptr || next < targetDegradation)
+            {
+                target = plugin;
+                targetDegradation = next;
+            }
+        }
+
+        if (target != nullptr && target->degrade())
+            report(engine, target, load, true);
+    }
+    else if (load < flimit * 0.7f && peak < flimit)
+    {
+        fOverTicks = 0;
+
+        if (++fUnderTicks < kOverloadRestoreTicks)
+            return;
+
+        fUnderTicks = 0;
+
+        // undo the last steps first, earlier plugins first among equals
+        CarlaPlugin* target = nullptr;
+        PluginDegradation targetDegradation = PLUGIN_DEGRADATION_NONE;
+
+        for (uint i=0; i < count; ++i)
+        {
+            CarlaPlugin* const plugin(plugins[i].plugin);
+
+            if (plugin == nullptr || ! plugin->isEnabled())
+                continue;
+
+            const PluginDegradation degradation(plugin->getDegradation());
+
+            if (degradation > targetDegradation)
+            {
+                target = plugin;
+                targetDegradation = degradation;
+            }
+        }
+
+        if (target != nullptr && target->restore())
+            report(engine, target, load, false);
+    }
+    else
+    {
+        fOverTicks = fUnderTicks = 0;
+    }
+}
+
+void EngineOverloadGovernor::reset() noexcept
+{
+    __atomic_store_n(&fLoadSum, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fLoadPeak, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&fCycleCount, 0, __ATOMIC_RELAXED);
+    fOverTicks = fUnderTicks = 0;
+}
+
+void EngineOverloadGovernor::report(CarlaEngine* const engine, CarlaPlugin* const plugin, const float load, const bool degraded)
+{
+    const PluginDegradation degradation(plugin->getDegradation());
+    const float pluginLoad(plugin->updateProcessLoad());
+
+    carla_stdout("Engine DSP load at %.1f%%, plugin '%s' %s to %s (%.1f%% DSP load)",
+                 static_cast<double>(load), plugin->getName(), degraded ? "degraded" : "restored",
+                 PluginDegradation2Str(degradation), static_cast<double>(pluginLoad));
+
+    engine->callback(ENGINE_CALLBACK_PLUGIN_DEGRADED, plugin->getId(),
+                     degradation, static_cast<int>(load), pluginLoad, nullptr);
+}
+#endif
+
 // -----------------------------------------------------------------------
 // CarlaEngine::ProtectedData
 
@@ -385,7 +789,16 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine) noexcept
 #ifndef BUILD_BRIDGE
       firstLinuxSamplerInstance(true),
       loadingProject(false),
+      loadingProjectInParallel(false),
+      loadingHiddenPlugins(false),
+      loadingStandbyPlugin(false),
+      loaderErrors(nullptr),
+      loaderErrorCount(0),
+      totalLatency(0),
+      savingProject(false),
+      lastAutosaveTime(0),
 #endif
+      memoryLocked(false),
       hints(0x0),
       bufferSize(0),
       sampleRate(0.0),
@@ -395,6 +808,7 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine) noexcept
       maxPluginNumber(0),
       nextPluginId(0),
       envMutex(),
+      lastErrorMutex(),
       lastError(),
       name(),
       options(),
@@ -407,7 +821,11 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine) noexcept
       graph(engine),
 #endif
       time(timeInfo, options.transportMode),
-      nextAction()
+      rtPlugins(),
+      removedPlugins()
+#ifndef BUILD_BRIDGE
+    , overload()
+#endif
 {
 #ifdef BUILD_BRIDGE
     carla_zeroStructs(plugins, 1);
@@ -488,11 +906,23 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
 #endif
 
 #ifndef BUILD_BRIDGE
-    plugins = new EnginePluginData[maxPluginNumber];
-    carla_zeroStructs(plugins, maxPluginNumber);
+    // one extra slot for loading standby plugins, so they do not need a free one
+    plugins = new EnginePluginData[maxPluginNumber+1];
+    carla_zeroStructs(plugins, maxPluginNumber+1);
+
+    totalLatency = 0;
+#endif
+
+#ifdef CARLA_OS_UNIX
+    if (options.rtMemoryLock && ! memoryLocked)
+    {
+        if (::mlockall(MCL_CURRENT|MCL_FUTURE) == 0)
+            memoryLocked = true;
+        else
+            carla_stderr2("Failed to lock engine memory, audio may glitch on page faults");
+    }
 #endif
 
-    nextAction.ready();
     thread.startThread();
 
     return true;
@@ -503,12 +933,10 @@ void CarlaEngine::ProtectedData::close()
     CARLA_SAFE_ASSERT(name.isNotEmpty());
     CARLA_SAFE_ASSERT(plugins != nullptr);
     CARLA_SAFE_ASSERT(nextPluginId == maxPluginNumber);
-    CARLA_SAFE_ASSERT(nextAction.opcode == kEnginePostActionNull);
 
     aboutToClose = true;
 
     thread.stopThread(500);
-    nextAction.ready();
 
 #ifdef HAVE_LIBLO
     osc.close();
@@ -520,6 +948,8 @@ void CarlaEngine::ProtectedData::close()
     maxPluginNumber = 0;
     nextPluginId    = 0;
 
+    rtPlugins.clear();
+
 #ifndef BUILD_BRIDGE
     if (plugins != nullptr)
     {
@@ -530,6 +960,48 @@ void CarlaEngine::ProtectedData::close()
 
     events.clear();
     name.clear();
+
+#ifdef CARLA_OS_UNIX
+    if (memoryLocked)
+    {
+        ::munlockall();
+        memoryLocked = false;
+    }
+#endif
+}
+
+void CarlaEngine::ProtectedData::initRtThread() const noexcept
+{
+    ScopedDenormalsDisable::setForCurrentThread();
+
+#ifdef CARLA_OS_LINUX
+    if (options.rtCpuAffinity != 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+
+        for (uint i=0; i < sizeof(options.rtCpuAffinity)*8 && i < CPU_SETSIZE; ++i)
+        {
+            if (options.rtCpuAffinity & (1U << i))
+                CPU_SET(i, &cpuset);
+        }
+
+        if (::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set_t), &cpuset) != 0)
+            carla_rt_stderr2("Failed to set CPU affinity of audio thread to 0x%x", options.rtCpuAffinity);
+    }
+#endif
+
+#ifdef CARLA_OS_UNIX
+    if (options.rtPriority != 0)
+    {
+        struct sched_param param;
+        carla_zeroStruct(param);
+        param.sched_priority = static_cast<int>(options.rtPriority);
+
+        if (::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param) != 0)
+            carla_rt_stderr2("Failed to set audio thread to SCHED_FIFO priority %u", options.rtPriority);
+    }
+#endif
 }
 
 void CarlaEngine::ProtectedData::initTime(const char* const features)
@@ -545,14 +1017,14 @@ void CarlaEngine::ProtectedData::initTime(const char* const features)
 // -----------------------------------------------------------------------
 
 #ifndef BUILD_BRIDGE
-void CarlaEngine::ProtectedData::doPluginRemove() noexcept
+void CarlaEngine::ProtectedData::doPluginRemove(const uint pluginId) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(curPluginCount > 0,);
-    CARLA_SAFE_ASSERT_RETURN(nextAction.pluginId < curPluginCount,);
+    CARLA_SAFE_ASSERT_RETURN(pluginId < curPluginCount,);
     --curPluginCount;
 
     // move all plugins 1 spot backwards
-    for (uint i=nextAction.pluginId; i < curPluginCount; ++i)
+    for (uint i=pluginId; i < curPluginCount; ++i)
     {
         CarlaPlugin* const plugin(plugins[i+1].plugin);
 
@@ -565,6 +1037,10 @@ void CarlaEngine::ProtectedData::doPluginRemove() noexcept
         plugins[i].insPeak[1]  = 0.0f;
         plugins[i].outsPeak[0] = 0.0f;
         plugins[i].outsPeak[1] = 0.0f;
+        plugins[i].standby     = plugins[i+1].standby;
+
+        if (CarlaPlugin* const standby = plugins[i].standby.plugin)
+            standby->setId(i);
     }
 
     const uint id(curPluginCount);
@@ -575,15 +1051,13 @@ void CarlaEngine::ProtectedData::doPluginRemove() noexcept
     plugins[id].insPeak[1]  = 0.0f;
     plugins[id].outsPeak[0] = 0.0f;
     plugins[id].outsPeak[1] = 0.0f;
+    carla_zeroStruct(plugins[id].standby);
 }
 
-void CarlaEngine::ProtectedData::doPluginsSwitch() noexcept
+void CarlaEngine::ProtectedData::doPluginsSwitch(const uint idA, const uint idB) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(curPluginCount >= 2,);
 
-    const uint idA(nextAction.pluginId);
-    const uint idB(nextAction.value);
-
     CARLA_SAFE_ASSERT_RETURN(idA < curPluginCount,);
     CARLA_SAFE_ASSERT_RETURN(idB < curPluginCount,);
     CARLA_SAFE_ASSERT_RETURN(plugins[idA].plugin != nullptr,);
@@ -597,88 +1071,119 @@ void CarlaEngine::ProtectedData::doPluginsSwitch() noexcept
     plugins[idA].plugin = plugins[idB].plugin;
     plugins[idB].plugin = tmp;
 #endif
+
+    const EngineStandbyPlugin tmpStandby(plugins[idA].standby);
+
+    plugins[idA].standby = plugins[idB].standby;
+    plugins[idB].standby = tmpStandby;
+
+    if (plugins[idA].standby.plugin != nullptr)
+        plugins[idA].standby.plugin->setId(idA);
+    if (plugins[idB].standby.plugin != nullptr)
+        plugins[idB].standby.plugin->setId(idB);
 }
 #endif
 
-void CarlaEngine::ProtectedData::doNextPluginAction(const bool unlock) noexcept
+bool CarlaEngine::ProtectedData::commitPluginList(const bool isRunning, const bool waitRt) noexcept
 {
-    switch (nextAction.opcode)
-    {
-    case kEnginePostActionNull:
-        break;
-    case kEnginePostActionZeroCount:
-        curPluginCount = 0;
-        break;
-#ifndef BUILD_BRIDGE
-    case kEnginePostActionRemovePlugin:
-        doPluginRemove();
-        break;
-    case kEnginePostActionSwitchPlugins:
-        doPluginsSwitch();
-        break;
-#endif
-    }
+    uint generation;
 
-    nextAction.opcode   = kEnginePostActionNull;
-    nextAction.pluginId = 0;
-    nextAction.value    = 0;
+    try {
+        generation = rtPlugins.publish(plugins, curPluginCount);
+    } CARLA_SAFE_EXCEPTION_RETURN("EngineRtPluginList::publish", false);
 
-    if (unlock)
+#ifndef BUILD_BRIDGE
+    // when stopped, the audio thread switches to the new list before its first cycle.
+    // on timeout the list stays published, older ones are reclaimed once the audio thread is done with them
+    if (isRunning && waitRt && ! rtPlugins.waitForGeneration(generation, 2000))
     {
-        nextAction.mutex.tryLock();
-        nextAction.mutex.unlock();
+        carla_stderr2("Audio thread did not pick up the new plugin list in time");
+        return false;
     }
-}
-
-// -----------------------------------------------------------------------
-// PendingRtEventsRunner
+#else
+    // the bridge audio thread uses its single plugin directly, not this list
+    (void)isRunning; (void)waitRt; (void)generation;
+#endif
 
-PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine, const uint32_t frames) noexcept
-    : pData(engine->pData),
-      numFrames(frames)
-{
-    pData->time.preProcess(frames);
+    rtPlugins.reclaim();
+    deleteRemovedPlugins(false);
+    return true;
 }
 
-PendingRtEventsRunner::~PendingRtEventsRunner() noexcept
+bool CarlaEngine::ProtectedData::commitPluginListWithFade(const bool isRunning, CarlaPlugin* const* const fadingOut, const uint32_t fadeFrames) noexcept
 {
-    pData->doNextPluginAction(true);
-}
+    // nothing to fade with if the audio thread is not there
+    if (! isRunning || fadeFrames == 0)
+        return commitPluginList(isRunning, true);
 
-// -----------------------------------------------------------------------
-// ScopedActionLock
+    uint generation;
 
-ScopedActionLock::ScopedActionLock(CarlaEngine* const engine, const EnginePostAction action, const uint pluginId, const uint value, const bool lockWait) noexcept
-    : pData(engine->pData)
-{
-    CARLA_SAFE_ASSERT_RETURN(action != kEnginePostActionNull,);
+    try {
+        generation = rtPlugins.publish(plugins, curPluginCount, fadingOut, fadeFrames);
+    } CARLA_SAFE_EXCEPTION_RETURN("EngineRtPluginList::publish", false);
 
-    pData->nextAction.mutex.lock();
+    const uint fadeTimeInMs(sampleRate > 0.0 ? static_cast<uint>(fadeFrames * 1000.0 / sampleRate) : 0);
 
-    CARLA_SAFE_ASSERT_RETURN(pData->nextAction.opcode == kEnginePostActionNull,);
+    if (! rtPlugins.waitForFade(generation, 2000 + fadeTimeInMs))
+        carla_stderr2("Audio thread did not finish the plugin crossfade in time, stopping it now");
 
-    pData->nextAction.opcode   = action;
-    pData->nextAction.pluginId = pluginId;
-    pData->nextAction.value    = value;
+    // publish the plain list, the faded out plugins are no longer referenced after this
+    return commitPluginList(isRunning, true);
+}
 
-    if (lockWait)
+void CarlaEngine::ProtectedData::deleteRemovedPlugin(CarlaPlugin* const plugin, const bool canDelete)
+{
+    CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
+
+    if (canDelete)
     {
-        // block wait for unlock on processing side
-        carla_stdout("ScopedPluginAction(%i) - blocking START", pluginId);
-        pData->nextAction.mutex.lock();
-        carla_stdout("ScopedPluginAction(%i) - blocking DONE", pluginId);
+        delete plugin;
+        return;
     }
-    else
+
+    carla_stderr2("Plugin '%s' might still be in use, deleting it later", plugin->getName());
+
+    const EngineRemovedPlugin removed = { plugin, rtPlugins.getLastGeneration() };
+
+    if (! removedPlugins.append(removed))
+        carla_stderr2("Failed to queue plugin '%s' for deletion, leaking it", plugin->getName());
+}
+
+void CarlaEngine::ProtectedData::deleteRemovedPlugins(const bool force)
+{
+    if (removedPlugins.isEmpty())
+        return;
+
+    if (! force)
+        rtPlugins.reclaim();
+
+    static const EngineRemovedPlugin kRemovedPluginFallback = { nullptr, 0 };
+
+    for (LinkedList<EngineRemovedPlugin>::Itenerator it = removedPlugins.begin2(); it.valid(); it.next())
     {
-        pData->doNextPluginAction(false);
+        const EngineRemovedPlugin& removed(it.getValue(kRemovedPluginFallback));
+        CARLA_SAFE_ASSERT_CONTINUE(removed.plugin != nullptr);
+
+        if (! force && ! rtPlugins.isGenerationActive(removed.generation))
+            continue;
+
+        CarlaPlugin* const plugin(removed.plugin);
+        removedPlugins.remove(it);
+        delete plugin;
     }
 }
 
-ScopedActionLock::~ScopedActionLock() noexcept
+// -----------------------------------------------------------------------
+// PendingRtEventsRunner
+
+PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine, const uint32_t frames) noexcept
+    : pData(engine->pData),
+      numFrames(frames)
 {
-    CARLA_SAFE_ASSERT(pData->nextAction.opcode == kEnginePostActionNull);
-    pData->nextAction.mutex.tryLock();
-    pData->nextAction.mutex.unlock();
+    pData->time.preProcess(frames);
+
+    // edits committed since the last cycle, or while the engine was stopped
+    pData->rtPlugins.rtUpdate();
 }
 
 // -----------------------------------------------------------------------
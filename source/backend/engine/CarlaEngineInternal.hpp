@@ -21,6 +21,7 @@
 #include "CarlaEngineOsc.hpp"
 #include "CarlaEngineThread.hpp"
 #include "CarlaEngineUtils.hpp"
+#include "LinkedList.hpp"
 
 #include "hylia/hylia.h"
 
@@ -73,6 +74,7 @@ public:
     void setBufferSize(const uint32_t bufferSize);
     void setSampleRate(const double sampleRate);
     void setOffline(const bool offline);
+    void setProcessThreads(const uint threads);
 
     bool isReady() const noexcept;
 
@@ -91,6 +93,10 @@ public:
     void removePlugin(CarlaPlugin* const plugin);
     void removeAllPlugins();
 
+    // delay compensation
+    void updatePluginLatency(CarlaPlugin* const plugin);
+    uint32_t getLatency() const noexcept;
+
     bool isUsingExternal() const noexcept;
     void setUsingExternal(const bool usingExternal) noexcept;
 
@@ -158,40 +164,171 @@ private:
 };
 
 // -----------------------------------------------------------------------
-// EngineNextAction
+// ScopedDenormalsDisable
 
-enum EnginePostAction {
-    kEnginePostActionNull = 0,
-    kEnginePostActionZeroCount,    // set curPluginCount to 0
-#ifndef BUILD_BRIDGE
-    kEnginePostActionRemovePlugin, // remove a plugin
-    kEnginePostActionSwitchPlugins // switch between 2 plugins
-#endif
-};
+// enables flush-to-zero and denormals-are-zero for the current thread, restoring previous state on exit.
+// used for threads that we do not own (ie, plugin hosts calling us from their own audio thread)
 
-struct EngineNextAction {
-    EnginePostAction opcode;
-    uint pluginId;
-    uint value;
-    CarlaMutex mutex;
+class ScopedDenormalsDisable
+{
+public:
+    ScopedDenormalsDisable() noexcept;
+    ~ScopedDenormalsDisable() noexcept;
 
-    EngineNextAction() noexcept;
-    ~EngineNextAction() noexcept;
-    void ready() const noexcept;
-    void clearAndReset() noexcept;
+    // permanently enable flush-to-zero and denormals-are-zero for the current thread
+    static void setForCurrentThread() noexcept;
 
-    CARLA_DECLARE_NON_COPY_STRUCT(EngineNextAction)
+private:
+#if defined(__SSE2_MATH__) || defined(__aarch64__)
+    const uintptr_t oldState;
+#endif
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPY_CLASS(ScopedDenormalsDisable)
 };
 
 // -----------------------------------------------------------------------
 // EnginePluginData
 
+// Inactive plugin instance kept ready to replace a running one, see CarlaEngine::loadStandbyPlugin()
+struct EngineStandbyPlugin {
+    CarlaPlugin* plugin;
+    uint64_t memoryUsage;
+    bool active;
+};
+
 struct EnginePluginData {
     CarlaPlugin* plugin;
     float insPeak[2];
     float outsPeak[2];
+    EngineStandbyPlugin standby;
+};
+
+// -----------------------------------------------------------------------
+// EngineRtPluginList
+
+// Read-only copy of the plugin list, as seen by the audio thread.
+// Optionally, it contains the plugins being replaced, which keep running while faded out.
+struct EngineRtPluginSnapshot {
+    uint count;
+    uint generation;
+    CarlaPlugin** plugins;
+    CarlaPlugin** fadingOut;
+    uint32_t fadeFrames;
+    EngineRtPluginSnapshot* nextRetired;
+};
+
+// The non-RT side edits the regular plugin list as it wishes, then publishes a new snapshot of it.
+// The audio thread switches to the latest published snapshot at the start of each cycle, without locks.
+// Any number of edits done between two cycles are committed at once.
+// Snapshots no longer in use are handed back to the non-RT side to be freed there.
+class EngineRtPluginList
+{
+public:
+    EngineRtPluginList() noexcept;
+    ~EngineRtPluginList() noexcept;
+
+    // non-RT: publish a snapshot of the current plugin list, returns its generation.
+    // 'fadingOut' (indexed like 'plugins', may be null) lists plugins to crossfade out of over 'fadeFrames'
+    uint publish(const EnginePluginData* const plugins, const uint count,
+                 CarlaPlugin* const* const fadingOut = nullptr, const uint32_t fadeFrames = 0);
+
+    // non-RT: generation of the last published snapshot
+    uint getLastGeneration() const noexcept;
+
+    // non-RT: check if the audio thread is done with all snapshots older than 'generation'
+    bool isGenerationActive(const uint generation) const noexcept;
+
+    // non-RT: wait until the audio thread is done with all snapshots older than 'generation'
+    bool waitForGeneration(const uint generation, const uint timeoutInMs) const noexcept;
+
+    // non-RT: wait until the audio thread has finished the crossfade of snapshot 'generation'
+    bool waitForFade(const uint generation, const uint timeoutInMs) const noexcept;
+
+    // non-RT: free all snapshots that the audio thread stopped using
+    void reclaim() noexcept;
+
+    // non-RT: free everything, must only be called while the audio thread is not running
+    void clear() noexcept;
+
+    // RT: switch to the latest published snapshot, if any
+    void rtUpdate() noexcept;
+
+    // RT: current snapshot data, valid until the next rtUpdate()
+    uint rtGetCount() const noexcept;
+    CarlaPlugin* rtGetPlugin(const uint index) const noexcept;
+
+    // RT: plugin being faded out at 'index', null if none or fade is complete
+    CarlaPlugin* rtGetFadingPlugin(const uint index) const noexcept;
+
+    // RT: gain of the new plugins at 'frame' within the current cycle, the faded out ones use 1 minus this
+    float rtGetFadeGain(const uint32_t frame) const noexcept;
+
+    // RT: move the crossfade forward, to be called once at the end of each cycle
+    void rtAdvanceFade(const uint32_t frames) noexcept;
+
+private:
+    EngineRtPluginSnapshot* fActive;  // used by audio thread
+    EngineRtPluginSnapshot* fPending; // published, not yet seen by audio thread
+    EngineRtPluginSnapshot* fRetired; // stack of snapshots to free
+    uint fLastGeneration;
+    uint fActiveGeneration;
+    uint fFadedGeneration; // last snapshot with a completed (or no) crossfade
+    uint32_t fFadePosition;
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineRtPluginList)
+};
+
+// Plugin removed from the list while the audio thread might still be using it
+struct EngineRemovedPlugin {
+    CarlaPlugin* plugin;
+    uint generation; // first published list without it
 };
 
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+// EngineOverloadGovernor
+
+// Watches the DSP load of the internal graph and degrades expendable plugins while it stays over the limit,
+// one step per plugin at a time, restoring them once the load has been low enough for a while.
+class EngineOverloadGovernor
+{
+public:
+    EngineOverloadGovernor() noexcept;
+
+    // RT: account one graph cycle that took 'seconds' to process 'frames'
+    void rtAddCycle(const double seconds, const uint32_t frames, const double sampleRate) noexcept;
+
+    // non-RT: check the load accumulated since the last call, degrade or restore plugins if needed.
+    // 'limit' is the maximum load in percent, 0 restores everything
+    void idle(CarlaEngine* const engine, const EnginePluginData* const plugins, const uint count, const uint limit);
+
+    // non-RT: forget the current load, to be called when the graph is reset
+    void reset() noexcept;
+
+private:
+    uint fLoadSum;     // RT, sum of cycle loads in 1/100 percent
+    uint fLoadPeak;    // RT, highest cycle load in 1/100 percent
+    uint fCycleCount;  // RT, number of cycles in fLoadSum
+    uint fOverTicks;   // consecutive idle calls over the limit
+    uint fUnderTicks;  // consecutive idle calls well below the limit
+
+    void report(CarlaEngine* const engine, CarlaPlugin* const plugin, const float load, const bool degraded);
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineOverloadGovernor)
+};
+#endif
+
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+// Error slot of a project loader thread, see CarlaEngine::loadProjectPluginsInParallel()
+
+struct EngineLoaderError {
+    pthread_t    thread;
+    CarlaString* error; // of the plugin being loaded, can be null
+};
+#endif
+
 // -----------------------------------------------------------------------
 // CarlaEngineProtectedData
 
@@ -217,8 +354,30 @@ struct CarlaEngine::ProtectedData {
     // special hack for linuxsampler
     bool firstLinuxSamplerInstance;
     bool loadingProject;
+    bool loadingProjectInParallel;
+
+    // new plugins are being loaded outside the plugin list, under ids from curPluginCount up.
+    // their callbacks and OSC messages are dropped until they are added to the engine.
+    bool loadingHiddenPlugins;
+
+    // a standby plugin is being loaded, addPlugin() puts it in the spare slot past maxPluginNumber
+    bool loadingStandbyPlugin;
+
+    // errors set from the loader threads of a parallel project load go to their current load
+    EngineLoaderError* loaderErrors;
+    uint loaderErrorCount;
+
+    // last graph latency reported to the driver/host
+    uint32_t totalLatency;
+
+    // a project save is in progress, autosave must wait
+    bool savingProject;
+    uint32_t lastAutosaveTime;
 #endif
 
+    // mlockall() was called on init
+    bool memoryLocked;
+
     uint     hints;
     uint32_t bufferSize;
     double   sampleRate;
@@ -230,6 +389,7 @@ struct CarlaEngine::ProtectedData {
     uint nextPluginId;    // invalid if == maxPluginNumber
 
     CarlaMutex     envMutex;
+    CarlaMutex     lastErrorMutex;
     CarlaString    lastError;
     CarlaString    name;
     EngineOptions  options;
@@ -246,7 +406,13 @@ struct CarlaEngine::ProtectedData {
     EngineInternalGraph  graph;
 #endif
     EngineInternalTime   time;
-    EngineNextAction     nextAction;
+    EngineRtPluginList   rtPlugins;
+
+    // removed plugins waiting for the audio thread to let go of them, see deleteRemovedPlugin()
+    LinkedList<EngineRemovedPlugin> removedPlugins;
+#ifndef BUILD_BRIDGE
+    EngineOverloadGovernor overload;
+#endif
 
     // -------------------------------------------------------------------
 
@@ -260,11 +426,38 @@ struct CarlaEngine::ProtectedData {
 
     void initTime(const char* const features);
 
+    // setup the calling thread for realtime audio according to the current options.
+    // drivers must call this once from each of their audio threads, before any processing.
+    void initRtThread() const noexcept;
+
     // -------------------------------------------------------------------
 
-    void doPluginRemove() noexcept;
-    void doPluginsSwitch() noexcept;
-    void doNextPluginAction(const bool unlock) noexcept;
+    void doPluginRemove(const uint pluginId) noexcept;
+    void doPluginsSwitch(const uint idA, const uint idB) noexcept;
+
+    // make the current plugin list visible to the audio thread.
+    // with 'waitRt', waits for the audio thread to stop using the previous list.
+    // returns false if it did not in time, plugins removed from the list must then not be deleted.
+    bool commitPluginList(const bool isRunning, const bool waitRt) noexcept;
+
+    // same as above, but crossfading from the plugins in 'fadingOut' (indexed like 'plugins').
+    // always waits for the crossfade to finish, returns true if the old plugins can be deleted.
+    bool commitPluginListWithFade(const bool isRunning, CarlaPlugin* const* const fadingOut, const uint32_t fadeFrames) noexcept;
+
+    // delete a plugin no longer in the list, right away if 'canDelete' (as returned by the calls above).
+    // otherwise it gets deleted later on, once the audio thread switched to a list without it.
+    void deleteRemovedPlugin(CarlaPlugin* const plugin, const bool canDelete);
+
+    // delete the removed plugins the audio thread is done with, or all of them with 'force' (audio thread stopped).
+    // called on the main thread from idle and on each commit.
+    void deleteRemovedPlugins(const bool force);
+
+#ifndef BUILD_BRIDGE
+    bool isHiddenPluginId(const uint pluginId) const noexcept
+    {
+        return loadingHiddenPlugins && pluginId >= curPluginCount;
+    }
+#endif
 
     // -------------------------------------------------------------------
 
@@ -280,7 +473,6 @@ class PendingRtEventsRunner
 {
 public:
     PendingRtEventsRunner(CarlaEngine* const engine, const uint32_t numFrames) noexcept;
-    ~PendingRtEventsRunner() noexcept;
 
 private:
     CarlaEngine::ProtectedData* const pData;
@@ -292,21 +484,6 @@ private:
 
 // -----------------------------------------------------------------------
 
-class ScopedActionLock
-{
-public:
-    ScopedActionLock(CarlaEngine* const engine, const EnginePostAction action, const uint pluginId, const uint value, const bool lockWait) noexcept;
-    ~ScopedActionLock() noexcept;
-
-private:
-    CarlaEngine::ProtectedData* const pData;
-
-    CARLA_PREVENT_HEAP_ALLOCATION
-    CARLA_DECLARE_NON_COPY_CLASS(ScopedActionLock)
-};
-
-// -----------------------------------------------------------------------
-
 class ScopedThreadStopper
 {
 public:
@@ -28,10 +28,6 @@
 #include "jackey.h"
 #include "juce_audio_basics/juce_audio_basics.h"
 
-#ifdef __SSE2_MATH__
-# include <xmmintrin.h>
-#endif
-
 // must be last
 #include "jackbridge/JackBridge.hpp"
 
@@ -658,6 +654,37 @@ public:
         } CARLA_SAFE_EXCEPTION_RETURN("jack_get_client_name", nullptr);
     }
 
+    void setLatency(const uint32_t samples) noexcept override
+    {
+        CarlaEngineClient::setLatency(samples);
+
+        if (fUseClient && fJackClient != nullptr)
+        {
+            try {
+                jackbridge_recompute_total_latencies(fJackClient);
+            } CARLA_SAFE_EXCEPTION("jack_recompute_total_latencies");
+        }
+    }
+
+    void handleJackLatencyCallback(const jack_latency_callback_mode_t mode) noexcept
+    {
+        // capture latency flows from inputs to outputs, playback latency the other way around
+        const bool fromInputs(mode == JackCaptureLatency);
+
+        jack_latency_range_t range = { 0, 0 };
+        _getPortsLatencyRange(fAudioPorts, mode, fromInputs, range);
+        _getPortsLatencyRange(fCVPorts,    mode, fromInputs, range);
+        _getPortsLatencyRange(fEventPorts, mode, fromInputs, range);
+
+        const uint32_t latency(getLatency());
+        range.min += latency;
+        range.max += latency;
+
+        _setPortsLatencyRange(fAudioPorts, mode, ! fromInputs, range);
+        _setPortsLatencyRange(fCVPorts,    mode, ! fromInputs, range);
+        _setPortsLatencyRange(fEventPorts, mode, ! fromInputs, range);
+    }
+
     void jackAudioPortDeleted(CarlaEngineJackAudioPort* const port) noexcept override
     {
         fAudioPorts.removeAll(port);
@@ -758,6 +785,49 @@ private:
         return true;
     }
 
+    template<typename T>
+    static void _getPortsLatencyRange(const LinkedList<T*>& t, const jack_latency_callback_mode_t mode,
+                                      const bool isInput, jack_latency_range_t& range) noexcept
+    {
+        for (typename LinkedList<T*>::Itenerator it = t.begin2(); it.valid(); it.next())
+        {
+            T* const port(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(port != nullptr);
+
+            if (port->fJackPort == nullptr || port->isInput() != isInput)
+                continue;
+
+            jack_latency_range_t portRange = { 0, 0 };
+
+            try {
+                jackbridge_port_get_latency_range(port->fJackPort, mode, &portRange);
+            } CARLA_SAFE_EXCEPTION_CONTINUE("jack_port_get_latency_range");
+
+            if (portRange.min > range.min)
+                range.min = portRange.min;
+            if (portRange.max > range.max)
+                range.max = portRange.max;
+        }
+    }
+
+    template<typename T>
+    static void _setPortsLatencyRange(const LinkedList<T*>& t, const jack_latency_callback_mode_t mode,
+                                      const bool isInput, jack_latency_range_t& range) noexcept
+    {
+        for (typename LinkedList<T*>::Itenerator it = t.begin2(); it.valid(); it.next())
+        {
+            T* const port(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(port != nullptr);
+
+            if (port->fJackPort == nullptr || port->isInput() != isInput)
+                continue;
+
+            try {
+                jackbridge_port_set_latency_range(port->fJackPort, mode, &range);
+            } CARLA_SAFE_EXCEPTION_CONTINUE("jack_port_set_latency_range");
+        }
+    }
+
     template<typename T>
     void _savePortsConnections(const LinkedList<T*>& t, const CarlaString& clientNamePrefix)
     {
@@ -945,7 +1015,7 @@ public:
         pData->sampleRate = jackbridge_get_sample_rate(fClient);
         pData->initTime(pData->options.transportExtra);
 
-        jackbridge_set_thread_init_callback(fClient, carla_jack_thread_init_callback, nullptr);
+        jackbridge_set_thread_init_callback(fClient, carla_jack_thread_init_callback, this);
         jackbridge_set_buffer_size_callback(fClient, carla_jack_bufsize_callback, this);
         jackbridge_set_sample_rate_callback(fClient, carla_jack_srate_callback, this);
         jackbridge_set_freewheel_callback(fClient, carla_jack_freewheel_callback, this);
@@ -1099,7 +1169,7 @@ public:
 
             CARLA_SAFE_ASSERT_RETURN(client != nullptr, nullptr);
 
-            jackbridge_set_thread_init_callback(client, carla_jack_thread_init_callback, nullptr);
+            jackbridge_set_thread_init_callback(client, carla_jack_thread_init_callback, this);
 
 #ifndef BUILD_BRIDGE
             jackbridge_set_latency_callback(client, carla_jack_latency_callback_plugin, plugin);
@@ -1199,7 +1269,7 @@ public:
 
                 // NOTE: jack1 locks up here
                 if (jackbridge_get_version_string() != nullptr)
-                    jackbridge_set_thread_init_callback(jackClient, carla_jack_thread_init_callback, nullptr);
+                    jackbridge_set_thread_init_callback(jackClient, carla_jack_thread_init_callback, this);
 
                 /* The following code is because of a tricky situation.
                    We cannot lock or do jack operations during jack callbacks on jack1. jack2 events are asynchronous.
@@ -1477,6 +1547,11 @@ public:
     // -------------------------------------------------------------------
 
 protected:
+    void handleJackThreadInitCallback() const noexcept
+    {
+        pData->initRtThread();
+    }
+
     void handleJackBufferSizeCallback(const uint32_t newBufferSize)
     {
         if (pData->bufferSize == newBufferSize)
@@ -1574,7 +1649,7 @@ protected:
                 if (float* const audioOut2 = (float*)jackbridge_port_get_buffer(fRackPorts[kRackPortAudioOut2], nframes))
                     FloatVectorOperations::clear(audioOut2, static_cast<int>(nframes));
             }
-            else if (pData->curPluginCount == 0)
+            else if (pData->rtPlugins.rtGetCount() == 0)
             {
                 float* const audioIn1  = (float*)jackbridge_port_get_buffer(fRackPorts[kRackPortAudioIn1], nframes);
                 float* const audioIn2  = (float*)jackbridge_port_get_buffer(fRackPorts[kRackPortAudioIn2], nframes);
@@ -1601,9 +1676,9 @@ protected:
 
         if (pData->options.processMode == ENGINE_PROCESS_MODE_SINGLE_CLIENT)
         {
-            for (uint i=0; i < pData->curPluginCount; ++i)
+            for (uint i=0, count=pData->rtPlugins.rtGetCount(); i < count; ++i)
             {
-                CarlaPlugin* const plugin(pData->plugins[i].plugin);
+                CarlaPlugin* const plugin(pData->rtPlugins.rtGetPlugin(i));
 
                 if (plugin != nullptr && plugin->isEnabled() && plugin->tryLock(fFreewheel))
                 {
@@ -1716,10 +1791,60 @@ protected:
 #endif // ! BUILD_BRIDGE
     }
 
-    void handleJackLatencyCallback(const jack_latency_callback_mode_t /*mode*/)
+    void handleJackLatencyCallback(const jack_latency_callback_mode_t mode)
     {
+#ifndef BUILD_BRIDGE
+        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+            pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
+            return;
+
+        const bool isCapture(mode == JackCaptureLatency);
+
+        // rack ports are always registered as input pairs followed by output pairs
+        jack_port_t* const inPorts[3]  = { fRackPorts[kRackPortAudioIn1],  fRackPorts[kRackPortAudioIn2],  fRackPorts[kRackPortEventIn]  };
+        jack_port_t* const outPorts[3] = { fRackPorts[kRackPortAudioOut1], fRackPorts[kRackPortAudioOut2], fRackPorts[kRackPortEventOut] };
+
+        jack_port_t* const* const srcPorts(isCapture ? inPorts  : outPorts);
+        jack_port_t* const* const dstPorts(isCapture ? outPorts : inPorts);
+
+        jack_latency_range_t range = { 0, 0 };
+
+        for (uint i=0; i < 3; ++i)
+        {
+            CARLA_SAFE_ASSERT_CONTINUE(srcPorts[i] != nullptr);
+
+            jack_latency_range_t portRange = { 0, 0 };
+            jackbridge_port_get_latency_range(srcPorts[i], mode, &portRange);
+
+            if (portRange.min > range.min)
+                range.min = portRange.min;
+            if (portRange.max > range.max)
+                range.max = portRange.max;
+        }
+
+        const uint32_t latency(getTotalLatency());
+        range.min += latency;
+        range.max += latency;
+
+        for (uint i=0; i < 3; ++i)
+        {
+            CARLA_SAFE_ASSERT_CONTINUE(dstPorts[i] != nullptr);
+            jackbridge_port_set_latency_range(dstPorts[i], mode, &range);
+        }
+#else
         // TODO
+        (void)mode;
+#endif
+    }
+
+#ifndef BUILD_BRIDGE
+    void totalLatencyChanged(const uint32_t) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fClient != nullptr,);
+
+        jackbridge_recompute_total_latencies(fClient);
     }
+#endif
 
 #ifndef BUILD_BRIDGE
     void handleJackTimebaseCallback(jack_nframes_t nframes, jack_position_t* const pos, const int new_pos)
@@ -1954,9 +2079,6 @@ protected:
         engineClient->invalidate();
         plugin->unlock();
 
-        //if (pData->nextAction.pluginId == plugin->getId())
-        //    pData->nextAction.clearAndReset();
-
         callback(ENGINE_CALLBACK_PLUGIN_UNAVAILABLE, plugin->getId(), 0, 0, 0.0f, "Killed by JACK");
     }
 
@@ -2255,7 +2377,22 @@ private:
             }
         }
 
+#ifndef BUILD_BRIDGE
+        if (plugin->checkSleep(audioIn, nframes))
+        {
+            for (uint32_t i=0; i < audioOutCount; ++i)
+                carla_zeroFloats(audioOut[i], nframes);
+            for (uint32_t i=0; i < cvOutCount; ++i)
+                carla_zeroFloats(cvOut[i], nframes);
+        }
+        else
+        {
+            plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
+            plugin->updateSleep(audioOut, nframes);
+        }
+#else
         plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
+#endif
 
         for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
         {
@@ -2390,12 +2527,9 @@ private:
 
     #define handlePtr ((CarlaEngineJack*)arg)
 
-    static void JACKBRIDGE_API carla_jack_thread_init_callback(void*)
+    static void JACKBRIDGE_API carla_jack_thread_init_callback(void* arg)
     {
-#ifdef __SSE2_MATH__
-        // Set FTZ and DAZ flags
-        _mm_setcsr(_mm_getcsr() | 0x8040);
-#endif
+        handlePtr->handleJackThreadInitCallback();
     }
 
     static int JACKBRIDGE_API carla_jack_bufsize_callback(jack_nframes_t newBufferSize, void* arg)
@@ -2504,9 +2638,15 @@ private:
         return 0;
     }
 
-    static void JACKBRIDGE_API carla_jack_latency_callback_plugin(jack_latency_callback_mode_t /*mode*/, void* /*arg*/)
+    static void JACKBRIDGE_API carla_jack_latency_callback_plugin(jack_latency_callback_mode_t mode, void* arg)
     {
-        // TODO
+        CarlaPlugin* const plugin((CarlaPlugin*)arg);
+        CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
+
+        CarlaEngineJackClient* const client((CarlaEngineJackClient*)plugin->getEngineClient());
+        CARLA_SAFE_ASSERT_RETURN(client != nullptr,);
+
+        client->handleJackLatencyCallback(mode);
     }
 
     static void JACKBRIDGE_API carla_jack_shutdown_callback_plugin(void* arg)
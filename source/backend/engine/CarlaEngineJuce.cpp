@@ -17,6 +17,7 @@
 
 #include "CarlaEngineGraph.hpp"
 #include "CarlaEngineInternal.hpp"
+#include "CarlaEngineMidiOutThread.hpp"
 #include "CarlaBackendUtils.hpp"
 #include "CarlaStringList.hpp"
 
@@ -101,7 +102,8 @@ static void initJuceDevicesIfNeeded()
 
 class CarlaEngineJuce : public CarlaEngine,
                         public AudioIODeviceCallback,
-                        public MidiInputCallback
+                        public MidiInputCallback,
+                        public CarlaEngineMidiOutThread::Callback
 {
 public:
     CarlaEngineJuce(AudioIODeviceType* const devType)
@@ -109,10 +111,12 @@ public:
           AudioIODeviceCallback(),
           fDevice(),
           fDeviceType(devType),
+          fRtThreadReady(false),
           fMidiIns(),
           fMidiInEvents(),
           fMidiOuts(),
-          fMidiOutMutex()
+          fMidiOutMutex(),
+          fMidiOutThread(this)
     {
         carla_debug("CarlaEngineJuce::CarlaEngineJuce(%p)", devType);
 
@@ -204,6 +208,8 @@ public:
 
         pData->graph.create(static_cast<uint32_t>(inputNames.size()), static_cast<uint32_t>(outputNames.size()));
 
+        fMidiOutThread.start();
+
         fDevice->start(this);
 
         patchbayRefresh(false);
@@ -230,6 +236,8 @@ public:
 
         pData->graph.destroy();
 
+        fMidiOutThread.stop();
+
         for (LinkedList<MidiInPort>::Itenerator it = fMidiIns.begin2(); it.valid(); it.next())
         {
             MidiInPort& inPort(it.getValue(kMidiInPortFallbackNC));
@@ -288,6 +296,11 @@ public:
         return fDeviceType->getTypeName().toRawUTF8();
     }
 
+    uint32_t getMidiOutJitter() const noexcept override
+    {
+        return fMidiOutThread.getJitter();
+    }
+
     // -------------------------------------------------------------------
     // Patchbay
 
@@ -445,6 +458,12 @@ protected:
     void audioDeviceIOCallback(const float** inputChannelData, int numInputChannels, float** outputChannelData,
                                int numOutputChannels, int numSamples) override
     {
+        if (! __atomic_load_n(&fRtThreadReady, __ATOMIC_ACQUIRE))
+        {
+            pData->initRtThread();
+            __atomic_store_n(&fRtThreadReady, true, __ATOMIC_RELEASE);
+        }
+
         const PendingRtEventsRunner prt(this, numSamples);
 
         // assert juce buffers
@@ -481,7 +500,7 @@ protected:
                 }
                 else if (midiEvent.time >= pData->timeInfo.frame + nframes)
                 {
-                    carla_stderr("MIDI Event in the future!, %i vs %i", engineEvent.time, pData->timeInfo.frame);
+                    carla_rt_stderr("MIDI Event in the future!, %i vs %i", engineEvent.time, pData->timeInfo.frame);
                     engineEvent.time = static_cast<uint32_t>(pData->timeInfo.frame) + nframes - 1;
                 }
                 else
@@ -499,63 +518,53 @@ protected:
 
         pData->graph.process(pData, inputChannelData, outputChannelData, nframes);
 
-        fMidiOutMutex.lock();
+        // sent later by the MIDI thread, at the time matching each event frame
+        fMidiOutThread.beginCycle(nframes, pData->sampleRate);
 
-        if (fMidiOuts.count() > 0)
-        {
-            uint8_t        size    = 0;
-            uint8_t        data[3] = { 0, 0, 0 };
-            const uint8_t* dataPtr = data;
+        uint8_t        size    = 0;
+        uint8_t        data[3] = { 0, 0, 0 };
+        const uint8_t* dataPtr = data;
 
-            for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
-            {
-                const EngineEvent& engineEvent(pData->events.out[i]);
+        for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+        {
+            const EngineEvent& engineEvent(pData->events.out[i]);
 
-                if (engineEvent.type == kEngineEventTypeNull)
-                    break;
+            if (engineEvent.type == kEngineEventTypeNull)
+                break;
 
-                else if (engineEvent.type == kEngineEventTypeControl)
-                {
-                    const EngineControlEvent& ctrlEvent(engineEvent.ctrl);
-                    ctrlEvent.convertToMidiData(engineEvent.channel, size, data);
-                    dataPtr = data;
-                }
-                else if (engineEvent.type == kEngineEventTypeMidi)
-                {
-                    const EngineMidiEvent& midiEvent(engineEvent.midi);
+            else if (engineEvent.type == kEngineEventTypeControl)
+            {
+                const EngineControlEvent& ctrlEvent(engineEvent.ctrl);
+                ctrlEvent.convertToMidiData(engineEvent.channel, size, data);
+                dataPtr = data;
+            }
+            else if (engineEvent.type == kEngineEventTypeMidi)
+            {
+                const EngineMidiEvent& midiEvent(engineEvent.midi);
 
-                    size = midiEvent.size;
+                size = midiEvent.size;
 
-                    if (size > EngineMidiEvent::kDataSize && midiEvent.dataExt != nullptr)
-                        dataPtr = midiEvent.dataExt;
-                    else
-                        dataPtr = midiEvent.data;
-                }
+                if (size > EngineMidiEvent::kDataSize && midiEvent.dataExt != nullptr)
+                    dataPtr = midiEvent.dataExt;
                 else
-                {
-                    continue;
-                }
-
-                if (size > 0)
-                {
-                    MidiMessage message(static_cast<const void*>(dataPtr), static_cast<int>(size), static_cast<double>(engineEvent.time)/nframes);
-
-                    for (LinkedList<MidiOutPort>::Itenerator it=fMidiOuts.begin2(); it.valid(); it.next())
-                    {
-                        MidiOutPort& outPort(it.getValue(kMidiOutPortFallbackNC));
-                        CARLA_SAFE_ASSERT_CONTINUE(outPort.port != nullptr);
-
-                        outPort.port->sendMessageNow(message);
-                    }
-                }
+                    dataPtr = midiEvent.data;
+            }
+            else
+            {
+                continue;
             }
+
+            if (size > 0)
+                fMidiOutThread.writeEvent(engineEvent.time, dataPtr, size);
         }
 
-        fMidiOutMutex.unlock();
+        fMidiOutThread.endCycle();
     }
 
     void audioDeviceAboutToStart(AudioIODevice* /*device*/) override
     {
+        // the device might use a new audio thread
+        __atomic_store_n(&fRtThreadReady, false, __ATOMIC_RELEASE);
     }
 
     void audioDeviceStopped() override
@@ -592,6 +601,24 @@ protected:
         fMidiInEvents.append(midiEvent);
     }
 
+    void midiOutThreadSend(const uint8_t* const data, const uint8_t size) override
+    {
+        const CarlaMutexLocker cml(fMidiOutMutex);
+
+        if (fMidiOuts.count() == 0)
+            return;
+
+        const MidiMessage message(static_cast<const void*>(data), static_cast<int>(size));
+
+        for (LinkedList<MidiOutPort>::Itenerator it=fMidiOuts.begin2(); it.valid(); it.next())
+        {
+            MidiOutPort& outPort(it.getValue(kMidiOutPortFallbackNC));
+            CARLA_SAFE_ASSERT_CONTINUE(outPort.port != nullptr);
+
+            outPort.port->sendMessageNow(message);
+        }
+    }
+
     // -------------------------------------------------------------------
 
     bool connectExternalGraphPort(const uint connectionType, const uint portId, const char* const portName) override
@@ -710,6 +737,9 @@ private:
     ScopedPointer<AudioIODevice> fDevice;
     AudioIODeviceType* const     fDeviceType;
 
+    // audio thread has been setup
+    bool fRtThreadReady; // atomic, the audio thread was set up
+
     struct RtMidiEvents {
         CarlaMutex mutex;
         RtLinkedList<RtMidiEvent>::Pool dataPool;
@@ -752,8 +782,9 @@ private:
     LinkedList<MidiInPort> fMidiIns;
     RtMidiEvents           fMidiInEvents;
 
-    LinkedList<MidiOutPort> fMidiOuts;
-    CarlaMutex              fMidiOutMutex;
+    LinkedList<MidiOutPort>  fMidiOuts;
+    CarlaMutex               fMidiOutMutex;
+    CarlaEngineMidiOutThread fMidiOutThread;
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineJuce)
 };
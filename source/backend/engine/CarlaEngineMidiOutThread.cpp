@@ -0,0 +1,257 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2017 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaEngineMidiOutThread.hpp"
+
+#include "AppConfig.h"
+#include "juce_core/juce_core.h"
+
+#ifdef CARLA_OS_WIN
+# include <windows.h>
+#else
+# include <unistd.h>
+#endif
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+// enough for several audio cycles full of events
+static const uint32_t kRingBufferSize = 65536;
+
+// cycle start estimate correction, as a fraction of the difference to the actual callback time
+static const int64_t kCycleStartCorrection = 8;
+
+// longest sleep before checking if the thread should exit, in microseconds
+static const int64_t kMaxSleepTime = 10000;
+
+// -----------------------------------------------------------------------
+
+CarlaEngineMidiOutThread::CarlaEngineMidiOutThread(Callback* const callback) noexcept
+    : CarlaThread("CarlaEngineMidiOutThread"),
+      kCallback(callback),
+      fRingBuffer(),
+      fSem(),
+      fPosted(0),
+      fHasEvents(false),
+      fCycleStart(0),
+      fCycleTicks(0),
+      fTicksPerFrame(0.0),
+      fHasPriority(false),
+      fNeedsPriority(false),
+      fPolicy(0),
+      fParam(),
+      fJitter(0)
+{
+    CARLA_SAFE_ASSERT(callback != nullptr);
+    carla_debug("CarlaEngineMidiOutThread::CarlaEngineMidiOutThread(%p)", callback);
+
+    carla_sem_create2(fSem);
+}
+
+CarlaEngineMidiOutThread::~CarlaEngineMidiOutThread() noexcept
+{
+    carla_debug("CarlaEngineMidiOutThread::~CarlaEngineMidiOutThread()");
+
+    stop();
+    carla_sem_destroy2(fSem);
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaEngineMidiOutThread::start() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(! isThreadRunning(),);
+    carla_debug("CarlaEngineMidiOutThread::start()");
+
+    fRingBuffer.createBuffer(kRingBufferSize);
+
+    fPosted        = 0;
+    fHasEvents     = false;
+    fCycleStart    = 0;
+    fHasPriority   = false;
+    fNeedsPriority = false;
+    fJitter        = 0;
+
+    startThread();
+}
+
+void CarlaEngineMidiOutThread::stop() noexcept
+{
+    if (! isThreadRunning())
+        return;
+
+    carla_debug("CarlaEngineMidiOutThread::stop()");
+
+    signalThreadShouldExit();
+    stopThread(-1);
+
+    // consume a post the thread did not get to, so the next one does not find the semaphore already posted
+    if (fPosted != 0)
+        carla_sem_trywait(fSem, true);
+
+    fRingBuffer.deleteBuffer();
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaEngineMidiOutThread::beginCycle(const uint32_t frames, const double sampleRate) noexcept
+{
+    const int64_t now(static_cast<int64_t>(juce::Time::getHighResolutionTicks()));
+    const double ticksPerSecond(static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    fTicksPerFrame = ticksPerSecond / sampleRate;
+    fCycleTicks    = static_cast<int64_t>(fTicksPerFrame * frames + 0.5);
+
+    // callbacks do not arrive exactly one cycle apart, follow them slowly so their jitter does not move the events.
+    // start over after xruns or buffer size changes
+    const int64_t expected(fCycleStart + fCycleTicks);
+    const int64_t diff(now - expected);
+
+    if (fCycleStart == 0 || diff > fCycleTicks || diff < -fCycleTicks)
+        fCycleStart = now;
+    else
+        fCycleStart = expected + diff / kCycleStartCorrection;
+
+    if (! fHasPriority)
+    {
+        fHasPriority = true;
+
+        if (pthread_getschedparam(pthread_self(), &fPolicy, &fParam) == 0)
+            fNeedsPriority = true;
+    }
+}
+
+void CarlaEngineMidiOutThread::writeEvent(const uint32_t frame, const uint8_t* const data, const uint8_t size) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr && size > 0,);
+
+    if (! isThreadRunning())
+        return;
+
+    // one cycle later, so all events of a cycle are due before the next one is processed
+    const int64_t time(fCycleStart + fCycleTicks + static_cast<int64_t>(fTicksPerFrame * frame));
+
+    fRingBuffer.writeLong(time);
+    fRingBuffer.writeByte(size);
+    fRingBuffer.writeCustomData(data, size);
+
+    if (fRingBuffer.commitWrite())
+        fHasEvents = true;
+}
+
+void CarlaEngineMidiOutThread::endCycle() noexcept
+{
+    if (! fHasEvents)
+        return;
+
+    fHasEvents = false;
+
+    // only post once until the thread consumes it
+    if (! __atomic_exchange_n(&fPosted, 1, __ATOMIC_SEQ_CST))
+        carla_sem_post(fSem, true);
+}
+
+uint32_t CarlaEngineMidiOutThread::getJitter() const noexcept
+{
+    return __atomic_load_n(&fJitter, __ATOMIC_RELAXED);
+}
+
+// -----------------------------------------------------------------------
+
+bool CarlaEngineMidiOutThread::waitUntil(const int64_t time) noexcept
+{
+    const int64_t ticksPerSecond(static_cast<int64_t>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    for (; ! shouldThreadExit();)
+    {
+        const int64_t remaining(time - static_cast<int64_t>(juce::Time::getHighResolutionTicks()));
+
+        if (remaining <= 0)
+            return true;
+
+        const int64_t usecs(std::min(remaining * 1000000 / ticksPerSecond, kMaxSleepTime));
+
+#ifdef CARLA_OS_WIN
+        // Sleep() has millisecond resolution at best, finish the wait by yielding
+        ::Sleep(usecs >= 2000 ? static_cast<DWORD>(usecs / 1000 - 1) : 0);
+#else
+        ::usleep(static_cast<useconds_t>(usecs));
+#endif
+    }
+
+    return false;
+}
+
+void CarlaEngineMidiOutThread::run() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(kCallback != nullptr,);
+    carla_debug("CarlaEngineMidiOutThread::run()");
+
+    const int64_t ticksPerSecond(static_cast<int64_t>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    uint8_t data[0xff];
+    int64_t jitterStart(static_cast<int64_t>(juce::Time::getHighResolutionTicks()));
+    int64_t jitterMax = 0;
+
+    for (; ! shouldThreadExit();)
+    {
+        // follow the audio thread priority
+        if (fNeedsPriority)
+        {
+            fNeedsPriority = false;
+            pthread_setschedparam(pthread_self(), fPolicy, &fParam);
+        }
+
+        const int64_t now(static_cast<int64_t>(juce::Time::getHighResolutionTicks()));
+
+        if (now - jitterStart >= ticksPerSecond)
+        {
+            __atomic_store_n(&fJitter, static_cast<uint32_t>(jitterMax * 1000000 / ticksPerSecond), __ATOMIC_RELAXED);
+            jitterStart = now;
+            jitterMax   = 0;
+        }
+
+        if (! fRingBuffer.isDataAvailableForReading())
+        {
+            if (carla_sem_timedwait(fSem, 100, true))
+                __atomic_store_n(&fPosted, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+
+        const int64_t time(fRingBuffer.readLong());
+        const uint8_t size(fRingBuffer.readByte());
+
+        if (size == 0)
+            continue;
+
+        fRingBuffer.readCustomData(data, size);
+
+        if (! waitUntil(time))
+            break;
+
+        try {
+            kCallback->midiOutThreadSend(data, size);
+        } CARLA_SAFE_EXCEPTION("midiOutThreadSend");
+
+        jitterMax = std::max(jitterMax, static_cast<int64_t>(juce::Time::getHighResolutionTicks()) - time);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,98 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2011-2017 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_ENGINE_MIDI_OUT_THREAD_HPP_INCLUDED
+#define CARLA_ENGINE_MIDI_OUT_THREAD_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaRingBuffer.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineMidiOutThread
+//
+// Sends the MIDI output of drivers without their own MIDI scheduling (RtAudio and Juce).
+// The audio thread queues events in a preallocated lock-free ring buffer, each stamped with the time it is due,
+// one audio cycle after its frame, following a smoothed estimate of when audio cycles start.
+// This thread runs at the audio thread priority, and sends each event once it is due.
+
+class CarlaEngineMidiOutThread : public CarlaThread
+{
+public:
+    struct Callback {
+        virtual ~Callback() {}
+
+        // called from the MIDI thread for each due event
+        virtual void midiOutThreadSend(const uint8_t* const data, const uint8_t size) = 0;
+    };
+
+    CarlaEngineMidiOutThread(Callback* const callback) noexcept;
+    ~CarlaEngineMidiOutThread() noexcept override;
+
+    // non-RT, start and stop sending, events still queued when stopping are dropped
+    void start() noexcept;
+    void stop() noexcept;
+
+    // RT, called once per audio cycle before queueing its events
+    void beginCycle(const uint32_t frames, const double sampleRate) noexcept;
+
+    // RT, queue an event of the current audio cycle
+    void writeEvent(const uint32_t frame, const uint8_t* const data, const uint8_t size) noexcept;
+
+    // RT, wake up the thread if events were queued during this cycle
+    void endCycle() noexcept;
+
+    // how late events were sent, in microseconds, maximum over the last second
+    uint32_t getJitter() const noexcept;
+
+protected:
+    void run() noexcept override;
+
+private:
+    Callback* const kCallback;
+
+    CarlaHeapRingBuffer fRingBuffer;
+    carla_sem_t fSem;
+    int fPosted;       // the semaphore was posted and not consumed yet
+    bool fHasEvents;   // events were queued during the current cycle
+
+    // audio clock estimate, in high resolution ticks
+    int64_t fCycleStart;
+    int64_t fCycleTicks;
+    double  fTicksPerFrame;
+
+    // audio thread scheduling, followed by this thread
+    bool fHasPriority;
+    volatile bool fNeedsPriority;
+    int fPolicy;
+    sched_param fParam;
+
+    uint32_t fJitter;
+
+    bool waitUntil(const int64_t time) noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineMidiOutThread)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_MIDI_OUT_THREAD_HPP_INCLUDED
@@ -26,6 +26,7 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
+#include "CarlaBinaryProjectUtils.hpp"
 #include "CarlaBinaryUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaStateUtils.hpp"
@@ -145,6 +146,26 @@ protected:
 
             delete[] filename;
         }
+        else if (std::strcmp(msg, "convert_project") == 0)
+        {
+            const char* inFilename;
+            const char* outFilename;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(inFilename), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(outFilename), true);
+
+            const File inFile(String::fromUTF8(inFilename));
+            const File outFile(String::fromUTF8(outFilename));
+
+            try {
+                ok = CarlaBinaryProjectReader::isBinaryProject(inFile)
+                   ? carla_convert_project_to_xml(inFile, outFile)
+                   : carla_convert_project_to_binary(inFile, outFile);
+            } CARLA_SAFE_EXCEPTION("convertProject");
+
+            delete[] inFilename;
+            delete[] outFilename;
+        }
         else if (std::strcmp(msg, "patchbay_connect") == 0)
         {
             uint32_t groupA, portA, groupB, portB;
@@ -278,6 +299,34 @@ protected:
 
             ok = fEngine->switchPlugins(pluginIdA, pluginIdB);
         }
+        else if (std::strcmp(msg, "load_standby_plugin") == 0)
+        {
+            uint32_t pluginId;
+            const char* filename;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(filename), true);
+
+            ok = fEngine->loadStandbyPlugin(pluginId, filename);
+
+            delete[] filename;
+        }
+        else if (std::strcmp(msg, "remove_standby_plugin") == 0)
+        {
+            uint32_t pluginId;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+
+            ok = fEngine->removeStandbyPlugin(pluginId);
+        }
+        else if (std::strcmp(msg, "switch_to_standby_plugins") == 0)
+        {
+            uint32_t crossfadeMs;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(crossfadeMs), true);
+
+            ok = fEngine->switchToStandbyPlugins(crossfadeMs);
+        }
         else if (std::strcmp(msg, "load_plugin_state") == 0)
         {
             uint32_t pluginId;
@@ -736,6 +785,11 @@ protected:
             pHost->dispatcher(pHost->handle, NATIVE_HOST_OPCODE_HOST_IDLE, 0, 0, nullptr, 0.0f);
     }
 
+    void totalLatencyChanged(const uint32_t latency) override
+    {
+        pHost->dispatcher(pHost->handle, NATIVE_HOST_OPCODE_UPDATE_LATENCY, 0, static_cast<intptr_t>(latency), nullptr, 0.0f);
+    }
+
     // -------------------------------------------------------------------
 
     const char* renamePlugin(const uint id, const char* const newName) override
@@ -1338,6 +1392,8 @@ protected:
     void process(float** const inBuffer, float** const outBuffer, const uint32_t frames,
                  const NativeMidiEvent* const midiEvents, const uint32_t midiEventCount)
     {
+        // we do not own the host audio thread, so only change its FPU state while processing
+        const ScopedDenormalsDisable sdd;
         const PendingRtEventsRunner prt(this, frames);
 
         // ---------------------------------------------------------------
@@ -1369,7 +1425,7 @@ protected:
         // ---------------------------------------------------------------
         // Do nothing if no plugins and rack mode
 
-        if (pData->curPluginCount == 0 && ! kIsPatchbay)
+        if (pData->rtPlugins.rtGetCount() == 0 && ! kIsPatchbay)
         {
             if (outBuffer[0] != inBuffer[0])
                 FloatVectorOperations::copy(outBuffer[0], inBuffer[0], static_cast<int>(frames));
@@ -1468,7 +1524,7 @@ protected:
                 }
                 else
                 {
-                    carla_stderr("Unknown event type...");
+                    carla_rt_stderr("Unknown event type...");
                     continue;
                 }
 
@@ -1582,6 +1638,10 @@ protected:
             }
         }
 
+        try {
+            pData->deleteRemovedPlugins(false);
+        } CARLA_SAFE_EXCEPTION("deleteRemovedPlugins");
+
         if (fUiServer.isPipeRunning())
         {
             fUiServer.idlePipe();
@@ -2146,6 +2206,7 @@ CARLA_BACKEND_END_NAMESPACE
 #include "CarlaPatchbayUtils.cpp"
 #include "CarlaPipeUtils.cpp"
 #include "CarlaStateUtils.cpp"
+#include "CarlaBinaryProjectUtils.cpp"
 #include "CarlaJuceEvents.cpp"
 
 #endif
@@ -22,18 +22,55 @@
 #include "CarlaEngine.hpp"
 #include "CarlaEngineOsc.hpp"
 #include "CarlaPlugin.hpp"
+#include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 
+#include "AppConfig.h"
+#include "juce_core/juce_core.h"
+
 #include <cctype>
 
+using juce::Time;
+
 CARLA_BACKEND_START_NAMESPACE
 
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+
+// internal parameters go first, PARAMETER_CTRL_CHANNEL..PARAMETER_ACTIVE, then up to 50 regular ones (as limited by the OSC protocol)
+static const int32_t kQueuedParameterOffset     = -PARAMETER_MAX;
+static const uint    kQueuedParametersPerPlugin = 50 + kQueuedParameterOffset;
+
+// keeps UDP bundles below common MTU sizes
+static const uint kMaxMessagesPerBundle = 24;
+
+static uint32_t getOscRateInterval(const char* const envName, const uint defaultRate) noexcept
+{
+    uint rate = defaultRate;
+
+    if (const char* const envValue = std::getenv(envName))
+        rate = static_cast<uint>(std::atoi(envValue));
+
+    return (rate != 0) ? 1000/rate : 0;
+}
+#endif
+
 // -----------------------------------------------------------------------
 
 CarlaEngineOsc::CarlaEngineOsc(CarlaEngine* const engine) noexcept
     : fEngine(engine),
 #ifndef BUILD_BRIDGE
       fControlData(),
+      fQueueMutex(),
+      fQueueMaxPlugins(0),
+      fQueuedParameters(nullptr),
+      fQueuedParameterIds(nullptr),
+      fQueuedParameterCount(0),
+      fQueuedPeaks(nullptr),
+      fParameterInterval(0),
+      fPeaksInterval(0),
+      fLastParameterTime(0),
+      fLastPeaksTime(0),
 #endif
       fName(),
       fServerPathTCP(),
@@ -52,6 +89,9 @@ CarlaEngineOsc::~CarlaEngineOsc() noexcept
     CARLA_SAFE_ASSERT(fServerPathUDP.isEmpty());
     CARLA_SAFE_ASSERT(fServerTCP == nullptr);
     CARLA_SAFE_ASSERT(fServerUDP == nullptr);
+#ifndef BUILD_BRIDGE
+    CARLA_SAFE_ASSERT(fQueuedParameters == nullptr);
+#endif
     carla_debug("CarlaEngineOsc::~CarlaEngineOsc()");
 }
 
@@ -79,6 +119,10 @@ void CarlaEngineOsc::init(const char* const name) noexcept
         tcpPort = std::getenv("CARLA_OSC_TCP_PORT");
         udpPort = std::getenv("CARLA_OSC_UDP_PORT");
     }
+
+    // rates in Hz, 0 to send on every idle tick
+    fParameterInterval = getOscRateInterval("CARLA_OSC_PARAMETER_RATE", 30);
+    fPeaksInterval     = getOscRateInterval("CARLA_OSC_PEAKS_RATE", 20);
 #endif
 
     fServerTCP = lo_server_new_with_proto(tcpPort, LO_TCP, osc_error_handler_TCP);
@@ -168,10 +212,243 @@ void CarlaEngineOsc::close() noexcept
     fServerPathUDP.clear();
 
 #ifndef BUILD_BRIDGE
+    clearQueue();
     fControlData.clear();
 #endif
 }
 
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+
+void CarlaEngineOsc::queueParameterValue(const uint pluginId, const int32_t index, const float value) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(index > PARAMETER_MAX && index < 50,);
+
+    const CarlaMutexLocker cml(fQueueMutex);
+
+    if (pluginId >= fQueueMaxPlugins)
+        return;
+
+    const uint id = pluginId*kQueuedParametersPerPlugin + static_cast<uint>(index + kQueuedParameterOffset);
+    QueuedParameter& param(fQueuedParameters[id]);
+
+    param.value = value;
+
+    if (param.queued)
+        return;
+
+    param.queued = true;
+    fQueuedParameterIds[fQueuedParameterCount++] = id;
+}
+
+void CarlaEngineOsc::queuePeaks(const uint pluginId, const float peaks[4]) noexcept
+{
+    const CarlaMutexLocker cml(fQueueMutex);
+
+    if (pluginId >= fQueueMaxPlugins)
+        return;
+
+    QueuedPeaks& queuedPeaks(fQueuedPeaks[pluginId]);
+
+    carla_copyFloats(queuedPeaks.peaks, peaks, 4);
+    queuedPeaks.queued = true;
+}
+
+void CarlaEngineOsc::sendQueuedMessages(const bool force) noexcept
+{
+    const CarlaMutexLocker cml(fQueueMutex);
+
+    if (fQueuedParameters == nullptr || fControlData.path == nullptr || fControlData.target == nullptr)
+        return;
+
+    const uint32_t time = Time::getMillisecondCounter();
+
+    const bool sendParameters = fQueuedParameterCount != 0 && (force || time - fLastParameterTime >= fParameterInterval);
+    const bool sendPeaks      = ! force && time - fLastPeaksTime >= fPeaksInterval;
+
+    if (! (sendParameters || sendPeaks || force))
+        return;
+
+    const std::size_t pathSize = std::strlen(fControlData.path);
+
+    char parameterPath[pathSize+21];
+    std::strcpy(parameterPath, fControlData.path);
+    std::strcat(parameterPath, "/set_parameter_value");
+
+    char peaksPath[pathSize+11];
+    std::strcpy(peaksPath, fControlData.path);
+    std::strcat(peaksPath, "/set_peaks");
+
+    lo_bundle bundle = nullptr;
+    uint bundleSize  = 0;
+
+    // messages are owned by the bundle, paths must stay valid until it is freed
+    struct BundleSender {
+        static void flush(const lo_address target, lo_bundle& b, uint& size) noexcept
+        {
+            if (b == nullptr)
+                return;
+
+            try {
+                lo_send_bundle(target, b);
+            } CARLA_SAFE_EXCEPTION("lo_send_bundle");
+
+            lo_bundle_free_messages(b);
+            b    = nullptr;
+            size = 0;
+        }
+
+        static bool add(const lo_address target, lo_bundle& b, uint& size, const char* const path, const lo_message msg) noexcept
+        {
+            if (msg == nullptr)
+                return false;
+
+            if (b == nullptr)
+            {
+                b = lo_bundle_new(LO_TT_IMMEDIATE);
+
+                if (b == nullptr)
+                {
+                    lo_message_free(msg);
+                    return false;
+                }
+            }
+
+            lo_bundle_add_message(b, path, msg);
+
+            if (++size == kMaxMessagesPerBundle)
+                flush(target, b, size);
+
+            return true;
+        }
+    };
+
+    if (sendParameters)
+    {
+        fLastParameterTime = time;
+
+        for (uint i=0; i < fQueuedParameterCount; ++i)
+        {
+            const uint id = fQueuedParameterIds[i];
+            QueuedParameter& param(fQueuedParameters[id]);
+
+            param.queued = false;
+
+            // output parameters are queued on every tick, only send what changed
+            if (param.sent && carla_isEqual(param.value, param.sentValue))
+                continue;
+
+            const lo_message msg = lo_message_new();
+            CARLA_SAFE_ASSERT_CONTINUE(msg != nullptr);
+
+            lo_message_add_int32(msg, static_cast<int32_t>(id / kQueuedParametersPerPlugin));
+            lo_message_add_int32(msg, static_cast<int32_t>(id % kQueuedParametersPerPlugin) - kQueuedParameterOffset);
+            lo_message_add_float(msg, param.value);
+
+            if (! BundleSender::add(fControlData.target, bundle, bundleSize, parameterPath, msg))
+                continue;
+
+            param.sentValue = param.value;
+            param.sent      = true;
+        }
+
+        fQueuedParameterCount = 0;
+    }
+
+    if (sendPeaks)
+    {
+        fLastPeaksTime = time;
+
+        for (uint i=0; i < fQueueMaxPlugins; ++i)
+        {
+            QueuedPeaks& queuedPeaks(fQueuedPeaks[i]);
+
+            if (! queuedPeaks.queued)
+                continue;
+
+            queuedPeaks.queued = false;
+
+            // silent plugins only need their last zero peaks sent once
+            if (queuedPeaks.sent && std::memcmp(queuedPeaks.peaks, queuedPeaks.sentPeaks, sizeof(float)*4) == 0)
+                continue;
+
+            const lo_message msg = lo_message_new();
+            CARLA_SAFE_ASSERT_CONTINUE(msg != nullptr);
+
+            lo_message_add_int32(msg, static_cast<int32_t>(i));
+
+            for (uint j=0; j < 4; ++j)
+                lo_message_add_float(msg, queuedPeaks.peaks[j]);
+
+            if (! BundleSender::add(fControlData.target, bundle, bundleSize, peaksPath, msg))
+                continue;
+
+            carla_copyFloats(queuedPeaks.sentPeaks, queuedPeaks.peaks, 4);
+            queuedPeaks.sent = true;
+        }
+    }
+
+    BundleSender::flush(fControlData.target, bundle, bundleSize);
+
+    // forced sends come before plugins are added or removed, which changes their ids
+    if (force)
+    {
+        for (uint i=0, count=fQueueMaxPlugins*kQueuedParametersPerPlugin; i < count; ++i)
+            fQueuedParameters[i].sent = false;
+
+        for (uint i=0; i < fQueueMaxPlugins; ++i)
+            fQueuedPeaks[i].sent = false;
+    }
+}
+
+void CarlaEngineOsc::allocQueue(const uint maxPlugins) noexcept
+{
+    clearQueue();
+
+    const CarlaMutexLocker cml(fQueueMutex);
+
+    try {
+        fQueuedParameters   = new QueuedParameter[maxPlugins*kQueuedParametersPerPlugin];
+        fQueuedParameterIds = new uint[maxPlugins*kQueuedParametersPerPlugin];
+        fQueuedPeaks        = new QueuedPeaks[maxPlugins];
+    } CARLA_SAFE_EXCEPTION_RETURN("CarlaEngineOsc::allocQueue",);
+
+    carla_zeroStructs(fQueuedParameters, maxPlugins*kQueuedParametersPerPlugin);
+    carla_zeroStructs(fQueuedPeaks, maxPlugins);
+
+    fQueueMaxPlugins      = maxPlugins;
+    fQueuedParameterCount = 0;
+    fLastParameterTime    = 0;
+    fLastPeaksTime        = 0;
+}
+
+void CarlaEngineOsc::clearQueue() noexcept
+{
+    const CarlaMutexLocker cml(fQueueMutex);
+
+    fQueueMaxPlugins      = 0;
+    fQueuedParameterCount = 0;
+
+    if (fQueuedParameters != nullptr)
+    {
+        delete[] fQueuedParameters;
+        fQueuedParameters = nullptr;
+    }
+
+    if (fQueuedParameterIds != nullptr)
+    {
+        delete[] fQueuedParameterIds;
+        fQueuedParameterIds = nullptr;
+    }
+
+    if (fQueuedPeaks != nullptr)
+    {
+        delete[] fQueuedPeaks;
+        fQueuedPeaks = nullptr;
+    }
+}
+#endif
+
 // -----------------------------------------------------------------------
 
 int CarlaEngineOsc::handleMessage(const bool isTCP, const char* const path, const int argc, const lo_arg* const* const argv, const char* const types, const lo_message msg)
@@ -301,6 +578,8 @@ int CarlaEngineOsc::handleMessage(const bool isTCP, const char* const path, cons
         return 0; //handleMsgSetControlChannel(plugin, argc, argv, types); // TODO
     if (std::strcmp(method, "set_parameter_value") == 0)
         return handleMsgSetParameterValue(plugin, argc, argv, types);
+    if (std::strcmp(method, "set_parameter_values") == 0)
+        return handleMsgSetParameterValues(plugin, argc, argv, types);
     if (std::strcmp(method, "set_parameter_midi_cc") == 0)
         return handleMsgSetParameterMidiCC(plugin, argc, argv, types);
     if (std::strcmp(method, "set_parameter_midi_channel") == 0)
@@ -352,6 +631,9 @@ int CarlaEngineOsc::handleMsgRegister(const bool isTCP, const int argc, const lo
         fControlData.target = lo_address_new_with_proto(isTCP ? LO_TCP : LO_UDP, host, port);
     }
 
+    // nothing was sent to this client yet
+    allocQueue(fEngine->getMaxPluginNumber());
+
     for (uint i=0, count=fEngine->getCurrentPluginCount(); i < count; ++i)
     {
         CarlaPlugin* const plugin(fEngine->getPluginUnchecked(i));
@@ -373,6 +655,7 @@ int CarlaEngineOsc::handleMsgUnregister()
         return 1;
     }
 
+    clearQueue();
     fControlData.clear();
     return 0;
 }
@@ -459,6 +742,39 @@ int CarlaEngineOsc::handleMsgSetParameterValue(CARLA_ENGINE_OSC_HANDLE_ARGS)
     return 0;
 }
 
+int CarlaEngineOsc::handleMsgSetParameterValues(CARLA_ENGINE_OSC_HANDLE_ARGS)
+{
+    carla_debug("CarlaEngineOsc::handleMsgSetParameterValues()");
+
+    // bulk version of set_parameter_value, as "ifif..." index and value pairs
+    if (argc <= 0 || argc % 2 != 0 || types == nullptr)
+    {
+        carla_stderr("CarlaEngineOsc::%s() - invalid argument count: %i", __FUNCTION__, argc);
+        return 1;
+    }
+
+    for (int i=0; i < argc; i += 2)
+    {
+        if (types[i] != 'i' || types[i+1] != 'f')
+        {
+            carla_stderr("CarlaEngineOsc::%s() - argument types mismatch: '%s'", __FUNCTION__, types);
+            return 1;
+        }
+    }
+
+    for (int i=0; i < argc; i += 2)
+    {
+        const int32_t index = argv[i]->i;
+        const float   value = argv[i+1]->f;
+
+        CARLA_SAFE_ASSERT_CONTINUE(index >= 0);
+
+        plugin->setParameterValue(static_cast<uint32_t>(index), value, true, false, true);
+    }
+
+    return 0;
+}
+
 int CarlaEngineOsc::handleMsgSetParameterMidiCC(CARLA_ENGINE_OSC_HANDLE_ARGS)
 {
     carla_debug("CarlaEngineOsc::handleMsgSetParameterMidiCC()");
@@ -23,6 +23,7 @@
 #ifdef HAVE_LIBLO
 
 #include "CarlaBackend.h"
+#include "CarlaMutex.hpp"
 #include "CarlaOscUtils.hpp"
 #include "CarlaString.hpp"
 
@@ -89,6 +90,16 @@ public:
     {
         return &fControlData;
     }
+
+    // -------------------------------------------------------------------
+    // Parameter values and peaks for the control client are queued, last value wins,
+    // and sent as bundles at most at their configured rates.
+
+    void queueParameterValue(const uint pluginId, const int32_t index, const float value) noexcept;
+    void queuePeaks(const uint pluginId, const float peaks[4]) noexcept;
+
+    // called on every engine idle tick, or with force before messages that must keep their order
+    void sendQueuedMessages(const bool force) noexcept;
 #endif
 
     // -------------------------------------------------------------------
@@ -98,6 +109,34 @@ private:
 
 #ifndef BUILD_BRIDGE
     CarlaOscData fControlData; // for carla-control
+
+    struct QueuedParameter {
+        float value;
+        float sentValue;
+        bool  queued;
+        bool  sent;
+    };
+
+    struct QueuedPeaks {
+        float peaks[4];
+        float sentPeaks[4];
+        bool  queued;
+        bool  sent;
+    };
+
+    CarlaMutex fQueueMutex;
+    uint fQueueMaxPlugins;
+
+    QueuedParameter* fQueuedParameters;   // fQueueMaxPlugins * kQueuedParametersPerPlugin
+    uint*            fQueuedParameterIds; // indexes into fQueuedParameters, in queue order
+    uint             fQueuedParameterCount;
+    QueuedPeaks*     fQueuedPeaks;        // fQueueMaxPlugins
+
+    uint32_t fParameterInterval, fPeaksInterval; // in ms, 0 for every idle tick
+    uint32_t fLastParameterTime, fLastPeaksTime;
+
+    void allocQueue(const uint maxPlugins) noexcept;
+    void clearQueue() noexcept;
 #endif
 
     CarlaString fName;
@@ -124,6 +163,7 @@ private:
     int handleMsgSetBalanceRight(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgSetPanning(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgSetParameterValue(CARLA_ENGINE_OSC_HANDLE_ARGS);
+    int handleMsgSetParameterValues(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgSetParameterMidiCC(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgSetParameterMidiChannel(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgSetProgram(CARLA_ENGINE_OSC_HANDLE_ARGS);
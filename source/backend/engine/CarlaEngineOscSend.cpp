@@ -30,6 +30,10 @@ CARLA_BACKEND_START_NAMESPACE
 #ifndef BUILD_BRIDGE
 void CarlaEngine::oscSend_control_add_plugin_start(const uint pluginId, const char* const pluginName) const noexcept
 {
+    // plugins not added to the engine yet, see ProtectedData::loadingHiddenPlugins
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -37,6 +41,8 @@ void CarlaEngine::oscSend_control_add_plugin_start(const uint pluginId, const ch
     CARLA_SAFE_ASSERT_RETURN(pluginName != nullptr && pluginName[0] != '\0',);
     carla_debug("CarlaEngine::oscSend_control_add_plugin_start(%i, \"%s\")", pluginId, pluginName);
 
+    pData->osc.sendQueuedMessages(true);
+
     char targetPath[std::strlen(pData->oscData->path)+18];
     std::strcpy(targetPath, pData->oscData->path);
     std::strcat(targetPath, "/add_plugin_start");
@@ -45,12 +51,17 @@ void CarlaEngine::oscSend_control_add_plugin_start(const uint pluginId, const ch
 
 void CarlaEngine::oscSend_control_add_plugin_end(const uint pluginId) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pluginId <= pData->curPluginCount,);
     carla_debug("CarlaEngine::oscSend_control_add_plugin_end(%i)", pluginId);
 
+    pData->osc.sendQueuedMessages(true);
+
     char targetPath[std::strlen(pData->oscData->path)+16];
     std::strcpy(targetPath, pData->oscData->path);
     std::strcat(targetPath, "/add_plugin_end");
@@ -59,12 +70,18 @@ void CarlaEngine::oscSend_control_add_plugin_end(const uint pluginId) const noex
 
 void CarlaEngine::oscSend_control_remove_plugin(const uint pluginId) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pluginId <= pData->curPluginCount,);
     carla_debug("CarlaEngine::oscSend_control_remove_plugin(%i)", pluginId);
 
+    // plugin ids change after this, queued values must go first
+    pData->osc.sendQueuedMessages(true);
+
     char targetPath[std::strlen(pData->oscData->path)+15];
     std::strcpy(targetPath, pData->oscData->path);
     std::strcat(targetPath, "/remove_plugin");
@@ -73,6 +90,9 @@ void CarlaEngine::oscSend_control_remove_plugin(const uint pluginId) const noexc
 
 void CarlaEngine::oscSend_control_set_plugin_info1(const uint pluginId, const PluginType type, const PluginCategory category, const uint hints, const int64_t uniqueId) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -88,6 +108,9 @@ void CarlaEngine::oscSend_control_set_plugin_info1(const uint pluginId, const Pl
 
 void CarlaEngine::oscSend_control_set_plugin_info2(const uint pluginId, const char* const realName, const char* const label, const char* const maker, const char* const copyright) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -106,6 +129,9 @@ void CarlaEngine::oscSend_control_set_plugin_info2(const uint pluginId, const ch
 
 void CarlaEngine::oscSend_control_set_audio_count(const uint pluginId, const uint32_t ins, const uint32_t outs) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -120,6 +146,9 @@ void CarlaEngine::oscSend_control_set_audio_count(const uint pluginId, const uin
 
 void CarlaEngine::oscSend_control_set_midi_count(const uint pluginId, const uint32_t ins, const uint32_t outs) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -134,6 +163,9 @@ void CarlaEngine::oscSend_control_set_midi_count(const uint pluginId, const uint
 
 void CarlaEngine::oscSend_control_set_parameter_count(const uint pluginId, const uint32_t ins, const uint32_t outs) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -150,6 +182,9 @@ void CarlaEngine::oscSend_control_set_parameter_count(const uint pluginId, const
 
 void CarlaEngine::oscSend_control_set_program_count(const uint pluginId, const uint32_t count) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -165,6 +200,9 @@ void CarlaEngine::oscSend_control_set_program_count(const uint pluginId, const u
 
 void CarlaEngine::oscSend_control_set_midi_program_count(const uint pluginId, const uint32_t count) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -180,6 +218,9 @@ void CarlaEngine::oscSend_control_set_midi_program_count(const uint pluginId, co
 
 void CarlaEngine::oscSend_control_set_parameter_data(const uint pluginId, const uint32_t index, const ParameterType type, const uint hints, const char* const name, const char* const unit) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -197,6 +238,9 @@ void CarlaEngine::oscSend_control_set_parameter_data(const uint pluginId, const
 
 void CarlaEngine::oscSend_control_set_parameter_ranges1(const uint pluginId, const uint32_t index, const float def, const float min, const float max) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -214,6 +258,9 @@ void CarlaEngine::oscSend_control_set_parameter_ranges1(const uint pluginId, con
 
 void CarlaEngine::oscSend_control_set_parameter_ranges2(const uint pluginId, const uint32_t index, const float step, const float stepSmall, const float stepLarge) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -231,6 +278,9 @@ void CarlaEngine::oscSend_control_set_parameter_ranges2(const uint pluginId, con
 
 void CarlaEngine::oscSend_control_set_parameter_midi_cc(const uint pluginId, const uint32_t index, const int16_t cc) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -247,6 +297,9 @@ void CarlaEngine::oscSend_control_set_parameter_midi_cc(const uint pluginId, con
 
 void CarlaEngine::oscSend_control_set_parameter_midi_channel(const uint pluginId, const uint32_t index, const uint8_t channel) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -263,6 +316,9 @@ void CarlaEngine::oscSend_control_set_parameter_midi_channel(const uint pluginId
 
 void CarlaEngine::oscSend_control_set_parameter_value(const uint pluginId, const int32_t index, const float value) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -271,14 +327,14 @@ void CarlaEngine::oscSend_control_set_parameter_value(const uint pluginId, const
     CARLA_SAFE_ASSERT_RETURN(index != PARAMETER_NULL,);
     carla_debug("CarlaEngine::oscSend_control_set_parameter_value(%i, %i:%s, %f)", pluginId, index, (index < 0) ? InternalParameterIndex2Str(static_cast<InternalParameterIndex>(index)) : "(none)", value);
 
-    char targetPath[std::strlen(pData->oscData->path)+21];
-    std::strcpy(targetPath, pData->oscData->path);
-    std::strcat(targetPath, "/set_parameter_value");
-    try_lo_send(pData->oscData->target, targetPath, "iif", static_cast<int32_t>(pluginId), index, value);
+    pData->osc.queueParameterValue(pluginId, index, value);
 }
 
 void CarlaEngine::oscSend_control_set_default_value(const uint pluginId, const uint32_t index, const float value) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -294,6 +350,9 @@ void CarlaEngine::oscSend_control_set_default_value(const uint pluginId, const u
 
 void CarlaEngine::oscSend_control_set_current_program(const uint pluginId, const int32_t index) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -309,6 +368,9 @@ void CarlaEngine::oscSend_control_set_current_program(const uint pluginId, const
 
 void CarlaEngine::oscSend_control_set_current_midi_program(const uint pluginId, const int32_t index) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -324,6 +386,9 @@ void CarlaEngine::oscSend_control_set_current_midi_program(const uint pluginId,
 
 void CarlaEngine::oscSend_control_set_program_name(const uint pluginId, const uint32_t index, const char* const name) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -340,6 +405,9 @@ void CarlaEngine::oscSend_control_set_program_name(const uint pluginId, const ui
 
 void CarlaEngine::oscSend_control_set_midi_program_data(const uint pluginId, const uint32_t index, const uint32_t bank, const uint32_t program, const char* const name) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -356,6 +424,9 @@ void CarlaEngine::oscSend_control_set_midi_program_data(const uint pluginId, con
 
 void CarlaEngine::oscSend_control_note_on(const uint pluginId, const uint8_t channel, const uint8_t note, const uint8_t velo) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -373,6 +444,9 @@ void CarlaEngine::oscSend_control_note_on(const uint pluginId, const uint8_t cha
 
 void CarlaEngine::oscSend_control_note_off(const uint pluginId, const uint8_t channel, const uint8_t note) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
@@ -389,18 +463,23 @@ void CarlaEngine::oscSend_control_note_off(const uint pluginId, const uint8_t ch
 
 void CarlaEngine::oscSend_control_set_peaks(const uint pluginId) const noexcept
 {
+    if (pData->isHiddenPluginId(pluginId))
+        return;
+
     CARLA_SAFE_ASSERT_RETURN(pData->oscData != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->path != nullptr && pData->oscData->path[0] != '\0',);
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(pluginId < pData->curPluginCount,);
 
-    // TODO - try and see if we can get peaks[4] ref
     const EnginePluginData& epData(pData->plugins[pluginId]);
+    const float peaks[4] = { epData.insPeak[0], epData.insPeak[1], epData.outsPeak[0], epData.outsPeak[1] };
 
-    char targetPath[std::strlen(pData->oscData->path)+11];
-    std::strcpy(targetPath, pData->oscData->path);
-    std::strcat(targetPath, "/set_peaks");
-    try_lo_send(pData->oscData->target, targetPath, "iffff", static_cast<int32_t>(pluginId), epData.insPeak[0], epData.insPeak[1], epData.outsPeak[0], epData.outsPeak[1]);
+    pData->osc.queuePeaks(pluginId, peaks);
+}
+
+void CarlaEngine::oscSend_control_send_queued() const noexcept
+{
+    pData->osc.sendQueuedMessages(false);
 }
 
 void CarlaEngine::oscSend_control_exit() const noexcept
@@ -410,6 +489,8 @@ void CarlaEngine::oscSend_control_exit() const noexcept
     CARLA_SAFE_ASSERT_RETURN(pData->oscData->target != nullptr,);
     carla_debug("CarlaEngine::oscSend_control_exit()");
 
+    pData->osc.sendQueuedMessages(true);
+
     char targetPath[std::strlen(pData->oscData->path)+6];
     std::strcpy(targetPath, pData->oscData->path);
     std::strcat(targetPath, "/exit");
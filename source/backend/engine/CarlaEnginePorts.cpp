@@ -86,6 +86,7 @@ void CarlaEngineCVPort::initBuffer() noexcept
 CarlaEngineEventPort::CarlaEngineEventPort(const CarlaEngineClient& client, const bool isInputPort, const uint32_t indexOffset) noexcept
     : CarlaEnginePort(client, isInputPort, indexOffset),
       fBuffer(nullptr),
+      fProcessBuffer(nullptr),
       kProcessMode(client.getEngine().getProccessMode())
 {
     carla_debug("CarlaEngineEventPort::CarlaEngineEventPort(%s)", bool2str(isInputPort));
@@ -118,14 +119,15 @@ void CarlaEngineEventPort::initBuffer() noexcept
 uint32_t CarlaEngineEventPort::getEventCount() const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(kIsInput, 0);
-    CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
+    const EngineEvent* const buffer(fProcessBuffer != nullptr ? fProcessBuffer : fBuffer);
+    CARLA_SAFE_ASSERT_RETURN(buffer != nullptr, 0);
     CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, 0);
 
     uint32_t i=0;
 
     for (; i < kMaxEngineEventInternalCount; ++i)
     {
-        if (fBuffer[i].type == kEngineEventTypeNull)
+        if (buffer[i].type == kEngineEventTypeNull)
             break;
     }
 
@@ -135,16 +137,17 @@ uint32_t CarlaEngineEventPort::getEventCount() const noexcept
 const EngineEvent& CarlaEngineEventPort::getEvent(const uint32_t index) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(kIsInput, kFallbackEngineEvent);
-    CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, kFallbackEngineEvent);
+    const EngineEvent* const buffer(fProcessBuffer != nullptr ? fProcessBuffer : fBuffer);
+    CARLA_SAFE_ASSERT_RETURN(buffer != nullptr, kFallbackEngineEvent);
     CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, kFallbackEngineEvent);
     CARLA_SAFE_ASSERT_RETURN(index < kMaxEngineEventInternalCount, kFallbackEngineEvent);
 
-    return fBuffer[index];
+    return buffer[index];
 }
 
 const EngineEvent& CarlaEngineEventPort::getEventUnchecked(const uint32_t index) const noexcept
 {
-    return fBuffer[index];
+    return (fProcessBuffer != nullptr ? fProcessBuffer : fBuffer)[index];
 }
 
 bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t channel, const EngineControlEvent& ctrl) noexcept
@@ -155,7 +158,8 @@ bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t
 bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t channel, const EngineControlEventType type, const uint16_t param, const float value) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(! kIsInput, false);
-    CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, false);
+    EngineEvent* const buffer(fProcessBuffer != nullptr ? fProcessBuffer : fBuffer);
+    CARLA_SAFE_ASSERT_RETURN(buffer != nullptr, false);
     CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, false);
     CARLA_SAFE_ASSERT_RETURN(type != kEngineControlEventTypeNull, false);
     CARLA_SAFE_ASSERT_RETURN(channel < MAX_MIDI_CHANNELS, false);
@@ -167,7 +171,7 @@ bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t
 
     for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
     {
-        EngineEvent& event(fBuffer[i]);
+        EngineEvent& event(buffer[i]);
 
         if (event.type != kEngineEventTypeNull)
             continue;
@@ -183,7 +187,7 @@ bool CarlaEngineEventPort::writeControlEvent(const uint32_t time, const uint8_t
         return true;
     }
 
-    carla_stderr2("CarlaEngineEventPort::writeControlEvent() - buffer full");
+    carla_rt_stderr2("CarlaEngineEventPort::writeControlEvent() - buffer full");
     return false;
 }
 
@@ -201,7 +205,8 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
 bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t channel, const uint8_t size, const uint8_t* const data) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(! kIsInput, false);
-    CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, false);
+    EngineEvent* const buffer(fProcessBuffer != nullptr ? fProcessBuffer : fBuffer);
+    CARLA_SAFE_ASSERT_RETURN(buffer != nullptr, false);
     CARLA_SAFE_ASSERT_RETURN(kProcessMode != ENGINE_PROCESS_MODE_SINGLE_CLIENT && kProcessMode != ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, false);
     CARLA_SAFE_ASSERT_RETURN(channel < MAX_MIDI_CHANNELS, false);
     CARLA_SAFE_ASSERT_RETURN(size > 0 && size <= EngineMidiEvent::kDataSize, false);
@@ -209,7 +214,7 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
 
     for (uint32_t i=0; i < kMaxEngineEventInternalCount; ++i)
     {
-        EngineEvent& event(fBuffer[i]);
+        EngineEvent& event(buffer[i]);
 
         if (event.type != kEngineEventTypeNull)
             continue;
@@ -284,7 +289,7 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
         return true;
     }
 
-    carla_stderr2("CarlaEngineEventPort::writeMidiEvent() - buffer full");
+    carla_rt_stderr2("CarlaEngineEventPort::writeMidiEvent() - buffer full");
     return false;
 }
 
@@ -17,6 +17,7 @@
 
 #include "CarlaEngineGraph.hpp"
 #include "CarlaEngineInternal.hpp"
+#include "CarlaEngineMidiOutThread.hpp"
 #include "CarlaBackendUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaStringList.hpp"
@@ -153,7 +154,8 @@ static RtMidi::Api getMatchedAudioMidiAPI(const RtAudio::Api rtApi) noexcept
 // -------------------------------------------------------------------------------------------------------------------
 // RtAudio Engine
 
-class CarlaEngineRtAudio : public CarlaEngine
+class CarlaEngineRtAudio : public CarlaEngine,
+                           public CarlaEngineMidiOutThread::Callback
 {
 public:
     CarlaEngineRtAudio(const RtAudio::Api api)
@@ -163,6 +165,7 @@ public:
           fAudioInCount(0),
           fAudioOutCount(0),
           fLastEventTime(0),
+          fRtThreadReady(false),
           fDeviceName(),
           fAudioIntBufIn(),
           fAudioIntBufOut(),
@@ -170,10 +173,14 @@ public:
           fMidiInEvents(),
           fMidiOuts(),
           fMidiOutMutex(),
-          fMidiOutVector(3)
+          fMidiOutVector(3),
+          fMidiOutThread(this)
     {
         carla_debug("CarlaEngineRtAudio::CarlaEngineRtAudio(%i)", api);
 
+        // so sending never allocates
+        fMidiOutVector.reserve(0xff);
+
         // just to make sure
         pData->options.transportMode = ENGINE_TRANSPORT_MODE_INTERNAL;
     }
@@ -287,12 +294,15 @@ public:
         fAudioInCount  = iParams.nChannels;
         fAudioOutCount = oParams.nChannels;
         fLastEventTime = 0;
+        __atomic_store_n(&fRtThreadReady, false, __ATOMIC_RELEASE);
 
         fAudioIntBufIn.setSize(static_cast<int>(fAudioInCount), static_cast<int>(bufferFrames));
         fAudioIntBufOut.setSize(static_cast<int>(fAudioOutCount), static_cast<int>(bufferFrames));
 
         pData->graph.create(fAudioInCount, fAudioOutCount);
 
+        fMidiOutThread.start();
+
         try {
             fAudio.startStream();
         }
@@ -337,6 +347,8 @@ public:
 
         pData->graph.destroy();
 
+        fMidiOutThread.stop();
+
         for (LinkedList<MidiInPort>::Itenerator it = fMidiIns.begin2(); it.valid(); it.next())
         {
             static MidiInPort fallback = { nullptr, { '\0' } };
@@ -400,6 +412,11 @@ public:
         return CarlaBackend::getRtAudioApiName(fAudio.getCurrentApi());
     }
 
+    uint32_t getMidiOutJitter() const noexcept override
+    {
+        return fMidiOutThread.getJitter();
+    }
+
     // -------------------------------------------------------------------
     // Patchbay
 
@@ -553,6 +570,12 @@ public:
 protected:
     void handleAudioProcessCallback(void* outputBuffer, void* inputBuffer, uint nframes, double streamTime, RtAudioStreamStatus status)
     {
+        if (! __atomic_load_n(&fRtThreadReady, __ATOMIC_ACQUIRE))
+        {
+            pData->initRtThread();
+            __atomic_store_n(&fRtThreadReady, true, __ATOMIC_RELEASE);
+        }
+
         const PendingRtEventsRunner prt(this, nframes);
 
         // get buffers from RtAudio
@@ -622,7 +645,7 @@ protected:
                 }
                 else if (midiEvent.time >= pData->timeInfo.frame + nframes)
                 {
-                    carla_stderr("MIDI Event in the future!, %i vs %i", engineEvent.time, pData->timeInfo.frame);
+                    carla_rt_stderr("MIDI Event in the future!, %i vs %i", engineEvent.time, pData->timeInfo.frame);
                     engineEvent.time = static_cast<uint32_t>(pData->timeInfo.frame) + nframes - 1;
                 }
                 else
@@ -640,61 +663,47 @@ protected:
 
         pData->graph.process(pData, inBuf, outBuf, nframes);
 
-        fMidiOutMutex.lock();
+        // sent later by the MIDI thread, at the time matching each event frame
+        fMidiOutThread.beginCycle(nframes, pData->sampleRate);
 
-        if (fMidiOuts.count() > 0)
-        {
-            uint8_t        size    = 0;
-            uint8_t        data[3] = { 0, 0, 0 };
-            const uint8_t* dataPtr = data;
+        uint8_t        size    = 0;
+        uint8_t        data[3] = { 0, 0, 0 };
+        const uint8_t* dataPtr = data;
 
-            for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
-            {
-                const EngineEvent& engineEvent(pData->events.out[i]);
+        for (ushort i=0; i < kMaxEngineEventInternalCount; ++i)
+        {
+            const EngineEvent& engineEvent(pData->events.out[i]);
 
-                if (engineEvent.type == kEngineEventTypeNull)
-                    break;
+            if (engineEvent.type == kEngineEventTypeNull)
+                break;
 
-                else if (engineEvent.type == kEngineEventTypeControl)
-                {
-                    const EngineControlEvent& ctrlEvent(engineEvent.ctrl);
-                    ctrlEvent.convertToMidiData(engineEvent.channel, size, data);
-                    dataPtr = data;
-                }
-                else if (engineEvent.type == kEngineEventTypeMidi)
-                {
-                    const EngineMidiEvent& midiEvent(engineEvent.midi);
+            else if (engineEvent.type == kEngineEventTypeControl)
+            {
+                const EngineControlEvent& ctrlEvent(engineEvent.ctrl);
+                ctrlEvent.convertToMidiData(engineEvent.channel, size, data);
+                dataPtr = data;
+            }
+            else if (engineEvent.type == kEngineEventTypeMidi)
+            {
+                const EngineMidiEvent& midiEvent(engineEvent.midi);
 
-                    size = midiEvent.size;
+                size = midiEvent.size;
 
-                    if (size > EngineMidiEvent::kDataSize && midiEvent.dataExt != nullptr)
-                        dataPtr = midiEvent.dataExt;
-                    else
-                        dataPtr = midiEvent.data;
-                }
+                if (size > EngineMidiEvent::kDataSize && midiEvent.dataExt != nullptr)
+                    dataPtr = midiEvent.dataExt;
                 else
-                {
-                    continue;
-                }
-
-                if (size > 0)
-                {
-                    fMidiOutVector.assign(dataPtr, dataPtr + size);
-
-                    for (LinkedList<MidiOutPort>::Itenerator it=fMidiOuts.begin2(); it.valid(); it.next())
-                    {
-                        static MidiOutPort fallback = { nullptr, { '\0' } };
-
-                        MidiOutPort& outPort(it.getValue(fallback));
-                        CARLA_SAFE_ASSERT_CONTINUE(outPort.port != nullptr);
-
-                        outPort.port->sendMessage(&fMidiOutVector);
-                    }
-                }
+                    dataPtr = midiEvent.data;
+            }
+            else
+            {
+                continue;
             }
+
+            if (size > 0)
+                fMidiOutThread.writeEvent(engineEvent.time, dataPtr, size);
         }
 
-        fMidiOutMutex.unlock();
+        fMidiOutThread.endCycle();
 
         if (fAudioInterleaved)
         {
@@ -740,6 +749,26 @@ protected:
         fMidiInEvents.append(midiEvent);
     }
 
+    void midiOutThreadSend(const uint8_t* const data, const uint8_t size) override
+    {
+        const CarlaMutexLocker cml(fMidiOutMutex);
+
+        if (fMidiOuts.count() == 0)
+            return;
+
+        fMidiOutVector.assign(data, data + size);
+
+        for (LinkedList<MidiOutPort>::Itenerator it=fMidiOuts.begin2(); it.valid(); it.next())
+        {
+            static MidiOutPort fallback = { nullptr, { '\0' } };
+
+            MidiOutPort& outPort(it.getValue(fallback));
+            CARLA_SAFE_ASSERT_CONTINUE(outPort.port != nullptr);
+
+            outPort.port->sendMessage(&fMidiOutVector);
+        }
+    }
+
     // -------------------------------------------------------------------
 
     bool connectExternalGraphPort(const uint connectionType, const uint portId, const char* const portName) override
@@ -922,6 +951,9 @@ private:
     uint fAudioOutCount;
     uint64_t fLastEventTime;
 
+    // audio thread has been setup
+    bool fRtThreadReady; // atomic, the audio thread was set up
+
     // current device name
     CarlaString fDeviceName;
 
@@ -987,9 +1019,10 @@ private:
     LinkedList<MidiInPort> fMidiIns;
     RtMidiEvents           fMidiInEvents;
 
-    LinkedList<MidiOutPort> fMidiOuts;
-    CarlaMutex              fMidiOutMutex;
-    std::vector<uint8_t>    fMidiOutVector;
+    LinkedList<MidiOutPort>  fMidiOuts;
+    CarlaMutex               fMidiOutMutex;
+    std::vector<uint8_t>     fMidiOutVector;
+    CarlaEngineMidiOutThread fMidiOutThread;
 
     #define handlePtr ((CarlaEngineRtAudio*)userData)
 
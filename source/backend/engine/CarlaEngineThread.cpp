@@ -19,13 +19,56 @@
 #include "CarlaEngineThread.hpp"
 #include "CarlaPlugin.hpp"
 
+#include "CarlaRtLogUtils.hpp"
+
+#ifdef CARLA_OS_WIN
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
 
+static const uint kTickTimeMs = 25;
+
+// output parameters of plugins without a custom UI are only sent every few ticks
+static const uint kSlowIdleTicks = 4;
+
+// ticks per average of getAverageTickTime(), about 1 second
+static const uint kTickTimeAverageCount = 1000 / kTickTimeMs;
+
+// CPU time used by the calling thread, in microseconds
+static uint64_t getThreadCpuTime() noexcept
+{
+#if defined(CARLA_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+
+    if (! ::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    const uint64_t kernel100ns = (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t user100ns   = (static_cast<uint64_t>(user.dwHighDateTime)   << 32) | user.dwLowDateTime;
+    return (kernel100ns + user100ns) / 10;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec t;
+
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t) != 0)
+        return 0;
+
+    return static_cast<uint64_t>(t.tv_sec) * 1000000 + static_cast<uint64_t>(t.tv_nsec) / 1000;
+#else
+    return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------
+
 CarlaEngineThread::CarlaEngineThread(CarlaEngine* const engine) noexcept
     : CarlaThread("CarlaEngineThread"),
-      kEngine(engine)
+      kEngine(engine),
+      fAverageTickTime(0)
 {
     CARLA_SAFE_ASSERT(engine != nullptr);
     carla_debug("CarlaEngineThread::CarlaEngineThread(%p)", engine);
@@ -36,6 +79,11 @@ CarlaEngineThread::~CarlaEngineThread() noexcept
     carla_debug("CarlaEngineThread::~CarlaEngineThread()");
 }
 
+uint32_t CarlaEngineThread::getAverageTickTime() const noexcept
+{
+    return __atomic_load_n(&fAverageTickTime, __ATOMIC_RELAXED);
+}
+
 // -----------------------------------------------------------------------
 
 void CarlaEngineThread::run() noexcept
@@ -50,13 +98,22 @@ void CarlaEngineThread::run() noexcept
     const bool isPlugin(kEngine->getType() == kEngineTypePlugin);
 #endif
     float value;
+    uint tick = 0;
+    uint64_t tickTimeSum = 0;
+
+    __atomic_store_n(&fAverageTickTime, 0, __ATOMIC_RELAXED);
+
+    // print messages from the audio thread(s) from here, see CarlaRtLogUtils.hpp
+    CarlaRtLog::addFlusher();
 
 #ifdef BUILD_BRIDGE
-    for (; /*kEngine->isRunning() &&*/ ! shouldThreadExit();)
+    for (; /*kEngine->isRunning() &&*/ ! shouldThreadExit(); ++tick)
 #else
-    for (; kEngine->isRunning() && ! shouldThreadExit();)
+    for (; kEngine->isRunning() && ! shouldThreadExit(); ++tick)
 #endif
     {
+        const uint64_t tickStartTime(getThreadCpuTime());
+
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
         const bool oscRegisted = kEngine->isOscControlRegistered();
 #else
@@ -76,7 +133,11 @@ void CarlaEngineThread::run() noexcept
             CARLA_SAFE_ASSERT_UINT2(i == plugin->getId(), i, plugin->getId());
 
             const uint hints(plugin->getHints());
-            const bool updateUI((hints & PLUGIN_HAS_CUSTOM_UI) != 0 && (hints & PLUGIN_NEEDS_UI_MAIN_THREAD) == 0);
+            const bool hasUI((hints & PLUGIN_HAS_CUSTOM_UI) != 0);
+            const bool updateUI(hasUI && (hints & PLUGIN_NEEDS_UI_MAIN_THREAD) == 0);
+
+            // spread the slow plugins over different ticks, changes are kept until sent
+            const bool sendOutputs(updateUI || (oscRegisted && (hasUI || (tick + i) % kSlowIdleTicks == 0)));
 
             // -----------------------------------------------------------
             // DSP Idle
@@ -85,19 +146,23 @@ void CarlaEngineThread::run() noexcept
                 plugin->idle();
             } CARLA_SAFE_EXCEPTION("idle()")
 
+#ifndef BUILD_BRIDGE
+            // -----------------------------------------------------------
+            // Delay compensation, latency might have changed during idle or reload
+
+            kEngine->updatePluginLatency(plugin);
+#endif
+
             // -----------------------------------------------------------
             // Post-poned events
 
-            if (oscRegisted || updateUI)
+            if (sendOutputs)
             {
                 // -------------------------------------------------------
-                // Update parameter outputs
+                // Update parameter outputs changed since they were last sent
 
-                for (uint32_t j=0, pcount=plugin->getParameterCount(); j < pcount; ++j)
+                for (uint32_t j=0; plugin->takeNextChangedOutputParameter(j); ++j)
                 {
-                    if (! plugin->isParameterOutput(j))
-                        continue;
-
                     value = plugin->getParameterValue(j);
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
@@ -127,8 +192,46 @@ void CarlaEngineThread::run() noexcept
 #endif
         }
 
-        carla_msleep(25);
+#if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
+        // ---------------------------------------------------------------
+        // Send OSC control client updates of this tick as bundles
+
+        if (oscRegisted)
+            kEngine->oscSend_control_send_queued();
+#endif
+
+#ifndef BUILD_BRIDGE
+        // ---------------------------------------------------------------
+        // Report graph latency changes
+
+        kEngine->updateTotalLatency();
+
+        // ---------------------------------------------------------------
+        // Degrade or restore expendable plugins
+
+        kEngine->updateOverload();
+#endif
+
+        // ---------------------------------------------------------------
+        // Measure CPU time of this tick
+
+        tickTimeSum += getThreadCpuTime() - tickStartTime;
+
+        if ((tick + 1) % kTickTimeAverageCount == 0)
+        {
+            __atomic_store_n(&fAverageTickTime, static_cast<uint32_t>(tickTimeSum / kTickTimeAverageCount), __ATOMIC_RELAXED);
+            tickTimeSum = 0;
+        }
+
+        // ---------------------------------------------------------------
+        // Print queued RT log messages
+
+        CarlaRtLog::flush();
+
+        carla_msleep(kTickTimeMs);
     }
+
+    CarlaRtLog::removeFlusher();
 }
 
 // -----------------------------------------------------------------------
@@ -32,11 +32,15 @@ public:
     CarlaEngineThread(CarlaEngine* const engine) noexcept;
     ~CarlaEngineThread() noexcept override;
 
+    // CPU time used per tick, in microseconds, averaged over the last second
+    uint32_t getAverageTickTime() const noexcept;
+
 protected:
     void run() noexcept override;
 
 private:
     CarlaEngine* const kEngine;
+    uint32_t fAverageTickTime;
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineThread)
 };
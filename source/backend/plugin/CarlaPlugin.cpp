@@ -20,6 +20,7 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
+#include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaPluginUI.hpp"
 
@@ -165,6 +166,12 @@ uint32_t CarlaPlugin::getLatencyInFrames() const noexcept
     return 0;
 }
 
+uint32_t CarlaPlugin::getProcessLatencyInFrames() const noexcept
+{
+    // plugin latency is reported at its own sample rate
+    return getLatencyInFrames() / pData->oversample.factor + pData->oversample.getLatency() + pData->reblock.getLatency();
+}
+
 // -------------------------------------------------------------------
 // Information (count)
 
@@ -255,6 +262,11 @@ bool CarlaPlugin::isParameterOutput(const uint32_t parameterId) const noexcept
     return (pData->param.data[parameterId].type == PARAMETER_OUTPUT);
 }
 
+bool CarlaPlugin::takeNextChangedOutputParameter(uint32_t& parameterId) noexcept
+{
+    return pData->param.takeNextChangedOutput(parameterId);
+}
+
 const MidiProgramData& CarlaPlugin::getMidiProgramData(const uint32_t index) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(index < pData->midiprog.count, kMidiProgramDataNull);
@@ -475,12 +487,16 @@ void CarlaPlugin::randomizeParameters() noexcept
     }
 }
 
-const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
+const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave, const bool encodeChunk, const bool reuseUnchanged)
 {
     if (callPrepareForSave)
         prepareForSave();
 
+    if (reuseUnchanged && ! isStateSaveOutdated())
+        return pData->stateSave;
+
     pData->stateSave.clear();
+    pData->stateSaveChanges = pData->stateChanges;
 
     const PluginType pluginType(getType());
 
@@ -527,7 +543,15 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
 
         if (data != nullptr && dataSize > 0)
         {
-            pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
+            if (encodeChunk)
+            {
+                pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
+            }
+            else
+            {
+                pData->stateSave.rawChunk     = data;
+                pData->stateSave.rawChunkSize = dataSize;
+            }
 
             if (pluginType != PLUGIN_INTERNAL)
                 usingChunk = true;
@@ -590,6 +614,13 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
         {
             stateParameter->value = getParameterValue(i);
 
+#ifndef BUILD_BRIDGE
+            // save the value from before an overload degradation, unless changed since
+            if (pData->degrade.polyphonyParam == static_cast<int32_t>(i) &&
+                carla_isEqual(stateParameter->value, pData->degrade.polyphonyLowered))
+                stateParameter->value = pData->degrade.polyphonyValue;
+#endif
+
             if (paramData.hints & PARAMETER_USES_SAMPLERATE)
                 stateParameter->value /= sampleRate;
         }
@@ -617,6 +648,22 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
     return pData->stateSave;
 }
 
+void CarlaPlugin::clearStateSaveRawChunk() noexcept
+{
+    // points into plugin memory, which might be gone or changed by now
+    pData->stateSave.rawChunk     = nullptr;
+    pData->stateSave.rawChunkSize = 0;
+}
+
+bool CarlaPlugin::isStateSaveOutdated() const noexcept
+{
+    // chunks can change without the host being told
+    if (pData->options & PLUGIN_OPTION_USE_CHUNKS)
+        return true;
+
+    return pData->stateChanges != pData->stateSaveChanges;
+}
+
 void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
 {
     char strBuf[STR_MAX+1];
@@ -833,7 +880,11 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
     // ---------------------------------------------------------------
     // Part 6 - set chunk
 
-    if (stateSave.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+    if (stateSave.rawChunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+    {
+        setChunkData(stateSave.rawChunk, stateSave.rawChunkSize);
+    }
+    else if (stateSave.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
     {
         std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateSave.chunk));
         setChunkData(chunk.data(), chunk.size());
@@ -934,6 +985,7 @@ void CarlaPlugin::setName(const char* const newName)
         delete[] pData->name;
 
     pData->name = carla_strdup(newName);
+    ++pData->stateChanges;
 }
 
 void CarlaPlugin::setOption(const uint option, const bool yesNo, const bool sendCallback)
@@ -945,6 +997,8 @@ void CarlaPlugin::setOption(const uint option, const bool yesNo, const bool send
     else
         pData->options &= ~option;
 
+    ++pData->stateChanges;
+
 #ifndef BUILD_BRIDGE
     if (sendCallback)
         pData->engine->callback(ENGINE_CALLBACK_OPTION_CHANGED, pData->id, static_cast<int>(option), yesNo ? 1 : 0, 0.0f, nullptr);
@@ -984,9 +1038,16 @@ void CarlaPlugin::setActive(const bool active, const bool sendOsc, const bool se
             activate();
         else
             deactivate();
+
+#ifndef BUILD_BRIDGE
+        // start at the current values, no ramps from before the plugin was active
+        if (active)
+            pData->postProc.resetRamps();
+#endif
     }
 
     pData->active = active;
+    ++pData->stateChanges;
 
 #ifndef BUILD_BRIDGE
     const float value(active ? 1.0f : 0.0f);
@@ -1015,6 +1076,7 @@ void CarlaPlugin::setDryWet(const float value, const bool sendOsc, const bool se
         return;
 
     pData->postProc.dryWet = fixedValue;
+    ++pData->stateChanges;
 
 #ifdef HAVE_LIBLO
     if (sendOsc && pData->engine->isOscControlRegistered())
@@ -1038,6 +1100,7 @@ void CarlaPlugin::setVolume(const float value, const bool sendOsc, const bool se
         return;
 
     pData->postProc.volume = fixedValue;
+    ++pData->stateChanges;
 
 #ifdef HAVE_LIBLO
     if (sendOsc && pData->engine->isOscControlRegistered())
@@ -1061,6 +1124,7 @@ void CarlaPlugin::setBalanceLeft(const float value, const bool sendOsc, const bo
         return;
 
     pData->postProc.balanceLeft = fixedValue;
+    ++pData->stateChanges;
 
 #ifdef HAVE_LIBLO
     if (sendOsc && pData->engine->isOscControlRegistered())
@@ -1084,6 +1148,7 @@ void CarlaPlugin::setBalanceRight(const float value, const bool sendOsc, const b
         return;
 
     pData->postProc.balanceRight = fixedValue;
+    ++pData->stateChanges;
 
 #ifdef HAVE_LIBLO
     if (sendOsc && pData->engine->isOscControlRegistered())
@@ -1107,6 +1172,7 @@ void CarlaPlugin::setPanning(const float value, const bool sendOsc, const bool s
         return;
 
     pData->postProc.panning = fixedValue;
+    ++pData->stateChanges;
 
 #ifdef HAVE_LIBLO
     if (sendOsc && pData->engine->isOscControlRegistered())
@@ -1132,6 +1198,7 @@ void CarlaPlugin::setCtrlChannel(const int8_t channel, const bool sendOsc, const
         return;
 
     pData->ctrlChannel = channel;
+    ++pData->stateChanges;
 
 #ifndef BUILD_BRIDGE
     const float channelf(channel);
@@ -1156,6 +1223,9 @@ void CarlaPlugin::setParameterValue(const uint32_t parameterId, const float valu
 {
     CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
 
+    if (pData->param.data[parameterId].type == PARAMETER_INPUT)
+        ++pData->stateChanges;
+
     if (sendGui && (pData->hints & PLUGIN_HAS_CUSTOM_UI) != 0)
         uiParameterChange(parameterId, value);
 
@@ -1216,6 +1286,8 @@ void CarlaPlugin::setParameterMidiChannel(const uint32_t parameterId, const uint
     CARLA_SAFE_ASSERT_RETURN(channel < MAX_MIDI_CHANNELS,);
 
     pData->param.data[parameterId].midiChannel = channel;
+    pData->param.midiCCMappingChanged();
+    ++pData->stateChanges;
 
 #ifndef BUILD_BRIDGE
 # ifdef HAVE_LIBLO
@@ -1240,6 +1312,8 @@ void CarlaPlugin::setParameterMidiCC(const uint32_t parameterId, const int16_t c
     CARLA_SAFE_ASSERT_RETURN(cc >= -1 && cc < MAX_MIDI_CONTROL,);
 
     pData->param.data[parameterId].midiCC = cc;
+    pData->param.midiCCMappingChanged();
+    ++pData->stateChanges;
 
 #ifndef BUILD_BRIDGE
 # ifdef HAVE_LIBLO
@@ -1268,6 +1342,8 @@ void CarlaPlugin::setCustomData(const char* const type, const char* const key, c
             return;
     }
 
+    ++pData->stateChanges;
+
     // Check if we already have this key
     for (LinkedList<CustomData>::Itenerator it = pData->custom.begin2(); it.valid(); it.next())
     {
@@ -1304,6 +1380,7 @@ void CarlaPlugin::setProgram(const int32_t index, const bool sendGui, const bool
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->prog.count),);
 
     pData->prog.current = index;
+    ++pData->stateChanges;
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     const bool reallySendOsc(sendOsc && pData->engine->isOscControlRegistered());
@@ -1338,6 +1415,7 @@ void CarlaPlugin::setMidiProgram(const int32_t index, const bool sendGui, const
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->midiprog.count),);
 
     pData->midiprog.current = index;
+    ++pData->stateChanges;
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     const bool reallySendOsc(sendOsc && pData->engine->isOscControlRegistered());
@@ -1407,6 +1485,753 @@ void CarlaPlugin::offlineModeChanged(const bool)
 {
 }
 
+#ifndef BUILD_BRIDGE
+// -------------------------------------------------------------------
+// Silence detection
+
+// -120dB, anything below this is treated as digital silence
+static const float kSilenceThreshold = 0.000001f;
+
+static inline
+bool isAudioSilent(const float* const* const buffers, const uint32_t count, const uint32_t frames) noexcept
+{
+    if (buffers == nullptr)
+        return true;
+
+    for (uint32_t i=0; i < count; ++i)
+    {
+        const float* const buffer(buffers[i]);
+
+        if (buffer == nullptr)
+            continue;
+
+        for (uint32_t j=0; j < frames; ++j)
+        {
+            if (std::abs(buffer[j]) > kSilenceThreshold)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool CarlaPlugin::checkSleep(const float* const* const audioIn, const uint32_t frames) noexcept
+{
+    ProtectedData::Silence& silence(pData->silence);
+
+    if ((pData->options & PLUGIN_OPTION_SLEEP_WHEN_SILENT) == 0 || ! pData->active)
+    {
+        if (silence.frames != 0 || silence.sleeping)
+            silence.reset();
+        return false;
+    }
+
+    silence.inputSilent = (! pData->needsReset) &&
+                          (pData->extNotes.data.isEmpty()) &&
+                          (pData->event.portIn == nullptr || pData->event.portIn->getEventCount() == 0) &&
+                          isAudioSilent(audioIn, pData->audioIn.count, frames);
+
+    if (! silence.inputSilent)
+    {
+        silence.sleeping = false;
+        silence.frames   = 0;
+        return false;
+    }
+
+    return silence.sleeping;
+}
+
+void CarlaPlugin::updateSleep(const float* const* const audioOut, const uint32_t frames) noexcept
+{
+    ProtectedData::Silence& silence(pData->silence);
+
+    const bool outputHint(silence.outputHint);
+    silence.outputHint = false;
+
+    if ((pData->options & PLUGIN_OPTION_SLEEP_WHEN_SILENT) == 0 || silence.sleeping)
+        return;
+
+    if (! silence.inputSilent || ! (outputHint || isAudioSilent(audioOut, pData->audioOut.count, frames)))
+    {
+        silence.frames = 0;
+        return;
+    }
+
+    // include plugin latency, so delayed output is never cut off
+    const double   sampleRate(pData->engine->getSampleRate());
+    const uint32_t tailTime(pData->engine->getOptions().silenceTailTime);
+    const uint32_t tailFrames(static_cast<uint32_t>(sampleRate * tailTime / 1000.0) + pData->latency.frames);
+
+    silence.frames += frames;
+
+    if (silence.frames >= tailFrames)
+        silence.sleeping = true;
+}
+
+bool CarlaPlugin::isSleeping() const noexcept
+{
+    return pData->silence.sleeping;
+}
+
+// -------------------------------------------------------------------
+// Overload degradation
+
+// analysis plugins are processed once every this many cycles while at a reduced rate
+static const uint32_t kDegradeRateDivider = 4;
+
+static bool isPolyphonyParameterName(const char* const name)
+{
+    CarlaString lowerName(name);
+    lowerName.toLower();
+
+    return (lowerName == "polyphony" || lowerName == "max polyphony" ||
+            lowerName == "voices"    || lowerName == "max voices"    || lowerName == "number of voices");
+}
+
+// index of a parameter known to set the plugin polyphony, which can still be lowered. -1 if none
+static int32_t findPolyphonyParameter(const CarlaPlugin* const plugin)
+{
+    char strBuf[STR_MAX+1];
+
+    for (uint32_t i=0, count=plugin->getParameterCount(); i < count; ++i)
+    {
+        const ParameterData& paramData(plugin->getParameterData(i));
+
+        if (paramData.type != PARAMETER_INPUT || (paramData.hints & PARAMETER_IS_ENABLED) == 0)
+            continue;
+
+        carla_zeroChars(strBuf, STR_MAX+1);
+        plugin->getParameterName(i, strBuf);
+
+        if (! isPolyphonyParameterName(strBuf))
+            continue;
+
+        const float value(plugin->getParameterValue(i));
+
+        if (value >= 2.0f && value > plugin->getParameterRanges(i).min)
+            return static_cast<int32_t>(i);
+    }
+
+    return -1;
+}
+
+void CarlaPlugin::processFromEngine(const float** const audioIn, float** const audioOut, const uint32_t frames)
+{
+    ProtectedData::Degrade& degrade(pData->degrade);
+
+    if (degrade.bypassed)
+    {
+        if (audioOut == nullptr)
+            return;
+
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        {
+            const uint32_t c = (pData->audioIn.count == 1) ? 0 : i;
+
+            if (audioIn == nullptr || c >= pData->audioIn.count)
+                FloatVectorOperations::clear(audioOut[i], static_cast<int>(frames));
+            else if (audioOut[i] != audioIn[c])
+                FloatVectorOperations::copy(audioOut[i], audioIn[c], static_cast<int>(frames));
+        }
+        return;
+    }
+
+    if (degrade.reducedRate)
+    {
+        if (degrade.skipCycles > 0)
+        {
+            --degrade.skipCycles;
+            return;
+        }
+
+        degrade.skipCycles = kDegradeRateDivider - 1;
+    }
+
+    const int64_t startTicks(juce::Time::getHighResolutionTicks());
+
+    processReblocked(audioIn, audioOut, frames);
+
+    __atomic_add_fetch(&degrade.processTicks, static_cast<uint64_t>(juce::Time::getHighResolutionTicks() - startTicks), __ATOMIC_RELAXED);
+    __atomic_add_fetch(&degrade.processFrames, frames, __ATOMIC_RELAXED);
+}
+
+float CarlaPlugin::updateProcessLoad() noexcept
+{
+    ProtectedData::Degrade& degrade(pData->degrade);
+
+    const uint64_t ticks(__atomic_exchange_n(&degrade.processTicks, 0, __ATOMIC_RELAXED));
+    const uint32_t frames(__atomic_exchange_n(&degrade.processFrames, 0, __ATOMIC_RELAXED));
+
+    if (frames == 0)
+        return degrade.load;
+
+    const double processTime(static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+    const double audioTime(static_cast<double>(frames) / pData->engine->getSampleRate());
+    const float load(static_cast<float>(processTime / audioTime * 100.0));
+
+    degrade.load += (load - degrade.load) * 0.25f;
+    return degrade.load;
+}
+
+PluginDegradation CarlaPlugin::getDegradation() const noexcept
+{
+    const ProtectedData::Degrade& degrade(pData->degrade);
+
+    if (degrade.bypassed)
+        return PLUGIN_DEGRADATION_BYPASSED;
+    if (degrade.reducedRate)
+        return PLUGIN_DEGRADATION_REDUCED_RATE;
+    if (degrade.polyphonyParam >= 0)
+        return PLUGIN_DEGRADATION_REDUCED_POLYPHONY;
+
+    return PLUGIN_DEGRADATION_NONE;
+}
+
+PluginDegradation CarlaPlugin::getNextDegradation() const noexcept
+{
+    switch (getDegradation())
+    {
+    case PLUGIN_DEGRADATION_BYPASSED:
+        return PLUGIN_DEGRADATION_NONE;
+    case PLUGIN_DEGRADATION_REDUCED_RATE:
+    case PLUGIN_DEGRADATION_REDUCED_POLYPHONY:
+        return PLUGIN_DEGRADATION_BYPASSED;
+    case PLUGIN_DEGRADATION_NONE:
+        break;
+    }
+
+    // analysis plugins, nothing depends on their processing but meters and UIs
+    if (pData->audioIn.count > 0 && pData->audioOut.count == 0 && pData->cvOut.count == 0 && getMidiOutCount() == 0)
+        return PLUGIN_DEGRADATION_REDUCED_RATE;
+
+    if (findPolyphonyParameter(this) >= 0)
+        return PLUGIN_DEGRADATION_REDUCED_POLYPHONY;
+
+    return PLUGIN_DEGRADATION_BYPASSED;
+}
+
+void CarlaPlugin::setDegradedParameterValue(const uint32_t parameterId, const float value) noexcept
+{
+    // called from the engine thread, UIs that need the main thread get the change from uiIdle()
+    setParameterValue(parameterId, value, false, true, true);
+
+    if ((pData->hints & PLUGIN_HAS_CUSTOM_UI) == 0)
+        return;
+
+    if (pData->hints & PLUGIN_NEEDS_UI_MAIN_THREAD)
+    {
+        const PluginPostRtEvent event = { kPluginPostRtEventParameterChange, static_cast<int32_t>(parameterId), 1, value };
+        pData->postUiEvents.append(event);
+    }
+    else
+    {
+        uiParameterChange(parameterId, value);
+    }
+}
+
+bool CarlaPlugin::degrade()
+{
+    ProtectedData::Degrade& degrade(pData->degrade);
+
+    switch (getNextDegradation())
+    {
+    case PLUGIN_DEGRADATION_NONE:
+        return false;
+
+    case PLUGIN_DEGRADATION_REDUCED_RATE:
+        degrade.skipCycles  = 0;
+        degrade.reducedRate = true;
+        return true;
+
+    case PLUGIN_DEGRADATION_REDUCED_POLYPHONY: {
+        const int32_t parameterId(findPolyphonyParameter(this));
+        CARLA_SAFE_ASSERT_RETURN(parameterId >= 0, false);
+
+        const uint32_t uparameterId(static_cast<uint32_t>(parameterId));
+        const float value(getParameterValue(uparameterId));
+        float newValue(std::floor(value / 2.0f));
+        getParameterRanges(uparameterId).fixValue(newValue);
+
+        degrade.polyphonyParam   = parameterId;
+        degrade.polyphonyValue   = value;
+        degrade.polyphonyLowered = newValue;
+
+        setDegradedParameterValue(uparameterId, newValue);
+        return true;
+    }
+
+    case PLUGIN_DEGRADATION_BYPASSED:
+        degrade.bypassed = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool CarlaPlugin::restore()
+{
+    ProtectedData::Degrade& degrade(pData->degrade);
+
+    if (degrade.bypassed)
+    {
+        degrade.bypassed = false;
+        return true;
+    }
+
+    if (degrade.reducedRate)
+    {
+        degrade.reducedRate = false;
+        return true;
+    }
+
+    if (degrade.polyphonyParam >= 0)
+    {
+        const uint32_t parameterId(static_cast<uint32_t>(degrade.polyphonyParam));
+        degrade.polyphonyParam = -1;
+
+        // parameters might have been reloaded since, and the user might have picked another value
+        if (parameterId < getParameterCount() && carla_isEqual(getParameterValue(parameterId), degrade.polyphonyLowered))
+            setDegradedParameterValue(parameterId, degrade.polyphonyValue);
+
+        return true;
+    }
+
+    return false;
+}
+#endif
+
+void CarlaPlugin::processReblocked(const float** const audioIn, float** const audioOut, const uint32_t frames)
+{
+    ProtectedData::Reblock& reblock(pData->reblock);
+
+    if (reblock.blockSize == 0)
+        return processOversampled(audioIn, audioOut, frames);
+
+    // FIFOs do not match the current setup, wait for the next idle to update them
+    if (reblock.engineBufferSize != pData->engine->getBufferSize() || frames > reblock.engineBufferSize ||
+        reblock.audioInCount != pData->audioIn.count || reblock.audioOutCount != pData->audioOut.count)
+    {
+        if (! reblock.jobPending)
+            return processOversampled(audioIn, audioOut, frames);
+
+        if (audioOut != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                FloatVectorOperations::clear(audioOut[i], static_cast<int>(frames));
+        }
+        return;
+    }
+
+    CarlaEngineEventPort* const portIn(pData->event.portIn);
+    CarlaEngineEventPort* const portOut(pData->event.portOut);
+
+    const EngineEvent* const engineEventsIn((portIn != nullptr) ? portIn->fBuffer : nullptr);
+    EngineEvent* const engineEventsOut((portOut != nullptr) ? portOut->fBuffer : nullptr);
+
+    uint32_t engineEventInIndex = 0;
+    uint32_t engineEventOutIndex = 0;
+
+    if (engineEventsOut != nullptr)
+    {
+        for (; engineEventOutIndex < kMaxEngineEventInternalCount; ++engineEventOutIndex)
+        {
+            if (engineEventsOut[engineEventOutIndex].type == kEngineEventTypeNull)
+                break;
+        }
+    }
+
+    for (uint32_t offset=0; offset < frames;)
+    {
+        const uint32_t cur(reblock.current);
+        const uint32_t count(std::min(frames - offset, reblock.blockSize - reblock.position));
+        const bool lastChunk(offset + count == frames);
+
+        // audio, output is one block behind
+        for (uint32_t i=0; i < reblock.audioInCount; ++i)
+        {
+            if (audioIn != nullptr && audioIn[i] != nullptr)
+                FloatVectorOperations::copy(reblock.audioIn[cur][i] + reblock.position, audioIn[i] + offset, static_cast<int>(count));
+            else
+                FloatVectorOperations::clear(reblock.audioIn[cur][i] + reblock.position, static_cast<int>(count));
+        }
+
+        if (audioOut != nullptr)
+        {
+            for (uint32_t i=0; i < reblock.audioOutCount; ++i)
+                FloatVectorOperations::copy(audioOut[i] + offset, reblock.audioOut[cur][i] + reblock.position, static_cast<int>(count));
+        }
+
+        // events, moved to the matching position inside the block
+        if (engineEventsIn != nullptr)
+            reblockEngineEventsIn(reblock.eventsIn[cur], reblock.eventInCount, reblock.position,
+                                  engineEventsIn, engineEventInIndex, offset, count, lastChunk);
+
+        if (engineEventsOut != nullptr)
+            deblockEngineEventsOut(engineEventsOut, engineEventOutIndex, offset,
+                                   reblock.eventsOut[cur], reblock.eventOutIndex, reblock.position, count);
+
+        offset           += count;
+        reblock.position += count;
+
+        if (reblock.position < reblock.blockSize)
+            continue;
+
+        // block is full
+        const uint32_t eventInCount(reblock.eventInCount);
+
+        reblock.position      = 0;
+        reblock.eventInCount  = 0;
+        reblock.eventOutIndex = 0;
+
+        if (reblock.worker == nullptr)
+        {
+            if (portIn != nullptr)
+                portIn->fProcessBuffer = reblock.eventsIn[cur];
+            if (portOut != nullptr)
+                portOut->fProcessBuffer = reblock.eventsOut[cur];
+
+            processReblockJob(cur);
+
+            if (portIn != nullptr)
+                portIn->fProcessBuffer = nullptr;
+            if (portOut != nullptr)
+                portOut->fProcessBuffer = nullptr;
+            continue;
+        }
+
+        if (reblock.jobPending)
+        {
+            // the worker had a full block of time, never block the audio thread waiting for it.
+            // if it is still busy this block's audio is lost, but its events go into the next block
+            if (! reblock.waitJob(pData->engine->isOffline() ? 2000 : 0))
+            {
+                for (uint32_t i=0; i < reblock.audioOutCount; ++i)
+                    FloatVectorOperations::clear(reblock.audioOut[cur][i], static_cast<int>(reblock.blockSize));
+
+                reblock.eventInCount = carryReblockedEngineEvents(reblock.eventsIn[cur], eventInCount);
+                carla_zeroStructs(reblock.eventsOut[cur], kMaxEngineEventInternalCount);
+                continue;
+            }
+
+            reblock.jobPending = false;
+        }
+
+        if (reblock.jobPortIn != nullptr)
+            reblock.jobPortIn->fProcessBuffer = nullptr;
+        if (reblock.jobPortOut != nullptr)
+            reblock.jobPortOut->fProcessBuffer = nullptr;
+
+        if (portIn != nullptr)
+            portIn->fProcessBuffer = reblock.eventsIn[cur];
+        if (portOut != nullptr)
+            portOut->fProcessBuffer = reblock.eventsOut[cur];
+
+        reblock.jobPortIn  = portIn;
+        reblock.jobPortOut = portOut;
+        reblock.jobPending = true;
+        reblock.current    = cur ^ 1;
+
+        reblock.postJob(cur);
+    }
+}
+
+void CarlaPlugin::resetReblock() noexcept
+{
+    const CarlaMutexLocker cml(pData->masterMutex);
+
+    finishReblockJob();
+    pData->reblock.clear();
+}
+
+bool CarlaPlugin::resetOversampling() noexcept
+{
+    if (pData->oversample.factor <= 1)
+        return false;
+
+    const CarlaMutexLocker cml(pData->masterMutex);
+
+    // the re-blocking worker may be processing through the oversampling buffers
+    finishReblockJob();
+    pData->reblock.clear();
+    pData->oversample.clear();
+    return true;
+}
+
+// -------------------------------------------------------------------
+// Re-blocking
+
+void CarlaPlugin::updateReblock()
+{
+    ProtectedData::Reblock& reblock(pData->reblock);
+
+    const EngineOptions& options(pData->engine->getOptions());
+    const uint32_t engineBufferSize(pData->engine->getBufferSize());
+
+    uint32_t blockSize = 0;
+
+    // only the default event ports are re-blocked
+    if ((pData->options & PLUGIN_OPTION_REBLOCK) != 0 && options.reblockSize > engineBufferSize &&
+        (options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK || options.processMode == ENGINE_PROCESS_MODE_PATCHBAY) &&
+        getMidiInCount() <= 1 && getMidiOutCount() <= 1)
+    {
+        blockSize = options.reblockSize;
+    }
+
+    const bool threaded(blockSize != 0 && options.reblockThread);
+
+    if (blockSize == reblock.blockSize)
+    {
+        if (blockSize == 0)
+            return;
+
+        if (engineBufferSize == reblock.engineBufferSize &&
+            pData->audioIn.count == reblock.audioInCount && pData->audioOut.count == reblock.audioOutCount &&
+            threaded == (reblock.eventsIn[1] != nullptr))
+            return;
+    }
+
+    carla_debug("CarlaPlugin::updateReblock() - block size %u, threaded %s", blockSize, bool2str(threaded));
+
+    const CarlaMutexLocker cml(pData->masterMutex);
+
+    const uint32_t oldBufferSize(pData->getBufferSize());
+
+    finishReblockJob();
+
+    try {
+        reblock.recreate(blockSize, engineBufferSize, pData->audioIn.count, pData->audioOut.count, threaded);
+    }
+    catch(...) {
+        carla_safe_exception("Reblock::recreate", __FILE__, __LINE__);
+        reblock.clear();
+    }
+
+    if (threaded && reblock.blockSize != 0)
+        reblock.startWorker(this);
+
+    if (pData->getBufferSize() != oldBufferSize)
+        bufferSizeChanged(pData->getBufferSize());
+}
+
+void CarlaPlugin::processReblockJob(const uint32_t index)
+{
+    ProtectedData::Reblock& reblock(pData->reblock);
+
+    EngineEvent* const eventsIn(reblock.eventsIn[index]);
+    EngineEvent* const eventsOut(reblock.eventsOut[index]);
+
+    carla_zeroStructs(eventsOut, kMaxEngineEventInternalCount);
+
+    processOversampled(const_cast<const float**>(reblock.audioIn[index]), reblock.audioOut[index], reblock.blockSize);
+
+    for (uint32_t i=0; i < kMaxEngineEventInternalCount && eventsIn[i].type != kEngineEventTypeNull; ++i)
+        carla_zeroStruct(eventsIn[i]);
+
+    // output events are sent in time order, plugins do not always write them that way
+    for (uint32_t i=1; i < kMaxEngineEventInternalCount && eventsOut[i].type != kEngineEventTypeNull; ++i)
+    {
+        const EngineEvent event(eventsOut[i]);
+        uint32_t j = i;
+
+        for (; j > 0 && eventsOut[j-1].time > event.time; --j)
+            eventsOut[j] = eventsOut[j-1];
+
+        eventsOut[j] = event;
+    }
+}
+
+void CarlaPlugin::finishReblockJob() noexcept
+{
+    ProtectedData::Reblock& reblock(pData->reblock);
+
+    if (reblock.jobPending)
+    {
+        if (! reblock.waitJob(2000))
+            carla_stderr2("CarlaPlugin::finishReblockJob() - timed out waiting for the worker thread");
+
+        reblock.jobPending = false;
+    }
+
+    if (reblock.jobPortIn != nullptr)
+    {
+        reblock.jobPortIn->fProcessBuffer = nullptr;
+        reblock.jobPortIn = nullptr;
+    }
+
+    if (reblock.jobPortOut != nullptr)
+    {
+        reblock.jobPortOut->fProcessBuffer = nullptr;
+        reblock.jobPortOut = nullptr;
+    }
+}
+
+// -------------------------------------------------------------------
+// Oversampling
+
+void CarlaPlugin::updateOversampling()
+{
+    ProtectedData::Oversample& oversample(pData->oversample);
+
+    const EngineOptions& options(pData->engine->getOptions());
+    const uint32_t engineBufferSize(pData->engine->getBufferSize());
+
+    uint32_t factor = 1;
+
+    // only the default event ports are oversampled
+    if ((pData->options & PLUGIN_OPTION_OVERSAMPLE) != 0 && options.oversampleFactor > 1 &&
+        (options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK || options.processMode == ENGINE_PROCESS_MODE_PATCHBAY) &&
+        getMidiInCount() <= 1 && getMidiOutCount() <= 1)
+    {
+        factor = options.oversampleFactor;
+    }
+
+    // sized for the biggest re-blocking size, so re-blocking changes do not need new filters
+    uint32_t maxFrames = engineBufferSize;
+
+    if ((pData->options & PLUGIN_OPTION_REBLOCK) != 0)
+        maxFrames = std::max(maxFrames, options.reblockSize);
+
+    if (factor == oversample.factor)
+    {
+        if (factor == 1)
+            return;
+
+        if (maxFrames == oversample.maxFrames &&
+            pData->audioIn.count == oversample.audioInCount && pData->audioOut.count == oversample.audioOutCount)
+            return;
+    }
+
+    carla_debug("CarlaPlugin::updateOversampling() - factor %u", factor);
+
+    const CarlaMutexLocker cml(pData->masterMutex);
+
+    const uint32_t oldBufferSize(pData->getBufferSize());
+    const double oldSampleRate(pData->getSampleRate());
+
+    // re-blocking is set up again on the next idle
+    finishReblockJob();
+    pData->reblock.clear();
+
+    try {
+        oversample.recreate(factor, maxFrames, pData->audioIn.count, pData->audioOut.count);
+    }
+    catch(...) {
+        carla_safe_exception("Oversample::recreate", __FILE__, __LINE__);
+        oversample.clear();
+    }
+
+    if (carla_isNotEqual(pData->getSampleRate(), oldSampleRate))
+        sampleRateChanged(pData->getSampleRate());
+
+    if (pData->getBufferSize() != oldBufferSize)
+        bufferSizeChanged(pData->getBufferSize());
+}
+
+void CarlaPlugin::processOversampled(const float** const audioIn, float** const audioOut, const uint32_t frames)
+{
+    ProtectedData::Oversample& oversample(pData->oversample);
+
+    if (oversample.factor <= 1)
+        return process(audioIn, audioOut, nullptr, nullptr, frames);
+
+    // buffers do not match the current setup, the plugin cannot run at the engine rate meanwhile
+    if (frames > oversample.maxFrames ||
+        oversample.audioInCount != pData->audioIn.count || oversample.audioOutCount != pData->audioOut.count)
+    {
+        if (audioOut != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                FloatVectorOperations::clear(audioOut[i], static_cast<int>(frames));
+        }
+        return;
+    }
+
+    const uint32_t factor(oversample.factor);
+
+    // all inputs are upsampled before writing any output, audioIn and audioOut may point to the same buffers
+    for (uint32_t i=0; i < oversample.audioInCount; ++i)
+    {
+        if (audioIn != nullptr && audioIn[i] != nullptr)
+        {
+            oversample.oversampler.upsample(i, audioIn[i], oversample.audioIn[i], frames);
+        }
+        else
+        {
+            FloatVectorOperations::clear(oversample.audioIn[i], static_cast<int>(frames));
+            oversample.oversampler.upsample(i, oversample.audioIn[i], oversample.audioIn[i], frames);
+        }
+    }
+
+    // redirect the event ports, keeping whatever buffer they currently use (re-blocking)
+    CarlaEngineEventPort* const portIn(pData->event.portIn);
+    CarlaEngineEventPort* const portOut(pData->event.portOut);
+
+    EngineEvent* const oldProcessBufferIn((portIn != nullptr) ? portIn->fProcessBuffer : nullptr);
+    EngineEvent* const oldProcessBufferOut((portOut != nullptr) ? portOut->fProcessBuffer : nullptr);
+
+    if (portIn != nullptr)
+    {
+        if (const EngineEvent* const eventsIn = (oldProcessBufferIn != nullptr) ? oldProcessBufferIn : portIn->fBuffer)
+        {
+            for (uint32_t i=0; i < kMaxEngineEventInternalCount && eventsIn[i].type != kEngineEventTypeNull; ++i)
+            {
+                oversample.eventsIn[i]      = eventsIn[i];
+                oversample.eventsIn[i].time = eventsIn[i].time * factor;
+            }
+        }
+
+        portIn->fProcessBuffer = oversample.eventsIn;
+    }
+
+    if (portOut != nullptr)
+        portOut->fProcessBuffer = oversample.eventsOut;
+
+    process(const_cast<const float**>(oversample.audioIn), oversample.audioOut, nullptr, nullptr, frames * factor);
+
+    if (portIn != nullptr)
+    {
+        portIn->fProcessBuffer = oldProcessBufferIn;
+
+        for (uint32_t i=0; i < kMaxEngineEventInternalCount && oversample.eventsIn[i].type != kEngineEventTypeNull; ++i)
+            carla_zeroStruct(oversample.eventsIn[i]);
+    }
+
+    if (portOut != nullptr)
+    {
+        portOut->fProcessBuffer = oldProcessBufferOut;
+
+        EngineEvent* const eventsOut((oldProcessBufferOut != nullptr) ? oldProcessBufferOut : portOut->fBuffer);
+        uint32_t eventsOutIndex = 0;
+
+        if (eventsOut != nullptr)
+        {
+            for (; eventsOutIndex < kMaxEngineEventInternalCount; ++eventsOutIndex)
+            {
+                if (eventsOut[eventsOutIndex].type == kEngineEventTypeNull)
+                    break;
+            }
+        }
+
+        for (uint32_t i=0; i < kMaxEngineEventInternalCount && oversample.eventsOut[i].type != kEngineEventTypeNull; ++i)
+        {
+            if (eventsOut != nullptr && eventsOutIndex < kMaxEngineEventInternalCount)
+            {
+                EngineEvent& event(eventsOut[eventsOutIndex++]);
+                event      = oversample.eventsOut[i];
+                event.time = oversample.eventsOut[i].time / factor;
+            }
+
+            carla_zeroStruct(oversample.eventsOut[i]);
+        }
+    }
+
+    for (uint32_t i=0; i < oversample.audioOutCount; ++i)
+    {
+        if (audioOut != nullptr && audioOut[i] != nullptr)
+            oversample.oversampler.downsample(i, oversample.audioOut[i], audioOut[i], frames);
+    }
+}
+
 // -------------------------------------------------------------------
 // Misc
 
@@ -1420,6 +2245,9 @@ void CarlaPlugin::idle()
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     const bool sendOsc(pData->engine->isOscControlRegistered());
 #endif
+    updateOversampling();
+    updateReblock();
+
     const uint32_t latency(getLatencyInFrames());
 
     if (pData->latency.frames != latency)
@@ -1453,6 +2281,10 @@ void CarlaPlugin::idle()
         } break;
 
         case kPluginPostRtEventParameterChange: {
+            if (event.value1 >= 0 && event.value1 < static_cast<int32_t>(pData->param.count) &&
+                pData->param.data[event.value1].type == PARAMETER_INPUT)
+                ++pData->stateChanges;
+
             // Update UI
             if (event.value1 >= 0 && hasUI)
             {
@@ -1475,6 +2307,8 @@ void CarlaPlugin::idle()
         } break;
 
         case kPluginPostRtEventProgramChange: {
+            ++pData->stateChanges;
+
             // Update UI
             if (event.value1 >= 0 && hasUI)
             {
@@ -1512,6 +2346,8 @@ void CarlaPlugin::idle()
         } break;
 
         case kPluginPostRtEventMidiProgramChange: {
+            ++pData->stateChanges;
+
             // Update UI
             if (event.value1 >= 0 && hasUI)
             {
@@ -2031,6 +2867,7 @@ CarlaPlugin::ScopedDisabler::ScopedDisabler(CarlaPlugin* const plugin) noexcept
     carla_debug("CarlaPlugin::ScopedDisabler(%p)", plugin);
 
     plugin->pData->masterMutex.lock();
+    plugin->finishReblockJob();
 
     if (plugin->pData->enabled)
     {
@@ -37,6 +37,7 @@
 
 using juce::ChildProcess;
 using juce::File;
+using juce::MemoryBlock;
 using juce::ScopedPointer;
 using juce::String;
 using juce::StringArray;
@@ -514,6 +515,14 @@ protected:
             std::snprintf(strBuf, STR_MAX, "%u", options.uiBridgesTimeout);
             carla_setenv("ENGINE_OPTION_UI_BRIDGES_TIMEOUT",strBuf);
 
+            carla_setenv("ENGINE_OPTION_RT_MEMORY_LOCK", bool2str(options.rtMemoryLock));
+
+            std::snprintf(strBuf, STR_MAX, "%u", options.rtCpuAffinity);
+            carla_setenv("ENGINE_OPTION_RT_CPU_AFFINITY", strBuf);
+
+            std::snprintf(strBuf, STR_MAX, "%u", options.rtPriority);
+            carla_setenv("ENGINE_OPTION_RT_PRIORITY", strBuf);
+
             if (options.pathLADSPA != nullptr)
                 carla_setenv("ENGINE_OPTION_PLUGIN_PATH_LADSPA", options.pathLADSPA);
             else
@@ -844,6 +853,15 @@ public:
         }
     }
 
+    bool isStateSaveOutdated() const noexcept override
+    {
+        // bridged LV2 plugins only send their internal state when asked to save
+        if (fPluginType == PLUGIN_LV2)
+            return true;
+
+        return CarlaPlugin::isStateSaveOutdated();
+    }
+
     void waitForSaved()
     {
         if (fSaved)
@@ -1051,7 +1069,7 @@ public:
         filePath += CARLA_OS_SEP_STR ".CarlaChunk_";
         filePath += fShmAudioPool.filename.buffer() + 18;
 
-        if (File(filePath).replaceWithText(dataBase64.buffer()))
+        if (File(filePath).replaceWithData(dataBase64.buffer(), dataBase64.length()))
         {
             const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
 
@@ -1719,102 +1737,7 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
-        {
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (k < pData->latency.frames)
-                            bufValue = pData->latency.buffers[c][k];
-                        else if (pData->latency.frames < frames)
-                            bufValue = audioIn[c][k-pData->latency.frames];
-                        else
-                            bufValue = audioIn[c][k];
-
-                        audioOut[i][k] = (audioOut[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, audioOut[i], iframes);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            audioOut[i][k]  = oldBufLeft[k]     * (1.0f - balRangeL);
-                            audioOut[i][k] += audioOut[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            audioOut[i][k]  = audioOut[i][k] * balRangeR;
-                            audioOut[i][k] += oldBufLeft[k]   * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k] *= pData->postProc.volume;
-                }
-            }
-
-        } // End of Post-processing
-
-        // --------------------------------------------------------------------------------------------------------
-        // Save latency values for next callback
-
-        if (const uint32_t latframes = pData->latency.frames)
-        {
-            if (latframes <= frames)
-            {
-                for (uint32_t i=0; i < pData->audioIn.count; ++i)
-                    FloatVectorOperations::copy(pData->latency.buffers[i], audioIn[i]+(frames-latframes), static_cast<int>(latframes));
-            }
-            else
-            {
-                const uint32_t diff = pData->latency.frames-frames;
-
-                for (uint32_t i=0, k; i<pData->audioIn.count; ++i)
-                {
-                    // push back buffer by 'frames'
-                    for (k=0; k < diff; ++k)
-                        pData->latency.buffers[i][k] = pData->latency.buffers[i][k+frames];
-
-                    // put current input at the end
-                    for (uint32_t j=0; k < latframes; ++j, ++k)
-                        pData->latency.buffers[i][k] = audioIn[i][j];
-                }
-            }
-        }
+        pData->postProcess(audioIn, audioOut, audioOut, 0, 0, frames);
 
 #endif // BUILD_BRIDGE
 
@@ -2148,6 +2071,7 @@ public:
                     pData->param.data[index].rindex = rindex;
                     pData->param.data[index].hints  = hints;
                     pData->param.data[index].midiCC = midiCC;
+                    pData->param.midiCCMappingChanged();
                 }
             }   break;
 
@@ -2219,6 +2143,9 @@ public:
                     const float fixedValue(pData->param.getFixedValue(index, value));
                     fParams[index].value = fixedValue;
 
+                    if (pData->param.data[index].type == PARAMETER_OUTPUT)
+                        pData->param.setOutputValue(index, fixedValue);
+
                     CarlaPlugin::setParameterValue(index, fixedValue, false, true, true);
                 }
             }   break;
@@ -2232,6 +2159,9 @@ public:
                 {
                     const float fixedValue(pData->param.getFixedValue(index, value));
                     fParams[index].value = fixedValue;
+
+                    if (pData->param.data[index].type == PARAMETER_OUTPUT)
+                        pData->param.setOutputValue(index, fixedValue);
                 }
             }   break;
 
@@ -2372,7 +2302,11 @@ public:
 
                 if (chunkFile.existsAsFile())
                 {
-                    fInfo.chunk = carla_getChunkFromBase64String(chunkFile.loadFileAsString().toRawUTF8());
+                    MemoryBlock chunkDataBase64;
+                    chunkFile.loadFileAsData(chunkDataBase64);
+
+                    fInfo.chunk = carla_getChunkFromBase64String(static_cast<const char*>(chunkDataBase64.getData()),
+                                                                 chunkDataBase64.getSize());
                     chunkFile.deleteFile();
                 }
             }   break;
@@ -2557,11 +2491,14 @@ public:
 #endif
         sFirstInit = false;
 
-        const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
+        // engine might be loading plugins in parallel, in which case we are not on the main thread
+        const bool inLoaderThread  = pData->engine->isLoadingProjectInParallel();
+        const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin && ! inLoaderThread;
 
         for (; Time::currentTimeMillis() < fLastPongTime + timeoutEnd && fBridgeThread.isThreadRunning();)
         {
-            pData->engine->callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
+            if (! inLoaderThread)
+                pData->engine->callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
 
             if (needsEngineIdle)
                 pData->engine->idle();
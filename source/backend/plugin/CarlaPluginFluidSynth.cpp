@@ -68,7 +68,7 @@ public:
         // define settings
         fluid_settings_setint(fSettings, "synth.audio-channels", use16Outs ? 16 : 1);
         fluid_settings_setint(fSettings, "synth.audio-groups", use16Outs ? 16 : 1);
-        fluid_settings_setnum(fSettings, "synth.sample-rate", pData->engine->getSampleRate());
+        fluid_settings_setnum(fSettings, "synth.sample-rate", pData->getSampleRate());
         //fluid_settings_setnum(fSettings, "synth.cpu-cores", 2);
         fluid_settings_setint(fSettings, "synth.parallel-render", 1);
         fluid_settings_setint(fSettings, "synth.threadsafe-api", 0);
@@ -78,7 +78,7 @@ public:
         CARLA_SAFE_ASSERT_RETURN(fSynth != nullptr,);
 
 #ifdef FLUIDSYNTH_VERSION_NEW_API
-        fluid_synth_set_sample_rate(fSynth, (float)pData->engine->getSampleRate());
+        fluid_synth_set_sample_rate(fSynth, (float)pData->getSampleRate());
 #endif
 
         // set default values
@@ -101,6 +101,7 @@ public:
 
         pData->singleMutex.lock();
         pData->masterMutex.lock();
+        pData->reblock.stopWorker();
 
         if (pData->client != nullptr && pData->client->isActive())
             pData->client->deactivate();
@@ -179,6 +180,11 @@ public:
         options |= PLUGIN_OPTION_SEND_PITCHBEND;
         options |= PLUGIN_OPTION_SEND_ALL_SOUND_OFF;
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_REBLOCK;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+        options |= PLUGIN_OPTION_OVERSAMPLE;
+
         return options;
     }
 
@@ -876,7 +882,7 @@ public:
         if (! kUse16Outs)
             pData->extraHints |= PLUGIN_EXTRA_HINT_CAN_RUN_RACK;
 
-        bufferSizeChanged(pData->engine->getBufferSize());
+        bufferSizeChanged(pData->getBufferSize());
         reloadPrograms(true);
 
         if (pData->active)
@@ -1168,12 +1174,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].hints != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -1365,6 +1368,7 @@ public:
             uint32_t k = FluidSynthVoiceCount;
             fParamBuffers[k] = float(fluid_synth_get_active_voice_count(fSynth));
             pData->param.ranges[k].fixValue(fParamBuffers[k]);
+            pData->param.setOutputValue(k, fParamBuffers[k]);
 
             if (pData->param.data[k].midiCC > 0)
             {
@@ -1417,55 +1421,10 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (volume and balance)
 
-        {
-            // note - balance not possible with kUse16Outs, so we can safely skip fAudioOutBuffers
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-
-            float oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Balance
-                if (doBalance)
-                {
-                    if (i % 2 == 0)
-                        FloatVectorOperations::copy(oldBufLeft, outBuffer[i]+timeOffset, static_cast<int>(frames));
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            // left
-                            outBuffer[i][k+timeOffset]  = oldBufLeft[k]                * (1.0f - balRangeL);
-                            outBuffer[i][k+timeOffset] += outBuffer[i+1][k+timeOffset] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            outBuffer[i][k+timeOffset]  = outBuffer[i][k+timeOffset] * balRangeR;
-                            outBuffer[i][k+timeOffset] += oldBufLeft[k]              * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume
-                if (kUse16Outs)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] = fAudio16Buffers[i][k] * pData->postProc.volume;
-                }
-                else if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] *= pData->postProc.volume;
-                }
-            }
-
-        } // End of Post-processing
+        if (kUse16Outs)
+            pData->postProcess(nullptr, fAudio16Buffers, outBuffer, 0, timeOffset, frames);
+        else
+            pData->postProcess(nullptr, outBuffer, outBuffer, timeOffset, timeOffset, frames);
 #else
         if (kUse16Outs)
         {
@@ -19,7 +19,10 @@
 #include "CarlaEngine.hpp"
 
 #include "CarlaLibCounter.hpp"
+#include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
 
 CARLA_BACKEND_START_NAMESPACE
 
@@ -181,7 +184,12 @@ PluginParameterData::PluginParameterData() noexcept
     : count(0),
       data(nullptr),
       ranges(nullptr),
-      special(nullptr) {}
+      special(nullptr),
+      outputValues(nullptr),
+      outputChanged(nullptr),
+      midiCCFirst(nullptr),
+      midiCCNext(nullptr),
+      midiCCChanged(0) {}
 
 PluginParameterData::~PluginParameterData() noexcept
 {
@@ -189,6 +197,10 @@ PluginParameterData::~PluginParameterData() noexcept
     CARLA_SAFE_ASSERT(data == nullptr);
     CARLA_SAFE_ASSERT(ranges == nullptr);
     CARLA_SAFE_ASSERT(special == nullptr);
+    CARLA_SAFE_ASSERT(outputValues == nullptr);
+    CARLA_SAFE_ASSERT(outputChanged == nullptr);
+    CARLA_SAFE_ASSERT(midiCCFirst == nullptr);
+    CARLA_SAFE_ASSERT(midiCCNext == nullptr);
 }
 
 void PluginParameterData::createNew(const uint32_t newCount, const bool withSpecial)
@@ -197,6 +209,10 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
     CARLA_SAFE_ASSERT_RETURN(data == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(ranges == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(special == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(outputValues == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(outputChanged == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(midiCCFirst == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(midiCCNext == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(newCount > 0,);
 
     data = new ParameterData[newCount];
@@ -218,7 +234,19 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
         carla_zeroStructs(special, newCount);
     }
 
+    outputValues = new float[newCount];
+    carla_zeroFloats(outputValues, newCount);
+
+    outputChanged = new uint32_t[(newCount+31)/32];
+    carla_zeroStructs(outputChanged, (newCount+31)/32);
+
+    midiCCFirst = new uint32_t[MAX_MIDI_CHANNELS*MAX_MIDI_CONTROL];
+    midiCCNext  = new uint32_t[newCount];
+
     count = newCount;
+
+    // parameters get their MIDI CC after this, let the audio thread build the lookup on first use
+    midiCCMappingChanged();
 }
 
 void PluginParameterData::clear() noexcept
@@ -241,6 +269,30 @@ void PluginParameterData::clear() noexcept
         special = nullptr;
     }
 
+    if (outputValues != nullptr)
+    {
+        delete[] outputValues;
+        outputValues = nullptr;
+    }
+
+    if (outputChanged != nullptr)
+    {
+        delete[] outputChanged;
+        outputChanged = nullptr;
+    }
+
+    if (midiCCFirst != nullptr)
+    {
+        delete[] midiCCFirst;
+        midiCCFirst = nullptr;
+    }
+
+    if (midiCCNext != nullptr)
+    {
+        delete[] midiCCNext;
+        midiCCNext = nullptr;
+    }
+
     count = 0;
 }
 
@@ -266,6 +318,82 @@ float PluginParameterData::getFixedValue(const uint32_t parameterId, const float
     return paramRanges.getFixedValue(value);
 }
 
+void PluginParameterData::setOutputValue(const uint32_t parameterId, const float value) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(parameterId < count,);
+
+    if (carla_isEqual(outputValues[parameterId], value))
+        return;
+
+    outputValues[parameterId] = value;
+    __atomic_fetch_or(&outputChanged[parameterId/32], 1U << (parameterId%32), __ATOMIC_RELEASE);
+}
+
+bool PluginParameterData::takeNextChangedOutput(uint32_t& parameterId) noexcept
+{
+    for (uint32_t word = parameterId/32, words = (count+31)/32; word < words; ++word)
+    {
+        uint32_t bits = __atomic_load_n(&outputChanged[word], __ATOMIC_ACQUIRE);
+
+        // skip the bits before 'parameterId' in its own word
+        if (word == parameterId/32)
+            bits &= ~0U << (parameterId%32);
+
+        if (bits == 0)
+            continue;
+
+        const uint32_t bit = static_cast<uint32_t>(__builtin_ctz(bits));
+        __atomic_fetch_and(&outputChanged[word], ~(1U << bit), __ATOMIC_ACQ_REL);
+
+        parameterId = word*32 + bit;
+        return true;
+    }
+
+    return false;
+}
+
+void PluginParameterData::midiCCMappingChanged() noexcept
+{
+    __atomic_store_n(&midiCCChanged, 1, __ATOMIC_RELEASE);
+}
+
+uint32_t PluginParameterData::getFirstMidiCCParameter(const uint8_t channel, const uint16_t cc) noexcept
+{
+    if (channel >= MAX_MIDI_CHANNELS || cc >= MAX_MIDI_CONTROL || count == 0)
+        return count;
+
+    if (__atomic_exchange_n(&midiCCChanged, 0, __ATOMIC_ACQUIRE) != 0)
+    {
+        for (uint32_t i=0; i < MAX_MIDI_CHANNELS*MAX_MIDI_CONTROL; ++i)
+            midiCCFirst[i] = count;
+
+        // go backwards, so each list is in parameter order
+        for (uint32_t i=count; i-- > 0;)
+        {
+            const ParameterData& paramData(data[i]);
+
+            if (paramData.midiCC < 0 || paramData.midiCC >= MAX_MIDI_CONTROL || paramData.midiChannel >= MAX_MIDI_CHANNELS)
+            {
+                midiCCNext[i] = count;
+                continue;
+            }
+
+            uint32_t& first(midiCCFirst[paramData.midiChannel*MAX_MIDI_CONTROL + static_cast<uint32_t>(paramData.midiCC)]);
+            midiCCNext[i] = first;
+            first = i;
+        }
+    }
+
+    return midiCCFirst[channel*MAX_MIDI_CONTROL + cc];
+}
+
+uint32_t PluginParameterData::getNextMidiCCParameter(const uint32_t parameterId) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(parameterId < count, count);
+
+    return midiCCNext[parameterId];
+}
+
 // -----------------------------------------------------------------------
 // PluginProgramData
 
@@ -408,6 +536,7 @@ CarlaPlugin::ProtectedData::Latency::Latency() noexcept
 #else
     : frames(0),
       channels(0),
+      position(0),
       buffers(nullptr) {}
 #endif
 
@@ -435,6 +564,20 @@ void CarlaPlugin::ProtectedData::Latency::clearBuffers() noexcept
 
     channels = 0;
     frames   = 0;
+    position = 0;
+}
+
+// copy 'count' frames of a circular buffer starting at its 'start'-th oldest frame
+static void copyLatencyFrames(float* const dest, const float* const buffer, const uint32_t bufferFrames,
+                              const uint32_t bufferPosition, const uint32_t start, const uint32_t count) noexcept
+{
+    const uint32_t first = (bufferPosition + start) % bufferFrames;
+    const uint32_t firstCount = std::min(count, bufferFrames - first);
+
+    FloatVectorOperations::copy(dest, buffer + first, static_cast<int>(firstCount));
+
+    if (count > firstCount)
+        FloatVectorOperations::copy(dest + firstCount, buffer, static_cast<int>(count - firstCount));
 }
 
 void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChannels, const uint32_t newFrames)
@@ -443,10 +586,13 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
 
     const bool retrieveOldBuffer = (channels == newChannels && channels > 0 && frames > 0 && newFrames > 0);
     float** const oldBuffers = buffers;
+    const uint32_t oldChannels = channels;
     const uint32_t oldFrames = frames;
+    const uint32_t oldPosition = position;
 
     channels = newChannels;
     frames   = newFrames;
+    position = 0;
 
     if (channels > 0 && frames > 0)
     {
@@ -461,13 +607,13 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
                 if (oldFrames > frames)
                 {
                     const uint32_t diff = oldFrames - frames;
-                    FloatVectorOperations::copy(buffers[i], oldBuffers[i] + diff, static_cast<int>(frames));
+                    copyLatencyFrames(buffers[i], oldBuffers[i], oldFrames, oldPosition, diff, frames);
                 }
                 else
                 {
                     const uint32_t diff = frames - oldFrames;
                     FloatVectorOperations::clear(buffers[i], static_cast<int>(diff));
-                    FloatVectorOperations::copy(buffers[i] + diff, oldBuffers[i], static_cast<int>(oldFrames));
+                    copyLatencyFrames(buffers[i] + diff, oldBuffers[i], oldFrames, oldPosition, 0, oldFrames);
                 }
             }
             else
@@ -484,7 +630,7 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
     // delete old buffer
     if (oldBuffers != nullptr)
     {
-        for (uint32_t i=0; i < channels; ++i)
+        for (uint32_t i=0; i < oldChannels; ++i)
         {
             CARLA_SAFE_ASSERT_CONTINUE(oldBuffers[i] != nullptr);
 
@@ -495,6 +641,37 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
         delete[] oldBuffers;
     }
 }
+
+void CarlaPlugin::ProtectedData::Latency::storeInput(const float* const* const inBuffers, const uint32_t inCount,
+                                                     const uint32_t offset, const uint32_t inFrames) noexcept
+{
+    if (buffers == nullptr || frames == 0)
+        return;
+
+    const uint32_t count = std::min(inCount, channels);
+
+    if (inFrames >= frames)
+    {
+        for (uint32_t i=0; i < count; ++i)
+            FloatVectorOperations::copy(buffers[i], inBuffers[i] + offset + (inFrames - frames), static_cast<int>(frames));
+
+        position = 0;
+        return;
+    }
+
+    // overwrite the oldest frames, without moving the others
+    const uint32_t firstCount = std::min(inFrames, frames - position);
+
+    for (uint32_t i=0; i < count; ++i)
+    {
+        FloatVectorOperations::copy(buffers[i] + position, inBuffers[i] + offset, static_cast<int>(firstCount));
+
+        if (inFrames > firstCount)
+            FloatVectorOperations::copy(buffers[i], inBuffers[i] + offset + firstCount, static_cast<int>(inFrames - firstCount));
+    }
+
+    position = (position + inFrames) % frames;
+}
 #endif
 
 // -----------------------------------------------------------------------
@@ -569,9 +746,444 @@ CarlaPlugin::ProtectedData::PostProc::PostProc() noexcept
       volume(1.0f),
       balanceLeft(-1.0f),
       balanceRight(1.0f),
-      panning(0.0f) {}
+      panning(0.0f),
+      lastDryWet(1.0f),
+      lastVolume(1.0f),
+      lastBalanceLeft(-1.0f),
+      lastBalanceRight(1.0f) {}
+
+void CarlaPlugin::ProtectedData::PostProc::resetRamps() noexcept
+{
+    lastDryWet       = dryWet;
+    lastVolume       = volume;
+    lastBalanceLeft  = balanceLeft;
+    lastBalanceRight = balanceRight;
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Silence
+
+CarlaPlugin::ProtectedData::Silence::Silence() noexcept
+    : sleeping(false),
+      inputSilent(false),
+      outputHint(false),
+      frames(0) {}
+
+void CarlaPlugin::ProtectedData::Silence::reset() noexcept
+{
+    sleeping    = false;
+    inputSilent = false;
+    outputHint  = false;
+    frames      = 0;
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Degrade
+
+CarlaPlugin::ProtectedData::Degrade::Degrade() noexcept
+    : reducedRate(false),
+      bypassed(false),
+      skipCycles(0),
+      polyphonyParam(-1),
+      polyphonyValue(0.0f),
+      polyphonyLowered(0.0f),
+      load(0.0f),
+      processTicks(0),
+      processFrames(0) {}
 #endif
 
+// -----------------------------------------------------------------------
+// ProtectedData::Reblock::Worker
+
+class CarlaPlugin::ProtectedData::Reblock::Worker : public CarlaThread
+{
+public:
+    Worker(CarlaPlugin* const plugin) noexcept
+        : CarlaThread("CarlaPluginReblockWorker"),
+          kPlugin(plugin),
+          fIndex(0),
+          fHasPriority(false),
+          fNeedsPriority(false),
+          fPolicy(0),
+          fParam()
+    {
+        carla_sem_create2(fStart);
+        carla_sem_create2(fDone);
+    }
+
+    ~Worker() noexcept override
+    {
+        stop();
+
+        carla_sem_destroy2(fStart);
+        carla_sem_destroy2(fDone);
+    }
+
+    void stop() noexcept
+    {
+        signalThreadShouldExit();
+        stopThread(-1);
+    }
+
+    // called from the audio thread
+    void post(const uint32_t index) noexcept
+    {
+        if (! fHasPriority)
+        {
+            fHasPriority = true;
+
+            if (pthread_getschedparam(pthread_self(), &fPolicy, &fParam) == 0)
+                fNeedsPriority = true;
+        }
+
+        fIndex = index;
+        carla_sem_post(fStart, true);
+    }
+
+    // a timeout of 0 only checks if the job is done, without blocking
+    bool wait(const uint msecs) noexcept
+    {
+        if (msecs == 0)
+            return carla_sem_trywait(fDone, true);
+
+        return carla_sem_timedwait(fDone, msecs, true);
+    }
+
+protected:
+    void run() override
+    {
+        FloatVectorOperations::disableDenormalisedNumberSupport();
+
+        for (; ! shouldThreadExit();)
+        {
+            if (! carla_sem_timedwait(fStart, 100, true))
+                continue;
+
+            // follow the audio thread priority
+            if (fNeedsPriority)
+            {
+                fNeedsPriority = false;
+                pthread_setschedparam(pthread_self(), fPolicy, &fParam);
+            }
+
+            try {
+                kPlugin->processReblockJob(fIndex);
+            } CARLA_SAFE_EXCEPTION("processReblockJob");
+
+            carla_sem_post(fDone, true);
+        }
+    }
+
+private:
+    CarlaPlugin* const kPlugin;
+    uint32_t fIndex;
+
+    bool fHasPriority;
+    volatile bool fNeedsPriority;
+    int fPolicy;
+    sched_param fParam;
+
+    carla_sem_t fStart;
+    carla_sem_t fDone;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Worker)
+};
+
+// -----------------------------------------------------------------------
+// ProtectedData::Reblock
+
+CarlaPlugin::ProtectedData::Reblock::Reblock() noexcept
+    : blockSize(0),
+      engineBufferSize(0),
+      audioInCount(0),
+      audioOutCount(0),
+      position(0),
+      current(0),
+      eventInCount(0),
+      eventOutIndex(0),
+      jobPending(false),
+      jobPortIn(nullptr),
+      jobPortOut(nullptr),
+      worker(nullptr)
+{
+    audioIn[0]   = audioIn[1]   = nullptr;
+    audioOut[0]  = audioOut[1]  = nullptr;
+    eventsIn[0]  = eventsIn[1]  = nullptr;
+    eventsOut[0] = eventsOut[1] = nullptr;
+}
+
+CarlaPlugin::ProtectedData::Reblock::~Reblock() noexcept
+{
+    CARLA_SAFE_ASSERT(worker == nullptr);
+    CARLA_SAFE_ASSERT(! jobPending);
+
+    clear();
+}
+
+void CarlaPlugin::ProtectedData::Reblock::clear() noexcept
+{
+    stopWorker();
+
+    for (uint32_t j=0; j < 2; ++j)
+    {
+        if (audioIn[j] != nullptr)
+        {
+            for (uint32_t i=0; i < audioInCount; ++i)
+                delete[] audioIn[j][i];
+
+            delete[] audioIn[j];
+            audioIn[j] = nullptr;
+        }
+
+        if (audioOut[j] != nullptr)
+        {
+            for (uint32_t i=0; i < audioOutCount; ++i)
+                delete[] audioOut[j][i];
+
+            delete[] audioOut[j];
+            audioOut[j] = nullptr;
+        }
+
+        if (eventsIn[j] != nullptr)
+        {
+            delete[] eventsIn[j];
+            eventsIn[j] = nullptr;
+        }
+
+        if (eventsOut[j] != nullptr)
+        {
+            delete[] eventsOut[j];
+            eventsOut[j] = nullptr;
+        }
+    }
+
+    blockSize        = 0;
+    engineBufferSize = 0;
+    audioInCount     = 0;
+    audioOutCount    = 0;
+    position         = 0;
+    current          = 0;
+    eventInCount     = 0;
+    eventOutIndex    = 0;
+}
+
+void CarlaPlugin::ProtectedData::Reblock::recreate(const uint32_t newBlockSize, const uint32_t newEngineBufferSize,
+                                                   const uint32_t newAudioInCount, const uint32_t newAudioOutCount, const bool threaded)
+{
+    clear();
+
+    if (newBlockSize == 0)
+        return;
+
+    // a single set of buffers is enough when processing in the audio thread
+    const uint32_t sets = threaded ? 2 : 1;
+
+    // set first so clear() can free a partial allocation
+    audioInCount  = newAudioInCount;
+    audioOutCount = newAudioOutCount;
+
+    for (uint32_t j=0; j < sets; ++j)
+    {
+        if (audioInCount > 0)
+        {
+            audioIn[j] = new float*[audioInCount];
+            carla_zeroPointers(audioIn[j], audioInCount);
+
+            for (uint32_t i=0; i < audioInCount; ++i)
+            {
+                audioIn[j][i] = new float[newBlockSize];
+                FloatVectorOperations::clear(audioIn[j][i], static_cast<int>(newBlockSize));
+            }
+        }
+
+        if (audioOutCount > 0)
+        {
+            audioOut[j] = new float*[audioOutCount];
+            carla_zeroPointers(audioOut[j], audioOutCount);
+
+            for (uint32_t i=0; i < audioOutCount; ++i)
+            {
+                audioOut[j][i] = new float[newBlockSize];
+                FloatVectorOperations::clear(audioOut[j][i], static_cast<int>(newBlockSize));
+            }
+        }
+
+        eventsIn[j] = new EngineEvent[kMaxEngineEventInternalCount];
+        carla_zeroStructs(eventsIn[j], kMaxEngineEventInternalCount);
+
+        eventsOut[j] = new EngineEvent[kMaxEngineEventInternalCount];
+        carla_zeroStructs(eventsOut[j], kMaxEngineEventInternalCount);
+    }
+
+    blockSize        = newBlockSize;
+    engineBufferSize = newEngineBufferSize;
+}
+
+void CarlaPlugin::ProtectedData::Reblock::startWorker(CarlaPlugin* const plugin) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(worker == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(eventsIn[1] != nullptr,);
+
+    try {
+        worker = new Worker(plugin);
+    } CARLA_SAFE_EXCEPTION_RETURN("Reblock::startWorker",);
+
+    if (! worker->startThread())
+    {
+        delete worker;
+        worker = nullptr;
+    }
+}
+
+void CarlaPlugin::ProtectedData::Reblock::stopWorker() noexcept
+{
+    if (worker == nullptr)
+        return;
+
+    // let the last block finish before stopping
+    if (jobPending)
+    {
+        worker->wait(2000);
+        jobPending = false;
+    }
+
+    delete worker;
+    worker = nullptr;
+}
+
+void CarlaPlugin::ProtectedData::Reblock::postJob(const uint32_t index) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(worker != nullptr,);
+
+    worker->post(index);
+}
+
+bool CarlaPlugin::ProtectedData::Reblock::waitJob(const uint msecs) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(worker != nullptr, false);
+
+    return worker->wait(msecs);
+}
+
+uint32_t CarlaPlugin::ProtectedData::Reblock::getLatency() const noexcept
+{
+    return (worker != nullptr) ? blockSize * 2 : blockSize;
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Oversample
+
+CarlaPlugin::ProtectedData::Oversample::Oversample() noexcept
+    : factor(1),
+      maxFrames(0),
+      audioInCount(0),
+      audioOutCount(0),
+      audioIn(nullptr),
+      audioOut(nullptr),
+      eventsIn(nullptr),
+      eventsOut(nullptr),
+      oversampler() {}
+
+CarlaPlugin::ProtectedData::Oversample::~Oversample() noexcept
+{
+    clear();
+}
+
+void CarlaPlugin::ProtectedData::Oversample::clear() noexcept
+{
+    if (audioIn != nullptr)
+    {
+        for (uint32_t i=0; i < audioInCount; ++i)
+            delete[] audioIn[i];
+
+        delete[] audioIn;
+        audioIn = nullptr;
+    }
+
+    if (audioOut != nullptr)
+    {
+        for (uint32_t i=0; i < audioOutCount; ++i)
+            delete[] audioOut[i];
+
+        delete[] audioOut;
+        audioOut = nullptr;
+    }
+
+    if (eventsIn != nullptr)
+    {
+        delete[] eventsIn;
+        eventsIn = nullptr;
+    }
+
+    if (eventsOut != nullptr)
+    {
+        delete[] eventsOut;
+        eventsOut = nullptr;
+    }
+
+    oversampler.clear();
+
+    factor        = 1;
+    maxFrames     = 0;
+    audioInCount  = 0;
+    audioOutCount = 0;
+}
+
+void CarlaPlugin::ProtectedData::Oversample::recreate(const uint32_t newFactor, const uint32_t newMaxFrames,
+                                                      const uint32_t newAudioInCount, const uint32_t newAudioOutCount)
+{
+    clear();
+
+    if (newFactor <= 1 || newMaxFrames == 0)
+        return;
+
+    const uint32_t highFrames(newMaxFrames * newFactor);
+
+    // set first so clear() can free a partial allocation
+    audioInCount  = newAudioInCount;
+    audioOutCount = newAudioOutCount;
+
+    if (audioInCount > 0)
+    {
+        audioIn = new float*[audioInCount];
+        carla_zeroPointers(audioIn, audioInCount);
+
+        for (uint32_t i=0; i < audioInCount; ++i)
+        {
+            audioIn[i] = new float[highFrames];
+            FloatVectorOperations::clear(audioIn[i], static_cast<int>(highFrames));
+        }
+    }
+
+    if (audioOutCount > 0)
+    {
+        audioOut = new float*[audioOutCount];
+        carla_zeroPointers(audioOut, audioOutCount);
+
+        for (uint32_t i=0; i < audioOutCount; ++i)
+        {
+            audioOut[i] = new float[highFrames];
+            FloatVectorOperations::clear(audioOut[i], static_cast<int>(highFrames));
+        }
+    }
+
+    eventsIn = new EngineEvent[kMaxEngineEventInternalCount];
+    carla_zeroStructs(eventsIn, kMaxEngineEventInternalCount);
+
+    eventsOut = new EngineEvent[kMaxEngineEventInternalCount];
+    carla_zeroStructs(eventsOut, kMaxEngineEventInternalCount);
+
+    oversampler.setup(newFactor, audioInCount, audioOutCount, newMaxFrames);
+
+    factor    = newFactor;
+    maxFrames = newMaxFrames;
+}
+
+uint32_t CarlaPlugin::ProtectedData::Oversample::getLatency() const noexcept
+{
+    return (factor > 1) ? oversampler.getLatency() : 0;
+}
+
 // -----------------------------------------------------------------------
 
 CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx) noexcept
@@ -604,12 +1216,18 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       masterMutex(),
       singleMutex(),
       stateSave(),
+      stateChanges(1),
+      stateSaveChanges(0),
       extNotes(),
       latency(),
       postRtEvents(),
-      postUiEvents()
+      postUiEvents(),
+      reblock(),
+      oversample()
 #ifndef BUILD_BRIDGE
-    , postProc()
+    , postProc(),
+      silence(),
+      degrade()
 #endif
       {}
 
@@ -719,6 +1337,16 @@ void CarlaPlugin::ProtectedData::clearBuffers() noexcept
 #endif
 }
 
+uint32_t CarlaPlugin::ProtectedData::getBufferSize() const noexcept
+{
+    return std::max(reblock.blockSize, engine->getBufferSize()) * oversample.factor;
+}
+
+double CarlaPlugin::ProtectedData::getSampleRate() const noexcept
+{
+    return engine->getSampleRate() * oversample.factor;
+}
+
 // -----------------------------------------------------------------------
 // Post-poned events
 
@@ -738,6 +1366,122 @@ void CarlaPlugin::ProtectedData::postponeRtEvent(const PluginPostRtEventType typ
     postRtEvents.appendRT(rtEvent);
 }
 
+#ifndef BUILD_BRIDGE
+// -----------------------------------------------------------------------
+// Post-processing
+
+void CarlaPlugin::ProtectedData::postProcess(const float* const* const dryBuffers, float* const* const buffers, float* const* const outBuffers,
+                                             const uint32_t bufferOffset, const uint32_t outOffset, const uint32_t frames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(buffers != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(outBuffers != nullptr,);
+
+    if (frames == 0)
+        return;
+
+    // read once, these can change at any time
+    const float dryWet       = (hints & PLUGIN_CAN_DRYWET)  ? postProc.dryWet       : 1.0f;
+    const float volume       = (hints & PLUGIN_CAN_VOLUME)  ? postProc.volume       : 1.0f;
+    const float balanceLeft  = (hints & PLUGIN_CAN_BALANCE) ? postProc.balanceLeft  : -1.0f;
+    const float balanceRight = (hints & PLUGIN_CAN_BALANCE) ? postProc.balanceRight : 1.0f;
+
+    const float lastDryWet       = (hints & PLUGIN_CAN_DRYWET)  ? postProc.lastDryWet       : 1.0f;
+    const float lastVolume       = (hints & PLUGIN_CAN_VOLUME)  ? postProc.lastVolume       : 1.0f;
+    const float lastBalanceLeft  = (hints & PLUGIN_CAN_BALANCE) ? postProc.lastBalanceLeft  : -1.0f;
+    const float lastBalanceRight = (hints & PLUGIN_CAN_BALANCE) ? postProc.lastBalanceRight : 1.0f;
+
+    // without a dry signal nothing gets mixed, keep the last mix so it can ramp once there is one
+    if (dryBuffers != nullptr)
+        postProc.lastDryWet = dryWet;
+
+    postProc.lastVolume       = volume;
+    postProc.lastBalanceLeft  = balanceLeft;
+    postProc.lastBalanceRight = balanceRight;
+
+    const float frameStep = 1.0f / static_cast<float>(frames);
+
+    // Dry/Wet, the dry signal is delayed by the plugin latency
+    if (dryBuffers != nullptr && audioIn.count > 0 && ! (carla_isEqual(dryWet, 1.0f) && carla_isEqual(lastDryWet, 1.0f)))
+    {
+        const float step = (dryWet - lastDryWet) * frameStep;
+
+        for (uint32_t i=0; i < audioOut.count; ++i)
+        {
+            const uint32_t c = (audioIn.count == 1) ? 0 : i;
+            CARLA_SAFE_ASSERT_BREAK(c < audioIn.count);
+
+            float* const wet = buffers[i] + bufferOffset;
+            const float* const dry = dryBuffers[c] + bufferOffset;
+
+            if (latency.buffers == nullptr || c >= latency.channels)
+            {
+                carla_crossfadeFloatsWithRamp(wet, dry, frames, lastDryWet, step);
+                continue;
+            }
+
+            const uint32_t firstCount  = std::min(frames, latency.frames - latency.position);
+            const uint32_t secondCount = std::min(frames - firstCount, latency.position);
+            const uint32_t delayed     = firstCount + secondCount;
+
+            carla_crossfadeFloatsWithRamp(wet, latency.buffers[c] + latency.position, firstCount, lastDryWet, step);
+
+            if (secondCount > 0)
+                carla_crossfadeFloatsWithRamp(wet + firstCount, latency.buffers[c], secondCount,
+                                              lastDryWet + step * static_cast<float>(firstCount), step);
+
+            if (delayed < frames)
+                carla_crossfadeFloatsWithRamp(wet + delayed, dry, frames - delayed,
+                                              lastDryWet + step * static_cast<float>(delayed), step);
+        }
+    }
+
+    if (dryBuffers != nullptr)
+        latency.storeInput(dryBuffers, audioIn.count, bufferOffset, frames);
+
+    // Balance and Volume, in a single pass per channel pair
+    const bool doBalance = ! (carla_isEqual(balanceLeft,     -1.0f) && carla_isEqual(balanceRight,     1.0f) &&
+                              carla_isEqual(lastBalanceLeft, -1.0f) && carla_isEqual(lastBalanceRight, 1.0f));
+    const bool doVolume  = ! (carla_isEqual(volume, 1.0f) && carla_isEqual(lastVolume, 1.0f));
+    const bool inPlace   = (buffers == outBuffers && bufferOffset == outOffset);
+
+    uint32_t i = 0;
+
+    if (doBalance)
+    {
+        const float balRangeL     = (balanceLeft      + 1.0f)/2.0f;
+        const float balRangeR     = (balanceRight     + 1.0f)/2.0f;
+        const float lastBalRangeL = (lastBalanceLeft  + 1.0f)/2.0f;
+        const float lastBalRangeR = (lastBalanceRight + 1.0f)/2.0f;
+
+        const float gains[4] = {
+            lastVolume * (1.0f - lastBalRangeL),
+            lastVolume * (1.0f - lastBalRangeR),
+            lastVolume * lastBalRangeL,
+            lastVolume * lastBalRangeR
+        };
+        const float steps[4] = {
+            (volume * (1.0f - balRangeL) - gains[0]) * frameStep,
+            (volume * (1.0f - balRangeR) - gains[1]) * frameStep,
+            (volume * balRangeL          - gains[2]) * frameStep,
+            (volume * balRangeR          - gains[3]) * frameStep
+        };
+
+        for (; i+1 < audioOut.count; i += 2)
+            carla_mixFloatPairWithRamp(outBuffers[i] + outOffset, outBuffers[i+1] + outOffset,
+                                       buffers[i] + bufferOffset, buffers[i+1] + bufferOffset, frames, gains, steps);
+    }
+
+    // channels without a pair, or everything if not balancing
+    if (doVolume || ! inPlace)
+    {
+        const float step = (volume - lastVolume) * frameStep;
+
+        for (; i < audioOut.count; ++i)
+            carla_multiplyFloatsWithRamp(outBuffers[i] + outOffset, buffers[i] + bufferOffset, frames, lastVolume, step);
+    }
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Library functions
 
@@ -25,6 +25,8 @@
 
 #include "CarlaMIDI.h"
 #include "CarlaMutex.hpp"
+#include "CarlaOversampler.hpp"
+#include "CarlaRtLogUtils.hpp"
 #include "CarlaString.hpp"
 #include "RtLinkedList.hpp"
 
@@ -34,6 +36,8 @@ using juce::FloatVectorOperations;
 
 CARLA_BACKEND_START_NAMESPACE
 
+struct EngineEvent;
+
 // -----------------------------------------------------------------------
 // Engine helper macro, sets lastError and returns false/NULL
 
@@ -168,12 +172,35 @@ struct PluginParameterData {
     ParameterRanges* ranges;
     SpecialParameterType* special;
 
+    // last output values seen by process(), and a bitmap of the ones the engine thread has not sent yet
+    float* outputValues;
+    uint32_t* outputChanged;
+
+    // MIDI CC to parameter lookup, per channel, as linked lists of parameter indexes ending with 'count'.
+    // only used by the audio thread, which rebuilds it after any MIDI CC or channel change
+    uint32_t* midiCCFirst;
+    uint32_t* midiCCNext;
+    int midiCCChanged;
+
     PluginParameterData() noexcept;
     ~PluginParameterData() noexcept;
     void createNew(const uint32_t newCount, const bool withSpecial);
     void clear() noexcept;
     float getFixedValue(const uint32_t parameterId, const float& value) const noexcept;
 
+    // RT-safe, marks the output parameter as changed if 'value' differs from the last one
+    void setOutputValue(const uint32_t parameterId, const float value) noexcept;
+    bool takeNextChangedOutput(uint32_t& parameterId) noexcept;
+
+    // non-RT, to be called after changing the MIDI CC or channel of any parameter
+    void midiCCMappingChanged() noexcept;
+
+    // RT-safe, first parameter mapped to 'cc' on 'channel', 'count' if none
+    uint32_t getFirstMidiCCParameter(const uint8_t channel, const uint16_t cc) noexcept;
+
+    // RT-safe, next parameter mapped to the same MIDI CC and channel as 'parameterId', 'count' if none
+    uint32_t getNextMidiCCParameter(const uint32_t parameterId) const noexcept;
+
     CARLA_DECLARE_NON_COPY_STRUCT(PluginParameterData)
 };
 
@@ -253,6 +280,8 @@ struct CarlaPlugin::ProtectedData {
     CarlaMutex singleMutex; // small lock used only in processSingle()
 
     CarlaStateSave stateSave;
+    uint stateChanges;     // increased every time the state changes through the host
+    uint stateSaveChanges; // value of stateChanges when stateSave was last filled
 
     struct ExternalNotes {
         CarlaMutex mutex;
@@ -272,6 +301,7 @@ struct CarlaPlugin::ProtectedData {
         uint32_t frames;
 #ifndef BUILD_BRIDGE
         uint32_t channels;
+        uint32_t position; // oldest frame, the buffers are circular
         float**  buffers;
 #endif
 
@@ -280,6 +310,7 @@ struct CarlaPlugin::ProtectedData {
         ~Latency() noexcept;
         void clearBuffers() noexcept;
         void recreateBuffers(const uint32_t newChannels, const uint32_t newFrames);
+        void storeInput(const float* const* const inBuffers, const uint32_t inCount, const uint32_t offset, const uint32_t inFrames) noexcept;
 #endif
 
         CARLA_DECLARE_NON_COPY_STRUCT(Latency)
@@ -315,6 +346,73 @@ struct CarlaPlugin::ProtectedData {
 
     } postUiEvents;
 
+    // FIFOs used to process the plugin at a bigger block size than the engine, see PLUGIN_OPTION_REBLOCK.
+    // Blocks alternate between 2 sets of buffers when using the worker thread.
+    struct Reblock {
+        class Worker;
+
+        uint32_t blockSize;        // internal block size, 0 when not re-blocking
+        uint32_t engineBufferSize; // engine buffer size the FIFOs were created for
+        uint32_t audioInCount;
+        uint32_t audioOutCount;
+        uint32_t position;         // frames written into the current block
+        uint32_t current;          // index of the current block buffers
+        uint32_t eventInCount;     // events written into the current block
+        uint32_t eventOutIndex;    // next event to send from the current block
+        bool     jobPending;       // worker is processing the other block
+
+        float** audioIn[2];
+        float** audioOut[2];
+        EngineEvent* eventsIn[2];
+        EngineEvent* eventsOut[2];
+
+        // engine ports redirected to the block being processed
+        CarlaEngineEventPort* jobPortIn;
+        CarlaEngineEventPort* jobPortOut;
+
+        Worker* worker;
+
+        Reblock() noexcept;
+        ~Reblock() noexcept;
+        void clear() noexcept;
+        void recreate(const uint32_t newBlockSize, const uint32_t newEngineBufferSize,
+                      const uint32_t newAudioInCount, const uint32_t newAudioOutCount, const bool threaded);
+        void startWorker(CarlaPlugin* const plugin) noexcept;
+        void stopWorker() noexcept;
+        void postJob(const uint32_t index) noexcept;
+        bool waitJob(const uint msecs) noexcept; // 0 checks without blocking
+        uint32_t getLatency() const noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Reblock)
+
+    } reblock;
+
+    // buffers used to process the plugin at a multiple of the engine sample rate, see PLUGIN_OPTION_OVERSAMPLE.
+    // Sits between the re-blocking FIFOs and the plugin, so it also runs in the re-blocking worker thread.
+    struct Oversample {
+        uint32_t factor;        // 1 when not oversampling
+        uint32_t maxFrames;     // maximum engine rate frames per process call
+        uint32_t audioInCount;
+        uint32_t audioOutCount;
+
+        float** audioIn;
+        float** audioOut;
+        EngineEvent* eventsIn;
+        EngineEvent* eventsOut;
+
+        CarlaOversampler oversampler;
+
+        Oversample() noexcept;
+        ~Oversample() noexcept;
+        void clear() noexcept;
+        void recreate(const uint32_t newFactor, const uint32_t newMaxFrames,
+                      const uint32_t newAudioInCount, const uint32_t newAudioOutCount);
+        uint32_t getLatency() const noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Oversample)
+
+    } oversample;
+
 #ifndef BUILD_BRIDGE
     struct PostProc {
         float dryWet;
@@ -323,11 +421,49 @@ struct CarlaPlugin::ProtectedData {
         float balanceRight;
         float panning;
 
+        // values reached at the end of the last processed block, changes ramp from these
+        float lastDryWet;
+        float lastVolume;
+        float lastBalanceLeft;
+        float lastBalanceRight;
+
         PostProc() noexcept;
+        void resetRamps() noexcept;
 
         CARLA_DECLARE_NON_COPY_STRUCT(PostProc)
 
     } postProc;
+
+    struct Silence {
+        bool     sleeping;
+        bool     inputSilent;
+        bool     outputHint; // set by plugins that know their outputs are silent
+        uint32_t frames;     // consecutive silent frames
+
+        Silence() noexcept;
+        void reset() noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Silence)
+
+    } silence;
+
+    // overload degradation, see PLUGIN_OPTION_EXPENDABLE
+    struct Degrade {
+        volatile bool reducedRate;  // read by the audio thread
+        volatile bool bypassed;     // read by the audio thread
+        uint32_t skipCycles;        // cycles left to skip while at a reduced rate
+        int32_t  polyphonyParam;    // lowered parameter, -1 if none
+        float    polyphonyValue;    // its value before being lowered
+        float    polyphonyLowered;  // the lowered value, left alone on restore if changed since
+        float    load;              // smoothed DSP load, in percent
+        uint64_t processTicks;      // time spent in process since the last load update
+        uint32_t processFrames;     // frames processed since the last load update
+
+        Degrade() noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Degrade)
+
+    } degrade;
 #endif
 
     ProtectedData(CarlaEngine* const engine, const uint idx) noexcept;
@@ -338,12 +474,26 @@ struct CarlaPlugin::ProtectedData {
 
     void clearBuffers() noexcept;
 
+    // maximum frames per process call, bigger than the engine buffer size when re-blocking or oversampling
+    uint32_t getBufferSize() const noexcept;
+
+    // sample rate the plugin runs at, a multiple of the engine one when oversampling
+    double getSampleRate() const noexcept;
+
     // -------------------------------------------------------------------
     // Post-poned events
 
     void postponeRtEvent(const PluginPostRtEvent& rtEvent) noexcept;
     void postponeRtEvent(const PluginPostRtEventType type, const int32_t value1, const int32_t value2, const float value3) noexcept;
 
+#ifndef BUILD_BRIDGE
+    // -------------------------------------------------------------------
+    // Post-processing (dry/wet, balance and volume)
+
+    void postProcess(const float* const* const dryBuffers, float* const* const buffers, float* const* const outBuffers,
+                     const uint32_t bufferOffset, const uint32_t outOffset, const uint32_t frames) noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Library functions
 
@@ -21,6 +21,7 @@
 #if (defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN))
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "JucePluginWindow.hpp"
 
@@ -35,6 +36,15 @@ CARLA_BACKEND_START_NAMESPACE
 
 static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
 
+// -------------------------------------------------------------------------------------------------------------------
+// Buffer limits
+
+// juce::AudioBuffer only refers to external data without allocating when below this channel count
+static const uint kMaxInPlaceChannels = 32;
+
+// enough space for a full cycle of engine events, so we never allocate MIDI data while processing
+static const size_t kMidiBufferPreallocSize = kMaxEngineEventInternalCount * (sizeof(int32) + sizeof(int16) + EngineMidiEvent::kDataSize);
+
 // -------------------------------------------------------------------------------------------------------------------
 
 class CarlaPluginJuce : public CarlaPlugin,
@@ -48,6 +58,8 @@ public:
           fInstance(nullptr),
           fFormatManager(),
           fAudioBuffer(),
+          fAudioRefBuffer(),
+          fAudioRefPointers(nullptr),
           fMidiBuffer(),
           fPosInfo(),
           fChunk(),
@@ -55,7 +67,7 @@ public:
     {
         carla_debug("CarlaPluginJuce::CarlaPluginJuce(%p, %i)", engine, id);
 
-        fMidiBuffer.ensureSize(2048);
+        fMidiBuffer.ensureSize(kMidiBufferPreallocSize);
         fMidiBuffer.clear();
         fPosInfo.resetToDefault();
     }
@@ -70,6 +82,7 @@ public:
 
         pData->singleMutex.lock();
         pData->masterMutex.lock();
+        pData->reblock.stopWorker();
 
         if (pData->client != nullptr && pData->client->isActive())
             pData->client->deactivate();
@@ -163,6 +176,11 @@ public:
             options |= PLUGIN_OPTION_SEND_ALL_SOUND_OFF;
         }
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_REBLOCK;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+        options |= PLUGIN_OPTION_OVERSAMPLE;
+
         return options;
     }
 
@@ -560,9 +578,9 @@ public:
         if (aIns <= 2 && aOuts <= 2 && (aIns == aOuts || aIns == 0 || aOuts == 0))
             pData->extraHints |= PLUGIN_EXTRA_HINT_CAN_RUN_RACK;
 
-        fInstance->setPlayConfigDetails(static_cast<int>(aIns), static_cast<int>(aOuts), pData->engine->getSampleRate(), static_cast<int>(pData->engine->getBufferSize()));
+        fInstance->setPlayConfigDetails(static_cast<int>(aIns), static_cast<int>(aOuts), pData->getSampleRate(), static_cast<int>(pData->getBufferSize()));
 
-        bufferSizeChanged(pData->engine->getBufferSize());
+        bufferSizeChanged(pData->getBufferSize());
         reloadPrograms(true);
 
         if (pData->active)
@@ -666,7 +684,7 @@ public:
         CARLA_SAFE_ASSERT_RETURN(fInstance != nullptr,);
 
         try {
-            fInstance->prepareToPlay(pData->engine->getSampleRate(), static_cast<int>(pData->engine->getBufferSize()));
+            fInstance->prepareToPlay(pData->getSampleRate(), static_cast<int>(pData->getBufferSize()));
         } catch(...) {}
     }
 
@@ -807,13 +825,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        uint32_t k;
-                        for (k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].type != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -1000,22 +1014,68 @@ public:
             return false;
         }
 
-        // --------------------------------------------------------------------------------------------------------
-        // Set audio in buffers
+        if (canProcessInPlace(inBuffer, outBuffer))
+        {
+            // ----------------------------------------------------------------------------------------------------
+            // Run plugin directly on the engine output buffers
 
-        for (uint32_t i=0; i < pData->audioIn.count; ++i)
-            fAudioBuffer.copyFrom(static_cast<int>(i), 0, inBuffer[i], static_cast<int>(frames));
+            const uint32_t channels = std::max<uint32_t>(pData->audioIn.count, pData->audioOut.count);
 
-        // --------------------------------------------------------------------------------------------------------
-        // Run plugin
+            for (uint32_t i=0; i < channels; ++i)
+            {
+                if (i < pData->audioOut.count)
+                {
+                    fAudioRefPointers[i] = outBuffer[i];
 
-        fInstance->processBlock(fAudioBuffer, fMidiBuffer);
+                    if (i >= pData->audioIn.count)
+                        FloatVectorOperations::clear(outBuffer[i], static_cast<int>(frames));
+                    else if (outBuffer[i] != inBuffer[i])
+                        FloatVectorOperations::copy(outBuffer[i], inBuffer[i], static_cast<int>(frames));
+                }
+                else
+                {
+                    // more inputs than outputs, extra channels still need writable space
+                    fAudioRefPointers[i] = fAudioBuffer.getWritePointer(static_cast<int>(i));
+                    FloatVectorOperations::copy(fAudioRefPointers[i], inBuffer[i], static_cast<int>(frames));
+                }
+            }
 
-        // --------------------------------------------------------------------------------------------------------
-        // Set audio out buffers
+            fAudioRefBuffer.setDataToReferTo(fAudioRefPointers, static_cast<int>(channels), static_cast<int>(frames));
+            fInstance->processBlock(fAudioRefBuffer, fMidiBuffer);
 
-        for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            FloatVectorOperations::copy(outBuffer[i], fAudioBuffer.getReadPointer(static_cast<int>(i)), static_cast<int>(frames));
+#ifndef BUILD_BRIDGE
+            // ----------------------------------------------------------------------------------------------------
+            // Post-processing (volume and balance)
+
+            pData->postProcess(nullptr, outBuffer, outBuffer, 0, 0, frames);
+#endif
+        }
+        else
+        {
+            // ----------------------------------------------------------------------------------------------------
+            // Set audio in buffers
+
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                fAudioBuffer.copyFrom(static_cast<int>(i), 0, inBuffer[i], static_cast<int>(frames));
+
+            // ----------------------------------------------------------------------------------------------------
+            // Run plugin
+
+            fInstance->processBlock(fAudioBuffer, fMidiBuffer);
+
+#ifndef BUILD_BRIDGE
+            // ----------------------------------------------------------------------------------------------------
+            // Post-processing (dry/wet, volume and balance) into the audio out buffers
+
+            pData->postProcess(inBuffer, fAudioBuffer.getArrayOfWritePointers(), outBuffer, 0, 0, frames);
+#else
+            // ----------------------------------------------------------------------------------------------------
+            // Set audio out buffers
+
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                FloatVectorOperations::copy(outBuffer[i], fAudioBuffer.getReadPointer(static_cast<int>(i)), static_cast<int>(frames));
+#endif
+        }
 
         // --------------------------------------------------------------------------------------------------------
         // Midi out
@@ -1046,12 +1106,52 @@ public:
         return true;
     }
 
+    // Engine outputs can be used as the plugin buffer if writing into them never clobbers an input not yet read.
+    // That is the case when each output either aliases its own input or no input at all.
+    bool canProcessInPlace(const float** const inBuffer, float** const outBuffer) const noexcept
+    {
+        if (fAudioRefPointers == nullptr)
+            return false;
+
+#ifndef BUILD_BRIDGE
+        // inputs might be overwritten, dry/wet needs them after processing
+        if ((pData->hints & PLUGIN_CAN_DRYWET) != 0 && ! (carla_isEqual(pData->postProc.dryWet, 1.0f) &&
+                                                         carla_isEqual(pData->postProc.lastDryWet, 1.0f)))
+            return false;
+#endif
+
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        {
+            for (uint32_t j=0; j < pData->audioIn.count; ++j)
+            {
+                if (i != j && outBuffer[i] == inBuffer[j])
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
     void bufferSizeChanged(const uint32_t newBufferSize) override
     {
         CARLA_ASSERT_INT(newBufferSize > 0, newBufferSize);
         carla_debug("CarlaPluginJuce::bufferSizeChanged(%i)", newBufferSize);
 
-        fAudioBuffer.setSize(static_cast<int>(std::max<uint32_t>(pData->audioIn.count, pData->audioOut.count)), static_cast<int>(newBufferSize));
+        const uint32_t channels = std::max<uint32_t>(pData->audioIn.count, pData->audioOut.count);
+
+        fAudioBuffer.setSize(static_cast<int>(channels), static_cast<int>(newBufferSize));
+
+        if (fAudioRefPointers != nullptr)
+        {
+            delete[] fAudioRefPointers;
+            fAudioRefPointers = nullptr;
+        }
+
+        if (channels > 0 && channels < kMaxInPlaceChannels)
+        {
+            fAudioRefPointers = new float*[channels];
+            carla_zeroPointers(fAudioRefPointers, channels);
+        }
 
         if (pData->active)
         {
@@ -1075,7 +1175,20 @@ public:
     // -------------------------------------------------------------------
     // Plugin buffers
 
-    // nothing
+    void clearBuffers() noexcept override
+    {
+        carla_debug("CarlaPluginJuce::clearBuffers() - start");
+
+        if (fAudioRefPointers != nullptr)
+        {
+            delete[] fAudioRefPointers;
+            fAudioRefPointers = nullptr;
+        }
+
+        CarlaPlugin::clearBuffers();
+
+        carla_debug("CarlaPluginJuce::clearBuffers() - end");
+    }
 
     // -------------------------------------------------------------------
     // Post-poned UI Stuff
@@ -1246,6 +1359,8 @@ private:
     AudioPluginFormatManager fFormatManager;
 
     AudioSampleBuffer   fAudioBuffer;
+    AudioSampleBuffer   fAudioRefBuffer;
+    float**             fAudioRefPointers;
     MidiBuffer          fMidiBuffer;
     CurrentPositionInfo fPosInfo;
     MemoryBlock         fChunk;
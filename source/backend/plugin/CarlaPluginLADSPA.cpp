@@ -53,6 +53,7 @@ public:
 
         pData->singleMutex.lock();
         pData->masterMutex.lock();
+        pData->reblock.stopWorker();
 
         if (pData->client != nullptr && pData->client->isActive())
             pData->client->deactivate();
@@ -198,6 +199,11 @@ public:
         else if (pData->audioIn.count == 1 || pData->audioOut.count == 1 || fForcedStereoIn || fForcedStereoOut)
             options |= PLUGIN_OPTION_FORCE_STEREO;
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_REBLOCK;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+        options |= PLUGIN_OPTION_OVERSAMPLE;
+
         return options;
     }
 
@@ -786,7 +792,7 @@ public:
         fForcedStereoIn  = forcedStereoIn;
         fForcedStereoOut = forcedStereoOut;
 
-        bufferSizeChanged(pData->engine->getBufferSize());
+        bufferSizeChanged(pData->getBufferSize());
 
         if (pData->active)
             activate();
@@ -1005,12 +1011,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].type != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -1073,7 +1076,6 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Control Output
 
-        if (pData->event.portOut != nullptr)
         {
             uint8_t  channel;
             uint16_t param;
@@ -1085,8 +1087,9 @@ public:
                     continue;
 
                 pData->param.ranges[k].fixValue(fParamBuffers[k]);
+                pData->param.setOutputValue(k, fParamBuffers[k]);
 
-                if (pData->param.data[k].midiCC > 0)
+                if (pData->param.data[k].midiCC > 0 && pData->event.portOut != nullptr)
                 {
                     channel = pData->param.data[k].midiChannel;
                     param   = static_cast<uint16_t>(pData->param.data[k].midiCC);
@@ -1187,102 +1190,7 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (k < pData->latency.frames)
-                            bufValue = pData->latency.buffers[c][k];
-                        else if (pData->latency.frames < frames)
-                            bufValue = fAudioInBuffers[c][k-pData->latency.frames];
-                        else
-                            bufValue = fAudioInBuffers[c][k];
-
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, fAudioOutBuffers[i], iframes);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
-
-        } // End of Post-processing
-
-        // --------------------------------------------------------------------------------------------------------
-        // Save latency values for next callback
-
-        if (const uint32_t latframes = pData->latency.frames)
-        {
-            CARLA_SAFE_ASSERT(timeOffset == 0);
-
-            if (latframes <= frames)
-            {
-                for (uint32_t i=0; i < pData->audioIn.count; ++i)
-                    FloatVectorOperations::copy(pData->latency.buffers[i], audioIn[i]+(frames-latframes), static_cast<int>(latframes));
-            }
-            else
-            {
-                const uint32_t diff = pData->latency.frames-frames;
-
-                for (uint32_t i=0, k; i<pData->audioIn.count; ++i)
-                {
-                    // push back buffer by 'frames'
-                    for (k=0; k < diff; ++k)
-                        pData->latency.buffers[i][k] = pData->latency.buffers[i][k+frames];
-
-                    // put current input at the end
-                    for (uint32_t j=0; k < latframes; ++j, ++k)
-                        pData->latency.buffers[i][k] = audioIn[i][j];
-                }
-            }
-        }
+        pData->postProcess(fAudioInBuffers, fAudioOutBuffers, audioOut, 0, timeOffset, frames);
 
 #else // BUILD_BRIDGE
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
@@ -1724,7 +1632,7 @@ private:
         LADSPA_Handle handle;
 
         try {
-            handle = fDescriptor->instantiate(fDescriptor, static_cast<ulong>(pData->engine->getSampleRate()));
+            handle = fDescriptor->instantiate(fDescriptor, static_cast<ulong>(pData->getSampleRate()));
         } CARLA_SAFE_EXCEPTION_RETURN_ERR("LADSPA instantiate", "Plugin failed to initialize");
 
         for (uint32_t i=0, count=pData->param.count; i<count; ++i)
@@ -29,6 +29,7 @@
 #include "CarlaPipeUtils.hpp"
 #include "CarlaPluginUI.hpp"
 #include "Lv2AtomRingBuffer.hpp"
+#include "Lv2AtomShmChannel.hpp"
 
 #include "../engine/CarlaEngineOsc.hpp"
 #include "../modules/lilv/config/lilv_config.h"
@@ -424,7 +425,8 @@ public:
           fFilename(),
           fPluginURI(),
           fUiURI(),
-          fUiState(UiNone) {}
+          fUiState(UiNone),
+          fAtomChannel() {}
 
     ~CarlaPipeServerLV2() noexcept override
     {
@@ -456,6 +458,36 @@ public:
         return CarlaPipeServer::startPipeServer(fFilename, fPluginURI, fUiURI, size);
     }
 
+    void stopPipeServer(const uint32_t timeOutMilliseconds) noexcept
+    {
+        CarlaPipeServer::stopPipeServer(timeOutMilliseconds);
+        fAtomChannel.clear();
+    }
+
+    // must be called with the pipe lock held
+    void writeAtomChannelMessage() noexcept
+    {
+        // in case the previous UI process crashed
+        fAtomChannel.clear();
+
+        if (! fAtomChannel.initialize())
+            return;
+
+        _writeMsgBuffer("atomShm\n", 8);
+        writeAndFixMessage(fAtomChannel.getFilename());
+    }
+
+    // atoms are sent in a batch, the UI is woken up on flushAtoms()
+    void writeAtom(const uint32_t portIndex, const LV2_Atom* const atom) noexcept
+    {
+        fAtomChannel.writeAtom(*this, portIndex, atom);
+    }
+
+    void flushAtoms() noexcept
+    {
+        fAtomChannel.flush(*this);
+    }
+
     void writeUiTitleMessage(const char* const title) const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(title != nullptr && title[0] != '\0',);
@@ -480,6 +512,8 @@ private:
     CarlaString fUiURI;
     UiState     fUiState;
 
+    Lv2AtomShmChannel fAtomChannel;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPipeServerLV2)
 };
 
@@ -601,6 +635,7 @@ public:
 
         pData->singleMutex.lock();
         pData->masterMutex.lock();
+        pData->reblock.stopWorker();
 
         if (pData->client != nullptr && pData->client->isActive())
             pData->client->deactivate();
@@ -835,6 +870,11 @@ public:
             options |= PLUGIN_OPTION_SEND_PROGRAM_CHANGES;
         }
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_REBLOCK;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+        options |= PLUGIN_OPTION_OVERSAMPLE;
+
         return options;
     }
 
@@ -1080,6 +1120,15 @@ public:
         }
     }
 
+    bool isStateSaveOutdated() const noexcept override
+    {
+        // internal state is only known after asking the plugin to save it
+        if (fExt.state != nullptr && fExt.state->save != nullptr)
+            return true;
+
+        return CarlaPlugin::isStateSaveOutdated();
+    }
+
     // -------------------------------------------------------------------
     // Set data (internal stuff)
 
@@ -1334,6 +1383,9 @@ public:
                         fPipeServer.writeMessage(tmpBuf);
                     }
 
+                    // binary atom channel, used once the UI attaches to it
+                    fPipeServer.writeAtomChannelMessage();
+
                     // ready to show
                     fPipeServer.writeMessage("show\n", 5);
 
@@ -1520,7 +1572,7 @@ public:
                 else if (fUI.type == UI::TYPE_BRIDGE)
                 {
                     if (fPipeServer.isPipeRunning())
-                        fPipeServer.writeLv2AtomMessage(portIndex, atom);
+                        fPipeServer.writeAtom(portIndex, atom);
                 }
                 else
                 {
@@ -1532,6 +1584,7 @@ public:
 
         if (fPipeServer.isPipeRunning())
         {
+            fPipeServer.flushAtoms();
             fPipeServer.idlePipe();
 
             switch (fPipeServer.getAndResetUiState())
@@ -2400,7 +2453,7 @@ public:
         // check initial latency
         findInitialLatencyValue(aIns, aOuts);
 
-        bufferSizeChanged(pData->engine->getBufferSize());
+        bufferSizeChanged(pData->getBufferSize());
         reloadPrograms(true);
 
         evIns.clear();
@@ -2944,7 +2997,7 @@ public:
                         }
                         else if (! lv2_atom_buffer_write(&evInAtomIters[j], 0, 0, atom->type, atom->size, LV2_ATOM_BODY_CONST(atom)))
                         {
-                            carla_stdout("Event input buffer full, at least 1 message lost");
+                            carla_rt_stdout("Event input buffer full, at least 1 message lost");
                             continue;
                         }
                     }
@@ -3139,13 +3192,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        uint32_t k;
-                        for (k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].type != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -3465,15 +3514,15 @@ public:
             }
         }
 
-#ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
         // Control Output
 
-        if (pData->event.portOut != nullptr)
         {
+#ifndef BUILD_BRIDGE
             uint8_t  channel;
             uint16_t param;
             float    value;
+#endif
 
             for (uint32_t k=0; k < pData->param.count; ++k)
             {
@@ -3484,16 +3533,19 @@ public:
                     // plugin is responsible to ensure correct bounds
                     pData->param.ranges[k].fixValue(fParamBuffers[k]);
 
-                if (pData->param.data[k].midiCC > 0)
+                pData->param.setOutputValue(k, fParamBuffers[k]);
+
+#ifndef BUILD_BRIDGE
+                if (pData->param.data[k].midiCC > 0 && pData->event.portOut != nullptr)
                 {
                     channel = pData->param.data[k].midiChannel;
                     param   = static_cast<uint16_t>(pData->param.data[k].midiCC);
                     value   = pData->param.ranges[k].getNormalizedValue(fParamBuffers[k]);
                     pData->event.portOut->writeControlEvent(0, channel, kEngineControlEventTypeParameter, param, value);
                 }
+#endif
             }
         } // End of Control Output
-#endif
 
         // --------------------------------------------------------------------------------------------------------
         // Final work
@@ -3607,101 +3659,7 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
-        {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-            const bool isMono    = (pData->audioIn.count == 1);
-
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    const uint32_t c = isMono ? 0 : i;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (k < pData->latency.frames)
-                            bufValue = pData->latency.buffers[c][k];
-                        else if (pData->latency.frames < frames)
-                            bufValue = fAudioInBuffers[c][k-pData->latency.frames];
-                        else
-                            bufValue = fAudioInBuffers[c][k];
-
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, fAudioOutBuffers[i], iframes);
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
-        } // End of Post-processing
-
-        // --------------------------------------------------------------------------------------------------------
-        // Save latency values for next callback
-
-        if (const uint32_t latframes = pData->latency.frames)
-        {
-            CARLA_SAFE_ASSERT(timeOffset == 0);
-
-            if (latframes <= frames)
-            {
-                for (uint32_t i=0; i < pData->audioIn.count; ++i)
-                    FloatVectorOperations::copy(pData->latency.buffers[i], audioIn[i]+(frames-latframes), static_cast<int>(latframes));
-            }
-            else
-            {
-                const uint32_t diff = pData->latency.frames-frames;
-
-                for (uint32_t i=0, k; i<pData->audioIn.count; ++i)
-                {
-                    // push back buffer by 'frames'
-                    for (k=0; k < diff; ++k)
-                        pData->latency.buffers[i][k] = pData->latency.buffers[i][k+frames];
-
-                    // put current input at the end
-                    for (uint32_t j=0; k < latframes; ++j, ++k)
-                        pData->latency.buffers[i][k] = audioIn[i][j];
-                }
-            }
-        }
+        pData->postProcess(fAudioInBuffers, fAudioOutBuffers, audioOut, 0, timeOffset, frames);
 
 #else // BUILD_BRIDGE
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
@@ -4889,12 +4847,12 @@ public:
         // ---------------------------------------------------------------
         // initialize options
 
-        const int bufferSize = static_cast<int>(pData->engine->getBufferSize());
+        const int bufferSize = static_cast<int>(pData->getBufferSize());
 
         fLv2Options.minBufferSize     = fNeedsFixedBuffers ? bufferSize : 1;
         fLv2Options.maxBufferSize     = bufferSize;
         fLv2Options.nominalBufferSize = bufferSize;
-        fLv2Options.sampleRate        = pData->engine->getSampleRate();
+        fLv2Options.sampleRate        = pData->getSampleRate();
         fLv2Options.frontendWinId     = static_cast<int64_t>(pData->engine->getOptions().frontendWinId);
 
         uint32_t eventBufferSize = MAX_DEFAULT_BUFFER_SIZE;
@@ -5036,7 +4994,7 @@ public:
         // initialize plugin
 
         try {
-            fHandle = fDescriptor->instantiate(fDescriptor, pData->engine->getSampleRate(), fRdfDescriptor->Bundle, fFeatures);
+            fHandle = fDescriptor->instantiate(fDescriptor, pData->getSampleRate(), fRdfDescriptor->Bundle, fFeatures);
         } catch(...) {}
 
         if (fHandle == nullptr)
@@ -6196,6 +6154,30 @@ bool CarlaPipeServerLV2::msgReceived(const char* const msg) noexcept
         return true;
     }
 
+    if (std::strcmp(msg, "atomShm") == 0)
+    {
+        fAtomChannel.setReady();
+        return true;
+    }
+
+    if (std::strcmp(msg, "atomShmData") == 0)
+    {
+        uint32_t count, index;
+        const LV2_Atom* atom;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(count), true);
+
+        for (; count > 0 && fAtomChannel.readAtom(index, atom); --count)
+        {
+            try {
+                kPlugin->handleUIWrite(index, lv2_atom_total_size(atom), CARLA_URI_MAP_ID_ATOM_TRANSFER_EVENT, atom);
+            } CARLA_SAFE_EXCEPTION("msgReceived atomShmData");
+        }
+
+        CARLA_SAFE_ASSERT_UINT(count == 0, count);
+        return true;
+    }
+
     if (std::strcmp(msg, "program") == 0)
     {
         uint32_t index;
@@ -326,6 +326,9 @@ public:
         if (kIsGIG)
             options |= PLUGIN_OPTION_MAP_PROGRAM_CHANGES;
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+
         return options;
     }
 
@@ -930,12 +933,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].hints != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -1060,6 +1060,9 @@ public:
 
         fParamBuffers[LinuxSamplerDiskStreamCount] = static_cast<float>(diskStreamCount);
         fParamBuffers[LinuxSamplerVoiceCount]      = static_cast<float>(voiceCount);
+
+        pData->param.setOutputValue(LinuxSamplerDiskStreamCount, fParamBuffers[LinuxSamplerDiskStreamCount]);
+        pData->param.setOutputValue(LinuxSamplerVoiceCount, fParamBuffers[LinuxSamplerVoiceCount]);
     }
 
     bool processSingle(float** const outBuffer, const uint32_t frames, const uint32_t timeOffset)
@@ -1098,51 +1101,9 @@ public:
 
 #ifndef BUILD_BRIDGE
         // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
-        {
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-
-            float oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Balance
-                if (doBalance)
-                {
-                    if (i % 2 == 0)
-                        FloatVectorOperations::copy(oldBufLeft, outBuffer[i], static_cast<int>(frames));
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (i % 2 == 0)
-                        {
-                            // left
-                            outBuffer[i][k]  = oldBufLeft[k]     * (1.0f - balRangeL);
-                            outBuffer[i][k] += outBuffer[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            outBuffer[i][k]  = outBuffer[i][k] * balRangeR;
-                            outBuffer[i][k] += oldBufLeft[k]   * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume
-                if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] *= pData->postProc.volume;
-                }
-            }
+        // Post-processing (volume and balance)
 
-        } // End of Post-processing
+        pData->postProcess(nullptr, outBuffer, outBuffer, timeOffset, timeOffset, frames);
 #endif
 
         // --------------------------------------------------------------------------------------------------------
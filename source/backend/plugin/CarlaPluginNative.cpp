@@ -20,6 +20,7 @@
 
 #include "CarlaMathUtils.hpp"
 #include "CarlaNative.h"
+#include "CarlaRingBuffer.hpp"
 
 #include "juce_core/juce_core.h"
 
@@ -191,9 +192,14 @@ public:
           fMidiEventCount(0),
           fCurBufferSize(engine->getBufferSize()),
           fCurSampleRate(engine->getSampleRate()),
+          fLatency(0),
+          fOutputFlags(nullptr),
+          fOutputsSilent(false),
           fMidiIn(),
           fMidiOut(),
-          fTimeInfo()
+          fTimeInfo(),
+          fWorkerJobs(),
+          fWorkerResponses()
     {
         carla_debug("CarlaPluginNative::CarlaPluginNative(%p, %i)", engine, id);
 
@@ -234,6 +240,7 @@ public:
 
         pData->singleMutex.lock();
         pData->masterMutex.lock();
+        pData->reblock.stopWorker();
 
         if (pData->client != nullptr && pData->client->isActive())
             pData->client->deactivate();
@@ -246,6 +253,10 @@ public:
             pData->active = false;
         }
 
+        // finish pending worker jobs, plugin is not processing anymore
+        runWorkerJobs();
+        runWorkerResponses();
+
         if (fDescriptor != nullptr)
         {
             if (fDescriptor->cleanup != nullptr)
@@ -327,6 +338,11 @@ public:
     // -------------------------------------------------------------------
     // Information (per-plugin data)
 
+    uint32_t getLatencyInFrames() const noexcept override
+    {
+        return fLatency;
+    }
+
     uint getOptionsAvailable() const noexcept override
     {
         CARLA_SAFE_ASSERT_RETURN(fDescriptor != nullptr, 0x0);
@@ -370,6 +386,11 @@ public:
         else if (hasMidiProgs)
             options |= PLUGIN_OPTION_MAP_PROGRAM_CHANGES;
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_REBLOCK;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+        options |= PLUGIN_OPTION_OVERSAMPLE;
+
         return options;
     }
 
@@ -870,10 +891,14 @@ public:
         {
             pData->audioOut.createNew(aOuts);
             fAudioOutBuffers = new float*[aOuts];
+            fOutputFlags = new uint[aOuts];
             needsCtrlIn = true;
 
             for (uint32_t i=0; i < aOuts; ++i)
+            {
                 fAudioOutBuffers[i] = nullptr;
+                fOutputFlags[i] = 0x0;
+            }
         }
 
         if (mIns > 0)
@@ -1178,7 +1203,7 @@ public:
         if (aIns <= 2 && aOuts <= 2 && (aIns == aOuts || aIns == 0 || aOuts == 0) && mIns <= 1 && mOuts <= 1)
             pData->extraHints |= PLUGIN_EXTRA_HINT_CAN_RUN_RACK;
 
-        bufferSizeChanged(pData->engine->getBufferSize());
+        bufferSizeChanged(pData->getBufferSize());
         reloadPrograms(true);
 
         if (pData->active)
@@ -1336,6 +1361,14 @@ public:
         fMidiEventCount = 0;
         carla_zeroStructs(fMidiEvents, kPluginMaxMidiEvents*2);
 
+        // --------------------------------------------------------------------------------------------------------
+        // Complete worker jobs finished since last cycle
+
+        runWorkerResponses();
+
+        // output flags are per instance, can't use them when forcing stereo
+        fOutputsSilent = (fHandle2 == nullptr && pData->audioOut.count > 0);
+
         // --------------------------------------------------------------------------------------------------------
         // Check if needs reset
 
@@ -1547,12 +1580,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].type != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -1771,12 +1801,10 @@ public:
         } // End of Plugin processing (no events)
 
         // --------------------------------------------------------------------------------------------------------
-        // Control and MIDI Output
+        // Control Output
 
-        if (pData->event.portOut != nullptr)
         {
-#ifndef BUILD_BRIDGE
-            float value, curValue;
+            float curValue;
 
             for (uint32_t k=0; k < pData->param.count; ++k)
             {
@@ -1785,15 +1813,23 @@ public:
 
                 curValue = fDescriptor->get_parameter_value(fHandle, k);
                 pData->param.ranges[k].fixValue(curValue);
+                pData->param.setOutputValue(k, curValue);
 
-                if (pData->param.data[k].midiCC > 0)
+#ifndef BUILD_BRIDGE
+                if (pData->param.data[k].midiCC > 0 && pData->event.portOut != nullptr)
                 {
-                    value = pData->param.ranges[k].getNormalizedValue(curValue);
+                    const float value(pData->param.ranges[k].getNormalizedValue(curValue));
                     pData->event.portOut->writeControlEvent(0, pData->param.data[k].midiChannel, kEngineControlEventTypeParameter, static_cast<uint16_t>(pData->param.data[k].midiCC), value);
                 }
-            }
 #endif
+            }
+        } // End of Control Output
+
+        // --------------------------------------------------------------------------------------------------------
+        // MIDI Output
 
+        if (pData->event.portOut != nullptr)
+        {
             // reverse lookup MIDI events
             for (uint32_t k = (kPluginMaxMidiEvents*2)-1; k >= fMidiEventCount; --k)
             {
@@ -1810,6 +1846,11 @@ public:
             }
 
         } // End of Control and MIDI Output
+
+#ifndef BUILD_BRIDGE
+        // plugin told us its outputs are silent, no need to scan them
+        pData->silence.outputHint = fOutputsSilent;
+#endif
     }
 
     bool processSingle(const float** const audioIn, float** const audioOut, const float** const cvIn, float** const cvOut, const uint32_t frames, const uint32_t timeOffset)
@@ -1879,6 +1920,9 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Run plugin
 
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            fOutputFlags[i] = 0x0;
+
         fIsProcessing = true;
 
         if (fHandle2 == nullptr)
@@ -1901,68 +1945,23 @@ public:
         fIsProcessing = false;
         fTimeInfo.frame += frames;
 
-#ifndef BUILD_BRIDGE
-        // --------------------------------------------------------------------------------------------------------
-        // Post-processing (dry/wet, volume and balance)
-
+        for (uint32_t i=0; fOutputsSilent && i < pData->audioOut.count; ++i)
         {
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
+            const uint flags(fOutputFlags[i]);
 
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        bufValue = fAudioInBuffers[(pData->audioIn.count == 1) ? 0 : i][k];
-                        fAudioOutBuffers[i][k] = (fAudioOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, fAudioOutBuffers[i], static_cast<int>(frames));
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
+            if (flags & NATIVE_OUTPUT_IS_SILENT)
+                continue;
+            if ((flags & NATIVE_OUTPUT_IS_CONSTANT) != 0 && carla_isZero(fAudioOutBuffers[i][0]))
+                continue;
 
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            fAudioOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioOutBuffers[i][k] += fAudioOutBuffers[i+1][k] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            fAudioOutBuffers[i][k]  = fAudioOutBuffers[i][k] * balRangeR;
-                            fAudioOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
-                        }
-                    }
-                }
+            fOutputsSilent = false;
+        }
 
-                // Volume (and buffer copy)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioOutBuffers[i][k] * pData->postProc.volume;
-                }
-            }
+#ifndef BUILD_BRIDGE
+        // --------------------------------------------------------------------------------------------------------
+        // Post-processing (dry/wet, volume and balance)
 
-        } // End of Post-processing
+        pData->postProcess(fAudioInBuffers, fAudioOutBuffers, audioOut, 0, timeOffset, frames);
 #else
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
         {
@@ -2053,6 +2052,16 @@ public:
         }
     }
 
+    // -------------------------------------------------------------------
+    // Misc
+
+    void idle() override
+    {
+        runWorkerJobs();
+
+        CarlaPlugin::idle();
+    }
+
     // -------------------------------------------------------------------
     // Plugin buffers
 
@@ -2098,6 +2107,12 @@ public:
             fAudioOutBuffers = nullptr;
         }
 
+        if (fOutputFlags != nullptr)
+        {
+            delete[] fOutputFlags;
+            fOutputFlags = nullptr;
+        }
+
         if (fMidiIn.count > 1)
             pData->event.portIn = nullptr;
 
@@ -2200,7 +2215,7 @@ protected:
             return true;
         }
 
-        carla_stdout("CarlaPluginNative::handleWriteMidiEvent(%p) - buffer full", event);
+        carla_rt_stdout("CarlaPluginNative::handleWriteMidiEvent(%p) - buffer full", event);
         return false;
     }
 
@@ -2267,6 +2282,15 @@ protected:
         case NATIVE_HOST_OPCODE_HOST_IDLE:
             pData->engine->callback(ENGINE_CALLBACK_IDLE, 0, 0, 0, 0.0f, nullptr);
             break;
+        case NATIVE_HOST_OPCODE_UPDATE_LATENCY:
+            // picked up by idle(), which updates ports and engine delay compensation
+            CARLA_SAFE_ASSERT_BREAK(value >= 0);
+            fLatency = static_cast<uint32_t>(value);
+            break;
+        case NATIVE_HOST_OPCODE_SCHEDULE_WORK:
+        case NATIVE_HOST_OPCODE_SET_OUTPUT_FLAGS:
+            // handled in carla_host_dispatcher
+            break;
         }
 
         return ret;
@@ -2278,6 +2302,84 @@ protected:
         (void)opt;
     }
 
+    // RT-safe, called from within process()
+    bool handleScheduleWork(const NativeWorkerJob* const job)
+    {
+        CARLA_SAFE_ASSERT_RETURN(job != nullptr && job->work != nullptr, false);
+
+        // nothing to gain from a worker if not running in realtime
+        if (fIsOffline || ! fIsProcessing)
+        {
+            job->work(job->data);
+
+            if (job->work_done != nullptr)
+                job->work_done(job->data);
+
+            return true;
+        }
+
+        fWorkerJobs.writeCustomType(*job);
+        return fWorkerJobs.commitWrite();
+    }
+
+    // RT-safe, called from within process()
+    void handleSetOutputFlags(const int32_t index, const uint flags) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fIsProcessing,);
+        CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->audioOut.count),);
+
+        if (index == -1)
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                fOutputFlags[i] = flags;
+        }
+        else
+        {
+            fOutputFlags[index] = flags;
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // Worker
+
+    // runs scheduled jobs, called from idle()
+    void runWorkerJobs() noexcept
+    {
+        NativeWorkerJob job;
+
+        for (; fWorkerJobs.isDataAvailableForReading();)
+        {
+            fWorkerJobs.readCustomType(job);
+            CARLA_SAFE_ASSERT_BREAK(job.work != nullptr);
+
+            try {
+                job.work(job.data);
+            } CARLA_SAFE_EXCEPTION_CONTINUE("NativeWorkerJob::work");
+
+            if (job.work_done == nullptr)
+                continue;
+
+            fWorkerResponses.writeCustomType(job);
+            fWorkerResponses.commitWrite();
+        }
+    }
+
+    // completes finished jobs, called from process()
+    void runWorkerResponses() noexcept
+    {
+        NativeWorkerJob job;
+
+        for (; fWorkerResponses.isDataAvailableForReading();)
+        {
+            fWorkerResponses.readCustomType(job);
+            CARLA_SAFE_ASSERT_BREAK(job.work_done != nullptr);
+
+            try {
+                job.work_done(job.data);
+            } CARLA_SAFE_EXCEPTION("NativeWorkerJob::work_done");
+        }
+    }
+
     // -------------------------------------------------------------------
 
 public:
@@ -2457,11 +2559,20 @@ private:
     uint32_t fCurBufferSize;
     double   fCurSampleRate;
 
+    uint32_t fLatency;
+    uint*    fOutputFlags;
+    bool     fOutputsSilent;
+
     NativePluginMidiData fMidiIn;
     NativePluginMidiData fMidiOut;
 
     NativeTimeInfo fTimeInfo;
 
+    // scheduled on the audio thread, run on idle
+    CarlaSmallStackRingBuffer fWorkerJobs;
+    // finished on idle, completed on the audio thread
+    CarlaSmallStackRingBuffer fWorkerResponses;
+
     // -------------------------------------------------------------------
 
     #define handlePtr ((CarlaPluginNative*)handle)
@@ -2518,6 +2629,18 @@ private:
 
     static intptr_t carla_host_dispatcher(NativeHostHandle handle, NativeHostDispatcherOpcode opcode, int32_t index, intptr_t value, void* ptr, float opt)
     {
+        // these are called from the audio thread, skip the debug and non-RT code paths
+        switch (opcode)
+        {
+        case NATIVE_HOST_OPCODE_SCHEDULE_WORK:
+            return handlePtr->handleScheduleWork((const NativeWorkerJob*)ptr) ? 1 : 0;
+        case NATIVE_HOST_OPCODE_SET_OUTPUT_FLAGS:
+            handlePtr->handleSetOutputFlags(index, static_cast<uint>(value));
+            return 0;
+        default:
+            break;
+        }
+
         return handlePtr->handleDispatcher(opcode, index, value, ptr, opt);
     }
 
@@ -102,6 +102,7 @@ public:
 
         pData->singleMutex.lock();
         pData->masterMutex.lock();
+        pData->reblock.stopWorker();
 
         if (pData->client != nullptr && pData->client->isActive())
             pData->client->deactivate();
@@ -226,6 +227,11 @@ public:
             options |= PLUGIN_OPTION_SEND_ALL_SOUND_OFF;
         }
 
+        options |= PLUGIN_OPTION_SLEEP_WHEN_SILENT;
+        options |= PLUGIN_OPTION_REBLOCK;
+        options |= PLUGIN_OPTION_EXPENDABLE;
+        options |= PLUGIN_OPTION_OVERSAMPLE;
+
         return options;
     }
 
@@ -1070,7 +1076,7 @@ public:
             fTimeInfo.flags |= kVstTransportPlaying;
 
         fTimeInfo.samplePos  = double(timeInfo.frame);
-        fTimeInfo.sampleRate = pData->engine->getSampleRate();
+        fTimeInfo.sampleRate = pData->getSampleRate();
 
         if (timeInfo.usecs != 0)
         {
@@ -1248,13 +1254,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        uint32_t k;
-                        for (k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMidiCCParameter(event.channel, ctrlEvent.param); k < pData->param.count;
+                             k = pData->param.getNextMidiCCParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].midiCC != ctrlEvent.param)
-                                continue;
                             if (pData->param.data[k].type != PARAMETER_INPUT)
                                 continue;
                             if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
@@ -1525,66 +1527,7 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
 
-        {
-            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
-            const bool doDryWet  = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
-            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
-
-            bool isPair;
-            float bufValue, oldBufLeft[doBalance ? frames : 1];
-
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            {
-                // Dry/Wet
-                if (doDryWet)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        bufValue = inBuffer[(pData->audioIn.count == 1) ? 0 : i][k+timeOffset];
-                        outBuffer[i][k+timeOffset] = (outBuffer[i][k+timeOffset] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
-                    }
-                }
-
-                // Balance
-                if (doBalance)
-                {
-                    isPair = (i % 2 == 0);
-
-                    if (isPair)
-                    {
-                        CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        FloatVectorOperations::copy(oldBufLeft, outBuffer[i]+timeOffset, static_cast<int>(frames));
-                    }
-
-                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
-                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
-
-                    for (uint32_t k=0; k < frames; ++k)
-                    {
-                        if (isPair)
-                        {
-                            // left
-                            outBuffer[i][k+timeOffset]  = oldBufLeft[k]                * (1.0f - balRangeL);
-                            outBuffer[i][k+timeOffset] += outBuffer[i+1][k+timeOffset] * (1.0f - balRangeR);
-                        }
-                        else
-                        {
-                            // right
-                            outBuffer[i][k+timeOffset]  = outBuffer[i][k+timeOffset] * balRangeR;
-                            outBuffer[i][k+timeOffset] += oldBufLeft[k]              * balRangeL;
-                        }
-                    }
-                }
-
-                // Volume
-                if (doVolume)
-                {
-                    for (uint32_t k=0; k < frames; ++k)
-                        outBuffer[i][k+timeOffset] *= pData->postProc.volume;
-                }
-            }
-
-        } // End of Post-processing
+        pData->postProcess(inBuffer, outBuffer, outBuffer, timeOffset, timeOffset, frames);
 #endif
 
         // --------------------------------------------------------------------------------------------------------
@@ -1602,7 +1545,7 @@ public:
             deactivate();
 
 #if ! VST_FORCE_DEPRECATED
-        dispatcher(effSetBlockSizeAndSampleRate, 0, static_cast<int32_t>(newBufferSize), nullptr, static_cast<float>(pData->engine->getSampleRate()));
+        dispatcher(effSetBlockSizeAndSampleRate, 0, static_cast<int32_t>(newBufferSize), nullptr, static_cast<float>(pData->getSampleRate()));
 #endif
         dispatcher(effSetBlockSize, 0, static_cast<int32_t>(newBufferSize), nullptr, 0.0f);
 
@@ -1619,7 +1562,7 @@ public:
             deactivate();
 
 #if ! VST_FORCE_DEPRECATED
-        dispatcher(effSetBlockSizeAndSampleRate, 0, static_cast<int32_t>(pData->engine->getBufferSize()), nullptr, static_cast<float>(newSampleRate));
+        dispatcher(effSetBlockSizeAndSampleRate, 0, static_cast<int32_t>(pData->getBufferSize()), nullptr, static_cast<float>(newSampleRate));
 #endif
         dispatcher(effSetSampleRate, 0, 0, nullptr, static_cast<float>(newSampleRate));
 
@@ -1865,11 +1808,11 @@ protected:
             break;
 
         case audioMasterGetSampleRate:
-            ret = static_cast<intptr_t>(pData->engine->getSampleRate());
+            ret = static_cast<intptr_t>(pData->getSampleRate());
             break;
 
         case audioMasterGetBlockSize:
-            ret = static_cast<intptr_t>(pData->engine->getBufferSize());
+            ret = static_cast<intptr_t>(pData->getBufferSize());
             break;
 
         case audioMasterGetInputLatency:
@@ -2168,10 +2111,10 @@ public:
         // initialize plugin (part 2)
 
 #if ! VST_FORCE_DEPRECATED
-        dispatcher(effSetBlockSizeAndSampleRate, 0, static_cast<int32_t>(pData->engine->getBufferSize()), nullptr, static_cast<float>(pData->engine->getSampleRate()));
+        dispatcher(effSetBlockSizeAndSampleRate, 0, static_cast<int32_t>(pData->getBufferSize()), nullptr, static_cast<float>(pData->getSampleRate()));
 #endif
-        dispatcher(effSetSampleRate, 0, 0, nullptr, static_cast<float>(pData->engine->getSampleRate()));
-        dispatcher(effSetBlockSize, 0, static_cast<int32_t>(pData->engine->getBufferSize()), nullptr, 0.0f);
+        dispatcher(effSetSampleRate, 0, 0, nullptr, static_cast<float>(pData->getSampleRate()));
+        dispatcher(effSetBlockSize, 0, static_cast<int32_t>(pData->getBufferSize()), nullptr, 0.0f);
         dispatcher(effSetProcessPrecision, 0, kVstProcessPrecision32, nullptr, 0.0f);
 
         if (dispatcher(effGetVstVersion, 0, 0, nullptr, 0.0f) < kVstVersion)
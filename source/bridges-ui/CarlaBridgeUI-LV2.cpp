@@ -733,7 +733,10 @@ public:
             const LV2_Atom* const atom((const LV2_Atom*)buffer);
 
             if (isPipeRunning())
-                writeLv2AtomMessage(portIndex, atom);
+            {
+                fAtomChannel.writeAtom(*this, portIndex, atom);
+                fAtomChannel.flush(*this);
+            }
         }
         else
         {
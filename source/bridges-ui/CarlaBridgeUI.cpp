@@ -39,7 +39,8 @@ CarlaBridgeUI::CarlaBridgeUI() noexcept
       fLastMsgTimer(-1),
       fToolkit(nullptr),
       fLib(nullptr),
-      fLibFilename()
+      fLibFilename(),
+      fAtomChannel()
 {
     carla_debug("CarlaBridgeUI::CarlaBridgeUI()");
 
@@ -206,6 +207,39 @@ bool CarlaBridgeUI::msgReceived(const char* const msg) noexcept
         return true;
     }
 
+    if (std::strcmp(msg, "atomShm") == 0)
+    {
+        const char* filename;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(filename), true);
+
+        // let the host know it can use the shared memory, otherwise it keeps using "atom" messages
+        if (fAtomChannel.attach(filename))
+        {
+            const CarlaMutexLocker cml(getPipeLock());
+
+            if (writeMessage("atomShm\n", 8))
+                flushMessages();
+        }
+
+        delete[] filename;
+        return true;
+    }
+
+    if (std::strcmp(msg, "atomShmData") == 0)
+    {
+        uint32_t count, index;
+        const LV2_Atom* atom;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(count), true);
+
+        for (; count > 0 && fAtomChannel.readAtom(index, atom); --count)
+            dspAtomReceived(index, atom);
+
+        CARLA_SAFE_ASSERT_UINT(count == 0, count);
+        return true;
+    }
+
     if (std::strcmp(msg, "urid") == 0)
     {
         uint32_t urid;
@@ -22,6 +22,7 @@
 #include "CarlaLibUtils.hpp"
 #include "CarlaPipeUtils.hpp"
 #include "CarlaString.hpp"
+#include "Lv2AtomShmChannel.hpp"
 
 #include "lv2/atom.h"
 #include "lv2/urid.h"
@@ -150,6 +151,8 @@ protected:
     lib_t fLib;
     CarlaString fLibFilename;
 
+    Lv2AtomShmChannel fAtomChannel;
+
     /*! @internal */
     bool msgReceived(const char* const msg) noexcept override;
 
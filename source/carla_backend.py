@@ -251,6 +251,30 @@ PLUGIN_OPTION_SEND_ALL_SOUND_OFF = 0x100
 # @note: This option conflicts with PLUGIN_OPTION_MAP_PROGRAM_CHANGES and cannot be used at the same time.
 PLUGIN_OPTION_SEND_PROGRAM_CHANGES = 0x200
 
+# Skip processing while the plugin inputs and outputs are silent.
+# The plugin goes to sleep after its outputs have been silent for longer than its tail time,
+# and is woken up as soon as audio or MIDI input arrives.
+# @see ENGINE_OPTION_SILENCE_TAIL_TIME
+PLUGIN_OPTION_SLEEP_WHEN_SILENT = 0x400
+
+# Process the plugin at a bigger internal block size than the engine, through audio and event FIFOs.
+# Adds one internal block of latency (two when using a worker thread), which is compensated by the engine.
+# Only used in rack and patchbay modes.
+# @see ENGINE_OPTION_REBLOCK_SIZE and ENGINE_OPTION_REBLOCK_THREAD
+PLUGIN_OPTION_REBLOCK = 0x800
+
+# Allow the engine to degrade the plugin while the DSP load stays over the limit,
+# by lowering its update rate or polyphony, or by bypassing it.
+# Plugins later in the list are degraded first, and restored last.
+# @see ENGINE_OPTION_OVERLOAD_LIMIT and PluginDegradation
+PLUGIN_OPTION_EXPENDABLE = 0x1000
+
+# Process the plugin at a multiple of the engine sample rate, through polyphase half-band filters.
+# Reduces aliasing of non-linear plugins, at the cost of the filters latency, which is compensated by the engine.
+# Only used in rack and patchbay modes, and for plugins with at most one MIDI input and output.
+# @see ENGINE_OPTION_OVERSAMPLE_FACTOR
+PLUGIN_OPTION_OVERSAMPLE = 0x2000
+
 # ------------------------------------------------------------------------------------------------------------
 # Parameter Hints
 # Various parameter hints.
@@ -701,6 +725,14 @@ ENGINE_CALLBACK_ERROR = 38
 # The engine has crashed or malfunctioned and will no longer work.
 ENGINE_CALLBACK_QUIT = 39
 
+# The engine degraded or restored a plugin because of its DSP load.
+# @a pluginId Plugin Id
+# @a value1   New degradation
+# @a value2   Engine DSP load, in percent
+# @a value3   Plugin DSP load, in percent
+# @see PluginDegradation and PLUGIN_OPTION_EXPENDABLE
+ENGINE_CALLBACK_PLUGIN_DEGRADED = 40
+
 # ------------------------------------------------------------------------------------------------------------
 # Engine Option
 # Engine options.
@@ -787,6 +819,63 @@ ENGINE_OPTION_FRONTEND_WIN_ID = 17
 # Capture console output into debug callbacks
 ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT = 18
 
+# Minimum time of silence, in milliseconds, before a plugin using PLUGIN_OPTION_SLEEP_WHEN_SILENT goes to sleep.
+# Plugin latency is added on top of this value.
+# Default is 2000 (2 seconds).
+ENGINE_OPTION_SILENCE_TAIL_TIME = 19
+
+# Lock all current and future process memory into RAM, avoiding page faults in the audio thread.
+# Default is no.
+# @note: Not available on Windows
+ENGINE_OPTION_RT_MEMORY_LOCK = 20
+
+# CPU affinity for the engine realtime threads, as a bitmask of CPU cores.
+# Default is 0 (no change).
+# @note: Linux only
+ENGINE_OPTION_RT_CPU_AFFINITY = 21
+
+# SCHED_FIFO priority for the engine realtime threads, from 1 to 99.
+# Default is 0 (use the audio driver default).
+# @note: Not available on Windows
+ENGINE_OPTION_RT_PRIORITY = 22
+
+# Number of background threads used to load plugin bridges when loading a project.
+# Plugins are still added to the engine in project order, once all of them are loaded.
+# Default is 0 (load everything sequentially).
+ENGINE_OPTION_PROJECT_LOAD_THREADS = 23
+
+# Number of extra threads used to process plugins in patchbay mode.
+# Plugins that do not depend on each other are then processed at the same time.
+# Default is 0 (process everything in the audio thread).
+# @note: Offline rendering and rack mode always process plugins in order
+ENGINE_OPTION_PROCESS_THREADS = 24
+
+# Internal block size, in frames, of plugins using PLUGIN_OPTION_REBLOCK.
+# Plugins are processed directly when this is not bigger than the engine buffer size.
+# Default is 1024.
+ENGINE_OPTION_REBLOCK_SIZE = 25
+
+# Process the internal blocks of plugins using PLUGIN_OPTION_REBLOCK on a worker thread,
+# spreading their cost over several engine cycles at the expense of one more block of latency.
+# Default is no.
+ENGINE_OPTION_REBLOCK_THREAD = 26
+
+# DSP load, in percent of the audio cycle, above which plugins using PLUGIN_OPTION_EXPENDABLE get degraded.
+# They are restored once the load stays well below this value.
+# Only used in rack and patchbay modes.
+# Default is 0 (never degrade plugins).
+ENGINE_OPTION_OVERLOAD_LIMIT = 27
+
+# Oversampling factor of plugins using PLUGIN_OPTION_OVERSAMPLE, either 2, 4 or 8.
+# Combine with PLUGIN_OPTION_REBLOCK and ENGINE_OPTION_REBLOCK_THREAD to run the oversampled plugin on a worker thread.
+# Default is 2.
+ENGINE_OPTION_OVERSAMPLE_FACTOR = 28
+
+# Save the current project to the file in valueStr every value seconds.
+# Plugins whose state did not change since they were last saved are not asked for it again.
+# Default is 0 (no autosave).
+ENGINE_OPTION_AUTOSAVE = 29
+
 # ------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -828,6 +917,24 @@ ENGINE_TRANSPORT_MODE_PLUGIN = 2
 # Special mode, used in plugin-bridges only.
 ENGINE_TRANSPORT_MODE_BRIDGE = 3
 
+# ------------------------------------------------------------------------------------------------------------
+# Plugin Degradation
+# How a plugin is degraded by the engine to reduce the DSP load.
+# @see PLUGIN_OPTION_EXPENDABLE and ENGINE_CALLBACK_PLUGIN_DEGRADED
+
+# Plugin is processed normally.
+PLUGIN_DEGRADATION_NONE = 0
+
+# Plugin is only processed every few cycles.
+# Used for analysis plugins, which have audio inputs but no outputs.
+PLUGIN_DEGRADATION_REDUCED_RATE = 1
+
+# Plugin polyphony parameter has been lowered.
+PLUGIN_DEGRADATION_REDUCED_POLYPHONY = 2
+
+# Plugin is not processed, its audio inputs are passed through to its outputs.
+PLUGIN_DEGRADATION_BYPASSED = 3
+
 # ------------------------------------------------------------------------------------------------------------
 # File Callback Opcode
 # File callback opcodes.
@@ -1328,6 +1435,12 @@ class CarlaHostMeta(object):
     def save_project(self, filename):
         raise NotImplementedError
 
+    # Convert a project file between the XML (.carxp) and binary (.carbp) formats.
+    # The format of outFilename is the other one than inFilename, the engine does not need to be running.
+    @abstractmethod
+    def convert_project(self, inFilename, outFilename):
+        raise NotImplementedError
+
     # Connect two patchbay ports.
     # @param groupIdA Output group
     # @param portIdA  Output port
@@ -1382,6 +1495,12 @@ class CarlaHostMeta(object):
     def get_current_plugin_count(self):
         raise NotImplementedError
 
+    # Current number of plugins asleep due to silence.
+    # @see PLUGIN_OPTION_SLEEP_WHEN_SILENT
+    @abstractmethod
+    def get_sleeping_plugin_count(self):
+        raise NotImplementedError
+
     # Maximum number of loadable plugins allowed.
     # Returns 0 if engine is not started.
     @abstractmethod
@@ -1442,6 +1561,32 @@ class CarlaHostMeta(object):
     def switch_plugins(self, pluginIdA, pluginIdB):
         raise NotImplementedError
 
+    # Load a plugin preset file as an inactive standby instance for a plugin.
+    # The running plugin is not touched until switch_to_standby_plugins() is called.
+    # @param pluginId Plugin
+    # @param filename Path to plugin preset
+    @abstractmethod
+    def load_standby_plugin(self, pluginId, filename):
+        raise NotImplementedError
+
+    # Remove the standby instance of a plugin, if any.
+    # @param pluginId Plugin
+    @abstractmethod
+    def remove_standby_plugin(self, pluginId):
+        raise NotImplementedError
+
+    # Replace all plugins that have a standby instance with it, all at once.
+    # @param crossfadeMs Crossfade time in milliseconds, only used in rack mode
+    @abstractmethod
+    def switch_to_standby_plugins(self, crossfadeMs):
+        raise NotImplementedError
+
+    # Get the estimated memory used by the standby instance of a plugin, in bytes.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_standby_plugin_memory_usage(self, pluginId):
+        raise NotImplementedError
+
     # Load a plugin state.
     # @param pluginId Plugin
     # @param filename Path to plugin state
@@ -1804,6 +1949,18 @@ class CarlaHostMeta(object):
     def get_sample_rate(self):
         raise NotImplementedError
 
+    # Get the CPU time used by each tick of the engine idle thread, in microseconds.
+    # This is an average over the last second.
+    @abstractmethod
+    def get_idle_thread_tick_time(self):
+        raise NotImplementedError
+
+    # Get how late MIDI output events were sent, compared to the time matching their frame, in microseconds.
+    # This is the maximum over the last second, 0 for drivers that do not schedule MIDI output themselves.
+    @abstractmethod
+    def get_midi_out_jitter(self):
+        raise NotImplementedError
+
     # Get the last error.
     @abstractmethod
     def get_last_error(self):
@@ -1880,6 +2037,9 @@ class CarlaHostNull(CarlaHostMeta):
     def save_project(self, filename):
         return False
 
+    def convert_project(self, inFilename, outFilename):
+        return False
+
     def patchbay_connect(self, groupIdA, portIdA, groupIdB, portIdB):
         return False
 
@@ -1907,6 +2067,9 @@ class CarlaHostNull(CarlaHostMeta):
     def get_current_plugin_count(self):
         return 0
 
+    def get_sleeping_plugin_count(self):
+        return 0
+
     def get_max_plugin_number(self):
         return 0
 
@@ -1931,6 +2094,18 @@ class CarlaHostNull(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return False
 
+    def load_standby_plugin(self, pluginId, filename):
+        return False
+
+    def remove_standby_plugin(self, pluginId):
+        return False
+
+    def switch_to_standby_plugins(self, crossfadeMs):
+        return False
+
+    def get_standby_plugin_memory_usage(self, pluginId):
+        return 0
+
     def load_plugin_state(self, pluginId, filename):
         return False
 
@@ -2081,6 +2256,12 @@ class CarlaHostNull(CarlaHostMeta):
     def get_sample_rate(self):
         return 0.0
 
+    def get_idle_thread_tick_time(self):
+        return 0
+
+    def get_midi_out_jitter(self):
+        return 0
+
     def get_last_error(self):
         return ""
 
@@ -2153,6 +2334,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_save_project.argtypes = [c_char_p]
         self.lib.carla_save_project.restype = c_bool
 
+        self.lib.carla_convert_project.argtypes = [c_char_p, c_char_p]
+        self.lib.carla_convert_project.restype = c_bool
+
         self.lib.carla_patchbay_connect.argtypes = [c_uint, c_uint, c_uint, c_uint]
         self.lib.carla_patchbay_connect.restype = c_bool
 
@@ -2180,6 +2364,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_current_plugin_count.argtypes = None
         self.lib.carla_get_current_plugin_count.restype = c_uint32
 
+        self.lib.carla_get_sleeping_plugin_count.argtypes = None
+        self.lib.carla_get_sleeping_plugin_count.restype = c_uint32
+
         self.lib.carla_get_max_plugin_number.argtypes = None
         self.lib.carla_get_max_plugin_number.restype = c_uint32
 
@@ -2204,6 +2391,18 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_switch_plugins.argtypes = [c_uint, c_uint]
         self.lib.carla_switch_plugins.restype = c_bool
 
+        self.lib.carla_load_standby_plugin.argtypes = [c_uint, c_char_p]
+        self.lib.carla_load_standby_plugin.restype = c_bool
+
+        self.lib.carla_remove_standby_plugin.argtypes = [c_uint]
+        self.lib.carla_remove_standby_plugin.restype = c_bool
+
+        self.lib.carla_switch_to_standby_plugins.argtypes = [c_uint]
+        self.lib.carla_switch_to_standby_plugins.restype = c_bool
+
+        self.lib.carla_get_standby_plugin_memory_usage.argtypes = [c_uint]
+        self.lib.carla_get_standby_plugin_memory_usage.restype = c_uint64
+
         self.lib.carla_load_plugin_state.argtypes = [c_uint, c_char_p]
         self.lib.carla_load_plugin_state.restype = c_bool
 
@@ -2354,6 +2553,12 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_sample_rate.argtypes = None
         self.lib.carla_get_sample_rate.restype = c_double
 
+        self.lib.carla_get_idle_thread_tick_time.argtypes = None
+        self.lib.carla_get_idle_thread_tick_time.restype = c_uint32
+
+        self.lib.carla_get_midi_out_jitter.argtypes = None
+        self.lib.carla_get_midi_out_jitter.restype = c_uint32
+
         self.lib.carla_get_last_error.argtypes = None
         self.lib.carla_get_last_error.restype = c_char_p
 
@@ -2418,6 +2623,9 @@ class CarlaHostDLL(CarlaHostMeta):
     def save_project(self, filename):
         return bool(self.lib.carla_save_project(filename.encode("utf-8")))
 
+    def convert_project(self, inFilename, outFilename):
+        return bool(self.lib.carla_convert_project(inFilename.encode("utf-8"), outFilename.encode("utf-8")))
+
     def patchbay_connect(self, groupIdA, portIdA, groupIdB, portIdB):
         return bool(self.lib.carla_patchbay_connect(groupIdA, portIdA, groupIdB, portIdB))
 
@@ -2445,6 +2653,9 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_current_plugin_count(self):
         return int(self.lib.carla_get_current_plugin_count())
 
+    def get_sleeping_plugin_count(self):
+        return int(self.lib.carla_get_sleeping_plugin_count())
+
     def get_max_plugin_number(self):
         return int(self.lib.carla_get_max_plugin_number())
 
@@ -2472,6 +2683,18 @@ class CarlaHostDLL(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return bool(self.lib.carla_switch_plugins(pluginIdA, pluginIdB))
 
+    def load_standby_plugin(self, pluginId, filename):
+        return bool(self.lib.carla_load_standby_plugin(pluginId, filename.encode("utf-8")))
+
+    def remove_standby_plugin(self, pluginId):
+        return bool(self.lib.carla_remove_standby_plugin(pluginId))
+
+    def switch_to_standby_plugins(self, crossfadeMs):
+        return bool(self.lib.carla_switch_to_standby_plugins(crossfadeMs))
+
+    def get_standby_plugin_memory_usage(self, pluginId):
+        return int(self.lib.carla_get_standby_plugin_memory_usage(pluginId))
+
     def load_plugin_state(self, pluginId, filename):
         return bool(self.lib.carla_load_plugin_state(pluginId, filename.encode("utf-8")))
 
@@ -2622,6 +2845,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_sample_rate(self):
         return float(self.lib.carla_get_sample_rate())
 
+    def get_idle_thread_tick_time(self):
+        return int(self.lib.carla_get_idle_thread_tick_time())
+
+    def get_midi_out_jitter(self):
+        return int(self.lib.carla_get_midi_out_jitter())
+
     def get_last_error(self):
         return charPtrToString(self.lib.carla_get_last_error())
 
@@ -2746,6 +2975,9 @@ class CarlaHostPlugin(CarlaHostMeta):
     def save_project(self, filename):
         return self.sendMsgAndSetError(["save_project", filename])
 
+    def convert_project(self, inFilename, outFilename):
+        return self.sendMsgAndSetError(["convert_project", inFilename, outFilename])
+
     def patchbay_connect(self, groupIdA, portIdA, groupIdB, portIdB):
         return self.sendMsgAndSetError(["patchbay_connect", groupIdA, portIdA, groupIdB, portIdB])
 
@@ -2774,6 +3006,9 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_current_plugin_count(self):
         return len(self.fPluginsInfo)
 
+    def get_sleeping_plugin_count(self):
+        return 0
+
     def get_max_plugin_number(self):
         return self.fMaxPluginNumber
 
@@ -2802,6 +3037,18 @@ class CarlaHostPlugin(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return self.sendMsgAndSetError(["switch_plugins", pluginIdA, pluginIdB])
 
+    def load_standby_plugin(self, pluginId, filename):
+        return self.sendMsgAndSetError(["load_standby_plugin", pluginId, filename])
+
+    def remove_standby_plugin(self, pluginId):
+        return self.sendMsgAndSetError(["remove_standby_plugin", pluginId])
+
+    def switch_to_standby_plugins(self, crossfadeMs):
+        return self.sendMsgAndSetError(["switch_to_standby_plugins", crossfadeMs])
+
+    def get_standby_plugin_memory_usage(self, pluginId):
+        return 0
+
     def load_plugin_state(self, pluginId, filename):
         return self.sendMsgAndSetError(["load_plugin_state", pluginId, filename])
 
@@ -2977,6 +3224,12 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_sample_rate(self):
         return self.fSampleRate
 
+    def get_idle_thread_tick_time(self):
+        return 0
+
+    def get_midi_out_jitter(self):
+        return 0
+
     def get_last_error(self):
         return self.fLastError
 
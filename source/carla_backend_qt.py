@@ -78,6 +78,7 @@ class CarlaHostSignals(QObject):
     InfoCallback = pyqtSignal(str)
     ErrorCallback = pyqtSignal(str)
     QuitCallback = pyqtSignal()
+    PluginDegradedCallback = pyqtSignal(int, int, int, float)
 
 # ------------------------------------------------------------------------------------------------------------
 # Carla Host object (dummy/null, does nothing)
@@ -566,7 +566,7 @@ class HostWindow(QMainWindow):
 
     @pyqtSlot()
     def slot_fileOpen(self):
-        fileFilter = self.tr("Carla Project File (*.carxp);;Carla Preset File (*.carxs)")
+        fileFilter = self.tr("Carla Project File (*.carxp);;Carla Binary Project File (*.carbp);;Carla Preset File (*.carxs)")
         filename   = QFileDialog.getOpenFileName(self, self.tr("Open Carla Project File"), self.fSavedSettings[CARLA_KEY_MAIN_PROJECT_FOLDER], filter=fileFilter)
 
         if config_UseQt5:
@@ -597,7 +597,7 @@ class HostWindow(QMainWindow):
         if self.fProjectFilename and not saveAs:
             return self.saveProjectNow()
 
-        fileFilter = self.tr("Carla Project File (*.carxp)")
+        fileFilter = self.tr("Carla Project File (*.carxp);;Carla Binary Project File (*.carbp)")
         filename   = QFileDialog.getSaveFileName(self, self.tr("Save Carla Project File"), self.fSavedSettings[CARLA_KEY_MAIN_PROJECT_FOLDER], filter=fileFilter)
 
         if config_UseQt5:
@@ -605,7 +605,7 @@ class HostWindow(QMainWindow):
         if not filename:
             return
 
-        if not filename.lower().endswith(".carxp"):
+        if not filename.lower().endswith((".carxp", ".carbp")):
             filename += ".carxp"
 
         if self.fProjectFilename != filename:
@@ -2169,6 +2169,8 @@ def engineCallback(host, action, pluginId, value1, value2, value3, valueStr):
         host.ErrorCallback.emit(valueStr)
     elif action == ENGINE_CALLBACK_QUIT:
         host.QuitCallback.emit()
+    elif action == ENGINE_CALLBACK_PLUGIN_DEGRADED:
+        host.PluginDegradedCallback.emit(pluginId, value1, value2, value3)
 
 # ------------------------------------------------------------------------------------------------------------
 # File callback
@@ -104,9 +104,17 @@ typedef enum {
     NATIVE_HOST_OPCODE_RELOAD_MIDI_PROGRAMS  = 4, /** nothing                                           */
     NATIVE_HOST_OPCODE_RELOAD_ALL            = 5, /** nothing                                           */
     NATIVE_HOST_OPCODE_UI_UNAVAILABLE        = 6, /** nothing                                           */
-    NATIVE_HOST_OPCODE_HOST_IDLE             = 7  /** nothing                                           */
+    NATIVE_HOST_OPCODE_HOST_IDLE             = 7, /** nothing                                           */
+    NATIVE_HOST_OPCODE_UPDATE_LATENCY        = 8, /** uses value (in frames)                            */
+    NATIVE_HOST_OPCODE_SCHEDULE_WORK         = 9, /** uses ptr (NativeWorkerJob*), returns 1 if accepted */
+    NATIVE_HOST_OPCODE_SET_OUTPUT_FLAGS      = 10 /** uses index, -1 for all; uses value (flags)        */
 } NativeHostDispatcherOpcode;
 
+typedef enum {
+    NATIVE_OUTPUT_IS_SILENT   = 1 << 0, /** all frames are zero                            */
+    NATIVE_OUTPUT_IS_CONSTANT = 1 << 1  /** all frames have the same value as the first one */
+} NativeOutputFlags;
+
 /* ------------------------------------------------------------------------------------------------------------
  * base structs */
 
@@ -173,6 +181,17 @@ typedef struct {
     NativeTimeInfoBBT bbt;
 } NativeTimeInfo;
 
+/**
+ * A job to be run by the host outside of the audio thread.
+ * Scheduled from within process() using NATIVE_HOST_OPCODE_SCHEDULE_WORK, the host keeps a copy of this struct.
+ * If the host returns 0 the job was not accepted, and the plugin should do the work itself.
+ */
+typedef struct {
+    void (*work)(void* data);      /** called on a host non-RT thread                                 */
+    void (*work_done)(void* data); /** called on the audio thread, before the next process, may be null */
+    void* data;
+} NativeWorkerJob;
+
 /* ------------------------------------------------------------------------------------------------------------
  * HostDescriptor */
 
@@ -214,6 +214,28 @@ protected:
         pHost->dispatcher(pHost->handle, NATIVE_HOST_OPCODE_HOST_IDLE, 0, 0, nullptr, 0.0f);
     }
 
+    void hostUpdateLatency(const uint32_t frames) const
+    {
+        CARLA_SAFE_ASSERT_RETURN(pHost != nullptr,);
+
+        pHost->dispatcher(pHost->handle, NATIVE_HOST_OPCODE_UPDATE_LATENCY, 0, static_cast<intptr_t>(frames), nullptr, 0.0f);
+    }
+
+    // returns false if the host did not accept the job, the plugin must run it itself then
+    bool hostScheduleWork(const NativeWorkerJob& job) const
+    {
+        CARLA_SAFE_ASSERT_RETURN(pHost != nullptr, false);
+
+        return pHost->dispatcher(pHost->handle, NATIVE_HOST_OPCODE_SCHEDULE_WORK, 0, 0, const_cast<NativeWorkerJob*>(&job), 0.0f) == 1;
+    }
+
+    void hostSetOutputFlags(const int32_t index, const uint flags) const
+    {
+        CARLA_SAFE_ASSERT_RETURN(pHost != nullptr,);
+
+        pHost->dispatcher(pHost->handle, NATIVE_HOST_OPCODE_SET_OUTPUT_FLAGS, index, static_cast<intptr_t>(flags), nullptr, 0.0f);
+    }
+
     // -------------------------------------------------------------------
     // Plugin parameter calls
 
@@ -58,6 +58,15 @@
  #define JUCE_PLUGINHOST_VST3 0
 #endif
 
+// used to pass the denormal and rounding modes on to graph rendering threads
+#if JUCE_INTEL && ! (JUCE_MINGW && ! defined (__SSE2__))
+ #include <xmmintrin.h>
+ #define JUCE_GRAPH_USE_SSE_CSR 1
+#endif
+
+// lock-free semaphores for waking graph rendering threads from the audio callback
+#include "CarlaSemUtils.hpp"
+
 //==============================================================================
 namespace juce
 {
@@ -58,11 +58,46 @@ template <typename FloatingType> struct FloatDoubleType<AudioBuffer<FloatPlaceho
 namespace GraphRenderingOps
 {
 
+//==============================================================================
+/** The shared buffers used by some rendering ops, as indexes into a single list
+    of audio channels, followed by midi buffers and the graph's own outputs.
+*/
+struct BufferUsage
+{
+    BufferUsage (const int numAudioBuffers, const int numMidiBuffers) noexcept
+        : numAudio (numAudioBuffers), numMidi (numMidiBuffers)
+    {}
+
+    void readAudio (const int channel)          { reads.addIfNotAlreadyThere (channel); }
+    void readMidi (const int buffer)            { reads.addIfNotAlreadyThere (numAudio + buffer); }
+    void writeMidi (const int buffer)           { writes.addIfNotAlreadyThere (numAudio + buffer); }
+    void writeGraphOutput (const int ioType)    { writes.addIfNotAlreadyThere (numAudio + numMidi + ioType); }
+
+    void writeAudio (const int channel)
+    {
+        // the first channel is read-only silence
+        if (channel == 0)
+            readAudio (channel);
+        else
+            writes.addIfNotAlreadyThere (channel);
+    }
+
+    int getNumResources() const noexcept        { return numAudio + numMidi + 4; }
+
+    const int numAudio, numMidi;
+    Array<int> reads, writes;
+
+    JUCE_DECLARE_NON_COPYABLE (BufferUsage)
+};
+
+//==============================================================================
 struct AudioGraphRenderingOpBase
 {
     AudioGraphRenderingOpBase() noexcept {}
     virtual ~AudioGraphRenderingOpBase() {}
 
+    virtual void getBufferUsage (BufferUsage& usage) const = 0;
+
     virtual void perform (AudioBuffer<float>& sharedBufferChans,
                           const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                           const int numSamples) = 0;
@@ -98,6 +133,11 @@ struct ClearChannelOp  : public AudioGraphRenderingOp<ClearChannelOp>
 {
     ClearChannelOp (const int channel) noexcept  : channelNum (channel)  {}
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.writeAudio (channelNum);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>& sharedBufferChans, const OwnedArray<MidiBuffer>&, const int numSamples)
     {
@@ -116,6 +156,12 @@ struct CopyChannelOp  : public AudioGraphRenderingOp<CopyChannelOp>
         : srcChannelNum (srcChan), dstChannelNum (dstChan)
     {}
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.readAudio (srcChannelNum);
+        usage.writeAudio (dstChannelNum);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>& sharedBufferChans, const OwnedArray<MidiBuffer>&, const int numSamples)
     {
@@ -134,6 +180,12 @@ struct AddChannelOp  : public AudioGraphRenderingOp<AddChannelOp>
         : srcChannelNum (srcChan), dstChannelNum (dstChan)
     {}
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.readAudio (srcChannelNum);
+        usage.writeAudio (dstChannelNum);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>& sharedBufferChans, const OwnedArray<MidiBuffer>&, const int numSamples)
     {
@@ -150,6 +202,11 @@ struct ClearMidiBufferOp  : public AudioGraphRenderingOp<ClearMidiBufferOp>
 {
     ClearMidiBufferOp (const int buffer) noexcept  : bufferNum (buffer)  {}
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.writeMidi (bufferNum);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>&, const OwnedArray<MidiBuffer>& sharedMidiBuffers, const int)
     {
@@ -168,6 +225,12 @@ struct CopyMidiBufferOp  : public AudioGraphRenderingOp<CopyMidiBufferOp>
         : srcBufferNum (srcBuffer), dstBufferNum (dstBuffer)
     {}
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.readMidi (srcBufferNum);
+        usage.writeMidi (dstBufferNum);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>&, const OwnedArray<MidiBuffer>& sharedMidiBuffers, const int)
     {
@@ -186,6 +249,12 @@ struct AddMidiBufferOp  : public AudioGraphRenderingOp<AddMidiBufferOp>
         : srcBufferNum (srcBuffer), dstBufferNum (dstBuffer)
     {}
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.readMidi (srcBufferNum);
+        usage.writeMidi (dstBufferNum);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>&, const OwnedArray<MidiBuffer>& sharedMidiBuffers, const int numSamples)
     {
@@ -210,6 +279,11 @@ struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
         buffer.doubleVersion.calloc ((size_t) bufferSize);
     }
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        usage.writeAudio (channel);
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>& sharedBufferChans, const OwnedArray<MidiBuffer>&, const int numSamples)
     {
@@ -254,6 +328,20 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
             audioChannelsToUse.add (0);
     }
 
+    void getBufferUsage (BufferUsage& usage) const override
+    {
+        for (int i = 0; i < totalChans; ++i)
+            usage.writeAudio (audioChannelsToUse.getUnchecked (i));
+
+        usage.writeMidi (midiBufferToUse);
+
+        // the graph outputs are shared by all output nodes of the same type
+        if (const AudioProcessorGraph::AudioGraphIOProcessor* const ioProc
+                = dynamic_cast<const AudioProcessorGraph::AudioGraphIOProcessor*> (processor))
+            if (ioProc->isOutput())
+                usage.writeGraphOutput (ioProc->getType());
+    }
+
     template <typename FloatType>
     void perform (AudioBuffer<FloatType>& sharedBufferChans, const OwnedArray<MidiBuffer>& sharedMidiBuffers, const int numSamples)
     {
@@ -320,10 +408,13 @@ struct RenderingOpSequenceCalculator
 {
     RenderingOpSequenceCalculator (AudioProcessorGraph& g,
                                    const Array<AudioProcessorGraph::Node*>& nodes,
-                                   Array<void*>& renderingOps)
+                                   Array<void*>& renderingOps,
+                                   Array<int>& nodeOpStarts,
+                                   const bool shouldReuseBuffers)
         : graph (g),
           orderedNodes (nodes),
-          totalLatency (0)
+          totalLatency (0),
+          reuseBuffers (shouldReuseBuffers)
     {
         nodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
         channels.add (0);
@@ -332,6 +423,7 @@ struct RenderingOpSequenceCalculator
 
         for (int i = 0; i < orderedNodes.size(); ++i)
         {
+            nodeOpStarts.add (renderingOps.size());
             createRenderingOpsForNode (*orderedNodes.getUnchecked(i), renderingOps, i);
             markAnyUnusedBuffersAsFree (i);
         }
@@ -357,6 +449,9 @@ private:
     Array<int> nodeDelays;
     int totalLatency;
 
+    // buffers that are reused make nodes wait for each other when rendering in parallel
+    const bool reuseBuffers;
+
     int getNodeDelay (const uint32 nodeID) const        { return nodeDelays [nodeDelayIDs.indexOf (nodeID)]; }
 
     void setNodeDelay (const uint32 nodeID, const int latency)
@@ -690,7 +785,7 @@ private:
     {
         if (forMidi)
         {
-            for (int i = 1; i < midiNodeIds.size(); ++i)
+            for (int i = 1; reuseBuffers && i < midiNodeIds.size(); ++i)
                 if (midiNodeIds.getUnchecked(i) == freeNodeID)
                     return i;
 
@@ -699,7 +794,7 @@ private:
         }
         else
         {
-            for (int i = 1; i < nodeIds.size(); ++i)
+            for (int i = 1; reuseBuffers && i < nodeIds.size(); ++i)
                 if (nodeIds.getUnchecked(i) == freeNodeID)
                     return i;
 
@@ -940,6 +1035,207 @@ struct ConnectionSorter
     }
 };
 
+//==============================================================================
+/** The rendering ops of each node, grouped into tasks that can run on different
+    threads once the tasks they depend on are done.
+
+    A task depends on the last earlier task that wrote any buffer it uses, and, for
+    buffers it writes, on the earlier tasks that read them since.
+*/
+struct RenderingSchedule
+{
+    RenderingSchedule (const Array<void*>& renderingOps, const Array<int>& nodeOpStarts,
+                       const int numAudioBuffers, const int numMidiBuffers)
+    {
+        const int numTasks = nodeOpStarts.size();
+        const int numResources = BufferUsage (numAudioBuffers, numMidiBuffers).getNumResources();
+
+        Array<int> lastWriters;
+        lastWriters.insertMultiple (0, -1, numResources);
+
+        OwnedArray<Array<int> > readers;
+
+        for (int i = 0; i < numResources; ++i)
+            readers.add (new Array<int>());
+
+        for (int t = 0; t < numTasks; ++t)
+        {
+            Task* const task = tasks.add (new Task());
+
+            const int opStart = nodeOpStarts.getUnchecked (t);
+            const int opEnd   = t + 1 < numTasks ? nodeOpStarts.getUnchecked (t + 1) : renderingOps.size();
+
+            BufferUsage usage (numAudioBuffers, numMidiBuffers);
+
+            for (int i = opStart; i < opEnd; ++i)
+            {
+                AudioGraphRenderingOpBase* const op = (AudioGraphRenderingOpBase*) renderingOps.getUnchecked (i);
+                task->ops.add (op);
+                op->getBufferUsage (usage);
+            }
+
+            for (int i = 0; i < usage.reads.size(); ++i)
+            {
+                const int resource = usage.reads.getUnchecked (i);
+
+                addDependency (lastWriters.getUnchecked (resource), t);
+                readers.getUnchecked (resource)->addIfNotAlreadyThere (t);
+            }
+
+            for (int i = 0; i < usage.writes.size(); ++i)
+            {
+                const int resource = usage.writes.getUnchecked (i);
+                Array<int>& resourceReaders = *readers.getUnchecked (resource);
+
+                addDependency (lastWriters.getUnchecked (resource), t);
+
+                for (int j = 0; j < resourceReaders.size(); ++j)
+                    addDependency (resourceReaders.getUnchecked (j), t);
+
+                resourceReaders.clearQuick();
+                lastWriters.set (resource, t);
+            }
+        }
+
+        for (int t = 0; t < numTasks; ++t)
+            if (tasks.getUnchecked (t)->numDependencies == 0)
+                initialTasks.add (t);
+
+        readyTasks.allocate ((size_t) jmax (1, numTasks), true);
+    }
+
+    int getNumTasks() const noexcept    { return tasks.size(); }
+
+    /** Resets the task states, the block starts once this returns. */
+    void prepareForBlock() noexcept
+    {
+        for (int i = tasks.size(); --i >= 0;)
+        {
+            Task& task = *tasks.getUnchecked (i);
+            task.pendingDependencies.set (task.numDependencies);
+            readyTasks[i].set (-1);
+        }
+
+        numReadyTasks.set (0);
+        nextReadyTask.set (0);
+        callerOnly.set (0);
+
+        for (int i = 0; i < initialTasks.size(); ++i)
+            pushReadyTask (initialTasks.getUnchecked (i));
+
+        numTasksRemaining.set (tasks.size());
+    }
+
+    /** Runs ready tasks until the whole block is done, called by all rendering threads.
+
+        The audio callback thread passes its deadline, in high resolution ticks; once that
+        passes, workers stop taking tasks and the caller finishes the remaining ones alone.
+        Workers pass 0 and return early when that happens.
+    */
+    template <typename FloatType>
+    void render (AudioBuffer<FloatType>& sharedBufferChans,
+                 const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                 const int numSamples, const int64 deadline) noexcept
+    {
+        const bool isCaller = deadline != 0;
+
+        while (numTasksRemaining.get() > 0)
+        {
+            if (isCaller)
+            {
+                if (callerOnly.get() == 0 && Time::getHighResolutionTicks() > deadline)
+                    callerOnly.set (1);
+            }
+            else if (callerOnly.get() != 0)
+            {
+                return;
+            }
+
+            const int taskIndex = popReadyTask();
+
+            if (taskIndex < 0)
+            {
+                Thread::yield();
+                continue;
+            }
+
+            Task& task = *tasks.getUnchecked (taskIndex);
+
+            for (int i = 0; i < task.ops.size(); ++i)
+                task.ops.getUnchecked (i)->perform (sharedBufferChans, sharedMidiBuffers, numSamples);
+
+            for (int i = 0; i < task.successors.size(); ++i)
+            {
+                const int successor = task.successors.getUnchecked (i);
+
+                if (--(tasks.getUnchecked (successor)->pendingDependencies) == 0)
+                    pushReadyTask (successor);
+            }
+
+            --numTasksRemaining;
+        }
+    }
+
+private:
+    struct Task
+    {
+        Task() noexcept : numDependencies (0) {}
+
+        Array<AudioGraphRenderingOpBase*> ops;
+        Array<int> successors;
+        int numDependencies;
+        Atomic<int> pendingDependencies;
+
+        JUCE_DECLARE_NON_COPYABLE (Task)
+    };
+
+    OwnedArray<Task> tasks;
+    Array<int> initialTasks;
+
+    // every task becomes ready once per block, so the queue never wraps
+    HeapBlock<Atomic<int> > readyTasks;
+    Atomic<int> numReadyTasks, nextReadyTask, numTasksRemaining, callerOnly;
+
+    void addDependency (const int task, const int dependentTask)
+    {
+        if (task < 0 || task == dependentTask)
+            return;
+
+        if (tasks.getUnchecked (task)->successors.addIfNotAlreadyThere (dependentTask))
+            ++(tasks.getUnchecked (dependentTask)->numDependencies);
+    }
+
+    void pushReadyTask (const int taskIndex) noexcept
+    {
+        const int slot = (++numReadyTasks) - 1;
+        readyTasks[slot].set (taskIndex);
+    }
+
+    int popReadyTask() noexcept
+    {
+        for (;;)
+        {
+            const int slot = nextReadyTask.get();
+
+            if (slot >= numReadyTasks.get())
+                return -1;
+
+            if (nextReadyTask.compareAndSetBool (slot + 1, slot))
+            {
+                // the slot is taken, but its task might not be written yet
+                int taskIndex;
+
+                while ((taskIndex = readyTasks[slot].get()) < 0)
+                    Thread::yield();
+
+                return taskIndex;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (RenderingSchedule)
+};
+
 }
 
 //==============================================================================
@@ -1034,9 +1330,292 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
     FloatAndDoubleComposition<AudioBuffer<FloatPlaceholder> > currentAudioOutputBuffer;
 };
 
+//==============================================================================
+/** Threads that render a RenderingSchedule together with the audio callback thread.
+
+    Workers spin for a little while between blocks, as these come at every audio
+    callback, and then sleep on a semaphore until the audio thread posts it for a new
+    block. They take the scheduling priority of the thread calling processBlock(), so
+    that spinning never keeps it from running.
+
+    The host may call processBlock() without holding the callback lock, so schedules,
+    rendering ops and workers are only replaced or deleted once the callback that was
+    running at the time, if any, has returned, see waitForCallback().
+*/
+struct AudioProcessorGraph::ParallelRenderer
+{
+    ParallelRenderer() noexcept
+        : callerThreadId (nullptr),
+          floatBuffers (nullptr), doubleBuffers (nullptr), midiBuffers (nullptr),
+          numSamples (0), fpState (0)
+    {}
+
+    ~ParallelRenderer()
+    {
+        setNumThreads (0);
+        delete swapSchedule (nullptr);
+    }
+
+    int getNumThreads() const noexcept
+    {
+        return numActiveThreads.get();
+    }
+
+    void setNumThreads (const int numThreads)
+    {
+        numActiveThreads.set (0);
+
+        // a callback that already saw the old workers might still be waking them
+        waitForCallback();
+
+        for (int i = workers.size(); --i >= 0;)
+        {
+            Worker* const worker = workers.getUnchecked (i);
+            worker->signalThreadShouldExit();
+            worker->wake();
+        }
+
+        for (int i = workers.size(); --i >= 0;)
+            workers.getUnchecked (i)->stopThread (1000);
+
+        workers.clear();
+
+        // more threads than cores would only take time away from each other
+        const int maxThreads = jmax (0, SystemStats::getNumCpus() - 1);
+
+        for (int i = jmin (numThreads, maxThreads); --i >= 0;)
+        {
+            Worker* const worker = workers.add (new Worker (*this));
+
+            if (! worker->isValid())
+            {
+                workers.removeLast();
+                break;
+            }
+
+            worker->startThread (9);
+        }
+
+        callerThreadId = nullptr;
+        numActiveThreads.set (workers.size());
+    }
+
+    /** Marks the start and end of the audio callback, around any use of the schedule or rendering ops. */
+    void beginCallback() noexcept   { ++callbackCounter; }
+    void endCallback() noexcept     { ++callbackCounter; }
+
+    /** Waits until the audio callback running right now, if any, has returned.
+        Anything swapped out before calling this is no longer used by the audio thread.
+    */
+    void waitForCallback() const
+    {
+        const int counter = callbackCounter.get();
+
+        if ((counter & 1) == 0)
+            return;
+
+        while (callbackCounter.get() == counter)
+            Thread::sleep (1);
+    }
+
+    /** Sets a new schedule, returning the old one once the audio thread is done with it. */
+    GraphRenderingOps::RenderingSchedule* swapSchedule (GraphRenderingOps::RenderingSchedule* const newSchedule)
+    {
+        GraphRenderingOps::RenderingSchedule* const oldSchedule = schedule.exchange (newSchedule);
+
+        waitForCallback();
+        return oldSchedule;
+    }
+
+    /** Renders a block in parallel, returns false if it must be rendered serially.
+        Must be called between beginCallback() and endCallback().
+    */
+    template <typename FloatType>
+    bool render (AudioBuffer<FloatType>& sharedBufferChans,
+                 const OwnedArray<MidiBuffer>& sharedMidiBuffers,
+                 const int numSamplesToRender, const double sampleRate) noexcept
+    {
+        GraphRenderingOps::RenderingSchedule* const currentSchedule = schedule.get();
+
+        if (currentSchedule == nullptr || currentSchedule->getNumTasks() < 2 || numActiveThreads.get() == 0)
+            return false;
+
+        // past half the block duration the audio thread finishes the block alone,
+        // rather than waiting on workers that did not get to run in time
+        const int64 deadline = Time::getHighResolutionTicks()
+                                + (sampleRate > 0.0 ? jmax ((int64) 1, (int64) (Time::getHighResolutionTicksPerSecond()
+                                                                                   * numSamplesToRender / sampleRate / 2))
+                                                    : std::numeric_limits<int64>::max() / 2);
+
+        const Thread::ThreadID currentThreadId = Thread::getCurrentThreadId();
+
+        if (currentThreadId != callerThreadId)
+        {
+            callerThreadId = currentThreadId;
+            followCallerPriority();
+        }
+
+        setBuffers (sharedBufferChans);
+        midiBuffers = &sharedMidiBuffers;
+        numSamples  = numSamplesToRender;
+        fpState     = getFpState();
+
+        currentSchedule->prepareForBlock();
+        activeSchedule.set (currentSchedule);
+        ++blockCounter;
+
+        for (int i = workers.size(); --i >= 0;)
+            workers.getUnchecked (i)->wake();
+
+        currentSchedule->render (sharedBufferChans, sharedMidiBuffers, numSamplesToRender, deadline);
+
+        // workers only touch the block while counted as busy; with every task done,
+        // all that is left for them is leaving the render loop
+        activeSchedule.set (nullptr);
+
+        while (numBusy.get() > 0)
+            Thread::yield();
+
+        return true;
+    }
+
+private:
+    struct Worker  : public Thread
+    {
+        Worker (ParallelRenderer& r)  : Thread ("AudioGraphRenderer"), renderer (r)
+        {
+            semValid = carla_sem_create2 (sem);
+        }
+
+        ~Worker()
+        {
+            if (semValid)
+                carla_sem_destroy2 (sem);
+        }
+
+        bool isValid() const noexcept   { return semValid; }
+
+        /** Posts the semaphore if the worker is sleeping on it, lock-free and safe for the audio thread. */
+        void wake() noexcept
+        {
+            if (sleeping.compareAndSetBool (0, 1))
+                carla_sem_post (sem, true);
+        }
+
+        void run() override
+        {
+            int lastBlock = renderer.blockCounter.get();
+            unsigned int lastFpState = getFpState();
+            int spins = 0;
+
+            while (! threadShouldExit())
+            {
+                const int block = renderer.blockCounter.get();
+
+                if (block == lastBlock)
+                {
+                    if (++spins < 2000)
+                    {
+                        Thread::yield();
+                        continue;
+                    }
+
+                    // only one post can follow each time 'sleeping' is set, drop any left from a timeout
+                    carla_sem_trywait (sem, true);
+                    sleeping.set (1);
+
+                    if (renderer.blockCounter.get() == lastBlock && ! threadShouldExit())
+                        carla_sem_timedwait (sem, 100, true);
+
+                    sleeping.set (0);
+                    continue;
+                }
+
+                lastBlock = block;
+                spins = 0;
+
+                ++(renderer.numBusy);
+
+                if (GraphRenderingOps::RenderingSchedule* const s = renderer.activeSchedule.get())
+                {
+                    // denormals and rounding modes follow the audio callback thread
+                    if (renderer.fpState != lastFpState)
+                        setFpState (lastFpState = renderer.fpState);
+
+                    if (renderer.doubleBuffers != nullptr)
+                        s->render (*renderer.doubleBuffers, *renderer.midiBuffers, renderer.numSamples, 0);
+                    else
+                        s->render (*renderer.floatBuffers, *renderer.midiBuffers, renderer.numSamples, 0);
+                }
+
+                --(renderer.numBusy);
+            }
+        }
+
+        ParallelRenderer& renderer;
+        carla_sem_t sem;
+        bool semValid;
+        Atomic<int> sleeping;
+
+        JUCE_DECLARE_NON_COPYABLE (Worker)
+    };
+
+    OwnedArray<Worker> workers;
+    Atomic<int> numActiveThreads;
+    Thread::ThreadID callerThreadId;
+
+    // current block, written before activeSchedule is set
+    AudioBuffer<float>* floatBuffers;
+    AudioBuffer<double>* doubleBuffers;
+    const OwnedArray<MidiBuffer>* midiBuffers;
+    int numSamples;
+    unsigned int fpState;
+
+    Atomic<GraphRenderingOps::RenderingSchedule*> schedule, activeSchedule;
+    Atomic<int> blockCounter, numBusy, callbackCounter;
+
+    void setBuffers (AudioBuffer<float>& buffers) noexcept    { floatBuffers = &buffers;  doubleBuffers = nullptr; }
+    void setBuffers (AudioBuffer<double>& buffers) noexcept   { doubleBuffers = &buffers; floatBuffers  = nullptr; }
+
+    void followCallerPriority() noexcept
+    {
+       #if ! JUCE_WINDOWS
+        struct sched_param param;
+        int policy;
+
+        if (pthread_getschedparam (pthread_self(), &policy, &param) != 0)
+            return;
+
+        for (int i = workers.size(); --i >= 0;)
+            pthread_setschedparam ((pthread_t) workers.getUnchecked (i)->getThreadId(), policy, &param);
+       #endif
+    }
+
+    static unsigned int getFpState() noexcept
+    {
+       #if JUCE_GRAPH_USE_SSE_CSR
+        return _mm_getcsr();
+       #else
+        return 0;
+       #endif
+    }
+
+    static void setFpState (const unsigned int state) noexcept
+    {
+       #if JUCE_GRAPH_USE_SSE_CSR
+        _mm_setcsr (state);
+       #else
+        ignoreUnused (state);
+       #endif
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelRenderer)
+};
+
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
     : lastNodeId (0), audioBuffers (new AudioProcessorGraphBufferHelpers),
+      parallelRenderer (new ParallelRenderer),
       currentMidiInputBuffer (nullptr), isPrepared (false)
 {
 }
@@ -1295,6 +1874,11 @@ bool AudioProcessorGraph::removeIllegalConnections()
     return doneAnything;
 }
 
+void AudioProcessorGraph::updateRenderingSequence()
+{
+    triggerAsyncUpdate();
+}
+
 //==============================================================================
 static void deleteRenderOpArray (Array<void*>& ops)
 {
@@ -1311,6 +1895,8 @@ void AudioProcessorGraph::clearRenderingSequence()
         renderingOps.swapWith (oldOps);
     }
 
+    // also waits for the audio callback to be done with the old ops
+    delete parallelRenderer->swapSchedule (nullptr);
     deleteRenderOpArray (oldOps);
 }
 
@@ -1339,6 +1925,7 @@ void AudioProcessorGraph::buildRenderingSequence()
     Array<void*> newRenderingOps;
     int numRenderingBuffersNeeded = 2;
     int numMidiBuffersNeeded = 1;
+    ScopedPointer<GraphRenderingOps::RenderingSchedule> newSchedule;
 
     {
         MessageManagerLock mml;
@@ -1363,10 +1950,19 @@ void AudioProcessorGraph::buildRenderingSequence()
             }
         }
 
-        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
+        // with rendering threads, shared buffers would serialise nodes that are otherwise independent
+        const bool renderInParallel = parallelRenderer->getNumThreads() > 0;
+        Array<int> nodeOpStarts;
+
+        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps,
+                                                                     nodeOpStarts, ! renderInParallel);
 
         numRenderingBuffersNeeded = calculator.getNumBuffersNeeded();
         numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
+
+        if (renderInParallel)
+            newSchedule = new GraphRenderingOps::RenderingSchedule (newRenderingOps, nodeOpStarts,
+                                                                    numRenderingBuffersNeeded, numMidiBuffersNeeded);
     }
 
     {
@@ -1384,7 +1980,8 @@ void AudioProcessorGraph::buildRenderingSequence()
         renderingOps.swapWith (newRenderingOps);
     }
 
-    // delete the old ones..
+    // delete the old ones, once the audio callback is done with them..
+    delete parallelRenderer->swapSchedule (newSchedule.release());
     deleteRenderOpArray (newRenderingOps);
 }
 
@@ -1393,6 +1990,26 @@ void AudioProcessorGraph::handleAsyncUpdate()
     buildRenderingSequence();
 }
 
+void AudioProcessorGraph::setNumRenderingThreads (const int numThreads)
+{
+    jassert (numThreads >= 0);
+
+    if (numThreads == parallelRenderer->getNumThreads())
+        return;
+
+    // render serially with the current ops until the new sequence is ready
+    delete parallelRenderer->swapSchedule (nullptr);
+    parallelRenderer->setNumThreads (jmax (0, numThreads));
+
+    if (isPrepared)
+        buildRenderingSequence();
+}
+
+int AudioProcessorGraph::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer->getNumThreads();
+}
+
 //==============================================================================
 void AudioProcessorGraph::prepareToPlay (double /*sampleRate*/, int estimatedSamplesPerBlock)
 {
@@ -1469,14 +2086,22 @@ void AudioProcessorGraph::processAudio (AudioBuffer<FloatType>& buffer, MidiBuff
     currentMidiInputBuffer = &midiMessages;
     currentMidiOutputBuffer.clear();
 
-    for (int i = 0; i < renderingOps.size(); ++i)
+    parallelRenderer->beginCallback();
+
+    // offline rendering has no deadline to meet, so it stays on the calling thread
+    if (isNonRealtime() || ! parallelRenderer->render (renderingBuffers, midiBuffers, numSamples, getSampleRate()))
     {
-        GraphRenderingOps::AudioGraphRenderingOpBase* const op
-            = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
+        for (int i = 0; i < renderingOps.size(); ++i)
+        {
+            GraphRenderingOps::AudioGraphRenderingOpBase* const op
+                = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
 
-        op->perform (renderingBuffers, midiBuffers, numSamples);
+            op->perform (renderingBuffers, midiBuffers, numSamples);
+        }
     }
 
+    parallelRenderer->endCallback();
+
     for (int i = 0; i < buffer.getNumChannels(); ++i)
         buffer.copyFrom (i, 0, currentAudioOutputBuffer, i, 0, numSamples);
 
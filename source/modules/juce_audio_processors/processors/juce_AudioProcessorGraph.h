@@ -248,6 +248,30 @@ public:
     */
     bool removeIllegalConnections();
 
+    /** Asynchronously rebuilds the rendering sequence.
+
+        This should be called when a node changes its latency, so that the
+        delay compensation of all paths in the graph gets recalculated.
+    */
+    void updateRenderingSequence();
+
+    //==============================================================================
+    /** Sets the number of extra threads used to render the graph.
+
+        Nodes that don't depend on each other are then rendered at the same time, with
+        the thread calling processBlock() always taking part in the work, so a block
+        never waits for a thread that isn't already busy with it.
+
+        With 0 threads, the default, the graph is rendered serially, as it also is
+        while in non-realtime mode.
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of extra rendering threads.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
     //==============================================================================
     /** A special number that represents the midi channel of a node.
 
@@ -393,6 +417,9 @@ private:
     struct AudioProcessorGraphBufferHelpers;
     ScopedPointer<AudioProcessorGraphBufferHelpers> audioBuffers;
 
+    struct ParallelRenderer;
+    ScopedPointer<ParallelRenderer> parallelRenderer;
+
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
 
@@ -110,10 +110,10 @@ public:
 
    #if JUCE_GCC
     // NB these are here as a workaround because GCC refuses to bind to packed values.
-    forcedinline uint8& getAlpha() noexcept           { return comps [indexA]; }
-    forcedinline uint8& getRed() noexcept             { return comps [indexR]; }
-    forcedinline uint8& getGreen() noexcept           { return comps [indexG]; }
-    forcedinline uint8& getBlue() noexcept            { return comps [indexB]; }
+    forcedinline uint8& getAlpha() noexcept           { return *(comps + indexA); }
+    forcedinline uint8& getRed() noexcept             { return *(comps + indexR); }
+    forcedinline uint8& getGreen() noexcept           { return *(comps + indexG); }
+    forcedinline uint8& getBlue() noexcept            { return *(comps + indexB); }
    #else
     forcedinline uint8& getAlpha() noexcept           { return components.a; }
     forcedinline uint8& getRed() noexcept             { return components.r; }
@@ -115,6 +115,14 @@ extern "C" {
 #undef rChangeCb
 #define rChangeCb
 
+#include "zynaddsubfx/DSP/OscilKernels.cpp"
+#undef rBegin
+#undef rObject
+#undef rStdString
+#undef rStdStringCb
+#undef rChangeCb
+#define rChangeCb
+
 #include "zynaddsubfx/DSP/SVFilter.cpp"
 #undef rBegin
 #undef rObject
@@ -298,6 +306,8 @@ extern "C" {
 #undef rChangeCb
 #define rChangeCb
 
+#include "zynaddsubfx/Misc/PartRenderPool.cpp"
+
 #include "zynaddsubfx/Misc/PresetExtractor.cpp"
 #undef rBegin
 #undef rObject
@@ -338,6 +348,8 @@ extern "C" {
 #undef rChangeCb
 #define rChangeCb
 
+#include "zynaddsubfx/Misc/WavetableCache.cpp"
+
 #include "zynaddsubfx/Misc/XMLwrapper.cpp"
 #undef rBegin
 #undef rObject
@@ -0,0 +1,184 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  OscilKernels.cpp - Vectorized inner loops for oscillators and unison
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "OscilKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+//The vector versions use the GCC vector extensions, so the same code builds
+//for every instruction set. x87 math rounds differently than SSE, so vectors
+//are only used when scalar floats use SSE too. FMA is never enabled, it would
+//change the rounding of the results.
+#if defined(__GNUC__) && defined(__SSE2_MATH__)
+#define OSCIL_KERNELS_SSE2
+#include <immintrin.h>
+//AVX2 code is built with a target pragma, which clang does not have
+#if !defined(__clang__)
+#define OSCIL_KERNELS_AVX2
+#endif
+#endif
+
+namespace OscilKernels
+{
+
+namespace scalar
+{
+#define OSCIL_LANES 1
+#include "OscilKernelsImpl.h"
+#undef OSCIL_LANES
+}
+
+#ifdef OSCIL_KERNELS_SSE2
+namespace sse2
+{
+#define OSCIL_LANES 4
+#include "OscilKernelsImpl.h"
+#undef OSCIL_LANES
+}
+#endif
+
+#ifdef OSCIL_KERNELS_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2
+{
+#define OSCIL_LANES 8
+#include "OscilKernelsImpl.h"
+#undef OSCIL_LANES
+}
+#pragma GCC pop_options
+#endif
+
+/*
+ * Runtime dispatch
+ */
+
+struct Kernels {
+    Isa isa;
+    void (*interpolate)(const float *, int, int, int, float **, int *, int *,
+                        const int *, const int *);
+    void (*modulate)(ModulationMode, const float *, int, int, int, float **,
+                     int *, float *, const int *, const float *, float, float);
+    void (*frequencyModulation)(const float *, int, int, int, float **, int *,
+                                int *, const int *, const int *, int);
+    void (*unisonTaps)(const float *, int, int, float, int, const float *,
+                       const float *, float *);
+};
+
+static bool supported(Isa isa)
+{
+    switch(isa) {
+        case Scalar:
+            return true;
+#ifdef OSCIL_KERNELS_SSE2
+        case SSE2:
+            return true;
+#endif
+#ifdef OSCIL_KERNELS_AVX2
+        case AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+static Kernels kernelsFor(Isa isa)
+{
+    switch(isa) {
+#ifdef OSCIL_KERNELS_AVX2
+        case AVX2:
+            return {AVX2, avx2::interpolate, avx2::modulate,
+                    avx2::frequencyModulation, avx2::unisonTaps};
+#endif
+#ifdef OSCIL_KERNELS_SSE2
+        case SSE2:
+            return {SSE2, sse2::interpolate, sse2::modulate,
+                    sse2::frequencyModulation, sse2::unisonTaps};
+#endif
+        default:
+            return {Scalar, scalar::interpolate, scalar::modulate,
+                    scalar::frequencyModulation, scalar::unisonTaps};
+    }
+}
+
+static Kernels bestKernels(void)
+{
+    if(supported(AVX2))
+        return kernelsFor(AVX2);
+    if(supported(SSE2))
+        return kernelsFor(SSE2);
+    return kernelsFor(Scalar);
+}
+
+static Kernels kernels = bestKernels();
+
+Isa isa(void)
+{
+    return kernels.isa;
+}
+
+bool setIsa(Isa isa)
+{
+    if(!supported(isa))
+        return false;
+    kernels = kernelsFor(isa);
+    return true;
+}
+
+const char *isaName(Isa isa)
+{
+    switch(isa) {
+        case SSE2:
+            return "SSE2";
+        case AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
+
+void interpolate(const float *smps, int oscilsize, int bufsize,
+                 int voices, float **out, int *poshi, int *poslo,
+                 const int *freqhi, const int *freqlo)
+{
+    kernels.interpolate(smps, oscilsize, bufsize, voices, out, poshi, poslo,
+                        freqhi, freqlo);
+}
+
+void modulate(ModulationMode mode, const float *smps, int oscilsize,
+              int bufsize, int voices, float **out, int *poshi,
+              float *poslo, const int *freqhi, const float *freqlo,
+              float oldamp, float newamp)
+{
+    kernels.modulate(mode, smps, oscilsize, bufsize, voices, out, poshi,
+                     poslo, freqhi, freqlo, oldamp, newamp);
+}
+
+void frequencyModulation(const float *smps, int oscilsize, int bufsize,
+                         int voices, float **out, int *poshi, int *poslo,
+                         const int *freqhi, const int *freqlo,
+                         int oddPhaseOffset)
+{
+    kernels.frequencyModulation(smps, oscilsize, bufsize, voices, out, poshi,
+                                poslo, freqhi, freqlo, oddPhaseOffset);
+}
+
+void unisonTaps(const float *delay, int max_delay, int delay_k,
+                float xpos, int voices, const float *realpos1,
+                const float *realpos2, float *taps)
+{
+    kernels.unisonTaps(delay, max_delay, delay_k, xpos, voices, realpos1,
+                       realpos2, taps);
+}
+
+}
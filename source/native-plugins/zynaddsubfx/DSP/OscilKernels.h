@@ -0,0 +1,76 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  OscilKernels.h - Vectorized inner loops for oscillators and unison
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#ifndef OSCIL_KERNELS_H
+#define OSCIL_KERNELS_H
+
+/**Inner loops of ADnote and Unison that run once per unison voice and sample.
+ *
+ * Each function processes several samples of a voice at once (several voices
+ * for the unison taps) with the widest vector unit available, picked at load
+ * time (AVX2 or SSE2 on x86, the plain C++ loops elsewhere). All variants do
+ * the same floating point operations in the same order as the plain loops, so
+ * the output is the same, bit for bit unless -ffast-math reorders the math.
+ *
+ * Wavetables must hold oscilsize + 1 samples (the guard sample used by the
+ * interpolation), oscilsize must be a power of two. Fixed point positions keep
+ * their fractional part in the 24 lower bits.*/
+namespace OscilKernels
+{
+    enum Isa {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**Implementation in use*/
+    Isa isa(void);
+
+    /**Force an implementation, for tests and benchmarks only.
+     * Not thread safe, returns false if the CPU cannot run it.*/
+    bool setIsa(Isa isa);
+
+    const char *isaName(Isa isa);
+
+    /**Linear interpolation through smps with fixed point positions,
+     * writing bufsize samples to out[k] for every voice k*/
+    void interpolate(const float *smps, int oscilsize, int bufsize,
+                     int voices, float **out, int *poshi, int *poslo,
+                     const int *freqhi, const int *freqlo);
+
+    enum ModulationMode {
+        Morph, //out = out * (1 - amp) + amp * wave
+        Ring   //out *= wave * amp + (1 - amp)
+    };
+
+    /**Read the modulator smps with floating point positions and apply it to
+     * out[k], with amp going linearly from oldamp to newamp over the buffer*/
+    void modulate(ModulationMode mode, const float *smps, int oscilsize,
+                  int bufsize, int voices, float **out, int *poshi,
+                  float *poslo, const int *freqhi, const float *freqlo,
+                  float oldamp, float newamp);
+
+    /**Phase modulation of the carrier smps by the modulator already in
+     * out[k], replacing it with the carrier output. The odd voices get
+     * oddPhaseOffset added to their position (pulse width modulation).*/
+    void frequencyModulation(const float *smps, int oscilsize, int bufsize,
+                             int voices, float **out, int *poshi, int *poslo,
+                             const int *freqhi, const int *freqlo,
+                             int oddPhaseOffset);
+
+    /**Taps of the unison delay line for one sample: the delay of voice k
+     * moves from realpos1[k] to realpos2[k] as xpos goes from 0 to 1, odd
+     * voices are inverted. Summing taps[] in order gives the unison output.*/
+    void unisonTaps(const float *delay, int max_delay, int delay_k,
+                    float xpos, int voices, const float *realpos1,
+                    const float *realpos2, float *taps);
+}
+
+#endif
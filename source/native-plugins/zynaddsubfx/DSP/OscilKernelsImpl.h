@@ -0,0 +1,400 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  OscilKernelsImpl.h - Oscillator and unison loops for one instruction set
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+
+//No include guard, OscilKernels.cpp includes this once per instruction set in
+//its own namespace, with OSCIL_LANES set to the vector width (1 for the plain
+//loops).
+
+/*
+ * One voice at a time, the loops ADnote and Unison always had. The vector
+ * versions use them for the samples left over.
+ */
+
+//is like i = (int)floor(f), the same as F2I() in globals.h
+static inline int floorInt(float f)
+{
+    return (f > 0) ? ((int)(f)) : ((int)(f - 1.0f));
+}
+
+static inline void interpolateVoice(const float *smps, int mask, int begin, int end,
+                                    float *tw, int &poshi_, int &poslo_,
+                                    int freqhi, int freqlo)
+{
+    int poshi = poshi_;
+    int poslo = poslo_;
+    for(int i = begin; i < end; ++i) {
+        tw[i]  = (smps[poshi] * ((1<<24) - poslo) + smps[poshi + 1] * poslo)/(1.0f*(1<<24));
+        poslo += freqlo;
+        poshi += freqhi + (poslo>>24);
+        poslo &= 0xffffff;
+        poshi &= mask;
+    }
+    poshi_ = poshi;
+    poslo_ = poslo;
+}
+
+static inline void modulateVoice(ModulationMode mode, const float *smps, int mask,
+                                 int begin, int end, int bufsize, float *tw,
+                                 int &poshi_, float &poslo_, int freqhi, float freqlo,
+                                 float oldamp, float newamp)
+{
+    int   poshi = poshi_;
+    float poslo = poslo_;
+    for(int i = begin; i < end; ++i) {
+        float amp  = oldamp + (newamp - oldamp) * (float)i / (float)bufsize;
+        float wave = smps[poshi] * (1.0f - poslo) + smps[poshi + 1] * poslo;
+        if(mode == Morph)
+            tw[i] = tw[i] * (1.0f - amp) + amp * wave;
+        else
+            tw[i] *= wave * amp + (1.0f - amp);
+        poslo += freqlo;
+        if(poslo >= 1.0f) {
+            poslo -= 1.0f;
+            poshi++;
+        }
+        poshi += freqhi;
+        poshi &= mask;
+    }
+    poshi_ = poshi;
+    poslo_ = poslo;
+}
+
+static inline void frequencyModulationVoice(const float *smps, int mask, int begin,
+                                            int end, float *tw, int &poshi_, int &poslo_,
+                                            int freqhi, int freqlo, int phaseOffset)
+{
+    int poshi = poshi_;
+    int poslo = poslo_;
+    for(int i = begin; i < end; ++i) {
+        int   FMmodfreqhi = floorInt(tw[i]);
+        float FMmodfreqlo = tw[i] - FMmodfreqhi;
+        if(FMmodfreqhi < 0)
+            FMmodfreqlo++;
+
+        //carrier
+        int carposhi = poshi + FMmodfreqhi + phaseOffset;
+        int carposlo = poslo + FMmodfreqlo;
+
+        if(carposlo >= (1<<24)) {
+            carposhi++;
+            carposlo &= 0xffffff;
+        }
+        carposhi &= mask;
+
+        tw[i] = (smps[carposhi] * ((1<<24) - carposlo)
+                + smps[carposhi + 1] * carposlo)/(1.0f*(1<<24));
+
+        poslo += freqlo;
+        if(poslo >= (1<<24)) {
+            poslo &= 0xffffff;
+            poshi++;
+        }
+        poshi += freqhi;
+        poshi &= mask;
+    }
+    poshi_ = poshi;
+    poslo_ = poslo;
+}
+
+//base is delay_k + max_delay - 1
+static inline float unisonTap(const float *delay, int max_delay, float base,
+                              float xpos, float realpos1, float realpos2)
+{
+    float vpos = realpos1 * (1.0f - xpos) + realpos2 * xpos;
+    float pos  = base - vpos;
+    int   posi = floorInt(pos);
+    int   posi_next = posi + 1;
+    if(posi >= max_delay)
+        posi -= max_delay;
+    if(posi_next >= max_delay)
+        posi_next -= max_delay;
+    float posf = pos - floorf(pos);
+    return (1.0f - posf) * delay[posi] + posf * delay[posi_next];
+}
+
+#if OSCIL_LANES > 1
+
+/*
+ * Vector helpers
+ */
+
+typedef float vf __attribute__((vector_size(OSCIL_LANES * sizeof(float))));
+typedef int   vi __attribute__((vector_size(OSCIL_LANES * sizeof(int))));
+
+template<typename V>
+static inline V load(const void *p)
+{
+    V v;
+    memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template<typename V>
+static inline void store(void *p, const V &v)
+{
+    memcpy(p, &v, sizeof(V));
+}
+
+static inline vf toFloat(const vi &v)
+{
+    return __builtin_convertvector(v, vf);
+}
+
+static inline vi toInt(const vf &v)
+{
+    return __builtin_convertvector(v, vi);
+}
+
+//the same as floorInt() for every lane
+static inline vi floorInt(const vf &f)
+{
+    const vi positive = f > 0.0f;
+    const vf adjusted = f - 1.0f;
+    return toInt((vf)(((vi)f & positive) | ((vi)adjusted & ~positive)));
+}
+
+//1.0f in the lanes where mask is set, 0.0f elsewhere
+static inline vf maskedOne(const vi &mask)
+{
+    const vf one = vf{} + 1.0f;
+    return (vf)((vi)one & mask);
+}
+
+static inline vf gather(const float *smps, const vi &index)
+{
+#if OSCIL_LANES == 8 && defined(__AVX2__)
+    return (vf)_mm256_i32gather_ps(smps, (__m256i)index, sizeof(float));
+#else
+    vf v;
+    for(int j = 0; j < OSCIL_LANES; ++j)
+        v[j] = smps[index[j]];
+    return v;
+#endif
+}
+
+static inline vf lerp24(const float *smps, const vi &poshi, const vi &poslo)
+{
+    const vf a = gather(smps, poshi);
+    const vf b = gather(smps + 1, poshi);
+    return (a * toFloat((1<<24) - poslo) + b * toFloat(poslo)) / (1.0f*(1<<24));
+}
+
+//fixed point positions of OSCIL_LANES consecutive samples of one voice
+struct FixedPhase {
+    vi  hi, lo;
+    int stephi, steplo, mask;
+};
+
+static inline FixedPhase fixedPhase(int poshi, int poslo, int freqhi, int freqlo,
+                                    int mask)
+{
+    FixedPhase p;
+    p.mask = mask;
+    for(int j = 0; j < OSCIL_LANES; ++j) {
+        p.hi[j] = poshi;
+        p.lo[j] = poslo;
+        poslo  += freqlo;
+        poshi  += freqhi + (poslo>>24);
+        poslo  &= 0xffffff;
+        poshi  &= mask;
+    }
+    //all the lanes step at once, the carry of the fraction works the same way
+    const int total = OSCIL_LANES * freqlo;
+    p.stephi = OSCIL_LANES * freqhi + (total>>24);
+    p.steplo = total & 0xffffff;
+    return p;
+}
+
+static inline void advance(FixedPhase &p)
+{
+    p.lo += p.steplo;
+    p.hi += p.stephi + (p.lo >> 24);
+    p.lo &= 0xffffff;
+    p.hi &= p.mask;
+}
+
+//float positions cannot step ahead exactly, they are computed for a chunk of
+//samples first
+#define OSCIL_CHUNK 64
+
+#endif
+
+/*
+ * Kernels
+ */
+
+static void interpolate(const float *smps, int oscilsize, int bufsize,
+                        int voices, float **out, int *poshi, int *poslo,
+                        const int *freqhi, const int *freqlo)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        int i = 0;
+#if OSCIL_LANES > 1
+        FixedPhase phase = fixedPhase(poshi[k], poslo[k], freqhi[k], freqlo[k], mask);
+        for(; i + OSCIL_LANES <= bufsize; i += OSCIL_LANES) {
+            store(out[k] + i, lerp24(smps, phase.hi, phase.lo));
+            advance(phase);
+        }
+        poshi[k] = phase.hi[0];
+        poslo[k] = phase.lo[0];
+#endif
+        interpolateVoice(smps, mask, i, bufsize, out[k], poshi[k], poslo[k],
+                         freqhi[k], freqlo[k]);
+    }
+}
+
+static void modulate(ModulationMode mode, const float *smps, int oscilsize,
+                     int bufsize, int voices, float **out, int *poshi,
+                     float *poslo, const int *freqhi, const float *freqlo,
+                     float oldamp, float newamp)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        int i = 0;
+#if OSCIL_LANES > 1
+        float *tw  = out[k];
+        int    ph  = poshi[k];
+        float  pl  = poslo[k];
+        int    fh  = freqhi[k];
+        float  fl  = freqlo[k];
+        int    hi[OSCIL_CHUNK];
+        float  lo[OSCIL_CHUNK];
+        vf     index;
+        for(int j = 0; j < OSCIL_LANES; ++j)
+            index[j] = j;
+
+        while(bufsize - i >= OSCIL_LANES) {
+            const int count = std::min(OSCIL_CHUNK, (bufsize - i) / OSCIL_LANES * OSCIL_LANES);
+            for(int j = 0; j < count; ++j) {
+                hi[j] = ph;
+                lo[j] = pl;
+                pl   += fl;
+                if(pl >= 1.0f) {
+                    pl -= 1.0f;
+                    ph++;
+                }
+                ph += fh;
+                ph &= mask;
+            }
+            for(int j = 0; j < count; j += OSCIL_LANES, i += OSCIL_LANES) {
+                const vf amp  = oldamp + (newamp - oldamp) * (index + (float)i) / (float)bufsize;
+                const vi h    = load<vi>(hi + j);
+                const vf l    = load<vf>(lo + j);
+                const vf wave = gather(smps, h) * (1.0f - l) + gather(smps + 1, h) * l;
+                vf v = load<vf>(tw + i);
+                if(mode == Morph)
+                    v = v * (1.0f - amp) + amp * wave;
+                else
+                    v *= wave * amp + (1.0f - amp);
+                store(tw + i, v);
+            }
+        }
+        poshi[k] = ph;
+        poslo[k] = pl;
+#endif
+        modulateVoice(mode, smps, mask, i, bufsize, bufsize, out[k], poshi[k],
+                      poslo[k], freqhi[k], freqlo[k], oldamp, newamp);
+    }
+}
+
+static void frequencyModulation(const float *smps, int oscilsize, int bufsize,
+                                int voices, float **out, int *poshi, int *poslo,
+                                const int *freqhi, const int *freqlo,
+                                int oddPhaseOffset)
+{
+    const int mask = oscilsize - 1;
+    for(int k = 0; k < voices; ++k) {
+        const int phaseOffset = (k & 1) ? oddPhaseOffset : 0;
+        int i = 0;
+#if OSCIL_LANES > 1
+        float *tw = out[k];
+        FixedPhase phase = fixedPhase(poshi[k], poslo[k], freqhi[k], freqlo[k], mask);
+        for(; i + OSCIL_LANES <= bufsize; i += OSCIL_LANES) {
+            const vf modulator   = load<vf>(tw + i);
+            const vi FMmodfreqhi = floorInt(modulator);
+            vf FMmodfreqlo = modulator - toFloat(FMmodfreqhi);
+            FMmodfreqlo += maskedOne(FMmodfreqhi < 0);
+
+            //carrier
+            vi carposhi = phase.hi + FMmodfreqhi + phaseOffset;
+            vi carposlo = toInt(toFloat(phase.lo) + FMmodfreqlo);
+            const vi carry = carposlo >= (1<<24);
+            carposhi -= carry;
+            carposlo &= ~carry | 0xffffff;
+            carposhi &= mask;
+
+            store(tw + i, lerp24(smps, carposhi, carposlo));
+            advance(phase);
+        }
+        poshi[k] = phase.hi[0];
+        poslo[k] = phase.lo[0];
+#endif
+        frequencyModulationVoice(smps, mask, i, bufsize, out[k], poshi[k], poslo[k],
+                                 freqhi[k], freqlo[k], phaseOffset);
+    }
+}
+
+static void unisonTaps(const float *delay, int max_delay, int delay_k,
+                       float xpos, int voices, const float *realpos1,
+                       const float *realpos2, float *taps)
+{
+    const float base = (float)(delay_k + max_delay - 1);
+#if OSCIL_LANES > 1
+    vf sign;
+    for(int j = 0; j < OSCIL_LANES; ++j)
+        sign[j] = (j & 1) ? -1.0f : 1.0f;
+
+    //one voice per lane, the last group is padded with the shortest delay
+    //which reads valid positions, and only the taps of real voices are kept
+    for(int k = 0; k < voices; k += OSCIL_LANES) {
+        const int count = std::min(OSCIL_LANES, voices - k);
+        vf r1, r2;
+        if(count == OSCIL_LANES) {
+            r1 = load<vf>(realpos1 + k);
+            r2 = load<vf>(realpos2 + k);
+        }
+        else {
+            r1 = r2 = vf{} + 1.0f;
+            memcpy(&r1, realpos1 + k, count * sizeof(float));
+            memcpy(&r2, realpos2 + k, count * sizeof(float));
+        }
+
+        const vf vpos = r1 * (1.0f - xpos) + r2 * xpos;
+        const vf pos  = base - vpos;
+        vi posi = floorInt(pos);
+        vi posi_next = posi + 1;
+        posi      -= max_delay & (posi >= max_delay);
+        posi_next -= max_delay & (posi_next >= max_delay);
+
+        //floorf(), exact for the range of delay positions
+        const vf trunc = toFloat(toInt(pos));
+        const vf posf  = pos - (trunc - maskedOne(trunc > pos));
+
+        const vf tap = ((1.0f - posf) * gather(delay, posi)
+                        + posf * gather(delay, posi_next)) * sign;
+        if(count == OSCIL_LANES)
+            store(taps + k, tap);
+        else
+            memcpy(taps + k, &tap, count * sizeof(float));
+    }
+#else
+    float sign = 1.0f;
+    for(int k = 0; k < voices; ++k) {
+        taps[k] = unisonTap(delay, max_delay, base, xpos, realpos1[k], realpos2[k]) * sign;
+        sign = -sign;
+    }
+#endif
+}
+
+#if OSCIL_LANES > 1
+#undef OSCIL_CHUNK
+#endif
@@ -16,6 +16,7 @@
 
 #include "../Misc/Allocator.h"
 #include "Unison.h"
+#include "OscilKernels.h"
 #include "globals.h"
 
 #define errx(...) {}
@@ -28,6 +29,9 @@ Unison::Unison(Allocator *alloc_, int update_period_samples_, float max_delay_se
     :unison_size(0),
       base_freq(1.0f),
       uv(NULL),
+      voice_pos1(NULL),
+      voice_pos2(NULL),
+      voice_taps(NULL),
       update_period_samples(update_period_samples_),
       update_period_sample_k(0),
       max_delay((int)(srate_f * max_delay_sec_) + 1),
@@ -49,6 +53,9 @@ Unison::Unison(Allocator *alloc_, int update_period_samples_, float max_delay_se
 Unison::~Unison() {
     alloc.devalloc(delay_buffer);
     alloc.devalloc(uv);
+    alloc.devalloc(voice_pos1);
+    alloc.devalloc(voice_pos2);
+    alloc.devalloc(voice_taps);
 }
 
 void Unison::setSize(int new_size)
@@ -57,7 +64,13 @@ void Unison::setSize(int new_size)
         new_size = 1;
     unison_size = new_size;
     alloc.devalloc(uv);
+    alloc.devalloc(voice_pos1);
+    alloc.devalloc(voice_pos2);
+    alloc.devalloc(voice_taps);
     uv = alloc.valloc<UnisonVoice>(unison_size);
+    voice_pos1 = alloc.valloc<float>(unison_size);
+    voice_pos2 = alloc.valloc<float>(unison_size);
+    voice_taps = alloc.valloc<float>(unison_size);
     first_time = true;
     updateParameters();
 }
@@ -133,23 +146,14 @@ void Unison::process(int bufsize, float *inbuf, float *outbuf)
             xpos = 0.0f;
         }
         xpos += xpos_step;
-        float in   = inbuf[i], out = 0.0f;
-        float sign = 1.0f;
-        for(int k = 0; k < unison_size; ++k) {
-            float vpos = uv[k].realpos1 * (1.0f - xpos) + uv[k].realpos2 * xpos;        //optimize
-            float pos  = (float)(delay_k + max_delay) - vpos - 1.0f;
-            int   posi;
-            F2I(pos, posi); //optimize!
-            int posi_next = posi + 1;
-            if(posi >= max_delay)
-                posi -= max_delay;
-            if(posi_next >= max_delay)
-                posi_next -= max_delay;
-            float posf = pos - floorf(pos);
-            out += ((1.0f - posf) * delay_buffer[posi] + posf
-                 * delay_buffer[posi_next]) * sign;
-            sign = -sign;
-        }
+        float in  = inbuf[i], out = 0.0f;
+        //the taps are vectorized, summing them in order keeps the result
+        //the same as with the scalar loop
+        OscilKernels::unisonTaps(delay_buffer, max_delay, delay_k, xpos,
+                                 unison_size, voice_pos1, voice_pos2,
+                                 voice_taps);
+        for(int k = 0; k < unison_size; ++k)
+            out += voice_taps[k];
         outbuf[i] = out * volume;
 //		printf("%d %g\n",i,outbuf[i]);
         delay_buffer[delay_k] = in;
@@ -193,6 +197,8 @@ void Unison::updateUnisonData()
 
         uv[k].position = pos;
         uv[k].step     = step;
+        voice_pos1[k]  = uv[k].realpos1;
+        voice_pos2[k]  = uv[k].realpos2;
     }
     first_time = false;
 }
@@ -55,6 +55,10 @@ class Unison
             }
         } *uv;
 
+        //delay positions of the voices as separate arrays, and the taps read
+        //at every sample, in the layout of the vectorized kernels
+        float *voice_pos1, *voice_pos2, *voice_taps;
+
         int    update_period_samples;
         int    update_period_sample_k;
         int    max_delay, delay_k;
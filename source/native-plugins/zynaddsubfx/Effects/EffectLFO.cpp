@@ -22,12 +22,13 @@ EffectLFO::EffectLFO(float srate_f, float bufsize_f)
       Prandomness(0),
       PLFOtype(0),
       Pstereo(64),
+      prngState(prng()),
       xl(0.0f),
       xr(0.0f),
-      ampl1(RND),
-      ampl2(RND),
-      ampr1(RND),
-      ampr2(RND),
+      ampl1(RND_R(prngState)),
+      ampl2(RND_R(prngState)),
+      ampr1(RND_R(prngState)),
+      ampr2(RND_R(prngState)),
       lfornd(0.0f),
       samplerate_f(srate_f),
       buffersize_f(bufsize_f)
@@ -89,7 +90,7 @@ void EffectLFO::effectlfoout(float *outl, float *outr)
     if(xl > 1.0f) {
         xl   -= 1.0f;
         ampl1 = ampl2;
-        ampl2 = (1.0f - lfornd) + lfornd * RND;
+        ampl2 = (1.0f - lfornd) + lfornd * RND_R(prngState);
     }
     *outl = (out + 1.0f) * 0.5f;
 
@@ -100,7 +101,7 @@ void EffectLFO::effectlfoout(float *outl, float *outr)
     if(xr > 1.0f) {
         xr   -= 1.0f;
         ampr1 = ampr2;
-        ampr2 = (1.0f - lfornd) + lfornd * RND;
+        ampr2 = (1.0f - lfornd) + lfornd * RND_R(prngState);
     }
     *outr = (out + 1.0f) * 0.5f;
 }
@@ -14,6 +14,8 @@
 #ifndef EFFECT_LFO_H
 #define EFFECT_LFO_H
 
+#include "../Misc/Util.h"
+
 /**LFO for some of the Effect objects
  * \todo see if this should inherit LFO*/
 class EffectLFO
@@ -30,6 +32,9 @@ class EffectLFO
     private:
         float getlfoshape(float x);
 
+        //own generator, effects of different parts may be rendered concurrently
+        prng_t prngState;
+
         float xl, xr;
         float incx;
         float ampl1, ampl2, ampr1, ampr2; //necessary for "randomness"
@@ -14,6 +14,8 @@
 #include <cassert>
 #include <utility>
 #include <cstdio>
+#include <atomic>
+#include <thread>
 #include "tlsf/tlsf.h"
 #include "Allocator.h"
 
@@ -42,6 +44,50 @@ struct AllocatorImpl
     //nice values
     next_t *pools = 0;
     unsigned long long totalAlloced = 0;
+
+    //parts may be rendered concurrently (see PartRenderPool), so the realtime
+    //side takes this very short lock around tlsf calls.
+    //render workers never take it for frees, the only thing notes do while
+    //rendering, so it is not contended in practice
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+    //blocks freed by render workers, linked through their first bytes and
+    //given back to tlsf by the next thread taking the lock
+    std::atomic<void*> deferred{nullptr};
+};
+
+static thread_local bool deferFrees = false;
+
+void Allocator::setDeferFrees(bool defer)
+{
+    deferFrees = defer;
+}
+
+//must hold the lock
+static void freeDeferred(AllocatorImpl *impl)
+{
+    void *mem = impl->deferred.exchange(nullptr, std::memory_order_acquire);
+    while(mem) {
+        void *nextMem = *(void**)mem;
+        tlsf_free(impl->tlsf, mem);
+        mem = nextMem;
+    }
+}
+
+class AllocatorLock
+{
+    public:
+        AllocatorLock(AllocatorImpl *impl_) : impl(impl_)
+        {
+            while(impl->lock.test_and_set(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+        ~AllocatorLock()
+        {
+            impl->lock.clear(std::memory_order_release);
+        }
+    private:
+        AllocatorImpl *impl;
 };
 
 Allocator::Allocator(void) : transaction_active()
@@ -70,6 +116,8 @@ Allocator::~Allocator(void)
 
 void *AllocatorClass::alloc_mem(size_t mem_size)
 {
+    AllocatorLock lock(impl);
+    freeDeferred(impl);
     impl->totalAlloced += mem_size;
     void *mem = tlsf_malloc(impl->tlsf, mem_size);
     //printf("Allocator.malloc(%p, %d) = %p\n", impl, mem_size, mem);
@@ -80,12 +128,27 @@ void *AllocatorClass::alloc_mem(size_t mem_size)
 void AllocatorClass::dealloc_mem(void *memory)
 {
     //printf("dealloc_mem(%d)\n", tlsf_block_size(memory));
+    if(deferFrees) {
+        void *head = impl->deferred.load(std::memory_order_relaxed);
+        do
+            *(void**)memory = head;
+        while(!impl->deferred.compare_exchange_weak(head, memory,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed));
+        return;
+    }
+
+    AllocatorLock lock(impl);
+    freeDeferred(impl);
     tlsf_free(impl->tlsf, memory);
     //free(memory);
 }
 
 bool AllocatorClass::lowMemory(unsigned n, size_t chunk_size) const
 {
+    AllocatorLock lock(impl);
+    freeDeferred(impl);
+
     //This should stay on the stack
     void *buf[n];
     for(unsigned i=0; i<n; ++i)
@@ -103,6 +166,8 @@ bool AllocatorClass::lowMemory(unsigned n, size_t chunk_size) const
 
 void AllocatorClass::addMemory(void *v, size_t mem_size)
 {
+    AllocatorLock lock(impl);
+    freeDeferred(impl);
     next_t *n = impl->pools;
     while(n->next) n = n->next;
     n->next = (next_t*)v;
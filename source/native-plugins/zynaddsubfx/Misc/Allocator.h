@@ -105,6 +105,12 @@ class Allocator
     void beginTransaction();
     void endTransaction();
 
+    /**
+     * Frees from the calling thread only get queued, without locking, and are
+     * done by the next thread using the allocator (see PartRenderPool)
+     */
+    static void setDeferFrees(bool defer);
+
     virtual void addMemory(void *, size_t mem_size) = 0;
 
     //Return true if the current pool cannot allocate n chunks of chunk_size
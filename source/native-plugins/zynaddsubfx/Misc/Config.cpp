@@ -48,6 +48,7 @@ static const rtosc::Ports ports = {
     rToggle(cfg.BankUIAutoClose, "Automatic Closing of BackUI After Patch Selection"),
     rParamI(cfg.GzipCompression, "Level of Gzip Compression For Save Files"),
     rParamI(cfg.Interpolation, "Level of Interpolation, Linear/Cubic"),
+    rParamI(cfg.PartRenderThreads, "Extra threads used to render parts in parallel (0 for none)"),
     {"cfg.presetsDirList", rDoc("list of preset search directories"), 0,
         [](const char *msg, rtosc::RtData &d)
         {
@@ -196,6 +197,7 @@ void CarlaConfig::init()
     cfg.GzipCompression = 3;
 
     cfg.Interpolation = 0;
+    cfg.PartRenderThreads = 0;
     cfg.CheckPADsynth = 1;
     cfg.IgnoreProgramChange = 0;
 
@@ -317,6 +319,11 @@ void CarlaConfig::readConfig(const char *filename)
                                            0,
                                            1);
 
+        cfg.PartRenderThreads = xmlcfg.getpar("part_render_threads",
+                                              cfg.PartRenderThreads,
+                                              0,
+                                              NUM_MIDI_PARTS - 1);
+
         cfg.CheckPADsynth = xmlcfg.getpar("check_pad_synth",
                                           cfg.CheckPADsynth,
                                           0,
@@ -427,6 +434,7 @@ void CarlaConfig::saveConfig(const char *filename) const
         }
 
     xmlcfg->addpar("interpolation", cfg.Interpolation);
+    xmlcfg->addpar("part_render_threads", cfg.PartRenderThreads);
 
     //linux stuff
     xmlcfg->addparstr("linux_oss_wave_out_dev", cfg.oss_devs.linux_wave_out);
@@ -44,6 +44,7 @@ class CarlaConfig
             int   BankUIAutoClose;
             int   GzipCompression;
             int   Interpolation;
+            int   PartRenderThreads;
             std::string bankRootDirList[MAX_BANK_ROOT_DIRS], currentBankDir;
             std::string presetsDirList[MAX_BANK_ROOT_DIRS];
             std::string favoriteList[MAX_BANK_ROOT_DIRS];
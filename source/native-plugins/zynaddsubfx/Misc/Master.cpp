@@ -25,6 +25,7 @@
 #include "../Containers/ScratchString.h"
 #include "../Nio/Nio.h"
 #include "PresetExtractor.h"
+#include "PartRenderPool.h"
 
 #include <rtosc/ports.h>
 #include <rtosc/port-sugar.h>
@@ -389,10 +390,17 @@ Master::Master(const SYNTH_T &synth_, CarlaConfig* config)
     }
 
     ScratchString ss;
-    for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+    for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart) {
         part[npart] = new Part(*memory, synth, time, config->cfg.GzipCompression,
                                config->cfg.Interpolation, &microtonal, fft, &watcher,
                                (ss+"/part"+npart+"/").c_str);
+        part[npart]->prngState = 0x1234 + npart * 2654435761u;
+    }
+
+    partPool = NULL;
+    if(config->cfg.PartRenderThreads > 0)
+        partPool = new PartRenderPool(min(config->cfg.PartRenderThreads,
+                                          NUM_MIDI_PARTS - 1));
 
     //Insertion Effects init
     for(int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
@@ -737,6 +745,69 @@ bool Master::runOSC(float *outl, float *outr, bool offline)
     return true;
 }
 
+static bool hasActiveWatches(const WatchManager &w)
+{
+    for(int i = 0; i < MAX_WATCH; ++i)
+        if(w.active_list[i][0])
+            return true;
+    return false;
+}
+
+/*
+ * Render a single part, this might run in a PartRenderPool thread
+ */
+void Master::renderPart(int npart)
+{
+    Part *p = part[npart];
+
+    p->ComputePartSmps();
+
+    //Insertion effects
+    for(int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
+        if(Pinsparts[nefx] == npart)
+            insefx[nefx]->out(p->partoutl, p->partoutr);
+
+    //Apply the part volumes and pannings (after insertion effects)
+    Stereo<float> newvol(p->volume),
+    oldvol(p->oldvolumel,
+           p->oldvolumer);
+
+    float pan = p->panning;
+    if(pan < 0.5f)
+        newvol.l *= pan * 2.0f;
+    else
+        newvol.r *= (1.0f - pan) * 2.0f;
+    //if(npart==0)
+    //printf("[%d]vol = %f->%f\n", npart, oldvol.l, newvol.l);
+
+    //the volume or the panning has changed and needs interpolation
+    if(ABOVE_AMPLITUDE_THRESHOLD(oldvol.l, newvol.l)
+       || ABOVE_AMPLITUDE_THRESHOLD(oldvol.r, newvol.r)) {
+        for(int i = 0; i < synth.buffersize; ++i) {
+            Stereo<float> vol(INTERPOLATE_AMPLITUDE(oldvol.l, newvol.l,
+                                                    i, synth.buffersize),
+                              INTERPOLATE_AMPLITUDE(oldvol.r, newvol.r,
+                                                    i, synth.buffersize));
+            p->partoutl[i] *= vol.l;
+            p->partoutr[i] *= vol.r;
+        }
+        p->oldvolumel = newvol.l;
+        p->oldvolumer = newvol.r;
+    }
+    else {
+        for(int i = 0; i < synth.buffersize; ++i) { //the volume did not changed
+            p->partoutl[i] *= newvol.l;
+            p->partoutr[i] *= newvol.r;
+        }
+    }
+}
+
+void Master::renderPartJob(void *master, int index)
+{
+    Master *m = (Master*)master;
+    m->renderPart(m->activeParts[index]);
+}
+
 /*
  * Master audio out (the final sound)
  */
@@ -771,59 +842,19 @@ bool Master::AudioOut(float *outr, float *outl)
     memset(outl, 0, synth.bufferbytes);
     memset(outr, 0, synth.bufferbytes);
 
-    //Compute part samples and store them part[npart]->partoutl,partoutr
+    //Compute part samples, with their insertion effects, volumes and pannings
+    //and store them part[npart]->partoutl,partoutr
+    int nactive = 0;
     for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
         if(part[npart]->Penabled)
-            part[npart]->ComputePartSmps();
-
-    //Insertion effects
-    for(int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
-        if(Pinsparts[nefx] >= 0) {
-            int efxpart = Pinsparts[nefx];
-            if(part[efxpart]->Penabled)
-                insefx[nefx]->out(part[efxpart]->partoutl,
-                                  part[efxpart]->partoutr);
-        }
-
-
-    //Apply the part volumes and pannings (after insertion effects)
-    for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart) {
-        if(!part[npart]->Penabled)
-            continue;
-
-        Stereo<float> newvol(part[npart]->volume),
-        oldvol(part[npart]->oldvolumel,
-               part[npart]->oldvolumer);
-
-        float pan = part[npart]->panning;
-        if(pan < 0.5f)
-            newvol.l *= pan * 2.0f;
-        else
-            newvol.r *= (1.0f - pan) * 2.0f;
-        //if(npart==0)
-        //printf("[%d]vol = %f->%f\n", npart, oldvol.l, newvol.l);
+            activeParts[nactive++] = npart;
 
-        //the volume or the panning has changed and needs interpolation
-        if(ABOVE_AMPLITUDE_THRESHOLD(oldvol.l, newvol.l)
-           || ABOVE_AMPLITUDE_THRESHOLD(oldvol.r, newvol.r)) {
-            for(int i = 0; i < synth.buffersize; ++i) {
-                Stereo<float> vol(INTERPOLATE_AMPLITUDE(oldvol.l, newvol.l,
-                                                        i, synth.buffersize),
-                                  INTERPOLATE_AMPLITUDE(oldvol.r, newvol.r,
-                                                        i, synth.buffersize));
-                part[npart]->partoutl[i] *= vol.l;
-                part[npart]->partoutr[i] *= vol.r;
-            }
-            part[npart]->oldvolumel = newvol.l;
-            part[npart]->oldvolumer = newvol.r;
-        }
-        else {
-            for(int i = 0; i < synth.buffersize; ++i) { //the volume did not changed
-                part[npart]->partoutl[i] *= newvol.l;
-                part[npart]->partoutr[i] *= newvol.r;
-            }
-        }
-    }
+    //watch points are not thread safe, these are only used for debugging
+    if(partPool && !hasActiveWatches(watcher))
+        partPool->run(renderPartJob, this, nactive);
+    else
+        for(int i = 0; i < nactive; ++i)
+            renderPart(activeParts[i]);
 
 
     //System effects
@@ -971,6 +1002,7 @@ void Master::GetAudioOutSamples(size_t nsamples,
 
 Master::~Master()
 {
+    delete partPool;
     delete []bufl;
     delete []bufr;
 
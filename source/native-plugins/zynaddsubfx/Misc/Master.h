@@ -194,6 +194,13 @@ class Master
         off_t  off;
         size_t smps;
 
+        //Parts are independent up to the system effects mix, so they can be
+        //rendered concurrently (if enabled in the config)
+        class PartRenderPool *partPool;
+        int  activeParts[NUM_MIDI_PARTS];
+        void renderPart(int npart) REALTIME;
+        static void renderPartJob(void *master, int index) REALTIME;
+
         //Callback When Master changes
         void(*mastercb)(void*,Master*);
         void* mastercb_ptr;
@@ -216,6 +216,8 @@ Part::Part(Allocator &alloc, const SYNTH_T &synth_, const AbsTime &time_,
     gzip_compression(gzip_compression),
     interpolation(interpolation)
 {
+    prngState = 0x1234;
+
     if(prefix_)
         strncpy(prefix, prefix_, sizeof(prefix));
     else
@@ -499,7 +501,7 @@ bool Part::NoteOn(unsigned char note,
             continue;
 
         SynthParams pars{memory, ctl, synth, time, notebasefreq, vel,
-            portamento, note, false};
+            portamento, note, false, prngState};
         const int sendto = Pkitmode ? item.sendto() : 0;
 
         try {
@@ -19,6 +19,7 @@
 #include "../globals.h"
 #include "../Params/Controller.h"
 #include "../Containers/NotePool.h"
+#include "Util.h"
 
 #include <functional>
 
@@ -143,6 +144,8 @@ class Part
         float volume, oldvolumel, oldvolumer; //this is applied by Master
         float panning; //this is applied by Master, too
 
+        prng_t prngState; //random generator of the notes of this part (see SynthParams)
+
         Controller ctl; //Part controllers
 
         EffectMgr    *partefx[NUM_PART_EFX]; //insertion part effects (they are part of the instrument)
@@ -0,0 +1,234 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PartRenderPool.cpp - Worker threads for rendering parts concurrently
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PartRenderPool.h"
+#include "Allocator.h"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+//Flush-to-zero and similar modes change results, so workers copy them
+//from the thread that started the batch
+static unsigned getFpState(void)
+{
+#if defined(__SSE__)
+    return _mm_getcsr();
+#elif defined(__aarch64__)
+    unsigned long fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return (unsigned)fpcr;
+#else
+    return 0;
+#endif
+}
+
+static void setFpState(unsigned state)
+{
+#if defined(__SSE__)
+    _mm_setcsr(state);
+#elif defined(__aarch64__)
+    unsigned long fpcr = state;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#else
+    (void)state;
+#endif
+}
+
+//The realtime thread waits for workers to finish their jobs, so these must
+//not run at a lower priority than it does
+static void getSchedState(int &policy, int &priority)
+{
+#ifndef _WIN32
+    sched_param param;
+    if(pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+        priority = param.sched_priority;
+        return;
+    }
+#endif
+    policy   = 0;
+    priority = 0;
+}
+
+static void setSchedState(int policy, int priority)
+{
+#ifndef _WIN32
+    sched_param param;
+    param.sched_priority = priority;
+    pthread_setschedparam(pthread_self(), policy, &param);
+#else
+    (void)policy;
+    (void)priority;
+#endif
+}
+
+//How many times an idle worker checks for a new batch before going to sleep,
+//kept short as workers left without a job would otherwise spin through every batch
+#define SPIN_COUNT 200
+
+PartRenderPool::PartRenderPool(int nthreads)
+    :job(nullptr), data(nullptr), fpState(0),
+    schedPolicy(0), schedPriority(0), quitting(false),
+    batch(0), next(0), pending(0)
+{
+    for(int i = 0; i < nthreads; ++i) {
+        std::unique_ptr<Worker> w(new Worker);
+        if(w->sem.init(0, 0) != 0)
+            break;
+        w->sleeping = 0;
+        w->thread   = std::thread(&PartRenderPool::workerLoop, this, w.get());
+        workers.push_back(std::move(w));
+    }
+}
+
+PartRenderPool::~PartRenderPool()
+{
+    quitting = true;
+
+    for(auto &w:workers)
+        wake(w.get());
+
+    for(auto &w:workers)
+        w->thread.join();
+}
+
+void PartRenderPool::wake(Worker *w)
+{
+    //only one post can follow each time a worker goes to sleep
+    int expected = 1;
+    if(w->sleeping.compare_exchange_strong(expected, 0))
+        w->sem.post();
+}
+
+void PartRenderPool::run(Job job_, void *data_, int count_)
+{
+    if(workers.empty() || count_ <= 1) {
+        for(int i = 0; i < count_; ++i)
+            job_(data_, i);
+        return;
+    }
+
+    const std::thread::id caller = std::this_thread::get_id();
+    if(caller != callerThread) {
+        callerThread = caller;
+        int policy, priority;
+        getSchedState(policy, priority);
+        schedPolicy.store(policy, std::memory_order_relaxed);
+        schedPriority.store(priority, std::memory_order_relaxed);
+    }
+
+    //the previous batch is done, so workers late for it cannot claim any job
+    //of this one (see claim()) and never use these while they change
+    const uint32_t b = batch.load(std::memory_order_relaxed) + 1;
+    job.store(job_, std::memory_order_relaxed);
+    data.store(data_, std::memory_order_relaxed);
+    fpState.store(getFpState(), std::memory_order_relaxed);
+    pending.store(count_, std::memory_order_relaxed);
+    next.store(((uint64_t)b << 32) | (uint32_t)count_, std::memory_order_relaxed);
+    batch.store(b);
+
+    for(auto &w:workers)
+        wake(w.get());
+
+    runJobs(job_, data_, b);
+
+    //every job is taken by now, this only waits for the ones workers are
+    //in the middle of, whose output is needed
+    while(pending.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+}
+
+int PartRenderPool::claim(uint32_t batch_)
+{
+    uint64_t cur = next.load(std::memory_order_relaxed);
+
+    while((uint32_t)(cur >> 32) == batch_ && (uint32_t)cur > 0)
+        if(next.compare_exchange_weak(cur, cur - 1, std::memory_order_acquire,
+                                      std::memory_order_relaxed))
+            return (int)(uint32_t)cur - 1;
+
+    return -1;
+}
+
+void PartRenderPool::runJobs(Job job_, void *data_, uint32_t batch_)
+{
+    for(int i; (i = claim(batch_)) >= 0;) {
+        job_(data_, i);
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void PartRenderPool::workerLoop(Worker *self)
+{
+    uint32_t seen   = 0;
+    unsigned seenFp = getFpState();
+    int seenPolicy, seenPriority;
+    getSchedState(seenPolicy, seenPriority);
+    int spins = 0;
+
+    //notes finishing here go back to the allocator without taking its lock
+    Allocator::setDeferFrees(true);
+
+    while(!quitting) {
+        const uint32_t b = batch.load();
+
+        if(b == seen) {
+            if(++spins < SPIN_COUNT) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            //drop a post left over from a wake-up that came after the check below
+            self->sem.trywait();
+            self->sleeping = 1;
+
+            if(batch.load() == seen && !quitting)
+                self->sem.wait();
+
+            self->sleeping = 0;
+            continue;
+        }
+
+        seen  = b;
+        spins = 0;
+
+        //these might already belong to a later batch, they are only used
+        //once a job of this batch is claimed, which means they do not
+        Job   job_  = job.load(std::memory_order_relaxed);
+        void *data_ = data.load(std::memory_order_relaxed);
+
+        const int first = claim(b);
+        if(first < 0)
+            continue;
+
+        const unsigned fpState_  = fpState.load(std::memory_order_relaxed);
+        const int      policy_   = schedPolicy.load(std::memory_order_relaxed);
+        const int      priority_ = schedPriority.load(std::memory_order_relaxed);
+
+        if(fpState_ != seenFp) {
+            setFpState(fpState_);
+            seenFp = fpState_;
+        }
+
+        if(policy_ != seenPolicy || priority_ != seenPriority) {
+            setSchedState(policy_, priority_);
+            seenPolicy   = policy_;
+            seenPriority = priority_;
+        }
+
+        job_(data_, first);
+        pending.fetch_sub(1, std::memory_order_release);
+
+        runJobs(job_, data_, b);
+    }
+}
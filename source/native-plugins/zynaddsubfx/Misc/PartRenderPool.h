@@ -0,0 +1,76 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PartRenderPool.h - Worker threads for rendering parts concurrently
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "../globals.h"
+#include "../Nio/ZynSema.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**Small pool of threads that runs a batch of independent jobs together
+ * with the realtime thread.
+ *
+ * The realtime thread always takes part in the work, so the pool never makes
+ * a batch slower than running it serially, and workers spin for a short while
+ * between batches since these come at every buffer. Starting a batch takes no
+ * locks, sleeping workers are woken by posting their semaphore.*/
+class PartRenderPool
+{
+    public:
+        typedef void (*Job)(void *data, int index);
+
+        /**Constructor
+         * @param nthreads Number of extra threads, besides the caller*/
+        PartRenderPool(int nthreads) NONREALTIME;
+        ~PartRenderPool() NONREALTIME;
+
+        PartRenderPool(const PartRenderPool&) = delete;
+
+        /**Call job(data, i) for all 0 <= i < count, returning once all are done.
+         * Jobs run with the floating point mode and the scheduling policy and
+         * priority of the calling thread.*/
+        void run(Job job, void *data, int count) REALTIME;
+
+        int threads() const { return (int)workers.size(); }
+
+    private:
+        struct Worker {
+            std::thread      thread;
+            ZynSema          sem;
+            std::atomic<int> sleeping; //set while the worker may wait on sem
+        };
+
+        void workerLoop(Worker *self);
+        void wake(Worker *w);
+        int  claim(uint32_t batch_);
+        void runJobs(Job job_, void *data_, uint32_t batch_);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        //batch parameters, written by the realtime thread before batch is
+        //incremented and never while a job of the previous batch can start
+        std::atomic<Job>      job;
+        std::atomic<void *>   data;
+        std::atomic<unsigned> fpState;
+        std::atomic<int>      schedPolicy;
+        std::atomic<int>      schedPriority;
+        std::atomic<bool>     quitting;
+
+        //scheduling parameters are only read again when the caller changes
+        std::thread::id callerThread;
+
+        std::atomic<uint32_t> batch;   //incremented for every new batch
+        std::atomic<uint64_t> next;    //batch in the high bits, jobs left to claim in the low ones
+        std::atomic<int>      pending; //jobs not finished yet
+};
@@ -119,6 +119,13 @@ inline prng_t prng(void)
     return prng_r(prng_state) & 0x7fffffff;
 }
 
+//Parts can be rendered concurrently (see PartRenderPool), so notes draw
+//from the generator of their part instead of the global one
+inline prng_t prng(prng_t &p)
+{
+    return prng_r(p) & 0x7fffffff;
+}
+
 inline void sprng(prng_t p)
 {
     prng_state = p;
@@ -131,6 +138,7 @@ inline void sprng(prng_t p)
 #define INT32_MAX      (2147483647)
 #endif
 #define RND (prng() / (INT32_MAX * 1.0f))
+#define RND_R(p) (prng(p) / (INT32_MAX * 1.0f))
 
 //Linear Interpolation
 float interpolate(const float *data, size_t len, float pos);
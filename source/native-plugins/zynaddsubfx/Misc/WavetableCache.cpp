@@ -0,0 +1,303 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  WavetableCache.cpp - On-disk cache of generated PADsynth samples
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "WavetableCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+namespace WavetableCache
+{
+
+//Whole cache, the least recently used entries are removed past this
+static const long long maxCacheSize = 256LL * 1024 * 1024;
+
+//Temporary files older than this (in seconds) were left by a crash
+static const time_t staleTmpAge = 60 * 60;
+
+struct Header {
+    char     magic[4];
+    uint32_t version;
+    uint32_t count, size, extra;
+};
+
+static const uint32_t formatVersion = 1;
+
+static Header makeHeader(int count, int size, int extra)
+{
+    Header h;
+    memcpy(h.magic, "ZPAD", 4);
+    h.version = formatVersion;
+    h.count   = count;
+    h.size    = size;
+    h.extra   = extra;
+    return h;
+}
+
+static long long entrySize(int count, int size, int extra)
+{
+    return (long long)sizeof(Header)
+           + (long long)count * (sizeof(float) * (size + extra + 1));
+}
+
+uint64_t hash(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#ifndef _WIN32
+
+static bool makeDirectory(const std::string &dir)
+{
+    struct stat st;
+    if(stat(dir.c_str(), &st) == 0)
+        return S_ISDIR(st.st_mode);
+
+    const size_t slash = dir.find_last_of('/');
+    if(slash != std::string::npos && slash > 0
+       && !makeDirectory(dir.substr(0, slash)))
+        return false;
+
+    return mkdir(dir.c_str(), S_IRWXU) == 0 || errno == EEXIST;
+}
+
+std::string directory(void)
+{
+    std::string dir;
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    if(xdg && xdg[0] == '/')
+        dir = xdg;
+    else if(home && home[0])
+        dir = std::string(home) + "/.cache";
+    else
+        return "";
+
+    dir += "/zynaddsubfx/padsynth";
+    return makeDirectory(dir) ? dir : "";
+}
+
+static std::string entryPath(const std::string &dir, uint64_t key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.pad", (unsigned long long)key);
+    return dir + name;
+}
+
+//Remove stale temporary files, then the least recently used entries until
+//the cache fits its limit
+static void trim(const std::string &dir)
+{
+    DIR *d = opendir(dir.c_str());
+    if(!d)
+        return;
+
+    struct Entry {
+        std::string path;
+        time_t      mtime;
+        long long   size;
+    };
+    std::vector<Entry> entries;
+    long long total = 0;
+    const time_t now = time(NULL);
+
+    while(struct dirent *fn = readdir(d)) {
+        const size_t len = strlen(fn->d_name);
+        const bool isTmp = strstr(fn->d_name, ".pad.tmp") != NULL;
+        if(!isTmp && (len < 4 || strcmp(fn->d_name + len - 4, ".pad") != 0))
+            continue;
+        const std::string path = dir + "/" + fn->d_name;
+        struct stat st;
+        if(stat(path.c_str(), &st) != 0)
+            continue;
+        if(isTmp) {
+            //recent ones may still be written by another instance
+            if(now - st.st_mtime > staleTmpAge)
+                remove(path.c_str());
+            continue;
+        }
+        entries.push_back({path, st.st_mtime, (long long)st.st_size});
+        total += st.st_size;
+    }
+    closedir(d);
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) {return a.mtime < b.mtime;});
+
+    for(const Entry &e:entries) {
+        if(total <= maxCacheSize)
+            break;
+        if(remove(e.path.c_str()) == 0)
+            total -= e.size;
+    }
+}
+
+bool load(uint64_t key, int count, int size, int extra, LoadCallback cb)
+{
+    const std::string dir = directory();
+    if(dir.empty())
+        return false;
+
+    const std::string path = entryPath(dir, key);
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f)
+        return false;
+
+    const Header expected = makeHeader(count, size, extra);
+    Header h;
+    bool ok = fread(&h, sizeof(h), 1, f) == 1
+              && memcmp(&h, &expected, sizeof(h)) == 0
+              && fseek(f, 0, SEEK_END) == 0
+              && ftell(f) == entrySize(count, size, extra)
+              && fseek(f, sizeof(Header), SEEK_SET) == 0;
+
+    //read the whole entry before handing out any sample, so a file that
+    //turns out to be bad never leaves the caller with part of it
+    std::vector<float>  basefreqs(ok ? count : 0);
+    std::vector<float*> smps(ok ? count : 0, nullptr);
+
+    for(int n = 0; ok && n < count; ++n) {
+        smps[n] = new float[size + extra];
+        ok = fread(&basefreqs[n], sizeof(float), 1, f) == 1
+             && fread(smps[n], sizeof(float), size + extra, f)
+                == (size_t)(size + extra);
+    }
+
+    fclose(f);
+
+    if(!ok) {
+        for(float *smp:smps)
+            delete[] smp;
+        return false;
+    }
+
+    //mark it as recently used, trim() removes the oldest entries first
+    utime(path.c_str(), NULL);
+
+    for(int n = 0; n < count; ++n)
+        cb(n, size, basefreqs[n], smps[n]);
+    return true;
+}
+
+Writer::Writer(uint64_t key, int count_, int size_, int extra_)
+    :file(NULL), count(count_), size(size_), extra(extra_), added(0)
+{
+    if(entrySize(count, size, extra) > maxCacheSize)
+        return;
+
+    const std::string dir = directory();
+    if(dir.empty())
+        return;
+
+    //unique name, other instances may be writing the same entry
+    static std::atomic<unsigned> serial(0);
+    path    = entryPath(dir, key);
+    tmppath = path + ".tmp" + std::to_string(getpid()) + "-"
+              + std::to_string(serial++);
+
+    file = fopen(tmppath.c_str(), "wb");
+    if(!file)
+        return;
+
+    const Header h = makeHeader(count, size, extra);
+    if(fwrite(&h, sizeof(h), 1, file) != 1)
+        discard();
+}
+
+Writer::~Writer()
+{
+    discard();
+}
+
+void Writer::add(float basefreq, const float *smp)
+{
+    if(!file)
+        return;
+
+    if(fwrite(&basefreq, sizeof(float), 1, file) != 1
+       || fwrite(smp, sizeof(float), size + extra, file)
+          != (size_t)(size + extra))
+        discard();
+    else
+        ++added;
+}
+
+void Writer::commit(void)
+{
+    if(!file)
+        return;
+
+    const bool ok = fclose(file) == 0 && added == count;
+    file = NULL;
+
+    if(ok && rename(tmppath.c_str(), path.c_str()) == 0)
+        trim(path.substr(0, path.find_last_of('/')));
+    else
+        remove(tmppath.c_str());
+}
+
+void Writer::discard(void)
+{
+    if(!file)
+        return;
+    fclose(file);
+    file = NULL;
+    remove(tmppath.c_str());
+}
+
+#else
+
+//no cache on Windows
+std::string directory(void)
+{
+    return "";
+}
+
+bool load(uint64_t, int, int, int, LoadCallback)
+{
+    return false;
+}
+
+Writer::Writer(uint64_t, int count_, int size_, int extra_)
+    :file(NULL), count(count_), size(size_), extra(extra_), added(0)
+{}
+
+Writer::~Writer()
+{}
+
+void Writer::add(float, const float *)
+{}
+
+void Writer::commit(void)
+{}
+
+void Writer::discard(void)
+{}
+
+#endif
+
+}
@@ -0,0 +1,69 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  WavetableCache.h - On-disk cache of generated PADsynth samples
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+/**Content addressed cache of PADsynth wavetables.
+ *
+ * Each entry holds all the samples of one PADsynth instrument and is named
+ * after a hash of everything that went into them, so entries never go stale
+ * and identical presets share one entry. Files live in
+ * $XDG_CACHE_HOME/zynaddsubfx/padsynth (~/.cache/... when unset) and the
+ * least recently used ones are removed once the cache grows past its size
+ * limit.
+ *
+ * Everything here is NONREALTIME, failures only mean the samples have to be
+ * generated again.*/
+namespace WavetableCache
+{
+    /**64 bit FNV-1a hash of data, continuing from hash*/
+    uint64_t hash(const void *data, size_t size,
+                  uint64_t hash = 0xcbf29ce484222325ULL);
+
+    /**Cache directory, empty when there is none*/
+    std::string directory(void);
+
+    typedef std::function<void(int n, int size, float basefreq,
+                               float *smp)> LoadCallback;
+
+    /**Read the entry stored under key, cb takes ownership of each smp
+     * (new[] allocated, size + extra floats). cb is only called once the
+     * whole entry was read and checked.
+     * @returns false when there is no complete entry of that shape*/
+    bool load(uint64_t key, int count, int size, int extra,
+              LoadCallback cb);
+
+    /**Writes a new entry one sample at a time, so samples can be handed
+     * over as soon as they are written. The entry only becomes visible when
+     * commit() is called after all count samples were added.*/
+    class Writer
+    {
+        public:
+            Writer(uint64_t key, int count, int size, int extra);
+            ~Writer();
+
+            Writer(const Writer&) = delete;
+
+            void add(float basefreq, const float *smp);
+            void commit(void);
+
+        private:
+            void discard(void);
+
+            std::string path, tmppath;
+            FILE *file;
+            int   count, size, extra;
+            int   added;
+    };
+}
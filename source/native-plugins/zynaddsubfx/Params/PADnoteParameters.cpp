@@ -19,7 +19,15 @@
 #include "../Synth/OscilGen.h"
 #include "../Misc/WavFile.h"
 #include "../Misc/Time.h"
+#include "../Misc/WavetableCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <rtosc/ports.h>
 #include <rtosc/port-sugar.h>
@@ -814,23 +822,31 @@ void PADnoteParameters::applyparameters(std::function<bool()> do_abort)
         deletesample(i);
 }
 
+//Sample generation threads, at most
+static const int maxSampleThreads = 4;
+//Memory that all of their FFTs together may use
+static const long long maxSampleThreadsMemory = 256LL * 1024 * 1024;
+
 //Requires
 // - Pquality.samplesize
 // - Pquality.basenote
 // - Pquality.oct
 // - Pquality.smpoct
 // - spectrum at various frequencies (oodles of data)
+//
+//Each sample needs its own big IFFT, so samples are computed in parallel by
+//a few threads while the calling thread hands them over in order. The phases
+//are seeded from the parameters, which makes the samples reproducible and
+//lets them be cached on disk.
 void PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
         std::function<bool()> do_abort)
 {
     const int samplesize   = (((int) 1) << (Pquality.samplesize + 14));
     const int spectrumsize = samplesize / 2;
-    float    *spectrum     = new float[spectrumsize];
-    const int profilesize = 512;
-    float     profile[profilesize];
+    //the last samples contains the first samples
+    //(used for linear/cubic interpolation)
+    const int extra_samples = 5;
 
-
-    const float bwadjust = getprofile(profile, profilesize);
     float basefreq = 65.406f * powf(2.0f, Pquality.basenote / 2);
     if(Pquality.basenote % 2 == 1)
         basefreq *= 1.5f;
@@ -848,71 +864,151 @@ void PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
     if(samplemax == 0)
         samplemax = 1;
 
-    //prepare a BIG FFT
-    FFTwrapper *fft      = new FFTwrapper(samplesize);
-    fft_t      *fftfreqs = new fft_t[samplesize / 2];
+    if(do_abort())
+        return;
+
+    const uint64_t key = wavetableHash();
+    const bool cached = WavetableCache::load(key, samplemax, samplesize,
+            extra_samples, [&cb](int n, int size, float freq, float *smp) {
+                PADnoteParameters::Sample newsample;
+                newsample.size     = size;
+                newsample.basefreq = freq;
+                newsample.smp      = smp;
+                cb(n, newsample);
+            });
+    if(cached)
+        return;
+
+    const int profilesize = 512;
+    float     profile[profilesize];
+    const float bwadjust = getprofile(profile, profilesize);
 
     //this is used to compute frequency relation to the base frequency
-    float adj[samplemax];
+    std::vector<float> adj(samplemax);
     for(int nsample = 0; nsample < samplemax; ++nsample)
         adj[nsample] = (Pquality.oct + 1.0f) * (float)nsample / samplemax;
-    for(int nsample = 0; nsample < samplemax; ++nsample) {
-        if(do_abort())
-            goto exit;
-        const float basefreqadjust =
-            powf(2.0f, adj[nsample] - adj[samplemax - 1] * 0.5f);
-
-        if(Pmode == 0)
-            generatespectrum_bandwidthMode(spectrum,
-                                           spectrumsize,
-                                           basefreq * basefreqadjust,
-                                           profile,
-                                           profilesize,
-                                           bwadjust);
-        else
-            generatespectrum_otherModes(spectrum, spectrumsize,
-                                        basefreq * basefreqadjust);
-
-        //the last samples contains the first samples
-        //(used for linear/cubic interpolation)
-        const int extra_samples = 5;
-        PADnoteParameters::Sample newsample;
-        newsample.smp = new float[samplesize + extra_samples];
-
-        newsample.smp[0] = 0.0f;
-        for(int i = 1; i < spectrumsize; ++i) //randomize the phases
-            fftfreqs[i] = FFTpolar(spectrum[i], (float)RND * 2 * PI);
-        //that's all; here is the only ifft for the whole sample;
-        //no windows are used ;-)
-        fft->freqs2smps(fftfreqs, newsample.smp);
-
-
-        //normalize(rms)
-        float rms = 0.0f;
-        for(int i = 0; i < samplesize; ++i)
-            rms += newsample.smp[i] * newsample.smp[i];
-        rms = sqrt(rms);
-        if(rms < 0.000001f)
-            rms = 1.0f;
-        rms *= sqrt(262144.0f / samplesize);//262144=2^18
-        for(int i = 0; i < samplesize; ++i)
-            newsample.smp[i] *= 1.0f / rms * 50.0f;
-
-        //prepare extra samples used by the linear or cubic interpolation
-        for(int i = 0; i < extra_samples; ++i)
-            newsample.smp[i + samplesize] = newsample.smp[i];
-
-        //yield new sample
-        newsample.size     = samplesize;
-        newsample.basefreq = basefreq * basefreqadjust;
-        cb(nsample, newsample);
+
+    std::vector<PADnoteParameters::Sample> samples(samplemax);
+    std::vector<bool>       done(samplemax, false);
+    std::mutex              mutex;
+    std::condition_variable finished;
+    std::mutex              spectrumMutex; //oscilgen is not thread safe
+    std::atomic<int>        next(0);
+    std::atomic<bool>       aborted(false);
+
+    auto worker = [&]() {
+        //each thread has its own big FFT
+        FFTwrapper *fft      = new FFTwrapper(samplesize);
+        fft_t      *fftfreqs = new fft_t[spectrumsize];
+        float      *spectrum = new float[spectrumsize];
+
+        for(int nsample; !aborted && (nsample = next++) < samplemax;) {
+            const float basefreqadjust =
+                powf(2.0f, adj[nsample] - adj[samplemax - 1] * 0.5f);
+
+            {
+                std::lock_guard<std::mutex> lock(spectrumMutex);
+                if(Pmode == 0)
+                    generatespectrum_bandwidthMode(spectrum,
+                                                   spectrumsize,
+                                                   basefreq * basefreqadjust,
+                                                   profile,
+                                                   profilesize,
+                                                   bwadjust);
+                else
+                    generatespectrum_otherModes(spectrum, spectrumsize,
+                                                basefreq * basefreqadjust);
+            }
+
+            PADnoteParameters::Sample newsample;
+            newsample.smp = new float[samplesize + extra_samples];
+
+            prng_t seed = (prng_t)(key ^ (key >> 32)) + nsample * 0x9e3779b9;
+            newsample.smp[0] = 0.0f;
+            for(int i = 1; i < spectrumsize; ++i) { //randomize the phases
+                const float rnd = (prng_r(seed) & 0x7fffffff) / (INT32_MAX * 1.0f);
+                fftfreqs[i] = FFTpolar(spectrum[i], rnd * 2 * PI);
+            }
+            //that's all; here is the only ifft for the whole sample;
+            //no windows are used ;-)
+            fft->freqs2smps(fftfreqs, newsample.smp);
+
+
+            //normalize(rms)
+            float rms = 0.0f;
+            for(int i = 0; i < samplesize; ++i)
+                rms += newsample.smp[i] * newsample.smp[i];
+            rms = sqrt(rms);
+            if(rms < 0.000001f)
+                rms = 1.0f;
+            rms *= sqrt(262144.0f / samplesize);//262144=2^18
+            for(int i = 0; i < samplesize; ++i)
+                newsample.smp[i] *= 1.0f / rms * 50.0f;
+
+            //prepare extra samples used by the linear or cubic interpolation
+            for(int i = 0; i < extra_samples; ++i)
+                newsample.smp[i + samplesize] = newsample.smp[i];
+
+            newsample.size     = samplesize;
+            newsample.basefreq = basefreq * basefreqadjust;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            samples[nsample] = newsample;
+            done[nsample]    = true;
+            finished.notify_one();
+        }
+
+        //Cleanup
+        delete (fft);
+        delete[] fftfreqs;
+        delete[] spectrum;
+    };
+
+    //each worker holds a big FFT (time and frequency buffers) plus its own
+    //spectrum, so their count is bound by memory too, not only by cores
+    const long long workerMemory = (long long)samplesize
+        * (sizeof(fftw_real) + sizeof(fft_t) + (sizeof(fft_t) + sizeof(float)) / 2);
+    const int nthreads = std::max(1, std::min({samplemax,
+                                  (int)std::thread::hardware_concurrency(),
+                                  maxSampleThreads,
+                                  (int)(maxSampleThreadsMemory / workerMemory)}));
+    std::vector<std::thread> threads;
+    for(int i = 0; i < nthreads; ++i)
+        threads.emplace_back(worker);
+
+    //yield the samples in order, a sample is written to the cache before
+    //cb takes it over
+    WavetableCache::Writer cache(key, samplemax, samplesize, extra_samples);
+    int yielded = 0;
+    while(yielded < samplemax) {
+        if(do_abort()) {
+            aborted = true;
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if(!done[yielded]) {
+            finished.wait_for(lock, std::chrono::milliseconds(20));
+            continue;
+        }
+        PADnoteParameters::Sample newsample = samples[yielded];
+        lock.unlock();
+
+        cache.add(newsample.basefreq, newsample.smp);
+        cb(yielded++, newsample);
+    }
+
+    for(auto &t:threads)
+        t.join();
+
+    if(aborted) {
+        for(int nsample = yielded; nsample < samplemax; ++nsample)
+            if(done[nsample])
+                delete[] samples[nsample].smp;
+        return;
     }
-exit:
 
-    //Cleanup
-    delete (fft);
-    delete[] fftfreqs;
-    delete[] spectrum;
+    cache.commit();
 }
 
 void PADnoteParameters::export2wav(std::string basefilename)
@@ -936,11 +1032,8 @@ void PADnoteParameters::export2wav(std::string basefilename)
     }
 }
 
-void PADnoteParameters::add2XML(XMLwrapper& xml)
+void PADnoteParameters::wavetable2XML(XMLwrapper& xml)
 {
-    xml.setPadSynth(true);
-
-    xml.addparbool("stereo", PStereo);
     xml.addpar("mode", Pmode);
     xml.addpar("bandwidth", Pbandwidth);
     xml.addpar("bandwidth_scale", Pbwscale);
@@ -981,6 +1074,29 @@ void PADnoteParameters::add2XML(XMLwrapper& xml)
     xml.addpar("octaves", Pquality.oct);
     xml.addpar("samples_per_octave", Pquality.smpoct);
     xml.endbranch();
+}
+
+uint64_t PADnoteParameters::wavetableHash()
+{
+    XMLwrapper xml;
+    xml.addpar("samplerate", synth.samplerate);
+    xml.addpar("oscilsize", synth.oscilsize);
+    wavetable2XML(xml);
+
+    char *xmldata = xml.getXMLdata();
+    if(xmldata == NULL)
+        return 0;
+    const uint64_t hash = WavetableCache::hash(xmldata, strlen(xmldata));
+    free(xmldata);
+    return hash;
+}
+
+void PADnoteParameters::add2XML(XMLwrapper& xml)
+{
+    xml.setPadSynth(true);
+
+    xml.addparbool("stereo", PStereo);
+    wavetable2XML(xml);
 
     xml.beginbranch("AMPLITUDE_PARAMETERS");
     xml.addpar("volume", PVolume);
@@ -161,6 +161,11 @@ class PADnoteParameters:public Presets
             float *smp;
         } sample[PAD_MAX_SAMPLES];
 
+        /**Generate all samples, calling cb(n, sample) for each in order.
+         * The samples are computed on several threads, or read back from the
+         * wavetable cache when these parameters were used before. cb and
+         * do_abort are only called from the calling thread, cb takes
+         * ownership of the sample data.*/
         typedef std::function<void(int,PADnoteParameters::Sample&)> callback;
         void sampleGenerator(PADnoteParameters::callback cb,
                              std::function<bool()> do_abort);
@@ -185,6 +190,10 @@ class PADnoteParameters:public Presets
         void deletesamples();
         void deletesample(int n);
 
+        //the parameters which the samples depend on
+        void wavetable2XML(XMLwrapper& xml);
+        uint64_t wavetableHash();
+
         FFTwrapper *fft;
     public:
         const SYNTH_T &synth;
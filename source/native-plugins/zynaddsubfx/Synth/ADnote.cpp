@@ -21,6 +21,7 @@
 #include "../globals.h"
 #include "../Misc/Util.h"
 #include "../Misc/Allocator.h"
+#include "../DSP/OscilKernels.h"
 #include "../Params/ADnoteParameters.h"
 #include "../Containers/ScratchString.h"
 #include "ModFilter.h"
@@ -51,7 +52,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
     bandwidthDetuneMultiplier = pars.getBandwidthDetuneMultiplier();
 
     if(pars.GlobalPar.PPanning == 0)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = RND_R(prngState);
     else
         NoteGlobalPar.Panning = pars.GlobalPar.PPanning / 128.0f;
 
@@ -79,7 +80,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
         for (int i = 0; i < 14; i++)
             pinking[nvoice][i] = 0.0;
 
-        pars.VoicePar[nvoice].OscilSmp->newrandseed(prng());
+        pars.VoicePar[nvoice].OscilSmp->newrandseed(prng(prngState));
         NoteVoicePar[nvoice].OscilSmp = NULL;
         NoteVoicePar[nvoice].FMSmp    = NULL;
         NoteVoicePar[nvoice].VoiceOut = NULL;
@@ -150,7 +151,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
                 float min = -1e-6, max = 1e-6;
                 for(int k = 0; k < true_unison; ++k) {
                     float step = (k / (float) (true_unison - 1)) * 2.0f - 1.0f; //this makes the unison spread more uniform
-                    float val  = step + (RND * 2.0f - 1.0f) / (true_unison - 1);
+                    float val  = step + (RND_R(prngState) * 2.0f - 1.0f) / (true_unison - 1);
                     unison_values[k] = val;
                     if (min > val) {
                         min = val;
@@ -192,13 +193,13 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
         const float vib_speed = pars.VoicePar[nvoice].Unison_vibratto_speed / 127.0f;
         float vibratto_base_period  = 0.25f * powf(2.0f, (1.0f - vib_speed) * 4.0f);
         for(int k = 0; k < unison; ++k) {
-            unison_vibratto[nvoice].position[k] = RND * 1.8f - 0.9f;
+            unison_vibratto[nvoice].position[k] = RND_R(prngState) * 1.8f - 0.9f;
             //make period to vary randomly from 50% to 200% vibratto base period
             float vibratto_period = vibratto_base_period
-                                    * powf(2.0f, RND * 2.0f - 1.0f);
+                                    * powf(2.0f, RND_R(prngState) * 2.0f - 1.0f);
 
             float m = 4.0f / (vibratto_period * increments_per_second);
-            if(RND < 0.5f)
+            if(RND_R(prngState) < 0.5f)
                 m = -m;
             unison_vibratto[nvoice].step[k] = m;
 
@@ -233,7 +234,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
                         unison_invert_phase[nvoice][k] = false;
                     break;
                 case 1: for(int k = 0; k < unison; ++k)
-                        unison_invert_phase[nvoice][k] = (RND > 0.5f);
+                        unison_invert_phase[nvoice][k] = (RND_R(prngState) > 0.5f);
                     break;
                 default: for(int k = 0; k < unison; ++k)
                         unison_invert_phase[nvoice][k] =
@@ -310,11 +311,12 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
         if(pars.VoicePar[nvoice].Pextoscil != -1)
             vc = pars.VoicePar[nvoice].Pextoscil;
         if(!pars.GlobalPar.Hrandgrouping)
-            pars.VoicePar[vc].OscilSmp->newrandseed(prng());
+            pars.VoicePar[vc].OscilSmp->newrandseed(prng(prngState));
         int oscposhi_start =
             pars.VoicePar[vc].OscilSmp->get(NoteVoicePar[nvoice].OscilSmp,
                                              getvoicebasefreq(nvoice),
-                                             pars.VoicePar[nvoice].Presonance);
+                                             pars.VoicePar[nvoice].Presonance,
+                                             prngState);
 
         // This code was planned for biasing the carrier in MOD_RING
         // but that's on hold for the moment.  Disabled 'cos small
@@ -349,7 +351,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
             oscposhi[nvoice][k] = kth_start % synth.oscilsize;
             //put random starting point for other subvoices
             kth_start      = oscposhi_start +
-                (int)(RND * pars.VoicePar[nvoice].Unison_phase_randomness /
+                (int)(RND_R(prngState) * pars.VoicePar[nvoice].Unison_phase_randomness /
                         127.0f * (synth.oscilsize - 1));
         }
 
@@ -451,6 +453,8 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
         tmpwave_unison[k] = memory.valloc<float>(synth.buffersize);
         memset(tmpwave_unison[k], 0, synth.bufferbytes);
     }
+    tmpposlo_unison  = memory.valloc<int>(max_unison);
+    tmpfreqlo_unison = memory.valloc<int>(max_unison);
 
     initparameters(wm, prefix);
     memory.endTransaction();
@@ -459,7 +463,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
 SynthNote *ADnote::cloneLegato(void)
 {
     SynthParams sp{memory, ctl, synth, time, legato.param.freq, velocity, 
-                   (bool)portamento, legato.param.midinote, true};
+                   (bool)portamento, legato.param.midinote, true, prngState};
     return memory.alloc<ADnote>(&pars, sp);
 }
 
@@ -489,7 +493,7 @@ void ADnote::legatonote(LegatoParams lpars)
     bandwidthDetuneMultiplier = pars.getBandwidthDetuneMultiplier();
 
     if(pars.GlobalPar.PPanning == 0)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = RND_R(prngState);
     else
         NoteGlobalPar.Panning = pars.GlobalPar.PPanning / 128.0f;
 
@@ -543,11 +547,12 @@ void ADnote::legatonote(LegatoParams lpars)
         if(pars.VoicePar[nvoice].Pextoscil != -1)
             vc = pars.VoicePar[nvoice].Pextoscil;
         if(!pars.GlobalPar.Hrandgrouping)
-            pars.VoicePar[vc].OscilSmp->newrandseed(prng());
+            pars.VoicePar[vc].OscilSmp->newrandseed(prng(prngState));
 
         pars.VoicePar[vc].OscilSmp->get(NoteVoicePar[nvoice].OscilSmp,
                                          getvoicebasefreq(nvoice),
-                                         pars.VoicePar[nvoice].Presonance); //(gf)Modif of the above line.
+                                         pars.VoicePar[nvoice].Presonance,
+                                         prngState); //(gf)Modif of the above line.
 
         //I store the first elments to the last position for speedups
         for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
@@ -658,7 +663,7 @@ void ADnote::legatonote(LegatoParams lpars)
             NoteVoicePar[nvoice].Volume = -NoteVoicePar[nvoice].Volume;
 
         if(pars.VoicePar[nvoice].PPanning == 0)
-            NoteVoicePar[nvoice].Panning = RND;  // random panning
+            NoteVoicePar[nvoice].Panning = RND_R(prngState);  // random panning
         else
             NoteVoicePar[nvoice].Panning =
                 pars.VoicePar[nvoice].PPanning / 128.0f;
@@ -682,7 +687,7 @@ void ADnote::legatonote(LegatoParams lpars)
         /* Voice Modulation Parameters Init */
         if((NoteVoicePar[nvoice].FMEnabled != NONE)
            && (NoteVoicePar[nvoice].FMVoice < 0)) {
-            pars.VoicePar[nvoice].FMSmp->newrandseed(prng());
+            pars.VoicePar[nvoice].FMSmp->newrandseed(prng(prngState));
 
             //Perform Anti-aliasing only on MORPH or RING MODULATION
 
@@ -691,7 +696,7 @@ void ADnote::legatonote(LegatoParams lpars)
                 vc = pars.VoicePar[nvoice].PextFMoscil;
 
             if(!pars.GlobalPar.Hrandgrouping)
-                pars.VoicePar[vc].FMSmp->newrandseed(prng());
+                pars.VoicePar[vc].FMSmp->newrandseed(prng(prngState));
 
             for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
                 NoteVoicePar[nvoice].FMSmp[synth.oscilsize + i] =
@@ -770,6 +775,8 @@ ADnote::~ADnote()
     for(int k = 0; k < max_unison; ++k)
         memory.devalloc(tmpwave_unison[k]);
     memory.devalloc(tmpwave_unison);
+    memory.devalloc(tmpposlo_unison);
+    memory.devalloc(tmpfreqlo_unison);
 }
 
 
@@ -784,7 +791,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
     // Global Parameters
     NoteGlobalPar.initparameters(pars.GlobalPar, synth,
-                                 time,
+                                 time, prngState,
                                  memory, basefreq, velocity,
                                  stereo, wm, prefix);
 
@@ -817,7 +824,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
             vce.Volume = -vce.Volume;
 
         if(param.PPanning == 0)
-            vce.Panning = RND;  // random panning
+            vce.Panning = RND_R(prngState);  // random panning
         else
             vce.Panning = param.PPanning / 128.0f;
 
@@ -831,7 +838,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
         }
 
         if(param.PAmpLfoEnabled) {
-            vce.AmpLfo = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, wm,
+            vce.AmpLfo = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, prngState, wm,
                     (pre+"VoicePar"+nvoice+"/AmpLfo/").c_str);
             newamplitude[nvoice] *= vce.AmpLfo->amplfoout();
         }
@@ -843,7 +850,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
                     (pre+"VoicePar"+nvoice+"/FreqEnvelope/").c_str);
 
         if(param.PFreqLfoEnabled)
-            vce.FreqLfo = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, wm,
+            vce.FreqLfo = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, prngState, wm,
                     (pre+"VoicePar"+nvoice+"/FreqLfo/").c_str);
 
         /* Voice Filter Parameters Init */
@@ -863,7 +870,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
             }
 
             if(param.PFilterLfoEnabled) {
-                vce.FilterLfo = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, wm,
+                vce.FilterLfo = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, prngState, wm,
                         (pre+"VoicePar"+nvoice+"/FilterLfo/").c_str);
                 vce.Filter->addMod(*vce.FilterLfo);
             }
@@ -871,7 +878,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
         /* Voice Modulation Parameters Init */
         if((vce.FMEnabled != NONE) && (vce.FMVoice < 0)) {
-            param.FMSmp->newrandseed(prng());
+            param.FMSmp->newrandseed(prng(prngState));
             vce.FMSmp = memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
 
             //Perform Anti-aliasing only on MORPH or RING MODULATION
@@ -887,12 +894,12 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
                 tmp = getFMvoicebasefreq(nvoice);
 
             if(!pars.GlobalPar.Hrandgrouping)
-                pars.VoicePar[vc].FMSmp->newrandseed(prng());
+                pars.VoicePar[vc].FMSmp->newrandseed(prng(prngState));
 
             for(int k = 0; k < unison_size[nvoice]; ++k)
                 oscposhiFM[nvoice][k] = (oscposhi[nvoice][k]
                                          + pars.VoicePar[vc].FMSmp->get(
-                                             vce.FMSmp, tmp))
+                                             vce.FMSmp, tmp, 0, prngState))
                                         % synth.oscilsize;
 
             for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
@@ -1198,23 +1205,20 @@ inline void ADnote::fadein(float *smps) const
 inline void ADnote::ComputeVoiceOscillator_LinearInterpolation(int nvoice)
 {
     for(int k = 0; k < unison_size[nvoice]; ++k) {
-        int    poshi  = oscposhi[nvoice][k];
-        int    poslo  = oscposlo[nvoice][k] * (1<<24);
-        int    freqhi = oscfreqhi[nvoice][k];
-        int    freqlo = oscfreqlo[nvoice][k] * (1<<24);
-        float *smps   = NoteVoicePar[nvoice].OscilSmp;
-        float *tw     = tmpwave_unison[k];
         assert(oscfreqlo[nvoice][k] < 1.0f);
-        for(int i = 0; i < synth.buffersize; ++i) {
-            tw[i]  = (smps[poshi] * ((1<<24) - poslo) + smps[poshi + 1] * poslo)/(1.0f*(1<<24));
-            poslo += freqlo;
-            poshi += freqhi + (poslo>>24);
-            poslo &= 0xffffff;
-            poshi &= synth.oscilsize - 1;
-        }
-        oscposhi[nvoice][k] = poshi;
-        oscposlo[nvoice][k] = poslo/(1.0f*(1<<24));
+        tmpposlo_unison[k]  = oscposlo[nvoice][k] * (1<<24);
+        tmpfreqlo_unison[k] = oscfreqlo[nvoice][k] * (1<<24);
     }
+
+    //all unison voices at once, see DSP/OscilKernels.cpp
+    OscilKernels::interpolate(NoteVoicePar[nvoice].OscilSmp, synth.oscilsize,
+                              synth.buffersize, unison_size[nvoice],
+                              tmpwave_unison, oscposhi[nvoice],
+                              tmpposlo_unison, oscfreqhi[nvoice],
+                              tmpfreqlo_unison);
+
+    for(int k = 0; k < unison_size[nvoice]; ++k)
+        oscposlo[nvoice][k] = tmpposlo_unison[k]/(1.0f*(1<<24));
 }
 
 
@@ -1281,32 +1285,13 @@ inline void ADnote::ComputeVoiceOscillatorMorph(int nvoice)
         }
     }
     else
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            int    poshiFM  = oscposhiFM[nvoice][k];
-            float  posloFM  = oscposloFM[nvoice][k];
-            int    freqhiFM = oscfreqhiFM[nvoice][k];
-            float  freqloFM = oscfreqloFM[nvoice][k];
-            float *tw = tmpwave_unison[k];
-
-            for(int i = 0; i < synth.buffersize; ++i) {
-                float amp = INTERPOLATE_AMPLITUDE(FMoldamplitude[nvoice],
-                                            FMnewamplitude[nvoice],
-                                            i,
-                                            synth.buffersize);
-                tw[i] = tw[i] * (1.0f - amp) + amp
-                        * (NoteVoicePar[nvoice].FMSmp[poshiFM] * (1 - posloFM)
-                           + NoteVoicePar[nvoice].FMSmp[poshiFM + 1] * posloFM);
-                posloFM += freqloFM;
-                if(posloFM >= 1.0f) {
-                    posloFM -= 1.0f;
-                    poshiFM++;
-                }
-                poshiFM += freqhiFM;
-                poshiFM &= synth.oscilsize - 1;
-            }
-            oscposhiFM[nvoice][k] = poshiFM;
-            oscposloFM[nvoice][k] = posloFM;
-        }
+        OscilKernels::modulate(OscilKernels::Morph, NoteVoicePar[nvoice].FMSmp,
+                               synth.oscilsize, synth.buffersize,
+                               unison_size[nvoice], tmpwave_unison,
+                               (int *)oscposhiFM[nvoice], oscposloFM[nvoice],
+                               (const int *)oscfreqhiFM[nvoice],
+                               oscfreqloFM[nvoice], FMoldamplitude[nvoice],
+                               FMnewamplitude[nvoice]);
 }
 
 /*
@@ -1333,33 +1318,13 @@ inline void ADnote::ComputeVoiceOscillatorRingModulation(int nvoice)
             }
         }
     else
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            int    poshiFM  = oscposhiFM[nvoice][k];
-            float  posloFM  = oscposloFM[nvoice][k];
-            int    freqhiFM = oscfreqhiFM[nvoice][k];
-            float  freqloFM = oscfreqloFM[nvoice][k];
-            float *tw = tmpwave_unison[k];
-
-            for(int i = 0; i < synth.buffersize; ++i) {
-                float amp = INTERPOLATE_AMPLITUDE(FMoldamplitude[nvoice],
-                                            FMnewamplitude[nvoice],
-                                            i,
-                                            synth.buffersize);
-                tw[i] *= (NoteVoicePar[nvoice].FMSmp[poshiFM] * (1.0f - posloFM)
-                          + NoteVoicePar[nvoice].FMSmp[poshiFM
-                                                       + 1] * posloFM) * amp
-                         + (1.0f - amp);
-                posloFM += freqloFM;
-                if(posloFM >= 1.0f) {
-                    posloFM -= 1.0f;
-                    poshiFM++;
-                }
-                poshiFM += freqhiFM;
-                poshiFM &= synth.oscilsize - 1;
-            }
-            oscposhiFM[nvoice][k] = poshiFM;
-            oscposloFM[nvoice][k] = posloFM;
-        }
+        OscilKernels::modulate(OscilKernels::Ring, NoteVoicePar[nvoice].FMSmp,
+                               synth.oscilsize, synth.buffersize,
+                               unison_size[nvoice], tmpwave_unison,
+                               (int *)oscposhiFM[nvoice], oscposloFM[nvoice],
+                               (const int *)oscfreqhiFM[nvoice],
+                               oscfreqloFM[nvoice], FMoldamplitude[nvoice],
+                               FMnewamplitude[nvoice]);
 }
 
 /*
@@ -1382,29 +1347,24 @@ inline void ADnote::ComputeVoiceOscillatorFrequencyModulation(int nvoice,
     } else {
         //Compute the modulator and store it in tmpwave_unison[][]
         for(int k = 0; k < unison_size[nvoice]; ++k) {
-            int    poshiFM  = oscposhiFM[nvoice][k];
-            int    posloFM  = oscposloFM[nvoice][k]  * (1<<24);
-            int    freqhiFM = oscfreqhiFM[nvoice][k];
-            int    freqloFM = oscfreqloFM[nvoice][k] * (1<<24);
-            float *tw = tmpwave_unison[k];
-            const float *smps = NoteVoicePar[nvoice].FMSmp;
+            tmpposlo_unison[k]  = oscposloFM[nvoice][k]  * (1<<24);
+            tmpfreqlo_unison[k] = oscfreqloFM[nvoice][k] * (1<<24);
+        }
 
-            for(int i = 0; i < synth.buffersize; ++i) {
-                tw[i] = (smps[poshiFM] * ((1<<24) - posloFM)
-                         + smps[poshiFM + 1] * posloFM) / (1.0f*(1<<24));
-                if (FMmode == PW_MOD && (k & 1))
-                    tw[i] = -tw[i];
+        OscilKernels::interpolate(NoteVoicePar[nvoice].FMSmp, synth.oscilsize,
+                                  synth.buffersize, unison_size[nvoice],
+                                  tmpwave_unison, (int *)oscposhiFM[nvoice],
+                                  tmpposlo_unison,
+                                  (const int *)oscfreqhiFM[nvoice],
+                                  tmpfreqlo_unison);
 
-                posloFM += freqloFM;
-                if(posloFM >= (1<<24)) {
-                    posloFM &= 0xffffff;//fmod(posloFM, 1.0f);
-                    poshiFM++;
-                }
-                poshiFM += freqhiFM;
-                poshiFM &= synth.oscilsize - 1;
+        for(int k = 0; k < unison_size[nvoice]; ++k) {
+            oscposloFM[nvoice][k] = tmpposlo_unison[k]/((1<<24)*1.0f);
+            if (FMmode == PW_MOD && (k & 1)) {
+                float *tw = tmpwave_unison[k];
+                for(int i = 0; i < synth.buffersize; ++i)
+                    tw[i] = -tw[i];
             }
-            oscposhiFM[nvoice][k] = poshiFM;
-            oscposloFM[nvoice][k] = posloFM/((1<<24)*1.0f);
         }
     }
     // Amplitude interpolation
@@ -1452,47 +1412,19 @@ inline void ADnote::ComputeVoiceOscillatorFrequencyModulation(int nvoice,
 
     //do the modulation
     for(int k = 0; k < unison_size[nvoice]; ++k) {
-        float *smps   = NoteVoicePar[nvoice].OscilSmp;
-        float *tw     = tmpwave_unison[k];
-        int    poshi  = oscposhi[nvoice][k];
-        int    poslo  = oscposlo[nvoice][k] * (1<<24);
-        int    freqhi = oscfreqhi[nvoice][k];
-        int    freqlo = oscfreqlo[nvoice][k] * (1<<24);
-
-        for(int i = 0; i < synth.buffersize; ++i) {
-            int FMmodfreqhi = 0;
-            F2I(tw[i], FMmodfreqhi);
-            float FMmodfreqlo = tw[i]-FMmodfreqhi;//fmod(tw[i] /*+ 0.0000000001f*/, 1.0f);
-            if(FMmodfreqhi < 0)
-                FMmodfreqlo++;
-
-            //carrier
-            int carposhi = poshi + FMmodfreqhi;
-            int carposlo = poslo + FMmodfreqlo;
-            if (FMmode == PW_MOD && (k & 1))
-                carposhi += NoteVoicePar[nvoice].phase_offset;
-
-            if(carposlo >= (1<<24)) {
-                carposhi++;
-                carposlo &= 0xffffff;//fmod(carposlo, 1.0f);
-            }
-            carposhi &= (synth.oscilsize - 1);
-
-            tw[i] = (smps[carposhi] * ((1<<24) - carposlo)
-                    + smps[carposhi + 1] * carposlo)/(1.0f*(1<<24));
+        tmpposlo_unison[k]  = oscposlo[nvoice][k] * (1<<24);
+        tmpfreqlo_unison[k] = oscfreqlo[nvoice][k] * (1<<24);
+    }
 
-            poslo += freqlo;
-            if(poslo >= (1<<24)) {
-                poslo &= 0xffffff;//fmod(poslo, 1.0f);
-                poshi++;
-            }
+    OscilKernels::frequencyModulation(NoteVoicePar[nvoice].OscilSmp,
+                                      synth.oscilsize, synth.buffersize,
+                                      unison_size[nvoice], tmpwave_unison,
+                                      oscposhi[nvoice], tmpposlo_unison,
+                                      oscfreqhi[nvoice], tmpfreqlo_unison,
+                                      FMmode == PW_MOD ? NoteVoicePar[nvoice].phase_offset : 0);
 
-            poshi += freqhi;
-            poshi &= synth.oscilsize - 1;
-        }
-        oscposhi[nvoice][k] = poshi;
-        oscposlo[nvoice][k] = (poslo)/((1<<24)*1.0f);
-    }
+    for(int k = 0; k < unison_size[nvoice]; ++k)
+        oscposlo[nvoice][k] = tmpposlo_unison[k]/((1<<24)*1.0f);
 }
 
 
@@ -1504,7 +1436,7 @@ inline void ADnote::ComputeVoiceWhiteNoise(int nvoice)
     for(int k = 0; k < unison_size[nvoice]; ++k) {
         float *tw = tmpwave_unison[k];
         for(int i = 0; i < synth.buffersize; ++i)
-            tw[i] = RND * 2.0f - 1.0f;
+            tw[i] = RND_R(prngState) * 2.0f - 1.0f;
     }
 }
 
@@ -1514,7 +1446,7 @@ inline void ADnote::ComputeVoicePinkNoise(int nvoice)
         float *tw = tmpwave_unison[k];
         float *f = &pinking[nvoice][k > 0 ? 7 : 0];
         for(int i = 0; i < synth.buffersize; ++i) {
-	    float white = (RND-0.5)/4.0;
+	    float white = (RND_R(prngState)-0.5)/4.0;
 	    f[0] = 0.99886*f[0]+white*0.0555179;
 	    f[1] = 0.99332*f[1]+white*0.0750759;
 	    f[2] = 0.96900*f[2]+white*0.1538520;
@@ -1903,6 +1835,7 @@ void ADnote::Global::kill(Allocator &memory)
 void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
                                     const SYNTH_T &synth,
                                     const AbsTime &time,
+                                    prng_t &prngState,
                                     class Allocator &memory,
                                     float basefreq, float velocity,
                                     bool stereo,
@@ -1912,12 +1845,12 @@ void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
     ScratchString pre = prefix;
     FreqEnvelope = memory.alloc<Envelope>(*param.FreqEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/FreqEnvelope/").c_str);
-    FreqLfo      = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, wm,
+    FreqLfo      = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, prngState, wm,
                    (pre+"GlobalPar/FreqLfo/").c_str);
 
     AmpEnvelope = memory.alloc<Envelope>(*param.AmpEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/AmpEnvelope/").c_str);
-    AmpLfo      = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, wm,
+    AmpLfo      = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, prngState, wm,
                    (pre+"GlobalPar/AmpLfo/").c_str);
 
     Volume = 4.0f * powf(0.1f, 3.0f * (1.0f - param.PVolume / 96.0f)) //-60 dB .. 0 dB
@@ -1928,7 +1861,7 @@ void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
 
     FilterEnvelope = memory.alloc<Envelope>(*param.FilterEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/FilterEnvelope/").c_str);
-    FilterLfo      = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, wm,
+    FilterLfo      = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, prngState, wm,
                    (pre+"GlobalPar/FilterLfo/").c_str);
 
     Filter->addMod(*FilterEnvelope);
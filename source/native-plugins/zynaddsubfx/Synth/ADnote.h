@@ -117,6 +117,7 @@ class ADnote:public SynthNote
             void initparameters(const ADnoteGlobalParam &param,
                                 const SYNTH_T &synth,
                                 const AbsTime &time,
+                                prng_t &prngState,
                                 class Allocator &memory,
                                 float basefreq, float velocity,
                                 bool stereo,
@@ -301,6 +302,10 @@ class ADnote:public SynthNote
         int     max_unison;
         float **tmpwave_unison;
 
+        //fixed point positions and frequencies of the unison voices,
+        //as the oscillator kernels take them
+        int *tmpposlo_unison, *tmpfreqlo_unison;
+
         //Filter bypass samples
         float *bypassl, *bypassr;
 
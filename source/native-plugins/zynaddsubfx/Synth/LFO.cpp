@@ -19,14 +19,14 @@
 #include <cstdio>
 #include <cmath>
 
-LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManager *m,
-        const char *watch_prefix)
+LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t,
+        prng_t &prngState_, WatchManager *m, const char *watch_prefix)
     :first_half(-1),
     delayTime(t, lfopars.Pdelay / 127.0f * 4.0f), //0..4 sec
     waveShape(lfopars.PLFOtype),
     deterministic(!lfopars.Pfreqrand),
     dt_(t.dt()),
-    lfopars_(lfopars), basefreq_(basefreq),
+    lfopars_(lfopars), basefreq_(basefreq), prngState(prngState_),
     watchOut(m, watch_prefix, "out")
 {
     int stretch = lfopars.Pstretch;
@@ -42,7 +42,7 @@ LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManage
 
     if(!lfopars.Pcontinous) {
         if(lfopars.Pstartphase == 0)
-            phase = RND;
+            phase = RND_R(prngState);
         else
             phase = fmod((lfopars.Pstartphase - 64.0f) / 127.0f + 1.0f, 1.0f);
     }
@@ -72,8 +72,8 @@ LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManage
             break;
     }
 
-    amp1     = (1 - lfornd) + lfornd * RND;
-    amp2     = (1 - lfornd) + lfornd * RND;
+    amp1     = (1 - lfornd) + lfornd * RND_R(prngState);
+    amp2     = (1 - lfornd) + lfornd * RND_R(prngState);
     incrnd   = nextincrnd = 1.0f;
     computeNextFreqRnd();
     computeNextFreqRnd(); //twice because I want incrnd & nextincrnd to be random
@@ -106,7 +106,7 @@ float LFO::baseOut(const char waveShape, const float phase)
         case LFO_RANDOM:
             if ((phase < 0.5) != first_half) {
                 first_half = phase < 0.5;
-                last_random = 2*RND-1;
+                last_random = 2*RND_R(prngState)-1;
             }
             return last_random;
         default:            return cosf(phase * 2.0f * PI); //LFO_SINE
@@ -164,7 +164,7 @@ float LFO::lfoout()
     if(phase >= 1) {
         phase    = fmod(phase, 1.0f);
         amp1 = amp2;
-        amp2 = (1 - lfornd) + lfornd * RND;
+        amp2 = (1 - lfornd) + lfornd * RND_R(prngState);
 
         computeNextFreqRnd();
     }
@@ -189,5 +189,5 @@ void LFO::computeNextFreqRnd()
     if(deterministic)
         return;
     incrnd     = nextincrnd;
-    nextincrnd = powf(0.5f, lfofreqrnd) + RND * (powf(2.0f, lfofreqrnd) - 1.0f);
+    nextincrnd = powf(0.5f, lfofreqrnd) + RND_R(prngState) * (powf(2.0f, lfofreqrnd) - 1.0f);
 }
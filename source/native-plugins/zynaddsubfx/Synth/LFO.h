@@ -16,6 +16,7 @@
 
 #include "../globals.h"
 #include "../Misc/Time.h"
+#include "../Misc/Util.h"
 #include "WatchPoint.h"
 
 /**Class for creating Low Frequency Oscillators*/
@@ -26,9 +27,10 @@ class LFO
          *
          * @param lfopars pointer to a LFOParams object
          * @param basefreq base frequency of LFO
+         * @param prngState random generator of the note
          */
-        LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManager *m=0,
-                const char *watch_prefix=0);
+        LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t,
+                prng_t &prngState, WatchManager *m=0, const char *watch_prefix=0);
         ~LFO();
 
         float lfoout();
@@ -64,6 +66,7 @@ class LFO
         const float     dt_;
         const LFOParams &lfopars_;
         const float basefreq_;
+        prng_t     &prngState;
 
         VecWatchPoint watchOut;
 
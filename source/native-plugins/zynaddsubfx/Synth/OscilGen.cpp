@@ -1018,6 +1018,11 @@ bool OscilGen::needPrepare(void)
  * Get the oscillator function
  */
 short int OscilGen::get(float *smps, float freqHz, int resonance)
+{
+    return get(smps, freqHz, resonance, prng_state);
+}
+
+short int OscilGen::get(float *smps, float freqHz, int resonance, prng_t &prngState)
 {
     if(needPrepare())
         prepare();
@@ -1025,7 +1030,7 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
     fft_t *input = freqHz > 0.0f ? oscilFFTfreqs : pendingfreqs;
 
     int outpos =
-        (int)((RND * 2.0f
+        (int)((RND_R(prngState) * 2.0f
                - 1.0f) * synth.oscilsize_f * (Prand - 64.0f) / 64.0f);
     outpos = (outpos + 2 * synth.oscilsize) % synth.oscilsize;
 
@@ -1064,13 +1069,13 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
         const float rnd = PI * powf((Prand - 64.0f) / 64.0f, 2.0f);
         for(int i = 1; i < nyquist - 1; ++i) //to Nyquist only for AntiAliasing
             outoscilFFTfreqs[i] *=
-                FFTpolar<fftw_real>(1.0f, (float)(rnd * i * RND));
+                FFTpolar<fftw_real>(1.0f, (float)(rnd * i * RND_R(prngState)));
     }
 
     //Harmonic Amplitude Randomness
     if((freqHz > 0.1f) && (!ADvsPAD)) {
-        unsigned int realrnd = prng();
-        sprng(randseed);
+        unsigned int realrnd = prng(prngState);
+        prng_t ampState = randseed;
         float power     = Pamprandpower / 127.0f;
         float normalize = 1.0f / (1.2f - power);
         switch(Pamprandtype) {
@@ -1078,18 +1083,18 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
                 power = power * 2.0f - 0.5f;
                 power = powf(15.0f, power);
                 for(int i = 1; i < nyquist - 1; ++i)
-                    outoscilFFTfreqs[i] *= powf(RND, power) * normalize;
+                    outoscilFFTfreqs[i] *= powf(RND_R(ampState), power) * normalize;
                 break;
             case 2:
                 power = power * 2.0f - 0.5f;
                 power = powf(15.0f, power) * 2.0f;
-                float rndfreq = 2 * PI * RND;
+                float rndfreq = 2 * PI * RND_R(ampState);
                 for(int i = 1; i < nyquist - 1; ++i)
                     outoscilFFTfreqs[i] *= powf(fabs(sinf(i * rndfreq)), power)
                                            * normalize;
                 break;
         }
-        sprng(realrnd + 1);
+        prngState = realrnd + 1;
     }
 
     if((freqHz > 0.1f) && (resonance != 0))
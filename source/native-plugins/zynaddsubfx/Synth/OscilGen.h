@@ -15,6 +15,7 @@
 #define OSCIL_GEN_H
 
 #include "../globals.h"
+#include "../Misc/Util.h"
 #include <rtosc/ports.h>
 #include "../Params/Presets.h"
 
@@ -34,6 +35,9 @@ class OscilGen:public Presets
         short get(float *smps, float freqHz, int resonance = 0);
         //if freqHz is smaller than 0, return the "un-randomized" sample for UI
 
+        //the same, with the random generator of the calling note
+        short get(float *smps, float freqHz, int resonance, prng_t &prngState);
+
         void getbasefunction(float *smps);
 
         //called by UI
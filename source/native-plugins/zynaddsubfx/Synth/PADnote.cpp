@@ -99,7 +99,7 @@ void PADnote::setup(float freq,
 
 
     if(!legato) { //not sure
-        poshi_l = (int)(RND * (size - 1));
+        poshi_l = (int)(RND_R(prngState) * (size - 1));
         if(pars.PStereo)
             poshi_r = (poshi_l + size / 2) % size;
         else
@@ -109,7 +109,7 @@ void PADnote::setup(float freq,
 
 
     if(pars.PPanning == 0)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = RND_R(prngState);
     else
         NoteGlobalPar.Panning = pars.PPanning / 128.0f;
 
@@ -139,14 +139,14 @@ void PADnote::setup(float freq,
             memory.alloc<Envelope>(*pars.FreqEnvelope, basefreq, synth.dt(),
                     wm, (pre+"FreqEnvelope/").c_str);
         NoteGlobalPar.FreqLfo      =
-            memory.alloc<LFO>(*pars.FreqLfo, basefreq, time,
+            memory.alloc<LFO>(*pars.FreqLfo, basefreq, time, prngState,
                     wm, (pre+"FreqLfo/").c_str);
 
         NoteGlobalPar.AmpEnvelope =
             memory.alloc<Envelope>(*pars.AmpEnvelope, basefreq, synth.dt(),
                     wm, (pre+"AmpEnvelope/").c_str);
         NoteGlobalPar.AmpLfo      =
-            memory.alloc<LFO>(*pars.AmpLfo, basefreq, time,
+            memory.alloc<LFO>(*pars.AmpLfo, basefreq, time, prngState,
                     wm, (pre+"AmpLfo/").c_str);
     }
 
@@ -171,7 +171,7 @@ void PADnote::setup(float freq,
         //setup mod
         env = memory.alloc<Envelope>(*pars.FilterEnvelope, basefreq,
                 synth.dt(), wm, (pre+"FilterEnvelope/").c_str);
-        lfo = memory.alloc<LFO>(*pars.FilterLfo, basefreq, time,
+        lfo = memory.alloc<LFO>(*pars.FilterLfo, basefreq, time, prngState,
                 wm, (pre+"FilterLfo/").c_str);
         flt->addMod(*env);
         flt->addMod(*lfo);
@@ -193,7 +193,7 @@ void PADnote::setup(float freq,
 SynthNote *PADnote::cloneLegato(void)
 {
     SynthParams sp{memory, ctl, synth, time, legato.param.freq, velocity, 
-                   (bool)portamento, legato.param.midinote, true};
+                   (bool)portamento, legato.param.midinote, true, prngState};
     return memory.alloc<PADnote>(&pars, sp, interpolation);
 }
 
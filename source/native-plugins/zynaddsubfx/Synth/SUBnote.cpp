@@ -99,7 +99,7 @@ void SUBnote::setup(float freq,
     if(pars.PPanning != 0)
         panning = pars.PPanning / 127.0f;
     else
-        panning = RND;
+        panning = RND_R(prngState);
 
     if(!legato) { //normal note
         numstages = pars.Pnumstages;
@@ -193,7 +193,7 @@ void SUBnote::setup(float freq,
 SynthNote *SUBnote::cloneLegato(void)
 {
     SynthParams sp{memory, ctl, synth, time, legato.param.freq, velocity,
-                   portamento, legato.param.midinote, true};
+                   portamento, legato.param.midinote, true, prngState};
     return memory.alloc<SUBnote>(&pars, sp);
 }
 
@@ -285,9 +285,9 @@ void SUBnote::initfilter(bpfilter &filter,
         }
         else {
             float a = 0.1f * mag; //empirically
-            float p = RND * 2.0f * PI;
+            float p = RND_R(prngState) * 2.0f * PI;
             if(start == 1)
-                a *= RND;
+                a *= RND_R(prngState);
             filter.yn1 = a * cosf(p);
             filter.yn2 = a * cosf(p + freq * 2.0f * PI / synth.samplerate_f);
 
@@ -502,7 +502,7 @@ void SUBnote::chanOutput(float *out, bpfilter *bp, int buffer_size)
 
     //Initialize Random Input
     for(int i = 0; i < buffer_size; ++i)
-        tmprnd[i] = RND * 2.0f - 1.0f;
+        tmprnd[i] = RND_R(prngState) * 2.0f - 1.0f;
 
     //For each harmonic apply the filter on the random input stream
     //Sum the filter outputs to obtain the output signal
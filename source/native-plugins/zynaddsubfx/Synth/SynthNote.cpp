@@ -18,7 +18,8 @@
 SynthNote::SynthNote(SynthParams &pars)
     :memory(pars.memory),
     legato(pars.synth, pars.frequency, pars.velocity, pars.portamento,
-            pars.note, pars.quiet), ctl(pars.ctl), synth(pars.synth), time(pars.time)
+            pars.note, pars.quiet), ctl(pars.ctl), synth(pars.synth), time(pars.time),
+    prngState(pars.prngState)
 {}
 
 SynthNote::Legato::Legato(const SYNTH_T &synth_, float freq, float vel, int port,
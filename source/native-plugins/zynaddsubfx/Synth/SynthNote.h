@@ -13,6 +13,7 @@
 #ifndef SYNTH_NOTE_H
 #define SYNTH_NOTE_H
 #include "../globals.h"
+#include "../Misc/Util.h"
 
 class Allocator;
 class Controller;
@@ -27,6 +28,7 @@ struct SynthParams
     bool      portamento;//True if portamento is used for this note
     int       note;      //Integer value of the note
     bool      quiet;     //Initial output condition for legato notes
+    prng_t   &prngState; //Random generator of the part playing the Note
 };
 
 struct LegatoParams
@@ -109,6 +111,7 @@ class SynthNote
         const SYNTH_T    &synth;
         const AbsTime    &time;
         WatchManager     *wm;
+        prng_t           &prngState;
 };
 
 #endif
@@ -1087,6 +1087,9 @@ protected:
         case NATIVE_HOST_OPCODE_RELOAD_MIDI_PROGRAMS:
         case NATIVE_HOST_OPCODE_RELOAD_ALL:
         case NATIVE_HOST_OPCODE_HOST_IDLE:
+        case NATIVE_HOST_OPCODE_UPDATE_LATENCY:
+        case NATIVE_HOST_OPCODE_SCHEDULE_WORK:
+        case NATIVE_HOST_OPCODE_SET_OUTPUT_FLAGS:
             // nothing
             break;
         case NATIVE_HOST_OPCODE_UI_UNAVAILABLE:
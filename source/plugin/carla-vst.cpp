@@ -570,6 +570,9 @@ protected:
         case NATIVE_HOST_OPCODE_RELOAD_MIDI_PROGRAMS:
         case NATIVE_HOST_OPCODE_RELOAD_ALL:
         case NATIVE_HOST_OPCODE_UI_UNAVAILABLE:
+        case NATIVE_HOST_OPCODE_UPDATE_LATENCY:
+        case NATIVE_HOST_OPCODE_SCHEDULE_WORK:
+        case NATIVE_HOST_OPCODE_SET_OUTPUT_FLAGS:
             break;
 
         case NATIVE_HOST_OPCODE_HOST_IDLE:
@@ -0,0 +1,161 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Checks the base64 codec against a plain bit-by-bit implementation,
+// then prints encode and decode throughput for a 100MB chunk
+
+#include "CarlaBase64Utils.hpp"
+#include "CarlaString.hpp"
+
+#include <chrono>
+#include <string>
+
+static const std::size_t kBenchmarkSize = 100*1024*1024;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static std::vector<uint8_t> makeData(const std::size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> data(size);
+
+    for (std::size_t i=0; i < size; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    return data;
+}
+
+// RFC 4648, one bit at a time
+static std::string referenceEncode(const std::vector<uint8_t>& data)
+{
+    static const char* const kChars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string ret;
+    uint value = 0, bits = 0;
+
+    for (std::size_t i=0; i < data.size(); ++i)
+    {
+        for (int b=7; b >= 0; --b)
+        {
+            value = (value << 1) | ((data[i] >> b) & 1);
+
+            if (++bits == 6)
+            {
+                ret += kChars[value];
+                value = bits = 0;
+            }
+        }
+    }
+
+    if (bits != 0)
+        ret += kChars[value << (6 - bits)];
+
+    while (ret.size() % 4 != 0)
+        ret += '=';
+
+    return ret;
+}
+
+static bool checkSize(const std::size_t size)
+{
+    const std::vector<uint8_t> data(makeData(size, static_cast<uint32_t>(size + 1)));
+    const std::string reference(referenceEncode(data));
+
+    // one go
+    const CarlaString base64(CarlaString::asBase64(data.data(), data.size()));
+    CARLA_SAFE_ASSERT_RETURN(base64.length() == carla_base64_encoded_size(size), false);
+    CARLA_SAFE_ASSERT_RETURN(reference == base64.buffer(), false);
+    CARLA_SAFE_ASSERT_RETURN(carla_getChunkFromBase64String(base64) == data, false);
+
+    // encoded in pieces of 3 bytes, decoded in pieces of 7 characters with line breaks in between
+    std::vector<char> pieces(carla_base64_encoded_size(size));
+    std::size_t written = 0;
+
+    for (std::size_t offset = 0; offset < size; offset += 3)
+        written += carla_base64_encode(data.data() + offset, std::min<std::size_t>(3, size - offset), pieces.data() + written);
+
+    CARLA_SAFE_ASSERT_RETURN(written == pieces.size(), false);
+    CARLA_SAFE_ASSERT_RETURN(reference == std::string(pieces.data(), written), false);
+
+    std::string split;
+
+    for (std::size_t i=0; i < reference.size(); i += 5)
+        split += reference.substr(i, 5) + (i % 2 ? "\r\n" : " ");
+
+    CarlaBase64Decoder decoder;
+    std::vector<uint8_t> decoded(carla_base64_decoded_max_size(split.size()) + 7);
+    std::size_t decodedSize = 0;
+
+    for (std::size_t i=0; i < split.size(); i += 7)
+    {
+        const std::size_t len = std::min<std::size_t>(7, split.size() - i);
+        decodedSize += decoder.decode(split.data() + i, len, decoded.data() + decodedSize);
+    }
+
+    decodedSize += decoder.finish(decoded.data() + decodedSize);
+    decoded.resize(decodedSize);
+    CARLA_SAFE_ASSERT_RETURN(decoded == data, false);
+
+    // unpadded input
+    const std::string unpadded(reference.substr(0, reference.find('=')));
+    CARLA_SAFE_ASSERT_RETURN(carla_getChunkFromBase64String(unpadded.c_str()) == data, false);
+
+    return true;
+}
+
+static double seconds(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    for (std::size_t size=0; size <= 300; ++size)
+    {
+        if (! checkSize(size))
+        {
+            carla_stderr2("base64 mismatch for %u bytes", static_cast<uint>(size));
+            return 1;
+        }
+    }
+
+    CARLA_SAFE_ASSERT_RETURN(checkSize(65536*3+1), 1);
+
+    const std::vector<uint8_t> data(makeData(kBenchmarkSize, 1));
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const CarlaString base64(CarlaString::asBase64(data.data(), data.size()));
+    const double encodeTime = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    const std::vector<uint8_t> decoded(carla_getChunkFromBase64String(base64, base64.length()));
+    const double decodeTime = seconds(start);
+
+    CARLA_SAFE_ASSERT_RETURN(decoded == data, 1);
+
+    const double megabytes = static_cast<double>(kBenchmarkSize) / (1024.0*1024.0);
+    carla_stdout("base64 %.0f MB: encode %.3fs (%.0f MB/s), decode %.3fs (%.0f MB/s)",
+                 megabytes, encodeTime, megabytes/encodeTime, decodeTime, megabytes/decodeTime);
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,169 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Drives the MIDI output thread like an audio driver would (beginCycle, writeEvent, endCycle once per cycle),
+// checking every event is sent once, in order, one cycle after its frame
+
+#include "engine/CarlaEngineMidiOutThread.hpp"
+#include "CarlaMutex.hpp"
+
+#include "AppConfig.h"
+#include "juce_core/juce_core.h"
+
+#include <unistd.h>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+static const uint32_t kFrames     = 256;
+static const double   kSampleRate = 48000.0;
+static const uint32_t kCycles     = 40;
+
+// how far off a sent event may be, in milliseconds
+static const double kTolerance = 3.0;
+
+struct SentEvent {
+    int64_t time;
+    uint8_t note;
+};
+
+class Receiver : public CarlaEngineMidiOutThread::Callback
+{
+public:
+    Receiver()
+        : mutex(),
+          events() {}
+
+    void midiOutThreadSend(const uint8_t* const data, const uint8_t size) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(size == 3,);
+
+        const CarlaMutexLocker cml(mutex);
+
+        SentEvent event = { static_cast<int64_t>(juce::Time::getHighResolutionTicks()), data[1] };
+        events.push_back(event);
+    }
+
+    CarlaMutex mutex;
+    std::vector<SentEvent> events;
+};
+
+static void sleepUntil(const int64_t time)
+{
+    const int64_t ticksPerSecond(static_cast<int64_t>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    for (;;)
+    {
+        const int64_t remaining(time - static_cast<int64_t>(juce::Time::getHighResolutionTicks()));
+
+        if (remaining <= 0)
+            return;
+
+        ::usleep(static_cast<useconds_t>(remaining * 1000000 / ticksPerSecond));
+    }
+}
+
+int main()
+{
+    static const uint32_t kEventFrames[] = { 0, 64, 65, 200, kFrames - 1 };
+    static const uint32_t kEventCount    = sizeof(kEventFrames)/sizeof(kEventFrames[0]);
+
+    Receiver receiver;
+    CarlaEngineMidiOutThread thread(&receiver);
+    thread.start();
+
+    const double ticksPerSecond(static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+    const double ticksPerFrame(ticksPerSecond / kSampleRate);
+    const int64_t cycleTicks(static_cast<int64_t>(ticksPerFrame * kFrames + 0.5));
+
+    std::vector<SentEvent> due;
+    uint8_t note = 0;
+
+    const int64_t start(static_cast<int64_t>(juce::Time::getHighResolutionTicks()) + cycleTicks);
+
+    for (uint32_t c=0; c < kCycles; ++c)
+    {
+        const int64_t cycleStart(start + cycleTicks * c);
+        sleepUntil(cycleStart);
+
+        thread.beginCycle(kFrames, kSampleRate);
+
+        // some cycles have no events
+        if (c % 4 != 3)
+        {
+            for (uint32_t i=0; i < kEventCount; ++i)
+            {
+                const uint8_t data[3] = { 0x90, note, 100 };
+                thread.writeEvent(kEventFrames[i], data, 3);
+
+                SentEvent event = { cycleStart + cycleTicks + static_cast<int64_t>(ticksPerFrame * kEventFrames[i]), note };
+                due.push_back(event);
+
+                note = static_cast<uint8_t>((note + 1) & 0x7f);
+            }
+        }
+
+        thread.endCycle();
+    }
+
+    sleepUntil(start + cycleTicks * (kCycles + 4));
+    thread.stop();
+
+    const double tolerance(kTolerance * ticksPerSecond / 1000.0);
+    const std::vector<SentEvent>& sent(receiver.events);
+
+    if (sent.size() != due.size())
+    {
+        carla_stderr2("queued %u events, sent %u", uint(due.size()), uint(sent.size()));
+        return 1;
+    }
+
+    double maxLate = 0.0;
+
+    for (size_t i=0; i < due.size(); ++i)
+    {
+        if (sent[i].note != due[i].note)
+        {
+            carla_stderr2("event %u out of order", uint(i));
+            return 1;
+        }
+
+        // never early, the thread waits until each event is due
+        if (sent[i].time < due[i].time - tolerance)
+        {
+            carla_stderr2("event %u sent %.3f ms early", uint(i), double(due[i].time - sent[i].time) * 1000.0 / ticksPerSecond);
+            return 1;
+        }
+
+        const double late(double(sent[i].time - due[i].time) * 1000.0 / ticksPerSecond);
+
+        if (late > kTolerance)
+        {
+            carla_stderr2("event %u sent %.3f ms late", uint(i), late);
+            return 1;
+        }
+
+        maxLate = std::max(maxLate, late);
+    }
+
+    carla_stdout("%u events sent in order, at most %.3f ms late", uint(sent.size()), maxLate);
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "../backend/engine/CarlaEngineMidiOutThread.cpp"
@@ -0,0 +1,248 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Runs impulses and sines through the half-band filter and the oversampler (up, then straight down again),
+// checking the round trip delay matches the reported latency, passband level and stopband rejection
+
+#include "CarlaOversampler.hpp"
+
+#include <cmath>
+#include <vector>
+
+static const double kSampleRate = 48000.0;
+
+// uneven block sizes, so state carried between calls gets tested too
+static const uint32_t kBlockSizes[] = { 64, 1, 37, 128, 5, 100 };
+static const uint32_t kMaxFrames    = 128;
+
+static uint32_t findPeak(const std::vector<float>& buf)
+{
+    uint32_t peak = 0;
+
+    for (uint32_t i=1; i < buf.size(); ++i)
+    {
+        if (std::fabs(buf[i]) > std::fabs(buf[peak]))
+            peak = i;
+    }
+
+    return peak;
+}
+
+static double sum(const std::vector<float>& buf)
+{
+    double ret = 0.0;
+
+    for (uint32_t i=0; i < buf.size(); ++i)
+        ret += double(buf[i]);
+
+    return ret;
+}
+
+static double rms(const std::vector<float>& buf, const uint32_t start, const uint32_t end)
+{
+    double ret = 0.0;
+
+    for (uint32_t i=start; i < end; ++i)
+        ret += double(buf[i]) * double(buf[i]);
+
+    return std::sqrt(ret / double(end - start));
+}
+
+static std::vector<float> roundTrip(CarlaOversampler& os, const std::vector<float>& in)
+{
+    const uint32_t factor(os.getFactor());
+
+    std::vector<float> out(in.size()), high(kMaxFrames * factor);
+
+    for (uint32_t pos=0, b=0; pos < in.size(); ++b)
+    {
+        const uint32_t frames(std::min(kBlockSizes[b % (sizeof(kBlockSizes)/sizeof(kBlockSizes[0]))], uint32_t(in.size()) - pos));
+
+        os.upsample(0, &in[pos], high.data(), frames);
+        os.downsample(0, high.data(), &out[pos], frames);
+        pos += frames;
+    }
+
+    return out;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool testHalfBandFilter(const uint32_t k)
+{
+    CarlaHalfBandFilter up, down;
+    up.setup(k, kMaxFrames);
+    down.setup(k, kMaxFrames);
+
+    std::vector<float> in(kMaxFrames), high(kMaxFrames*2), out(kMaxFrames);
+    in[10] = 1.0f;
+
+    up.upsample(in.data(), high.data(), kMaxFrames);
+    down.downsample(high.data(), out.data(), kMaxFrames);
+
+    // the round trip is 2*getDelay() high rate samples, so getDelay() low rate ones
+    const uint32_t peak(findPeak(out));
+
+    if (peak != 10 + up.getDelay())
+    {
+        carla_stderr2("half-band k=%u: impulse came out at %u, expected %u", k, peak, 10 + up.getDelay());
+        return false;
+    }
+    if (std::fabs(sum(out) - 1.0) > 0.001)
+    {
+        carla_stderr2("half-band k=%u: impulse response sums to %f, not unity gain", k, sum(out));
+        return false;
+    }
+
+    return true;
+}
+
+static bool testLatency(const uint32_t factor, const uint32_t expected)
+{
+    CarlaOversampler os;
+    os.setup(factor, 1, 1, kMaxFrames);
+
+    if (os.getLatency() != expected)
+    {
+        carla_stderr2("%ux: reported latency %u, expected %u", factor, os.getLatency(), expected);
+        return false;
+    }
+
+    // the impulse must come back exactly 'latency' frames later, whatever its position inside a block
+    for (uint32_t offset=0; offset < 70; offset += 23)
+    {
+        os.reset();
+
+        std::vector<float> in(512);
+        in[offset] = 1.0f;
+
+        const std::vector<float> out(roundTrip(os, in));
+        const uint32_t peak(findPeak(out));
+
+        if (peak != offset + expected)
+        {
+            carla_stderr2("%ux: impulse at %u came out at %u, expected %u", factor, offset, peak, offset + expected);
+            return false;
+        }
+        if (std::fabs(sum(out) - 1.0) > 0.001)
+        {
+            carla_stderr2("%ux: impulse response sums to %f, not unity gain", factor, sum(out));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool testPassband(const uint32_t factor, const double freq)
+{
+    CarlaOversampler os;
+    os.setup(factor, 1, 1, kMaxFrames);
+
+    const uint32_t latency(os.getLatency());
+
+    std::vector<float> in(8192);
+
+    for (uint32_t i=0; i < in.size(); ++i)
+        in[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * freq * double(i) / kSampleRate));
+
+    const std::vector<float> out(roundTrip(os, in));
+
+    // skip the filters warming up
+    const uint32_t start(1024), end(uint32_t(in.size()));
+
+    const double gainDb(20.0 * std::log10(rms(out, start, end) / rms(in, start - latency, end - latency)));
+
+    if (std::fabs(gainDb) > 0.1)
+    {
+        carla_stderr2("%ux: %.0f Hz passband gain %.3f dB", factor, freq, gainDb);
+        return false;
+    }
+
+    // linear phase, the output is the input delayed by the latency
+    double maxError = 0.0;
+
+    for (uint32_t i=start; i < end; ++i)
+        maxError = std::max(maxError, std::fabs(double(out[i]) - double(in[i - latency])));
+
+    if (maxError > 0.01)
+    {
+        carla_stderr2("%ux: %.0f Hz differs from the delayed input by %f", factor, freq, maxError);
+        return false;
+    }
+
+    return true;
+}
+
+static bool testStopband(const uint32_t factor, const double freq, const double minRejection)
+{
+    CarlaOversampler os;
+    os.setup(factor, 0, 1, kMaxFrames);
+
+    // generated at the high rate, above the low rate nyquist frequency
+    const uint32_t frames(4096);
+    std::vector<float> high(frames * factor), out(frames);
+
+    for (uint32_t i=0; i < high.size(); ++i)
+        high[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * freq * double(i) / (kSampleRate * factor)));
+
+    for (uint32_t pos=0; pos < frames; pos += kMaxFrames)
+        os.downsample(0, &high[pos * factor], &out[pos], kMaxFrames);
+
+    const double levelDb(20.0 * std::log10(rms(out, 512, frames) / 0.5 * std::sqrt(2.0) + 1e-12));
+
+    if (levelDb > -minRejection)
+    {
+        carla_stderr2("%ux: %.0f Hz only rejected by %.1f dB", factor, freq, -levelDb);
+        return false;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    bool ok = true;
+
+    ok = testHalfBandFilter(4)  && ok;
+    ok = testHalfBandFilter(6)  && ok;
+    ok = testHalfBandFilter(12) && ok;
+
+    ok = testLatency(2, 23) && ok;
+    ok = testLatency(4, 29) && ok;
+    ok = testLatency(8, 31) && ok;
+
+    static const uint32_t kFactors[] = { 2, 4, 8 };
+
+    for (uint32_t i=0; i < sizeof(kFactors)/sizeof(kFactors[0]); ++i)
+    {
+        ok = testPassband(kFactors[i], 100.0)   && ok;
+        ok = testPassband(kFactors[i], 1000.0)  && ok;
+        ok = testPassband(kFactors[i], 10000.0) && ok;
+        // 30 kHz would fold back to 18 kHz, right past the transition band
+        ok = testStopband(kFactors[i], 30000.0, 50.0) && ok;
+        ok = testStopband(kFactors[i], 40000.0, 60.0) && ok;
+    }
+
+    if (! ok)
+        return 1;
+
+    carla_stdout("oversampler latency, passband and stopband ok");
+    return 0;
+}
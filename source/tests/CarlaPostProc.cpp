@@ -0,0 +1,375 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Checks the plugin post-processing kernels (dry/wet, balance and volume with a circular
+// latency buffer) match the old per-sample loops, then prints how long each takes per block
+
+#include "CarlaMathUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static const uint32_t kChannels = 2;
+
+struct Params {
+    float dryWet, volume, balanceLeft, balanceRight;
+};
+
+struct Channels {
+    std::vector<float> data[kChannels];
+    float* ptrs[kChannels];
+
+    Channels(const uint32_t frames)
+    {
+        for (uint32_t i=0; i < kChannels; ++i)
+        {
+            data[i].resize(std::max(frames, 1u));
+            ptrs[i] = data[i].data();
+        }
+    }
+};
+
+static void fillNoise(Channels& c, const uint32_t frames, uint32_t& seed)
+{
+    for (uint32_t i=0; i < kChannels; ++i)
+    {
+        for (uint32_t k=0; k < frames; ++k)
+        {
+            seed = seed * 1103515245u + 12345u;
+            c.ptrs[i][k] = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// the loops every plugin type had at the end of processSingle
+
+struct OldPostProc {
+    uint32_t latency;
+    Channels history;
+    std::vector<float> oldBufLeft; // was a VLA on the stack
+
+    OldPostProc(const uint32_t lat)
+        : latency(lat),
+          history(lat),
+          oldBufLeft()
+    {
+        for (uint32_t i=0; i < kChannels; ++i)
+            std::fill(history.data[i].begin(), history.data[i].end(), 0.0f);
+    }
+
+    void process(const Params& p, float** const in, float** const out, float** const audioOut, const uint32_t frames)
+    {
+        const bool doDryWet  = carla_isNotEqual(p.dryWet, 1.0f);
+        const bool doBalance = ! (carla_isEqual(p.balanceLeft, -1.0f) && carla_isEqual(p.balanceRight, 1.0f));
+
+        bool isPair;
+        float bufValue;
+        oldBufLeft.resize(frames);
+
+        for (uint32_t i=0; i < kChannels; ++i)
+        {
+            if (doDryWet)
+            {
+                for (uint32_t k=0; k < frames; ++k)
+                {
+                    if (k < latency)
+                        bufValue = history.ptrs[i][k];
+                    else if (latency < frames)
+                        bufValue = in[i][k-latency];
+                    else
+                        bufValue = in[i][k];
+
+                    out[i][k] = (out[i][k] * p.dryWet) + (bufValue * (1.0f - p.dryWet));
+                }
+            }
+
+            if (doBalance)
+            {
+                isPair = (i % 2 == 0);
+
+                if (isPair)
+                    std::copy(out[i], out[i] + frames, oldBufLeft.begin());
+
+                float balRangeL = (p.balanceLeft  + 1.0f)/2.0f;
+                float balRangeR = (p.balanceRight + 1.0f)/2.0f;
+
+                for (uint32_t k=0; k < frames; ++k)
+                {
+                    if (isPair)
+                    {
+                        out[i][k]  = oldBufLeft[k] * (1.0f - balRangeL);
+                        out[i][k] += out[i+1][k]   * (1.0f - balRangeR);
+                    }
+                    else
+                    {
+                        out[i][k]  = out[i][k]     * balRangeR;
+                        out[i][k] += oldBufLeft[k] * balRangeL;
+                    }
+                }
+            }
+
+            for (uint32_t k=0; k < frames; ++k)
+                audioOut[i][k] = out[i][k] * p.volume;
+        }
+
+        if (latency == 0)
+            return;
+
+        if (latency <= frames)
+        {
+            for (uint32_t i=0; i < kChannels; ++i)
+                std::copy(in[i] + (frames-latency), in[i] + frames, history.ptrs[i]);
+        }
+        else
+        {
+            const uint32_t diff = latency-frames;
+
+            for (uint32_t i=0, k; i < kChannels; ++i)
+            {
+                for (k=0; k < diff; ++k)
+                    history.ptrs[i][k] = history.ptrs[i][k+frames];
+
+                for (uint32_t j=0; k < latency; ++j, ++k)
+                    history.ptrs[i][k] = in[i][j];
+            }
+        }
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// same steps as CarlaPlugin::ProtectedData::postProcess() and Latency::storeInput(), without ramps
+
+struct NewPostProc {
+    uint32_t latency, position;
+    Channels history;
+
+    NewPostProc(const uint32_t lat)
+        : latency(lat),
+          position(0),
+          history(lat)
+    {
+        for (uint32_t i=0; i < kChannels; ++i)
+            std::fill(history.data[i].begin(), history.data[i].end(), 0.0f);
+    }
+
+    void process(const Params& p, float** const in, float** const out, float** const audioOut, const uint32_t frames)
+    {
+        if (carla_isNotEqual(p.dryWet, 1.0f))
+        {
+            for (uint32_t i=0; i < kChannels; ++i)
+            {
+                if (latency == 0)
+                {
+                    carla_crossfadeFloatsWithRamp(out[i], in[i], frames, p.dryWet, 0.0f);
+                    continue;
+                }
+
+                const uint32_t firstCount  = std::min(frames, latency - position);
+                const uint32_t secondCount = std::min(frames - firstCount, position);
+                const uint32_t delayed     = firstCount + secondCount;
+
+                carla_crossfadeFloatsWithRamp(out[i], history.ptrs[i] + position, firstCount, p.dryWet, 0.0f);
+
+                if (secondCount > 0)
+                    carla_crossfadeFloatsWithRamp(out[i] + firstCount, history.ptrs[i], secondCount, p.dryWet, 0.0f);
+
+                if (delayed < frames)
+                    carla_crossfadeFloatsWithRamp(out[i] + delayed, in[i], frames - delayed, p.dryWet, 0.0f);
+            }
+        }
+
+        if (latency != 0)
+        {
+            if (frames >= latency)
+            {
+                for (uint32_t i=0; i < kChannels; ++i)
+                    std::copy(in[i] + (frames - latency), in[i] + frames, history.ptrs[i]);
+
+                position = 0;
+            }
+            else
+            {
+                const uint32_t firstCount = std::min(frames, latency - position);
+
+                for (uint32_t i=0; i < kChannels; ++i)
+                {
+                    std::copy(in[i], in[i] + firstCount, history.ptrs[i] + position);
+                    std::copy(in[i] + firstCount, in[i] + frames, history.ptrs[i]);
+                }
+
+                position = (position + frames) % latency;
+            }
+        }
+
+        const float balRangeL = (p.balanceLeft  + 1.0f)/2.0f;
+        const float balRangeR = (p.balanceRight + 1.0f)/2.0f;
+        const float gains[4] = {
+            p.volume * (1.0f - balRangeL),
+            p.volume * (1.0f - balRangeR),
+            p.volume * balRangeL,
+            p.volume * balRangeR
+        };
+        const float steps[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        carla_mixFloatPairWithRamp(audioOut[0], audioOut[1], out[0], out[1], frames, gains, steps);
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool checkRamps()
+{
+    const uint32_t frames = 61;
+    Channels a(frames), b(frames), src(frames);
+    uint32_t seed = 7;
+    fillNoise(a, frames, seed);
+    fillNoise(src, frames, seed);
+    b.data[0] = a.data[0];
+    b.data[1] = a.data[1];
+
+    const float gain = 0.25f, step = 0.5f / static_cast<float>(frames);
+
+    carla_crossfadeFloatsWithRamp(a.ptrs[0], src.ptrs[0], frames, gain, step);
+    carla_multiplyFloatsWithRamp(a.ptrs[1], src.ptrs[1], frames, gain, step);
+
+    for (uint32_t k=0; k < frames; ++k)
+    {
+        const float g = gain + step * static_cast<float>(k);
+        const float crossfade = b.ptrs[0][k] * g + src.ptrs[0][k] * (1.0f - g);
+
+        CARLA_SAFE_ASSERT_RETURN(std::abs(a.ptrs[0][k] - crossfade) < 1e-5f, false);
+        CARLA_SAFE_ASSERT_RETURN(std::abs(a.ptrs[1][k] - src.ptrs[1][k] * g) < 1e-5f, false);
+    }
+
+    const float gains[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    const float steps[4] = { -step, step, step, -step };
+
+    b.data[0] = src.data[0];
+    b.data[1] = src.data[1];
+    carla_mixFloatPairWithRamp(b.ptrs[0], b.ptrs[1], b.ptrs[0], b.ptrs[1], frames, gains, steps);
+
+    for (uint32_t k=0; k < frames; ++k)
+    {
+        const float s = step * static_cast<float>(k);
+        const float l = src.ptrs[0][k] * (1.0f - s) + src.ptrs[1][k] * s;
+        const float r = src.ptrs[0][k] * s + src.ptrs[1][k] * (1.0f - s);
+
+        CARLA_SAFE_ASSERT_RETURN(std::abs(b.ptrs[0][k] - l) < 1e-5f, false);
+        CARLA_SAFE_ASSERT_RETURN(std::abs(b.ptrs[1][k] - r) < 1e-5f, false);
+    }
+
+    return true;
+}
+
+static bool checkBlocks(const Params& p, const uint32_t frames, const uint32_t latency)
+{
+    OldPostProc oldProc(latency);
+    NewPostProc newProc(latency);
+    Channels in(frames), oldOut(frames), newOut(frames), oldAudioOut(frames), newAudioOut(frames);
+    uint32_t seed = frames + latency;
+
+    for (int block=0; block < 20; ++block)
+    {
+        fillNoise(in, frames, seed);
+        fillNoise(oldOut, frames, seed);
+        newOut.data[0] = oldOut.data[0];
+        newOut.data[1] = oldOut.data[1];
+
+        oldProc.process(p, in.ptrs, oldOut.ptrs, oldAudioOut.ptrs, frames);
+        newProc.process(p, in.ptrs, newOut.ptrs, newAudioOut.ptrs, frames);
+
+        for (uint32_t i=0; i < kChannels; ++i)
+            for (uint32_t k=0; k < frames; ++k)
+CARLA_SAFE_ASSERT_RETURN(std::abs(oldAudioOut.ptrs[i][k] - newAudioOut.ptrs[i][k]) < 1e-5f, false);
+    }
+
+    return true;
+}
+
+template<class PostProc>
+static double benchmark(const Params& p, const uint32_t frames, const uint32_t latency)
+{
+    const int blocks = 200000;
+
+    PostProc proc(latency);
+    Channels in(frames), out(frames), audioOut(frames);
+    uint32_t seed = 1;
+    fillNoise(in, frames, seed);
+    fillNoise(out, frames, seed);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int block=0; block < blocks; ++block)
+        proc.process(p, in.ptrs, out.ptrs, audioOut.ptrs, frames);
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // keep the results alive
+    if (audioOut.ptrs[0][0] > 1e30f)
+        std::printf(" ");
+
+    return seconds * 1e9 / blocks;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    CARLA_SAFE_ASSERT_RETURN(checkRamps(), 1);
+
+    // the old loops balanced the left channel with the right one before its dry/wet,
+    // so these only match if one of them is off
+    const Params dryWetParams  = { 0.7f, 0.9f, -1.0f, 1.0f };
+    const Params balanceParams = { 1.0f, 0.9f, -0.5f, 0.8f };
+    static const uint32_t kFrames[]  = { 1, 3, 64, 509, 512 };
+    static const uint32_t kLatency[] = { 0, 1, 100, 511, 1000 };
+
+    for (uint32_t f=0; f < sizeof(kFrames)/sizeof(kFrames[0]); ++f)
+    {
+        for (uint32_t l=0; l < sizeof(kLatency)/sizeof(kLatency[0]); ++l)
+        {
+            if (! checkBlocks(dryWetParams, kFrames[f], kLatency[l]) || ! checkBlocks(balanceParams, kFrames[f], kLatency[l]))
+            {
+                carla_stderr2("post-processing mismatch for %u frames, %u latency", kFrames[f], kLatency[l]);
+                return 1;
+            }
+        }
+    }
+
+    const Params params = { 0.7f, 0.9f, -0.5f, 0.8f };
+
+    std::printf("stereo dry/wet + balance + volume, ns per block\n");
+    std::printf("frames latency      old      new\n");
+
+    static const uint32_t kBenchFrames[]  = { 64, 256, 512, 512, 512 };
+    static const uint32_t kBenchLatency[] = { 0, 0, 0, 256, 2048 };
+
+    for (uint32_t i=0; i < sizeof(kBenchFrames)/sizeof(kBenchFrames[0]); ++i)
+    {
+        const double oldTime = benchmark<OldPostProc>(params, kBenchFrames[i], kBenchLatency[i]);
+        const double newTime = benchmark<NewPostProc>(params, kBenchFrames[i], kBenchLatency[i]);
+
+        std::printf("%6u %7u %8.0f %8.0f\n", kBenchFrames[i], kBenchLatency[i], oldTime, newTime);
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,186 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Converts a project to the binary format and back, plugin states and chunks must survive unchanged
+
+#include "CarlaStateUtils.cpp"
+#include "CarlaBinaryProjectUtils.cpp"
+
+#include "CarlaString.hpp"
+
+using namespace CarlaBackend;
+using juce::File;
+using juce::MemoryOutputStream;
+using juce::ScopedPointer;
+using juce::String;
+using juce::XmlDocument;
+using juce::XmlElement;
+
+static const std::size_t kChunkSizes[] = { 100, 4097, 3*1024*1024 };
+static const uint kPluginCount = sizeof(kChunkSizes)/sizeof(kChunkSizes[0]);
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static std::vector<uint8_t> makeChunk(const uint index)
+{
+    std::vector<uint8_t> chunk(kChunkSizes[index]);
+    uint32_t seed = index + 1;
+
+    for (std::size_t i=0; i < chunk.size(); ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        chunk[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    return chunk;
+}
+
+static void writeProject(const File& file)
+{
+    MemoryOutputStream out;
+    out << "<?xml version='1.0' encoding='UTF-8'?>\n";
+    out << "<!DOCTYPE CARLA-PROJECT>\n";
+    out << "<CARLA-PROJECT VERSION='2.0'>\n";
+    out << " <EngineSettings>\n";
+    out << "  <ForceStereo>false</ForceStereo>\n";
+    out << "  <MaxParameters>200</MaxParameters>\n";
+    out << " </EngineSettings>\n";
+
+    for (uint i=0; i < kPluginCount; ++i)
+    {
+        const std::vector<uint8_t> chunk(makeChunk(i));
+
+        CarlaStateSave stateSave;
+        stateSave.type     = carla_strdup("VST2");
+        stateSave.name     = carla_strdup(String("Plugin & <" + String(i) + ">").toRawUTF8());
+        stateSave.label    = carla_strdup("label");
+        stateSave.binary   = carla_strdup("/usr/lib/vst/plugin.so");
+        stateSave.uniqueId = 1234 + i;
+        stateSave.chunk    = CarlaString::asBase64(chunk.data(), chunk.size()).dup();
+
+        CarlaStateSave::CustomData* const customData(new CarlaStateSave::CustomData());
+        customData->type  = carla_strdup(CUSTOM_DATA_TYPE_STRING);
+        customData->key   = carla_strdup("key");
+        customData->value = carla_strdup("value");
+        stateSave.customData.append(customData);
+
+        MemoryOutputStream streamPlugin;
+        stateSave.dumpToMemoryStream(streamPlugin);
+
+        out << "\n <Plugin>\n" << streamPlugin << " </Plugin>\n";
+    }
+
+    out << "\n <Patchbay>\n";
+    out << "  <Connection>\n";
+    out << "   <Source>Plugin &amp; 0:out</Source>\n";
+    out << "   <Target>system:playback_1</Target>\n";
+    out << "  </Connection>\n";
+    out << " </Patchbay>\n";
+    out << "</CARLA-PROJECT>\n";
+
+    CARLA_SAFE_ASSERT(file.replaceWithData(out.getData(), out.getDataSize()));
+}
+
+// plugin states of a project, as saved
+static juce::StringArray getPluginStates(const File& file)
+{
+    juce::StringArray states;
+
+    XmlDocument xml(file);
+    ScopedPointer<XmlElement> projectElement(xml.getDocumentElement());
+    CARLA_SAFE_ASSERT_RETURN(projectElement != nullptr, states);
+
+    for (XmlElement* elem = projectElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (! elem->getTagName().equalsIgnoreCase("plugin"))
+        {
+            states.add(elem->createDocument(String(), true, false));
+            continue;
+        }
+
+        CarlaStateSave stateSave;
+        stateSave.fillFromXmlElement(elem);
+
+        MemoryOutputStream stream;
+        stateSave.dumpToMemoryStream(stream);
+        states.add(stream.toString());
+    }
+
+    return states;
+}
+
+static bool checkBinaryProject(const File& file)
+{
+    const CarlaBinaryProjectReader reader(file);
+    CARLA_SAFE_ASSERT_RETURN(reader.isValid(), false);
+
+    XmlDocument xml(reader.getProjectXml());
+    ScopedPointer<XmlElement> projectElement(xml.getDocumentElement());
+    CARLA_SAFE_ASSERT_RETURN(projectElement != nullptr, false);
+
+    uint i = 0;
+
+    for (XmlElement* elem = projectElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (! elem->getTagName().equalsIgnoreCase("plugin"))
+            continue;
+
+        CARLA_SAFE_ASSERT_RETURN(i < kPluginCount, false);
+
+        CarlaStateSave stateSave;
+        CARLA_SAFE_ASSERT_RETURN(reader.fillStateSave(stateSave, elem), false);
+        CARLA_SAFE_ASSERT_RETURN(stateSave.chunk == nullptr, false);
+        CARLA_SAFE_ASSERT_RETURN(stateSave.uniqueId == 1234 + i, false);
+
+        // raw chunks are aligned and match the original data
+        const std::vector<uint8_t> chunk(makeChunk(i++));
+        CARLA_SAFE_ASSERT_RETURN(reinterpret_cast<uintptr_t>(stateSave.rawChunk) % 16 == 0, false);
+        CARLA_SAFE_ASSERT_RETURN(stateSave.rawChunkSize == chunk.size(), false);
+        CARLA_SAFE_ASSERT_RETURN(std::memcmp(stateSave.rawChunk, chunk.data(), chunk.size()) == 0, false);
+    }
+
+    return i == kPluginCount;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    const File dir(File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("carla-project-binary", ""));
+    CARLA_SAFE_ASSERT_RETURN(dir.createDirectory(), 1);
+
+    const File xmlFile(dir.getChildFile("project.carxp"));
+    const File binaryFile(dir.getChildFile("project.carbp"));
+    const File convertedFile(dir.getChildFile("converted.carxp"));
+
+    writeProject(xmlFile);
+
+    bool ok = carla_convert_project_to_binary(xmlFile, binaryFile)
+           && CarlaBinaryProjectReader::isBinaryProject(binaryFile)
+           && ! CarlaBinaryProjectReader::isBinaryProject(xmlFile)
+           && checkBinaryProject(binaryFile)
+           && carla_convert_project_to_xml(binaryFile, convertedFile)
+           && getPluginStates(xmlFile) == getPluginStates(convertedFile);
+
+    carla_stdout("%s, xml %lli bytes, binary %lli bytes", ok ? "project round trip ok" : "project round trip FAILED",
+                 static_cast<long long>(xmlFile.getSize()), static_cast<long long>(binaryFile.getSize()));
+
+    dir.deleteRecursively();
+    return ok ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,255 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Runs engine events through the plugin re-blocking FIFO (same steps as CarlaPlugin::processReblocked,
+// with the worker replaced by an echo job), checking event times, order, and that a missed job loses nothing
+
+#include "CarlaEngineUtils.hpp"
+
+#include <cstdio>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+struct SentEvent {
+    uint64_t time;
+    uint8_t note;
+};
+
+struct Fifo {
+    const uint32_t blockSize;
+
+    EngineEvent eventsIn[2][kMaxEngineEventInternalCount];
+    EngineEvent eventsOut[2][kMaxEngineEventInternalCount];
+
+    uint32_t current;
+    uint32_t position;
+    uint32_t eventInCount;
+    uint32_t eventOutIndex;
+    bool jobPending;
+
+    Fifo(const uint32_t bs)
+        : blockSize(bs),
+          current(0),
+          position(0),
+          eventInCount(0),
+          eventOutIndex(0),
+          jobPending(false)
+    {
+        carla_zeroStructs(eventsIn[0],  kMaxEngineEventInternalCount);
+        carla_zeroStructs(eventsIn[1],  kMaxEngineEventInternalCount);
+        carla_zeroStructs(eventsOut[0], kMaxEngineEventInternalCount);
+        carla_zeroStructs(eventsOut[1], kMaxEngineEventInternalCount);
+    }
+
+    // what the plugin does inside processReblockJob: output every input event at the same time
+    void runJob(const uint32_t index)
+    {
+        carla_zeroStructs(eventsOut[index], kMaxEngineEventInternalCount);
+
+        for (uint32_t i=0; i < kMaxEngineEventInternalCount && eventsIn[index][i].type != kEngineEventTypeNull; ++i)
+            eventsOut[index][i] = eventsIn[index][i];
+
+        carla_zeroStructs(eventsIn[index], kMaxEngineEventInternalCount);
+    }
+
+    // 'busy' says for each full block if the worker is still running the previous job
+    void process(const EngineEvent* const engineIn, EngineEvent* const engineOut, const uint32_t frames,
+                 const std::vector<bool>& busy, uint32_t& blockNumber)
+    {
+        uint32_t engineEventInIndex  = 0;
+        uint32_t engineEventOutIndex = 0;
+
+        for (uint32_t offset=0; offset < frames;)
+        {
+            const uint32_t cur(current);
+            const uint32_t count(std::min(frames - offset, blockSize - position));
+            const bool lastChunk(offset + count == frames);
+
+            reblockEngineEventsIn(eventsIn[cur], eventInCount, position, engineIn, engineEventInIndex, offset, count, lastChunk);
+            deblockEngineEventsOut(engineOut, engineEventOutIndex, offset, eventsOut[cur], eventOutIndex, position, count);
+
+            offset   += count;
+            position += count;
+
+            if (position < blockSize)
+                continue;
+
+            const uint32_t blockEventInCount(eventInCount);
+
+            position      = 0;
+            eventInCount  = 0;
+            eventOutIndex = 0;
+
+            const bool missed(blockNumber < busy.size() && busy[blockNumber]);
+            ++blockNumber;
+
+            if (jobPending)
+            {
+                if (missed)
+                {
+                    eventInCount = carryReblockedEngineEvents(eventsIn[cur], blockEventInCount);
+                    carla_zeroStructs(eventsOut[cur], kMaxEngineEventInternalCount);
+                    continue;
+                }
+
+                // the worker finished the previous job
+                runJob(cur ^ 1);
+                jobPending = false;
+            }
+
+            jobPending = true;
+            current    = cur ^ 1;
+        }
+    }
+};
+
+static bool runFifo(const uint32_t blockSize, const uint32_t bufferSize, const std::vector<bool>& busy)
+{
+    Fifo fifo(blockSize);
+
+    static const uint32_t kCycles = 64;
+    const uint32_t latency = blockSize * 2;
+
+    std::vector<SentEvent> sent, received;
+    EngineEvent engineIn[kMaxEngineEventInternalCount];
+    EngineEvent engineOut[kMaxEngineEventInternalCount];
+
+    uint32_t seed = 1, blockNumber = 0;
+    uint8_t note = 0;
+
+    // the last cycles only flush what is still inside the FIFO
+    for (uint32_t c=0; c < kCycles + 6 * blockSize / bufferSize + 6; ++c)
+    {
+        carla_zeroStructs(engineIn,  kMaxEngineEventInternalCount);
+        carla_zeroStructs(engineOut, kMaxEngineEventInternalCount);
+
+        if (c < kCycles)
+        {
+            uint32_t time = 0;
+
+            for (uint32_t i=0; i < 6; ++i)
+            {
+                seed = seed * 1103515245u + 12345u;
+                time += (seed >> 16) % (bufferSize / 4);
+
+                if (time >= bufferSize)
+                    break;
+
+                EngineEvent& event(engineIn[i]);
+                event.type = kEngineEventTypeMidi;
+                event.time = time;
+                event.midi.size    = 3;
+                event.midi.data[0] = MIDI_STATUS_NOTE_ON;
+                event.midi.data[1] = note;
+                event.midi.data[2] = 100;
+
+                SentEvent s = { uint64_t(c) * bufferSize + time, note++ };
+                sent.push_back(s);
+            }
+        }
+
+        fifo.process(engineIn, engineOut, bufferSize, busy, blockNumber);
+
+        for (uint32_t i=0; i < kMaxEngineEventInternalCount && engineOut[i].type != kEngineEventTypeNull; ++i)
+        {
+            if (engineOut[i].time >= bufferSize)
+            {
+                carla_stderr2("block %u buffer %u: event time %u outside of the cycle", blockSize, bufferSize, engineOut[i].time);
+                return false;
+            }
+
+            SentEvent r = { uint64_t(c) * bufferSize + engineOut[i].time, engineOut[i].midi.data[1] };
+            received.push_back(r);
+        }
+    }
+
+    if (received.size() != sent.size())
+    {
+        carla_stderr2("block %u buffer %u: sent %u events, received %u",
+                      blockSize, bufferSize, uint(sent.size()), uint(received.size()));
+        return false;
+    }
+
+    for (size_t i=0; i < sent.size(); ++i)
+    {
+        // order is kept
+        if (received[i].note != sent[i].note)
+        {
+            carla_stderr2("block %u buffer %u: event %u out of order", blockSize, bufferSize, uint(i));
+            return false;
+        }
+        if (i > 0 && received[i].time < received[i-1].time)
+        {
+            carla_stderr2("block %u buffer %u: event %u goes back in time", blockSize, bufferSize, uint(i));
+            return false;
+        }
+
+        // without misses every event keeps its time, only delayed by the reported latency
+        if (busy.empty() && received[i].time != sent[i].time + latency)
+        {
+            carla_stderr2("block %u buffer %u: event %u at " P_UINT64 ", expected " P_UINT64,
+                          blockSize, bufferSize, uint(i), received[i].time, sent[i].time + latency);
+            return false;
+        }
+
+        // after a miss events can only come later, either whole blocks late (a late job)
+        // or at the start of a following block (carried into the next job)
+        if (received[i].time < sent[i].time + latency)
+        {
+            carla_stderr2("block %u buffer %u: event %u early", blockSize, bufferSize, uint(i));
+            return false;
+        }
+        if ((received[i].time - sent[i].time - latency) % blockSize != 0 && received[i].time % blockSize != 0)
+        {
+            carla_stderr2("block %u buffer %u: late event %u moved inside its block", blockSize, bufferSize, uint(i));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main()
+{
+    static const uint32_t kSizes[][2] = {
+        { 256, 64 }, { 256, 256 }, { 128, 48 }, { 1024, 96 }, { 64, 32 }
+    };
+
+    std::vector<bool> noMisses, someMisses, manyMisses;
+
+    for (uint32_t i=0; i < 40; ++i)
+    {
+        someMisses.push_back(i == 3 || i == 9 || i == 10);
+        manyMisses.push_back(i >= 2 && i % 3 != 0);
+    }
+
+    bool ok = true;
+
+    for (uint32_t i=0; i < sizeof(kSizes)/sizeof(kSizes[0]); ++i)
+    {
+        ok = runFifo(kSizes[i][0], kSizes[i][1], noMisses)   && ok;
+        ok = runFifo(kSizes[i][0], kSizes[i][1], someMisses) && ok;
+        ok = runFifo(kSizes[i][0], kSizes[i][1], manyMisses) && ok;
+    }
+
+    if (! ok)
+        return 1;
+
+    carla_stdout("re-blocked events keep their order and time, missed blocks carry their events");
+    return 0;
+}
@@ -0,0 +1,255 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Saves a project twice the way autosave does (reusing unchanged plugin states),
+// changing a parameter, an option and custom data in between, and checks the second file has every change
+
+#include "../backend/engine/CarlaEngineInternal.hpp"
+
+#include "CarlaPlugin.hpp"
+
+#include "CarlaStateUtils.hpp"
+#include "CarlaUtils.hpp"
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_START_NAMESPACE
+
+class CarlaEngineDummy : public CarlaEngine
+{
+public:
+    CarlaEngineDummy()
+        : CarlaEngine(),
+          fIsRunning(false)
+    {
+    }
+
+    bool init(const char* const clientName) override
+    {
+        fIsRunning = true;
+
+        if (! pData->init(clientName))
+        {
+            close();
+            setLastError("Failed to init internal data");
+            return false;
+        }
+
+        pData->bufferSize = 512;
+        pData->sampleRate = 44100.0;
+        return true;
+    }
+
+    bool close() override
+    {
+        fIsRunning = false;
+        return CarlaEngine::close();
+    }
+
+    bool isRunning() const noexcept override
+    {
+        return fIsRunning;
+    }
+
+    bool isOffline() const noexcept override
+    {
+        return false;
+    }
+
+    EngineType getType() const noexcept override
+    {
+        return kEngineTypePlugin;
+    }
+
+    const char* getCurrentDriverName() const noexcept override
+    {
+        return "Dummy";
+    }
+
+    // what updateAutosave() does
+    bool autosave(const char* const filename)
+    {
+        return saveProjectToFile(filename, true);
+    }
+
+private:
+    bool fIsRunning;
+};
+
+CARLA_BACKEND_END_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_USE_NAMESPACE
+
+#define TEST_NAME "TestName"
+#define TEST_KEY  "AutosaveTest"
+
+static void loadPluginState(const juce::File& file, CarlaStateSave& stateSave)
+{
+    juce::XmlDocument xml(file);
+    const juce::ScopedPointer<juce::XmlElement> xmlElement(xml.getDocumentElement());
+    assert(xmlElement != nullptr);
+
+    for (juce::XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (! elem->getTagName().equalsIgnoreCase("plugin"))
+            continue;
+
+        const bool filled(stateSave.fillFromXmlElement(elem));
+        assert(filled);
+        return;
+    }
+
+    assert(false);
+}
+
+static const char* findCustomData(const CarlaStateSave& stateSave, const char* const key)
+{
+    for (CarlaStateSave::CustomDataItenerator it = stateSave.customData.begin2(); it.valid(); it.next())
+    {
+        const CarlaStateSave::CustomData* const cdata(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(cdata != nullptr && cdata->isValid());
+
+        if (std::strcmp(cdata->key, key) == 0)
+            return cdata->value;
+    }
+
+    return nullptr;
+}
+
+static float findParameterValue(const CarlaStateSave& stateSave, const int32_t index)
+{
+    for (CarlaStateSave::ParameterItenerator it = stateSave.parameters.begin2(); it.valid(); it.next())
+    {
+        const CarlaStateSave::Parameter* const param(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(param != nullptr);
+
+        if (param->index == index)
+            return param->value;
+    }
+
+    return -1.0f;
+}
+
+static void autosave(CarlaEngineDummy* const eng, const juce::File& file)
+{
+    const bool saved(eng->autosave(file.getFullPathName().toRawUTF8()));
+    assert(saved);
+}
+
+static void testAutosave(CarlaEngineDummy* const eng, const juce::File& file)
+{
+    const bool initiated(eng->init("test"));
+    assert(initiated);
+
+    const bool added(eng->addPlugin(PLUGIN_INTERNAL, nullptr, TEST_NAME, "midigain", 0, nullptr));
+    assert(added);
+
+    CarlaPlugin* const plugin(eng->getPlugin(0));
+    assert(plugin != nullptr);
+    assert(plugin->getParameterCount() > 0);
+
+    const uint optionsAvailable(plugin->getOptionsAvailable());
+    assert(optionsAvailable != 0x0);
+
+    // lowest available option
+    const uint option(optionsAvailable & ~(optionsAvailable - 1));
+
+    const ParameterRanges& ranges(plugin->getParameterRanges(0));
+    const float value1(ranges.min);
+    const float value2(ranges.max);
+
+    plugin->setParameterValue(0, value1, false, false, false);
+    plugin->setOption(option, false, false);
+    plugin->setCustomData(CUSTOM_DATA_TYPE_PROPERTY, TEST_KEY, "first", false);
+
+    // first save, the plugin has never been saved before
+    autosave(eng, file);
+    {
+        CarlaStateSave stateSave;
+        loadPluginState(file, stateSave);
+        assert(carla_isEqual(findParameterValue(stateSave, 0), value1));
+        assert((stateSave.options & option) == 0x0);
+
+        const char* const cdata(findCustomData(stateSave, TEST_KEY));
+        assert(cdata != nullptr && std::strcmp(cdata, "first") == 0);
+    }
+
+    // nothing changed, the previous state is reused as-is
+    const juce::String firstContents(file.loadFileAsString());
+    autosave(eng, file);
+    assert(file.loadFileAsString() == firstContents);
+
+    plugin->setParameterValue(0, value2, false, false, false);
+    plugin->setOption(option, true, false);
+    plugin->setCustomData(CUSTOM_DATA_TYPE_PROPERTY, TEST_KEY, "second", false);
+
+    // second save, every change must be there even though states are reused when unchanged
+    autosave(eng, file);
+    {
+        CarlaStateSave stateSave;
+        loadPluginState(file, stateSave);
+        assert(carla_isEqual(findParameterValue(stateSave, 0), value2));
+        assert((stateSave.options & option) == option);
+
+        const char* const cdata(findCustomData(stateSave, TEST_KEY));
+        assert(cdata != nullptr && std::strcmp(cdata, "second") == 0);
+    }
+
+    // each change alone also makes the state outdated
+    plugin->setParameterValue(0, value1, false, false, false);
+    autosave(eng, file);
+    {
+        CarlaStateSave stateSave;
+        loadPluginState(file, stateSave);
+        assert(carla_isEqual(findParameterValue(stateSave, 0), value1));
+    }
+
+    plugin->setOption(option, false, false);
+    autosave(eng, file);
+    {
+        CarlaStateSave stateSave;
+        loadPluginState(file, stateSave);
+        assert((stateSave.options & option) == 0x0);
+    }
+
+    plugin->setCustomData(CUSTOM_DATA_TYPE_PROPERTY, TEST_KEY, "third", false);
+    autosave(eng, file);
+    {
+        CarlaStateSave stateSave;
+        loadPluginState(file, stateSave);
+
+        const char* const cdata(findCustomData(stateSave, TEST_KEY));
+        assert(cdata != nullptr && std::strcmp(cdata, "third") == 0);
+    }
+
+    eng->close();
+}
+
+int main()
+{
+    const juce::File file(juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("carla-autosave-test", ".carxp"));
+
+    CarlaEngineDummy e;
+    testAutosave(&e, file);
+
+    file.deleteFile();
+
+    carla_stdout("autosave keeps every parameter, option and custom data change");
+    return 0;
+}
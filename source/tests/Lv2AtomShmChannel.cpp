@@ -0,0 +1,167 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2016 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Streams synthetic atoms through the UI bridge shared memory channel, checking they arrive intact,
+// then compares its throughput against the base64 encoding used by "atom" pipe messages
+
+#include "Lv2AtomShmChannel.hpp"
+#include "CarlaBase64Utils.hpp"
+
+#include "lv2/atom-util.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// never started, only needed as the fallback target of writeAtom()
+class DummyPipe : public CarlaPipeServer
+{
+public:
+    DummyPipe()
+        : CarlaPipeServer() {}
+
+    bool msgReceived(const char* const) noexcept override
+    {
+        return true;
+    }
+};
+
+static std::vector<uint8_t> makeAtom(const uint32_t bodySize, const uint32_t seed)
+{
+    std::vector<uint8_t> data(sizeof(LV2_Atom) + bodySize);
+
+    LV2_Atom* const atom((LV2_Atom*)data.data());
+    atom->size = bodySize;
+    atom->type = 1 + seed;
+
+    for (uint32_t i=0; i < bodySize; ++i)
+        data[sizeof(LV2_Atom) + i] = static_cast<uint8_t>(seed * 31 + i);
+
+    return data;
+}
+
+static double elapsedSeconds(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void testChannel(Lv2AtomShmChannel& host, Lv2AtomShmChannel& ui, const DummyPipe& pipe)
+{
+    static const uint32_t sizes[] = { 0, 4, 61, 1000, 64*1024 };
+
+    // several rounds so the ring buffer wraps around
+    for (uint32_t round=0; round < 40; ++round)
+    {
+        for (uint32_t i=0; i < sizeof(sizes)/sizeof(sizes[0]); ++i)
+        {
+            const std::vector<uint8_t> data(makeAtom(sizes[i], round+i));
+            host.writeAtom(pipe, i, (const LV2_Atom*)data.data());
+        }
+
+        for (uint32_t i=0; i < sizeof(sizes)/sizeof(sizes[0]); ++i)
+        {
+            const std::vector<uint8_t> data(makeAtom(sizes[i], round+i));
+
+            uint32_t portIndex;
+            const LV2_Atom* atom;
+
+            CARLA_SAFE_ASSERT_RETURN(ui.readAtom(portIndex, atom),);
+            CARLA_SAFE_ASSERT_RETURN(portIndex == i,);
+            CARLA_SAFE_ASSERT_RETURN(lv2_atom_total_size(atom) == data.size(),);
+            CARLA_SAFE_ASSERT_RETURN(std::memcmp(atom, data.data(), data.size()) == 0,);
+        }
+
+        uint32_t portIndex;
+        const LV2_Atom* atom;
+        CARLA_SAFE_ASSERT_RETURN(! ui.readAtom(portIndex, atom),);
+    }
+
+    carla_stdout("channel ok");
+}
+
+static void testThroughput(Lv2AtomShmChannel& host, Lv2AtomShmChannel& ui, const DummyPipe& pipe,
+                           const uint32_t bodySize)
+{
+    const std::vector<uint8_t> data(makeAtom(bodySize, 0));
+    const LV2_Atom* const atom((const LV2_Atom*)data.data());
+    const uint32_t totalSize(lv2_atom_total_size(atom));
+    const uint32_t count((64*1024*1024) / totalSize);
+
+    uint32_t portIndex;
+    const LV2_Atom* readAtom;
+    std::size_t check = 0;
+
+    // what "atom" pipe messages do on each side, minus the pipe itself
+    std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
+    for (uint32_t i=0; i < count; ++i)
+    {
+        CarlaString base64atom(CarlaString::asBase64(atom, totalSize));
+        std::vector<uint8_t> chunk(carla_getChunkFromBase64String(base64atom.buffer()));
+        check += chunk.size();
+    }
+
+    const double base64Time(elapsedSeconds(start));
+
+    start = std::chrono::steady_clock::now();
+
+    for (uint32_t i=0; i < count; ++i)
+    {
+        host.writeAtom(pipe, 0, atom);
+        CARLA_SAFE_ASSERT_RETURN(ui.readAtom(portIndex, readAtom),);
+        check += lv2_atom_total_size(readAtom);
+    }
+
+    const double shmTime(elapsedSeconds(start));
+    const double megabytes(double(count) * totalSize / (1024.0*1024.0));
+
+    CARLA_SAFE_ASSERT_RETURN(check == std::size_t(count) * totalSize * 2,);
+
+    std::printf("%6u bytes: base64 %8.1f MB/s, shared memory %8.1f MB/s\n",
+                totalSize, megabytes / base64Time, megabytes / shmTime);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    DummyPipe pipe;
+    Lv2AtomShmChannel host, ui;
+
+    CARLA_SAFE_ASSERT_RETURN(host.initialize(), 1);
+    CARLA_SAFE_ASSERT_RETURN(ui.attach(host.getFilename()), 1);
+    host.setReady();
+
+    testChannel(host, ui, pipe);
+
+    testThroughput(host, ui, pipe, 32);
+    testThroughput(host, ui, pipe, 256);
+    testThroughput(host, ui, pipe, 4096);
+    testThroughput(host, ui, pipe, 64*1024);
+
+    ui.clear();
+    host.clear();
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "../utils/CarlaPipeUtils.cpp"
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,275 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Checks the vectorized zyn oscillator kernels match the scalar ones,
+// then prints how many unison voices each version renders in realtime on one core
+
+#include "DSP/OscilKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace OscilKernels;
+
+const int kOscilSize  = 1024;
+const int kBufferSize = 256;
+const int kMaxVoices  = 50;
+const int kMaxDelay   = 2000;
+const int kSampleRate = 48000;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static unsigned gSeed = 1;
+
+static int randInt(const int max)
+{
+    gSeed = gSeed * 1103515245u + 12345u;
+    return static_cast<int>((gSeed >> 8) % static_cast<unsigned>(max));
+}
+
+static float randFloat(const float min, const float max)
+{
+    return min + (max - min) * static_cast<float>(randInt(1 << 20)) / static_cast<float>(1 << 20);
+}
+
+struct State {
+    std::vector<float> smps, delay;
+    std::vector<float> buffers;
+    std::vector<float*> out;
+    std::vector<int> poshi, poslo, freqhi, freqlo;
+    std::vector<float> fposlo, ffreqlo, realpos1, realpos2, taps;
+
+    State(const unsigned seed)
+        : smps(kOscilSize + 1),
+          delay(kMaxDelay),
+          buffers(kMaxVoices * kBufferSize),
+          out(kMaxVoices),
+          poshi(kMaxVoices),
+          poslo(kMaxVoices),
+          freqhi(kMaxVoices),
+          freqlo(kMaxVoices),
+          fposlo(kMaxVoices),
+          ffreqlo(kMaxVoices),
+          realpos1(kMaxVoices),
+          realpos2(kMaxVoices),
+          taps(kMaxVoices)
+    {
+        gSeed = seed;
+
+        for (int i=0; i < kOscilSize; ++i)
+            smps[i] = randFloat(-1.0f, 1.0f);
+        smps[kOscilSize] = smps[0];
+
+        for (int i=0; i < kMaxDelay; ++i)
+            delay[i] = randFloat(-1.0f, 1.0f);
+
+        for (int k=0; k < kMaxVoices; ++k)
+        {
+            out[k]      = &buffers[k * kBufferSize];
+            poshi[k]    = randInt(kOscilSize);
+            poslo[k]    = randInt(1 << 24);
+            freqhi[k]   = randInt(40);
+            freqlo[k]   = randInt(1 << 24);
+            fposlo[k]   = randFloat(0.0f, 1.0f);
+            ffreqlo[k]  = randFloat(0.0f, 1.0f);
+            realpos1[k] = randFloat(1.0f, kMaxDelay - 2);
+            realpos2[k] = randFloat(1.0f, kMaxDelay - 2);
+        }
+
+        // modulator input for frequencyModulation, in samples
+        for (int i=0; i < kMaxVoices * kBufferSize; ++i)
+            buffers[i] = randFloat(-60.0f, 60.0f);
+    }
+
+    bool samePositions(const State& s) const
+    {
+        return poshi == s.poshi && poslo == s.poslo
+            && std::memcmp(&fposlo[0], &s.fposlo[0], fposlo.size() * sizeof(float)) == 0;
+    }
+
+    float maxDifference(const State& s) const
+    {
+        float diff = 0.0f;
+
+        for (std::size_t i=0; i < buffers.size(); ++i)
+            diff = std::max(diff, std::fabs(buffers[i] - s.buffers[i]));
+
+        for (std::size_t i=0; i < taps.size(); ++i)
+            diff = std::max(diff, std::fabs(taps[i] - s.taps[i]));
+
+        return diff;
+    }
+};
+
+enum Kernel {
+    kInterpolate,
+    kMorph,
+    kRing,
+    kFrequencyModulation,
+    kUnisonTaps,
+    kKernelCount
+};
+
+static const char* const kKernelNames[kKernelCount] = {
+    "interpolate", "morph", "ring", "frequencyModulation", "unisonTaps"
+};
+
+static void run(const Kernel kernel, State& s, const int voices)
+{
+    switch (kernel)
+    {
+    case kInterpolate:
+        interpolate(&s.smps[0], kOscilSize, kBufferSize, voices, &s.out[0],
+                    &s.poshi[0], &s.poslo[0], &s.freqhi[0], &s.freqlo[0]);
+        break;
+    case kMorph:
+    case kRing:
+        modulate(kernel == kMorph ? Morph : Ring, &s.smps[0], kOscilSize, kBufferSize, voices, &s.out[0],
+                 &s.poshi[0], &s.fposlo[0], &s.freqhi[0], &s.ffreqlo[0], 0.2f, 0.7f);
+        break;
+    case kFrequencyModulation:
+        frequencyModulation(&s.smps[0], kOscilSize, kBufferSize, voices, &s.out[0],
+                            &s.poshi[0], &s.poslo[0], &s.freqhi[0], &s.freqlo[0], 37);
+        break;
+    case kUnisonTaps:
+        for (int i=0; i < kBufferSize; ++i)
+            unisonTaps(&s.delay[0], kMaxDelay, i * 7, static_cast<float>(i) / kBufferSize, voices,
+                       &s.realpos1[0], &s.realpos2[0], &s.taps[0]);
+        break;
+    default:
+        break;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// The vector code does the same operations as the scalar code, so without -ffast-math the results are bit-exact.
+// With it (as Carla builds) the compiler may reorder the scalar math differently, the unison delay positions are
+// then off by the float resolution at ~2000 samples, which moves the interpolated taps by up to ~1e-3.
+static float testKernels(const Isa isa, const Kernel kernel)
+{
+    float maxDiff = 0.0f;
+
+    for (int voices=1; voices <= kMaxVoices; ++voices)
+    {
+        State expected(static_cast<unsigned>(voices)), actual(static_cast<unsigned>(voices));
+
+        setIsa(Scalar);
+        run(kernel, expected, voices);
+
+        setIsa(isa);
+        run(kernel, actual, voices);
+
+        if (! expected.samePositions(actual))
+        {
+            std::fprintf(stderr, "%s: %s positions differ from scalar with %i voices\n",
+                         isaName(isa), kKernelNames[kernel], voices);
+            return 1.0f;
+        }
+
+        maxDiff = std::max(maxDiff, expected.maxDifference(actual));
+    }
+
+    return maxDiff;
+}
+
+static double voicesPerCore(const Isa isa, const Kernel kernel)
+{
+    setIsa(isa);
+
+    const int voices = 16;
+    const int runs   = 1000;
+    State s(1);
+    const std::vector<float> input(s.buffers);
+    double best = 0.0;
+
+    // best of a few rounds, the others are disturbed by the rest of the system
+    for (int round=0; round < 5; ++round)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (int i=0; i < runs; ++i)
+        {
+            // fresh input every time, some kernels work in place
+            std::memcpy(&s.buffers[0], &input[0], voices * kBufferSize * sizeof(float));
+
+            run(kernel, s, voices);
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double result  = static_cast<double>(voices) * runs * kBufferSize / kSampleRate / seconds;
+
+        if (result > best)
+            best = result;
+    }
+
+    return best;
+}
+
+int main()
+{
+    static const Isa isas[] = { Scalar, SSE2, AVX2 };
+    const Isa best = isa();
+    bool ok = true;
+
+    for (const Isa i : isas)
+    {
+        if (i == Scalar || ! setIsa(i))
+            continue;
+
+        for (int kernel=0; kernel < kKernelCount; ++kernel)
+        {
+            const float diff = testKernels(i, static_cast<Kernel>(kernel));
+            const float tolerance = kernel == kUnisonTaps ? 1e-3f : 1e-5f;
+
+            if (diff > tolerance)
+            {
+                std::fprintf(stderr, "%s: %s differs from scalar by %g\n", isaName(i), kKernelNames[kernel], diff);
+                ok = false;
+            }
+            else if (diff > 0.0f)
+            {
+                std::printf("%s: %s within %g of scalar\n", isaName(i), kKernelNames[kernel], diff);
+            }
+        }
+    }
+
+    std::printf("voices per core at %i Hz:\n", kSampleRate);
+
+    for (int kernel=0; kernel < kKernelCount; ++kernel)
+    {
+        std::printf("  %-20s", kKernelNames[kernel]);
+
+        for (const Isa i : isas)
+        {
+            if (! setIsa(i))
+                continue;
+            std::printf("  %s %8.0f", isaName(i), voicesPerCore(i, static_cast<Kernel>(kernel)));
+        }
+
+        std::printf("\n");
+    }
+
+    setIsa(best);
+    std::printf("%s, using %s\n", ok ? "all kernels match scalar" : "FAILED", isaName(best));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * Carla Tests
+ * Copyright (C) 2013-2014 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+// Renders the same notes with serial and parallel part rendering, output must match exactly
+
+#include "Misc/Config.h"
+#include "Misc/Master.h"
+#include "Misc/Util.h"
+
+#include <cstdio>
+#include <cstring>
+
+const int kBufferSize = 32;
+const int kFrames     = 48000;
+const int kParts      = 12;
+
+static void render(const int threads, float* const outL, float* const outR)
+{
+    sprng(0x1234);
+
+    SYNTH_T synth;
+    synth.buffersize = kBufferSize;
+    synth.samplerate = 48000;
+    synth.alias();
+
+    CarlaConfig config;
+    config.init();
+    config.cfg.PartRenderThreads = threads;
+
+    Master master(synth, &config);
+
+    for (int i=0; i < kParts; ++i)
+    {
+        master.partonoff(i, 1);
+        master.noteOn(static_cast<char>(i % NUM_MIDI_CHANNELS), static_cast<char>(36 + i*5), 100);
+    }
+
+    for (int i=0; i < kFrames; i += kBufferSize)
+    {
+        if (i == kFrames/2)
+        {
+            for (int j=0; j < kParts; ++j)
+                master.noteOff(static_cast<char>(j % NUM_MIDI_CHANNELS), static_cast<char>(36 + j*5));
+        }
+
+        master.AudioOut(outL + i, outR + i);
+    }
+}
+
+int main()
+{
+    static float serialL[kFrames], serialR[kFrames];
+    static float parallelL[kFrames], parallelR[kFrames];
+
+    render(0, serialL, serialR);
+    render(3, parallelL, parallelR);
+
+    if (std::memcmp(serialL, parallelL, sizeof(serialL)) != 0 || std::memcmp(serialR, parallelR, sizeof(serialR)) != 0)
+    {
+        std::fprintf(stderr, "parallel part rendering does not match serial output\n");
+        return 1;
+    }
+
+    std::printf("parallel part rendering matches serial output\n");
+    return 0;
+}
@@ -48,6 +48,14 @@ const char* PluginOption2Str(const uint option) noexcept
         return "PLUGIN_OPTION_SEND_PITCHBEND";
     case PLUGIN_OPTION_SEND_ALL_SOUND_OFF:
         return "PLUGIN_OPTION_SEND_ALL_SOUND_OFF";
+    case PLUGIN_OPTION_SLEEP_WHEN_SILENT:
+        return "PLUGIN_OPTION_SLEEP_WHEN_SILENT";
+    case PLUGIN_OPTION_REBLOCK:
+        return "PLUGIN_OPTION_REBLOCK";
+    case PLUGIN_OPTION_EXPENDABLE:
+        return "PLUGIN_OPTION_EXPENDABLE";
+    case PLUGIN_OPTION_OVERSAMPLE:
+        return "PLUGIN_OPTION_OVERSAMPLE";
     }
 
     carla_stderr("CarlaBackend::PluginOption2Str(%i) - invalid option", option);
@@ -282,6 +290,8 @@ const char* EngineCallbackOpcode2Str(const EngineCallbackOpcode opcode) noexcept
         return "ENGINE_CALLBACK_ERROR";
     case ENGINE_CALLBACK_QUIT:
         return "ENGINE_CALLBACK_QUIT";
+    case ENGINE_CALLBACK_PLUGIN_DEGRADED:
+        return "ENGINE_CALLBACK_PLUGIN_DEGRADED";
     }
 
     carla_stderr("CarlaBackend::EngineCallbackOpcode2Str(%i) - invalid opcode", opcode);
@@ -331,6 +341,28 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_FRONTEND_WIN_ID";
     case ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT:
         return "ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT";
+    case ENGINE_OPTION_SILENCE_TAIL_TIME:
+        return "ENGINE_OPTION_SILENCE_TAIL_TIME";
+    case ENGINE_OPTION_RT_MEMORY_LOCK:
+        return "ENGINE_OPTION_RT_MEMORY_LOCK";
+    case ENGINE_OPTION_RT_CPU_AFFINITY:
+        return "ENGINE_OPTION_RT_CPU_AFFINITY";
+    case ENGINE_OPTION_RT_PRIORITY:
+        return "ENGINE_OPTION_RT_PRIORITY";
+    case ENGINE_OPTION_PROJECT_LOAD_THREADS:
+        return "ENGINE_OPTION_PROJECT_LOAD_THREADS";
+    case ENGINE_OPTION_PROCESS_THREADS:
+        return "ENGINE_OPTION_PROCESS_THREADS";
+    case ENGINE_OPTION_REBLOCK_SIZE:
+        return "ENGINE_OPTION_REBLOCK_SIZE";
+    case ENGINE_OPTION_REBLOCK_THREAD:
+        return "ENGINE_OPTION_REBLOCK_THREAD";
+    case ENGINE_OPTION_OVERLOAD_LIMIT:
+        return "ENGINE_OPTION_OVERLOAD_LIMIT";
+    case ENGINE_OPTION_OVERSAMPLE_FACTOR:
+        return "ENGINE_OPTION_OVERSAMPLE_FACTOR";
+    case ENGINE_OPTION_AUTOSAVE:
+        return "ENGINE_OPTION_AUTOSAVE";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
@@ -377,6 +409,25 @@ const char* EngineTransportMode2Str(const EngineTransportMode mode) noexcept
     return nullptr;
 }
 
+static inline
+const char* PluginDegradation2Str(const PluginDegradation degradation) noexcept
+{
+    switch (degradation)
+    {
+    case PLUGIN_DEGRADATION_NONE:
+        return "PLUGIN_DEGRADATION_NONE";
+    case PLUGIN_DEGRADATION_REDUCED_RATE:
+        return "PLUGIN_DEGRADATION_REDUCED_RATE";
+    case PLUGIN_DEGRADATION_REDUCED_POLYPHONY:
+        return "PLUGIN_DEGRADATION_REDUCED_POLYPHONY";
+    case PLUGIN_DEGRADATION_BYPASSED:
+        return "PLUGIN_DEGRADATION_BYPASSED";
+    }
+
+    carla_stderr("CarlaBackend::PluginDegradation2Str(%i) - invalid degradation", degradation);
+    return nullptr;
+}
+
 static inline
 const char* FileCallbackOpcode2Str(const FileCallbackOpcode opcode) noexcept
 {
@@ -1,7 +1,6 @@
 /*
- * Carla base64 utils, based on http://www.adp-gmbh.ch/cpp/common/base64.html
- * Copyright (C) 2004-2008 René Nyffenegger
- * Copyright (C) 2014 Filipe Coelho <falktx@falktx.com>
+ * Carla base64 utils
+ * Copyright (C) 2014-2017 Filipe Coelho <falktx@falktx.com>
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License as
@@ -21,7 +20,6 @@
 
 #include "CarlaUtils.hpp"
 
-#include <cctype>
 #include <vector>
 
 // -----------------------------------------------------------------------
@@ -29,95 +27,269 @@
 
 namespace CarlaBase64Helpers {
 
-static const char* const kBase64Chars =
+static const char kBase64Chars[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
-static inline
-uint8_t findBase64CharIndex(const char c)
-{
-    static const uint8_t kBase64CharsLen(static_cast<uint8_t>(std::strlen(kBase64Chars)));
+// decoding table, values above 63 are special
+static const uint8_t kBase64Invalid = 0xff;
+static const uint8_t kBase64Space   = 0xfe;
+static const uint8_t kBase64End     = 0xfd;
 
-    for (uint8_t i=0; i<kBase64CharsLen; ++i)
-    {
-        if (kBase64Chars[i] == c)
-            return i;
-    }
-
-    carla_stderr2("findBase64CharIndex('%c') - failed", c);
-    return 0;
-}
+static const uint8_t kBase64Values[256] = {
+    0xfd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xfd, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
 
 static inline
-bool isBase64Char(const char c)
+void encodeTriplet(const uint8_t* const in, char* const out) noexcept
 {
-    return (std::isalnum(c) || (c == '+') || (c == '/'));
+    const uint32_t v = (static_cast<uint32_t>(in[0]) << 16) | (static_cast<uint32_t>(in[1]) << 8) | in[2];
+
+    out[0] = kBase64Chars[(v >> 18) & 0x3f];
+    out[1] = kBase64Chars[(v >> 12) & 0x3f];
+    out[2] = kBase64Chars[(v >>  6) & 0x3f];
+    out[3] = kBase64Chars[ v        & 0x3f];
 }
 
 } // namespace CarlaBase64Helpers
 
 // -----------------------------------------------------------------------
+// Encoding
+
+/*
+ * Number of characters needed to encode @a dataSize bytes, padding included.
+ */
+static inline
+std::size_t carla_base64_encoded_size(const std::size_t dataSize) noexcept
+{
+    return (dataSize + 2) / 3 * 4;
+}
 
+/*
+ * Encode @a dataSize bytes into @a out, which must hold carla_base64_encoded_size(dataSize) characters.
+ * No null terminator is written. Returns the number of characters written.
+ *
+ * Data can be encoded in pieces as long as every piece but the last has a size multiple of 3,
+ * only the last piece gets padded.
+ */
 static inline
-std::vector<uint8_t> carla_getChunkFromBase64String(const char* const base64string)
+std::size_t carla_base64_encode(const void* const data, const std::size_t dataSize, char* const out) noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr, std::vector<uint8_t>());
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr || dataSize == 0, 0);
+    CARLA_SAFE_ASSERT_RETURN(out != nullptr || dataSize == 0, 0);
 
-    uint i=0, j=0;
-    uint charArray3[3], charArray4[4];
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    const uint8_t* const inEnd = in + dataSize;
+    char* outPtr = out;
 
-    std::vector<uint8_t> ret;
-    ret.reserve(std::strlen(base64string)*3/4 + 4);
+    for (; inEnd - in >= 12; in += 12, outPtr += 16)
+    {
+        CarlaBase64Helpers::encodeTriplet(in,    outPtr);
+        CarlaBase64Helpers::encodeTriplet(in+3,  outPtr+4);
+        CarlaBase64Helpers::encodeTriplet(in+6,  outPtr+8);
+        CarlaBase64Helpers::encodeTriplet(in+9,  outPtr+12);
+    }
+
+    for (; inEnd - in >= 3; in += 3, outPtr += 4)
+        CarlaBase64Helpers::encodeTriplet(in, outPtr);
 
-    for (std::size_t l=0, len=std::strlen(base64string); l<len; ++l)
+    if (const std::size_t rest = static_cast<std::size_t>(inEnd - in))
     {
-        const char c = base64string[l];
+        const uint8_t tail[3] = { in[0], rest > 1 ? in[1] : uint8_t(0), 0 };
+        CarlaBase64Helpers::encodeTriplet(tail, outPtr);
 
-        if (c == '\0' || c == '=')
-            break;
-        if (c == ' ' || c == '\n')
-            continue;
+        outPtr[3] = '=';
+        if (rest == 1)
+            outPtr[2] = '=';
+
+        outPtr += 4;
+    }
+
+    return static_cast<std::size_t>(outPtr - out);
+}
+
+// -----------------------------------------------------------------------
+// Decoding
 
-         CARLA_SAFE_ASSERT_CONTINUE(CarlaBase64Helpers::isBase64Char(c));
+/*
+ * Maximum number of bytes decoded from @a base64Size characters.
+ */
+static inline
+std::size_t carla_base64_decoded_max_size(const std::size_t base64Size) noexcept
+{
+    return (base64Size + 3) / 4 * 3;
+}
 
-        charArray4[i++] = static_cast<uint>(c);
+/*
+ * Incremental base64 decoder, for input that comes in pieces.
+ * Whitespace is ignored, decoding stops at the first '=' or null character.
+ */
+class CarlaBase64Decoder
+{
+public:
+    CarlaBase64Decoder() noexcept
+        : fBits(0),
+          fCount(0),
+          fDone(false) {}
 
-        if (i == 4)
+    /*
+     * Decode @a size characters into @a out, which must hold carla_base64_decoded_max_size(size) bytes.
+     * Returns the number of bytes written.
+     */
+    std::size_t decode(const char* const base64, const std::size_t size, uint8_t* const out) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(base64 != nullptr || size == 0, 0);
+        CARLA_SAFE_ASSERT_RETURN(out != nullptr || size == 0, 0);
+
+        using namespace CarlaBase64Helpers;
+
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(base64);
+        const uint8_t* const inEnd = in + size;
+        uint8_t* outPtr = out;
+
+        while (in < inEnd && ! fDone)
         {
-            for (i=0; i<4; ++i)
-                charArray4[i] = CarlaBase64Helpers::findBase64CharIndex(static_cast<char>(charArray4[i]));
+            // fast path, 4 plain characters at once
+            if (fCount == 0)
+            {
+                for (; inEnd - in >= 4; in += 4, outPtr += 3)
+                {
+                    const uint8_t a = kBase64Values[in[0]], b = kBase64Values[in[1]],
+                                  c = kBase64Values[in[2]], d = kBase64Values[in[3]];
+
+                    if ((a | b | c | d) & 0xc0)
+                        break;
+
+                    const uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+
+                    outPtr[0] = static_cast<uint8_t>(v >> 16);
+                    outPtr[1] = static_cast<uint8_t>(v >> 8);
+                    outPtr[2] = static_cast<uint8_t>(v);
+                }
+
+                if (in == inEnd)
+                    break;
+            }
+
+            const uint8_t value = kBase64Values[*in++];
 
-            charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-            charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-            charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+            if (value < 64)
+            {
+                fBits = (fBits << 6) | value;
 
-            for (i=0; i<3; ++i)
-                ret.push_back(static_cast<uint8_t>(charArray3[i]));
+                if (++fCount == 4)
+                {
+                    outPtr[0] = static_cast<uint8_t>(fBits >> 16);
+                    outPtr[1] = static_cast<uint8_t>(fBits >> 8);
+                    outPtr[2] = static_cast<uint8_t>(fBits);
+                    outPtr += 3;
+                    fBits  = 0;
+                    fCount = 0;
+                }
+                continue;
+            }
 
-            i = 0;
+            switch (value)
+            {
+            case kBase64Space:
+                break;
+            case kBase64End:
+                fDone = true;
+                break;
+            default:
+                carla_stderr2("CarlaBase64Decoder::decode() - invalid character '%c'", static_cast<char>(in[-1]));
+                break;
+            }
         }
+
+        return static_cast<std::size_t>(outPtr - out);
     }
 
-    if (i != 0)
+    /*
+     * Flush the bytes of an unpadded or incomplete last group into @a out, which must hold 2 bytes.
+     * Returns the number of bytes written, the decoder is then ready for new input.
+     */
+    std::size_t finish(uint8_t* const out) noexcept
     {
-        for (j=0; j<i && j<4; ++j)
-            charArray4[j] = CarlaBase64Helpers::findBase64CharIndex(static_cast<char>(charArray4[j]));
+        CARLA_SAFE_ASSERT_RETURN(out != nullptr || fCount < 2, 0);
 
-        for (j=i; j<4; ++j)
-            charArray4[j] = 0;
+        std::size_t written = 0;
 
-        charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-        charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-        charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+        switch (fCount)
+        {
+        case 2:
+            out[0] = static_cast<uint8_t>(fBits >> 4);
+            written = 1;
+            break;
+        case 3:
+            out[0] = static_cast<uint8_t>(fBits >> 10);
+            out[1] = static_cast<uint8_t>(fBits >> 2);
+            written = 2;
+            break;
+        }
 
-        for (j=0; i>0 && j<i-1; j++)
-            ret.push_back(static_cast<uint8_t>(charArray3[j]));
+        fBits  = 0;
+        fCount = 0;
+        fDone  = false;
+        return written;
     }
 
+private:
+    uint32_t fBits;
+    uint     fCount;
+    bool     fDone;
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaBase64Decoder)
+};
+
+/*
+ * Decode @a size characters into @a out, which must hold carla_base64_decoded_max_size(size) bytes.
+ * Returns the number of bytes written.
+ */
+static inline
+std::size_t carla_base64_decode(const char* const base64, const std::size_t size, uint8_t* const out) noexcept
+{
+    CarlaBase64Decoder decoder;
+    const std::size_t written = decoder.decode(base64, size, out);
+    return written + decoder.finish(out + written);
+}
+
+// -----------------------------------------------------------------------
+
+static inline
+std::vector<uint8_t> carla_getChunkFromBase64String(const char* const base64string, const std::size_t size)
+{
+    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr, std::vector<uint8_t>());
+
+    std::vector<uint8_t> ret(carla_base64_decoded_max_size(size));
+    ret.resize(carla_base64_decode(base64string, size, ret.data()));
     return ret;
 }
 
+static inline
+std::vector<uint8_t> carla_getChunkFromBase64String(const char* const base64string)
+{
+    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr, std::vector<uint8_t>());
+
+    return carla_getChunkFromBase64String(base64string, std::strlen(base64string));
+}
+
 // -----------------------------------------------------------------------
 
 #endif // CARLA_BASE64_UTILS_HPP_INCLUDED
@@ -0,0 +1,370 @@
+/*
+ * Carla Binary Project utils
+ * Copyright (C) 2012-2017 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBinaryProjectUtils.hpp"
+
+#include "CarlaBase64Utils.hpp"
+
+using juce::ByteOrder;
+using juce::File;
+using juce::FileOutputStream;
+using juce::MemoryMappedFile;
+using juce::MemoryOutputStream;
+using juce::ScopedPointer;
+using juce::String;
+using juce::TemporaryFile;
+using juce::XmlDocument;
+using juce::XmlElement;
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static const char kFileMagic[8]    = { 'C','A','R','L','A','B','P','\0' };
+static const char kTrailerMagic[8] = { 'C','A','R','L','A','B','P','E' };
+
+static const uint32_t kFileVersion = 1;
+
+static const uint32_t kHeaderSize       = 16;
+static const uint32_t kRecordHeaderSize = 16;
+static const uint32_t kIndexEntrySize   = 24;
+static const uint32_t kTrailerSize      = 16;
+static const uint32_t kRecordAlignment  = 16;
+
+static const uint32_t kNoOwner = 0xffffffff;
+
+enum RecordType {
+    kRecordProject     = 1,
+    kRecordPluginState = 2,
+    kRecordPluginChunk = 3,
+    kRecordIndex       = 4
+};
+
+// -----------------------------------------------------------------------
+// CarlaBinaryProjectWriter
+
+CarlaBinaryProjectWriter::CarlaBinaryProjectWriter(juce::OutputStream& stream)
+    : fStream(stream),
+      fIndex(),
+      fOk(true)
+{
+    fOk = fStream.write(kFileMagic, sizeof(kFileMagic))
+       && fStream.writeInt(static_cast<int>(kFileVersion))
+       && fStream.writeInt(0);
+}
+
+uint32_t CarlaBinaryProjectWriter::writePluginState(const CarlaStateSave& stateSave)
+{
+    MemoryOutputStream xml;
+    xml << " <Plugin>\n";
+    stateSave.dumpToMemoryStream(xml, false);
+    xml << " </Plugin>\n";
+
+    const uint32_t record = writeRecord(kRecordPluginState, kNoOwner, xml.getData(), xml.getDataSize());
+
+    if (stateSave.rawChunk != nullptr && stateSave.rawChunkSize > 0)
+    {
+        writeRecord(kRecordPluginChunk, record, stateSave.rawChunk, stateSave.rawChunkSize);
+    }
+    else if (stateSave.chunk != nullptr && stateSave.chunk[0] != '\0')
+    {
+        const std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateSave.chunk));
+        writeRecord(kRecordPluginChunk, record, chunk.data(), chunk.size());
+    }
+
+    return record;
+}
+
+void CarlaBinaryProjectWriter::writeProject(const MemoryOutputStream& xml)
+{
+    writeRecord(kRecordProject, kNoOwner, xml.getData(), xml.getDataSize());
+}
+
+bool CarlaBinaryProjectWriter::finish()
+{
+    MemoryOutputStream index(fIndex.size() * kIndexEntrySize);
+
+    for (std::vector<IndexEntry>::const_iterator it = fIndex.begin(); it != fIndex.end(); ++it)
+    {
+        index.writeInt(static_cast<int>(it->type));
+        index.writeInt(static_cast<int>(it->owner));
+        index.writeInt64(static_cast<juce::int64>(it->offset));
+        index.writeInt64(static_cast<juce::int64>(it->size));
+    }
+
+    writeRecord(kRecordIndex, kNoOwner, index.getData(), index.getDataSize());
+
+    fOk = fOk
+       && fStream.writeInt64(static_cast<juce::int64>(fIndex.back().offset))
+       && fStream.write(kTrailerMagic, sizeof(kTrailerMagic));
+
+    fStream.flush();
+    return fOk;
+}
+
+uint32_t CarlaBinaryProjectWriter::writeRecord(const uint32_t type, const uint32_t owner,
+                                               const void* const data, const std::size_t size)
+{
+    const uint32_t record = static_cast<uint32_t>(fIndex.size());
+
+    fOk = fOk
+       && fStream.writeInt(static_cast<int>(type))
+       && fStream.writeInt(static_cast<int>(owner))
+       && fStream.writeInt64(static_cast<juce::int64>(size));
+
+    const IndexEntry entry = { type, owner, static_cast<uint64_t>(fStream.getPosition()), size };
+    fIndex.push_back(entry);
+
+    if (size > 0)
+        fOk = fOk && fStream.write(data, size);
+
+    // keep records aligned, so mapped chunks can be used in place
+    if (const std::size_t padding = (kRecordAlignment - size % kRecordAlignment) % kRecordAlignment)
+        fOk = fOk && fStream.writeRepeatedByte(0, padding);
+
+    return record;
+}
+
+// -----------------------------------------------------------------------
+// CarlaBinaryProjectReader
+
+CarlaBinaryProjectReader::CarlaBinaryProjectReader(const File& file)
+    : fFile(new MemoryMappedFile(file, MemoryMappedFile::readOnly)),
+      fData(nullptr),
+      fSize(0),
+      fIndex(nullptr),
+      fIndexCount(0)
+{
+    const uint8_t* const data = static_cast<const uint8_t*>(fFile->getData());
+    const uint64_t size = fFile->getSize();
+
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(size >= kHeaderSize + kRecordHeaderSize + kTrailerSize,);
+    CARLA_SAFE_ASSERT_RETURN(std::memcmp(data, kFileMagic, sizeof(kFileMagic)) == 0,);
+    CARLA_SAFE_ASSERT_RETURN(ByteOrder::littleEndianInt(data + 8) == kFileVersion,);
+
+    const uint8_t* const trailer = data + size - kTrailerSize;
+    CARLA_SAFE_ASSERT_RETURN(std::memcmp(trailer + 8, kTrailerMagic, sizeof(kTrailerMagic)) == 0,);
+
+    const uint64_t indexOffset = ByteOrder::littleEndianInt64(trailer);
+    CARLA_SAFE_ASSERT_RETURN(indexOffset >= kHeaderSize + kRecordHeaderSize && indexOffset <= size - kTrailerSize,);
+
+    const uint8_t* const indexHeader = data + indexOffset - kRecordHeaderSize;
+    const uint64_t indexSize = ByteOrder::littleEndianInt64(indexHeader + 8);
+    CARLA_SAFE_ASSERT_RETURN(ByteOrder::littleEndianInt(indexHeader) == kRecordIndex,);
+    CARLA_SAFE_ASSERT_RETURN(indexSize % kIndexEntrySize == 0 && indexSize <= size - kTrailerSize - indexOffset,);
+
+    fData       = data;
+    fSize       = size;
+    fIndex      = data + indexOffset;
+    fIndexCount = static_cast<uint32_t>(indexSize / kIndexEntrySize);
+}
+
+bool CarlaBinaryProjectReader::isValid() const noexcept
+{
+    return fIndex != nullptr;
+}
+
+bool CarlaBinaryProjectReader::isBinaryProject(const File& file)
+{
+    ScopedPointer<juce::FileInputStream> stream(file.createInputStream());
+
+    if (stream == nullptr)
+        return false;
+
+    char magic[sizeof(kFileMagic)];
+    return stream->read(magic, sizeof(magic)) == sizeof(magic) && std::memcmp(magic, kFileMagic, sizeof(magic)) == 0;
+}
+
+String CarlaBinaryProjectReader::getProjectXml() const
+{
+    for (uint32_t i=0; i < fIndexCount; ++i)
+    {
+        std::size_t size;
+
+        if (const uint8_t* const data = getRecord(i, kRecordProject, size))
+            return String::fromUTF8(reinterpret_cast<const char*>(data), static_cast<int>(size));
+    }
+
+    return String();
+}
+
+bool CarlaBinaryProjectReader::fillStateSave(CarlaStateSave& stateSave, const XmlElement* const xmlElement) const
+{
+    CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, false);
+
+    if (! xmlElement->hasAttribute("Record"))
+        return stateSave.fillFromXmlElement(xmlElement);
+
+    const int record = xmlElement->getIntAttribute("Record", -1);
+    CARLA_SAFE_ASSERT_RETURN(record >= 0, false);
+
+    std::size_t size;
+    const uint8_t* const data = getRecord(static_cast<uint32_t>(record), kRecordPluginState, size);
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+    XmlDocument xml(String::fromUTF8(reinterpret_cast<const char*>(data), static_cast<int>(size)));
+    ScopedPointer<XmlElement> pluginElement(xml.getDocumentElement());
+    CARLA_SAFE_ASSERT_RETURN(pluginElement != nullptr, false);
+
+    if (! stateSave.fillFromXmlElement(pluginElement))
+        return false;
+
+    std::size_t chunkSize;
+
+    if (const uint8_t* const chunk = getOwnedRecord(static_cast<uint32_t>(record), kRecordPluginChunk, chunkSize))
+    {
+        stateSave.rawChunk     = chunk;
+        stateSave.rawChunkSize = chunkSize;
+    }
+
+    return true;
+}
+
+const uint8_t* CarlaBinaryProjectReader::getRecord(const uint32_t record, const uint32_t type, std::size_t& size) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(record < fIndexCount, nullptr);
+
+    const uint8_t* const entry = fIndex + record * kIndexEntrySize;
+
+    if (ByteOrder::littleEndianInt(entry) != type)
+        return nullptr;
+
+    const uint64_t offset = ByteOrder::littleEndianInt64(entry + 8);
+    const uint64_t length = ByteOrder::littleEndianInt64(entry + 16);
+    CARLA_SAFE_ASSERT_RETURN(offset <= fSize && length <= fSize - offset, nullptr);
+
+    size = static_cast<std::size_t>(length);
+    return fData + offset;
+}
+
+const uint8_t* CarlaBinaryProjectReader::getOwnedRecord(const uint32_t owner, const uint32_t type, std::size_t& size) const noexcept
+{
+    // records are written right after their owner
+    for (uint32_t i=owner+1; i < fIndexCount; ++i)
+    {
+        const uint8_t* const entry = fIndex + i * kIndexEntrySize;
+
+        if (ByteOrder::littleEndianInt(entry + 4) != owner)
+            break;
+        if (ByteOrder::littleEndianInt(entry) == type)
+            return getRecord(i, type, size);
+    }
+
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------
+// Converters
+
+static void writeProjectHeader(juce::OutputStream& stream, const XmlElement* const projectElement)
+{
+    stream << "<?xml version='1.0' encoding='UTF-8'?>\n";
+    stream << "<!DOCTYPE CARLA-PROJECT>\n";
+    stream << "<CARLA-PROJECT VERSION='" << projectElement->getStringAttribute("VERSION", "2.0") << "'>\n";
+}
+
+bool carla_convert_project_to_binary(const File& xmlFile, const File& binaryFile)
+{
+    XmlDocument xml(xmlFile);
+    ScopedPointer<XmlElement> projectElement(xml.getDocumentElement());
+    CARLA_SAFE_ASSERT_RETURN(projectElement != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(projectElement->getTagName().equalsIgnoreCase("carla-project"), false);
+
+    TemporaryFile tempFile(binaryFile);
+
+    {
+        ScopedPointer<FileOutputStream> stream(tempFile.getFile().createOutputStream());
+        CARLA_SAFE_ASSERT_RETURN(stream != nullptr && stream->openedOk(), false);
+
+        CarlaBinaryProjectWriter writer(*stream);
+        MemoryOutputStream project;
+        writeProjectHeader(project, projectElement);
+
+        for (XmlElement* elem = projectElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+        {
+            if (elem->getTagName().equalsIgnoreCase("plugin"))
+            {
+                CarlaStateSave stateSave;
+                stateSave.fillFromXmlElement(elem);
+
+                project << "\n <Plugin Record='" << String(writer.writePluginState(stateSave)) << "'/>\n";
+            }
+            else
+            {
+                project << "\n" << elem->createDocument(String(), false, false) << "\n";
+            }
+        }
+
+        project << "</CARLA-PROJECT>\n";
+        writer.writeProject(project);
+
+        if (! writer.finish() || stream->getStatus().failed())
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+bool carla_convert_project_to_xml(const File& binaryFile, const File& xmlFile)
+{
+    const CarlaBinaryProjectReader reader(binaryFile);
+    CARLA_SAFE_ASSERT_RETURN(reader.isValid(), false);
+
+    XmlDocument xml(reader.getProjectXml());
+    ScopedPointer<XmlElement> projectElement(xml.getDocumentElement());
+    CARLA_SAFE_ASSERT_RETURN(projectElement != nullptr, false);
+
+    TemporaryFile tempFile(xmlFile);
+
+    {
+        ScopedPointer<FileOutputStream> stream(tempFile.getFile().createOutputStream());
+        CARLA_SAFE_ASSERT_RETURN(stream != nullptr && stream->openedOk(), false);
+
+        writeProjectHeader(*stream, projectElement);
+
+        for (XmlElement* elem = projectElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+        {
+            if (elem->getTagName().equalsIgnoreCase("plugin"))
+            {
+                CarlaStateSave stateSave;
+                CARLA_SAFE_ASSERT_CONTINUE(reader.fillStateSave(stateSave, elem));
+
+                MemoryOutputStream streamPlugin;
+                stateSave.dumpToMemoryStream(streamPlugin);
+
+                *stream << "\n <Plugin>\n" << streamPlugin << " </Plugin>\n";
+            }
+            else
+            {
+                *stream << "\n" << elem->createDocument(String(), false, false) << "\n";
+            }
+        }
+
+        *stream << "</CARLA-PROJECT>\n";
+        stream->flush();
+
+        if (stream->getStatus().failed())
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
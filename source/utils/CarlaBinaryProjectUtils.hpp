@@ -0,0 +1,138 @@
+/*
+ * Carla Binary Project utils
+ * Copyright (C) 2012-2017 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_BINARY_PROJECT_UTILS_HPP_INCLUDED
+#define CARLA_BINARY_PROJECT_UTILS_HPP_INCLUDED
+
+#include "CarlaStateUtils.hpp"
+
+#include <vector>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Binary project files (.carbp)
+//
+// Same contents as a .carxp project, but each plugin state is stored as its own record
+// and plugin chunks are kept as raw data instead of base64 text inside the XML.
+//
+// Layout, all integers are little endian:
+//  - file header:  "CARLABP" magic (8 bytes), uint32 version, uint32 reserved
+//  - records:      uint32 type, uint32 owner, uint64 size, then the data padded to 16 bytes
+//  - index record: one entry per record (uint32 type, uint32 owner, uint64 offset, uint64 size)
+//  - trailer:      uint64 index offset, "CARLABPE" magic (8 bytes)
+//
+// The project record is the usual project document, with every plugin replaced by
+// a <Plugin Record='N'/> reference to a plugin state record. A plugin state record holds
+// the same XML as a plugin in a .carxp project, minus its chunk, which follows in a chunk
+// record owned by it. Records are written as they come, the index goes last, so
+// projects can be streamed to disk one plugin at a time.
+
+// -----------------------------------------------------------------------
+
+class CarlaBinaryProjectWriter
+{
+public:
+    CarlaBinaryProjectWriter(juce::OutputStream& stream);
+
+    /*!
+     * Write a plugin state and its chunk, returning the record to reference from the project document.
+     * Base64 chunks are stored decoded.
+     */
+    uint32_t writePluginState(const CarlaStateSave& stateSave);
+
+    /*!
+     * Write the project document, once.
+     */
+    void writeProject(const juce::MemoryOutputStream& xml);
+
+    /*!
+     * Write the index, completing the file.
+     * Returns false if anything failed to be written.
+     */
+    bool finish();
+
+private:
+    struct IndexEntry {
+        uint32_t type;
+        uint32_t owner;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    juce::OutputStream& fStream;
+    std::vector<IndexEntry> fIndex;
+    bool fOk;
+
+    uint32_t writeRecord(const uint32_t type, const uint32_t owner, const void* const data, const std::size_t size);
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaBinaryProjectWriter)
+};
+
+// -----------------------------------------------------------------------
+
+class CarlaBinaryProjectReader
+{
+public:
+    /*!
+     * Map a binary project file, records are only decoded when requested.
+     */
+    CarlaBinaryProjectReader(const juce::File& file);
+
+    bool isValid() const noexcept;
+
+    /*!
+     * Quick check for the file magic.
+     */
+    static bool isBinaryProject(const juce::File& file);
+
+    /*!
+     * The project document, plugins are references to their state records.
+     */
+    juce::String getProjectXml() const;
+
+    /*!
+     * Fill @a stateSave from a plugin element of the project document.
+     * Raw chunks point into the mapped file, valid for the lifetime of this reader.
+     * Elements without a record reference are read as regular XML.
+     */
+    bool fillStateSave(CarlaStateSave& stateSave, const juce::XmlElement* const xmlElement) const;
+
+private:
+    juce::ScopedPointer<juce::MemoryMappedFile> fFile;
+    const uint8_t* fData;
+    uint64_t       fSize;
+    const uint8_t* fIndex;
+    uint32_t       fIndexCount;
+
+    const uint8_t* getRecord(const uint32_t record, const uint32_t type, std::size_t& size) const noexcept;
+    const uint8_t* getOwnedRecord(const uint32_t owner, const uint32_t type, std::size_t& size) const noexcept;
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaBinaryProjectReader)
+};
+
+// -----------------------------------------------------------------------
+// Converters between .carxp and .carbp projects
+
+bool carla_convert_project_to_binary(const juce::File& xmlFile, const juce::File& binaryFile);
+bool carla_convert_project_to_xml(const juce::File& binaryFile, const juce::File& xmlFile);
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_BINARY_PROJECT_UTILS_HPP_INCLUDED
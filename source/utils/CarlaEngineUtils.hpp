@@ -19,6 +19,7 @@
 #define CARLA_ENGINE_UTILS_HPP_INCLUDED
 
 #include "CarlaEngine.hpp"
+#include "CarlaRtLogUtils.hpp"
 #include "CarlaUtils.hpp"
 
 #include "CarlaMIDI.h"
@@ -205,6 +206,77 @@ void fillJuceMidiBufferFromEngineEvents(juce::MidiBuffer& midiBuffer, const Engi
     }
 }
 
+// -----------------------------------------------------------------------
+// Re-blocking of engine events, for plugins running at a bigger internal block size
+
+/*
+ * Move the engine events of the chunk [offset, offset+count) into a block, at the matching position.
+ * Later events are left for the next chunk, unless this is the last chunk of the engine cycle.
+ */
+static inline
+void reblockEngineEventsIn(EngineEvent blockEvents[kMaxEngineEventInternalCount], uint32_t& blockEventCount, const uint32_t position,
+                           const EngineEvent engineEvents[kMaxEngineEventInternalCount], uint32_t& engineEventIndex,
+                           const uint32_t offset, const uint32_t count, const bool lastChunk) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(count > 0,);
+
+    for (; engineEventIndex < kMaxEngineEventInternalCount; ++engineEventIndex)
+    {
+        const EngineEvent& engineEvent(engineEvents[engineEventIndex]);
+
+        if (engineEvent.type == kEngineEventTypeNull)
+            break;
+        if (engineEvent.time >= offset + count && ! lastChunk)
+            break;
+        if (blockEventCount >= kMaxEngineEventInternalCount)
+            continue;
+
+        EngineEvent& event(blockEvents[blockEventCount++]);
+        event      = engineEvent;
+        event.time = position + std::min(engineEvent.time > offset ? engineEvent.time - offset : 0U, count - 1);
+    }
+}
+
+/*
+ * Move the block events of [position, position+count) back into the engine buffer, starting at offset.
+ */
+static inline
+void deblockEngineEventsOut(EngineEvent engineEvents[kMaxEngineEventInternalCount], uint32_t& engineEventIndex, const uint32_t offset,
+                            const EngineEvent blockEvents[kMaxEngineEventInternalCount], uint32_t& blockEventIndex,
+                            const uint32_t position, const uint32_t count) noexcept
+{
+    for (; blockEventIndex < kMaxEngineEventInternalCount; ++blockEventIndex)
+    {
+        const EngineEvent& event(blockEvents[blockEventIndex]);
+
+        if (event.type == kEngineEventTypeNull)
+            break;
+        if (event.time >= position + count)
+            break;
+        if (engineEventIndex >= kMaxEngineEventInternalCount)
+            continue;
+
+        EngineEvent& engineEvent(engineEvents[engineEventIndex++]);
+        engineEvent      = event;
+        engineEvent.time = offset + (event.time > position ? event.time - position : 0U);
+    }
+}
+
+/*
+ * Keep the events of a block that could not be processed, moved to the start of the next block.
+ * Returns the number of events kept, new events are to be appended after them.
+ */
+static inline
+uint32_t carryReblockedEngineEvents(EngineEvent blockEvents[kMaxEngineEventInternalCount], const uint32_t blockEventCount) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(blockEventCount <= kMaxEngineEventInternalCount, 0);
+
+    for (uint32_t i=0; i < blockEventCount; ++i)
+        blockEvents[i].time = 0;
+
+    return blockEventCount;
+}
+
 // -------------------------------------------------------------------
 // Helper classes
 
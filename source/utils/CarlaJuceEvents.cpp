@@ -16,6 +16,7 @@
  */
 
 #include "CarlaJuceUtils.hpp"
+#include "CarlaSemUtils.hpp"
 
 // -------------------------------------------------------------------------------------------------------------------
 
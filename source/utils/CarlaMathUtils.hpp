@@ -23,6 +23,10 @@
 #include <cmath>
 #include <limits>
 
+#ifdef __SSE2_MATH__
+# include <xmmintrin.h>
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // math functions (base)
 
@@ -200,6 +204,112 @@ void carla_zeroFloats(float floats[], const std::size_t count) noexcept
     std::memset(floats, 0, count*sizeof(float));
 }
 
+/*
+ * Crossfade a float array into another, with the gain of 'dest' going from 'gain' by 'step' every frame.
+ * dest = dest * gain + src * (1 - gain)
+ */
+static inline
+void carla_crossfadeFloatsWithRamp(float dest[], const float src[], const std::size_t count,
+                                   const float gain, const float step) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+
+    std::size_t i=0;
+
+#ifdef __SSE2_MATH__
+    __m128 g = _mm_set_ps(gain+step*3.0f, gain+step*2.0f, gain+step, gain);
+    const __m128 gStep = _mm_set1_ps(step*4.0f);
+
+    for (; i+4 <= count; i += 4)
+    {
+        const __m128 d = _mm_loadu_ps(dest+i);
+        const __m128 s = _mm_loadu_ps(src+i);
+        _mm_storeu_ps(dest+i, _mm_add_ps(s, _mm_mul_ps(_mm_sub_ps(d, s), g)));
+        g = _mm_add_ps(g, gStep);
+    }
+#endif
+
+    for (; i<count; ++i)
+        dest[i] = src[i] + (dest[i] - src[i]) * (gain + step * static_cast<float>(i));
+}
+
+/*
+ * Multiply a float array into another, with the gain going from 'gain' by 'step' every frame.
+ * 'dest' and 'src' can be the same array.
+ */
+static inline
+void carla_multiplyFloatsWithRamp(float dest[], const float src[], const std::size_t count,
+                                  const float gain, const float step) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+
+    std::size_t i=0;
+
+#ifdef __SSE2_MATH__
+    __m128 g = _mm_set_ps(gain+step*3.0f, gain+step*2.0f, gain+step, gain);
+    const __m128 gStep = _mm_set1_ps(step*4.0f);
+
+    for (; i+4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dest+i, _mm_mul_ps(_mm_loadu_ps(src+i), g));
+        g = _mm_add_ps(g, gStep);
+    }
+#endif
+
+    for (; i<count; ++i)
+        dest[i] = src[i] * (gain + step * static_cast<float>(i));
+}
+
+/*
+ * Mix a pair of float arrays through a 2x2 gain matrix, each gain going from 'gains' by 'steps' every frame.
+ * destL = srcL * gains[0] + srcR * gains[1]
+ * destR = srcL * gains[2] + srcR * gains[3]
+ * The destination arrays can be the same as the sources.
+ */
+static inline
+void carla_mixFloatPairWithRamp(float destL[], float destR[], const float srcL[], const float srcR[],
+                                const std::size_t count, const float gains[4], const float steps[4]) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(destL != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(destR != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(srcL != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(srcR != nullptr,);
+
+    std::size_t i=0;
+
+#ifdef __SSE2_MATH__
+    __m128 g[4], gStep[4];
+
+    for (int j=0; j<4; ++j)
+    {
+        g[j]     = _mm_set_ps(gains[j]+steps[j]*3.0f, gains[j]+steps[j]*2.0f, gains[j]+steps[j], gains[j]);
+        gStep[j] = _mm_set1_ps(steps[j]*4.0f);
+    }
+
+    for (; i+4 <= count; i += 4)
+    {
+        const __m128 l = _mm_loadu_ps(srcL+i);
+        const __m128 r = _mm_loadu_ps(srcR+i);
+        _mm_storeu_ps(destL+i, _mm_add_ps(_mm_mul_ps(l, g[0]), _mm_mul_ps(r, g[1])));
+        _mm_storeu_ps(destR+i, _mm_add_ps(_mm_mul_ps(l, g[2]), _mm_mul_ps(r, g[3])));
+
+        for (int j=0; j<4; ++j)
+            g[j] = _mm_add_ps(g[j], gStep[j]);
+    }
+#endif
+
+    for (; i<count; ++i)
+    {
+        const float frame = static_cast<float>(i);
+        const float l = srcL[i];
+        const float r = srcR[i];
+        destL[i] = l * (gains[0] + steps[0] * frame) + r * (gains[1] + steps[1] * frame);
+        destR[i] = l * (gains[2] + steps[2] * frame) + r * (gains[3] + steps[3] * frame);
+    }
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // Missing functions in old OSX versions.
 
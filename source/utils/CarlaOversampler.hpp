@@ -0,0 +1,387 @@
+/*
+ * Carla Oversampler
+ * Copyright (C) 2011-2017 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_OVERSAMPLER_HPP_INCLUDED
+#define CARLA_OVERSAMPLER_HPP_INCLUDED
+
+#include "CarlaMathUtils.hpp"
+
+// -----------------------------------------------------------------------
+// Half-band FIR filter, for changing the sample rate by 2.
+//
+// Linear phase, windowed sinc with 4*K-1 taps. Every other tap is zero except the center one (0.5),
+// so each direction only needs 2*K multiplications per low rate sample, done in polyphase form.
+// Delay is 2*K-1 samples at the high rate.
+
+class CarlaHalfBandFilter
+{
+public:
+    CarlaHalfBandFilter() noexcept
+        : fTapCount(0),
+          fTaps(nullptr),
+          fMaxFrames(0),
+          fBuffer(nullptr),
+          fOddBuffer(nullptr) {}
+
+    ~CarlaHalfBandFilter() noexcept
+    {
+        clear();
+    }
+
+    // non-RT, 'maxFrames' is the maximum number of low rate frames per call
+    void setup(const uint32_t k, const uint32_t maxFrames)
+    {
+        CARLA_SAFE_ASSERT_RETURN(k > 0,);
+        CARLA_SAFE_ASSERT_RETURN(maxFrames > 0,);
+
+        clear();
+
+        fTapCount  = 2*k;
+        fTaps      = new float[fTapCount];
+        fMaxFrames = maxFrames;
+        fBuffer    = new float[fTapCount + maxFrames];
+        fOddBuffer = new float[k + maxFrames];
+
+        // h[n] = 0.5 * sinc(n/2) * blackman-harris window, for the odd n taps only
+        const uint32_t length(4*k - 1);
+        const double center(static_cast<double>(2*k - 1));
+        double sum = 0.0;
+
+        for (uint32_t i=0; i < fTapCount; ++i)
+        {
+            const double n(static_cast<double>(2*i) - center);
+            const double x(M_PI * n / 2.0);
+            const double w(2.0 * M_PI * static_cast<double>(2*i) / static_cast<double>(length - 1));
+            const double window(0.35875 - 0.48829*std::cos(w) + 0.14128*std::cos(2.0*w) - 0.01168*std::cos(3.0*w));
+
+            const double tap(0.5 * std::sin(x) / x * window);
+            fTaps[i] = static_cast<float>(tap);
+            sum += tap;
+        }
+
+        // the odd taps alone must sum to 0.5 for unity gain at DC
+        for (uint32_t i=0; i < fTapCount; ++i)
+            fTaps[i] = static_cast<float>(fTaps[i] * 0.5 / sum);
+
+        reset();
+    }
+
+    void clear() noexcept
+    {
+        if (fTaps != nullptr)
+        {
+            delete[] fTaps;
+            fTaps = nullptr;
+        }
+
+        if (fBuffer != nullptr)
+        {
+            delete[] fBuffer;
+            fBuffer = nullptr;
+        }
+
+        if (fOddBuffer != nullptr)
+        {
+            delete[] fOddBuffer;
+            fOddBuffer = nullptr;
+        }
+
+        fTapCount  = 0;
+        fMaxFrames = 0;
+    }
+
+    // RT-safe, forget all past samples
+    void reset() noexcept
+    {
+        if (fBuffer != nullptr)
+            carla_zeroFloats(fBuffer, fTapCount + fMaxFrames);
+        if (fOddBuffer != nullptr)
+            carla_zeroFloats(fOddBuffer, fTapCount/2 + fMaxFrames);
+    }
+
+    // RT-safe, 'frames' low rate samples from 'in' to 2*frames high rate samples in 'out'
+    void upsample(const float* const in, float* const out, const uint32_t frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(frames <= fMaxFrames,);
+
+        const uint32_t history(fTapCount - 1);
+        const uint32_t k(fTapCount/2);
+
+        // buffer holds the last 'history' input samples, followed by the new ones
+        carla_copyFloats(fBuffer + history, in, frames);
+
+        for (uint32_t i=0; i < frames; ++i)
+        {
+            const float* const x(fBuffer + i + history);
+            float sum = 0.0f;
+
+            for (uint32_t j=0; j < fTapCount; ++j)
+                sum += fTaps[j] * x[-static_cast<int32_t>(j)];
+
+            out[2*i]   = 2.0f * sum;
+            out[2*i+1] = x[-static_cast<int32_t>(k - 1)];
+        }
+
+        std::memmove(fBuffer, fBuffer + frames, sizeof(float)*history);
+    }
+
+    // RT-safe, 2*frames high rate samples from 'in' to 'frames' low rate samples in 'out'
+    void downsample(const float* const in, float* const out, const uint32_t frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(frames <= fMaxFrames,);
+
+        const uint32_t history(fTapCount - 1);
+        const uint32_t k(fTapCount/2);
+
+        // even samples go through the FIR taps, odd ones through the center tap only
+        for (uint32_t i=0; i < frames; ++i)
+        {
+            fBuffer[history + i] = in[2*i];
+            fOddBuffer[k + i]    = in[2*i+1];
+        }
+
+        for (uint32_t i=0; i < frames; ++i)
+        {
+            const float* const x(fBuffer + i + history);
+            float sum = 0.0f;
+
+            for (uint32_t j=0; j < fTapCount; ++j)
+                sum += fTaps[j] * x[-static_cast<int32_t>(j)];
+
+            out[i] = sum + 0.5f * fOddBuffer[i];
+        }
+
+        std::memmove(fBuffer, fBuffer + frames, sizeof(float)*history);
+        std::memmove(fOddBuffer, fOddBuffer + frames, sizeof(float)*k);
+    }
+
+    // delay in high rate samples, of each direction
+    uint32_t getDelay() const noexcept
+    {
+        return fTapCount - 1;
+    }
+
+private:
+    uint32_t fTapCount; // non-zero taps, besides the center one
+    float*   fTaps;
+    uint32_t fMaxFrames;
+    float*   fBuffer;    // history and new samples for the FIR taps
+    float*   fOddBuffer; // history and new odd samples for the center tap (downsampling only)
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaHalfBandFilter)
+};
+
+// -----------------------------------------------------------------------
+// Multi-channel 2x, 4x or 8x oversampler, made of cascaded half-band filters.
+//
+// The round-trip delay is padded to a whole number of low rate frames, see getLatency().
+
+class CarlaOversampler
+{
+public:
+    static const uint32_t kMaxStages = 3;
+
+    CarlaOversampler() noexcept
+        : fFactor(1),
+          fStageCount(0),
+          fChannelsIn(0),
+          fChannelsOut(0),
+          fMaxFrames(0),
+          fLatency(0),
+          fPadding(0),
+          fUp(nullptr),
+          fDown(nullptr),
+          fPadBuffers(nullptr),
+          fTmpBuffer(nullptr) {}
+
+    ~CarlaOversampler() noexcept
+    {
+        clear();
+    }
+
+    // non-RT, 'factor' must be 2, 4 or 8. 'maxFrames' is the maximum number of low rate frames per call
+    void setup(const uint32_t factor, const uint32_t channelsIn, const uint32_t channelsOut, const uint32_t maxFrames)
+    {
+        CARLA_SAFE_ASSERT_RETURN(factor == 2 || factor == 4 || factor == 8,);
+        CARLA_SAFE_ASSERT_RETURN(maxFrames > 0,);
+
+        clear();
+
+        fFactor      = factor;
+        fStageCount  = (factor == 2) ? 1 : (factor == 4) ? 2 : 3;
+        fChannelsIn  = channelsIn;
+        fChannelsOut = channelsOut;
+        fMaxFrames   = maxFrames;
+
+        // the first stage has the narrowest transition band, the next ones have more room to spare
+        static const uint32_t kStageK[kMaxStages] = { 12, 6, 4 };
+
+        // total round-trip delay in high rate samples, each stage counted twice (up and down)
+        uint32_t delay = 0;
+
+        if (fChannelsIn > 0)
+        {
+            fUp = new CarlaHalfBandFilter[fChannelsIn*fStageCount];
+            fPadBuffers = new float*[fChannelsIn];
+        }
+        if (fChannelsOut > 0)
+            fDown = new CarlaHalfBandFilter[fChannelsOut*fStageCount];
+
+        for (uint32_t s=0; s < fStageCount; ++s)
+        {
+            const uint32_t stageFrames(maxFrames << s);
+
+            for (uint32_t c=0; c < fChannelsIn; ++c)
+                fUp[c*fStageCount + s].setup(kStageK[s], stageFrames);
+            for (uint32_t c=0; c < fChannelsOut; ++c)
+                fDown[c*fStageCount + s].setup(kStageK[s], stageFrames);
+
+            delay += 2 * (2*kStageK[s] - 1) << (fStageCount - s - 1);
+        }
+
+        fPadding = (factor - delay % factor) % factor;
+        fLatency = (delay + fPadding) / factor;
+
+        for (uint32_t c=0; c < fChannelsIn; ++c)
+        {
+            fPadBuffers[c] = new float[fPadding + maxFrames*factor];
+            carla_zeroFloats(fPadBuffers[c], fPadding + maxFrames*factor);
+        }
+
+        fTmpBuffer = new float[maxFrames*factor];
+    }
+
+    void clear() noexcept
+    {
+        if (fUp != nullptr)
+        {
+            delete[] fUp;
+            fUp = nullptr;
+        }
+
+        if (fDown != nullptr)
+        {
+            delete[] fDown;
+            fDown = nullptr;
+        }
+
+        if (fPadBuffers != nullptr)
+        {
+            for (uint32_t c=0; c < fChannelsIn; ++c)
+                delete[] fPadBuffers[c];
+
+            delete[] fPadBuffers;
+            fPadBuffers = nullptr;
+        }
+
+        if (fTmpBuffer != nullptr)
+        {
+            delete[] fTmpBuffer;
+            fTmpBuffer = nullptr;
+        }
+
+        fFactor      = 1;
+        fStageCount  = 0;
+        fChannelsIn  = 0;
+        fChannelsOut = 0;
+        fMaxFrames   = 0;
+        fLatency     = 0;
+        fPadding     = 0;
+    }
+
+    // RT-safe, forget all past samples
+    void reset() noexcept
+    {
+        for (uint32_t i=0, count=fChannelsIn*fStageCount; i < count; ++i)
+            fUp[i].reset();
+        for (uint32_t i=0, count=fChannelsOut*fStageCount; i < count; ++i)
+            fDown[i].reset();
+        for (uint32_t c=0; c < fChannelsIn; ++c)
+            carla_zeroFloats(fPadBuffers[c], fPadding + fMaxFrames*fFactor);
+    }
+
+    // RT-safe, 'frames' low rate samples of input 'channel' to frames*factor high rate samples in 'out'
+    void upsample(const uint32_t channel, const float* const in, float* const out, const uint32_t frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(channel < fChannelsIn,);
+        CARLA_SAFE_ASSERT_RETURN(frames <= fMaxFrames,);
+
+        // each stage doubles the data, alternate between the buffers so the last stage writes into the padding buffer
+        float* const padBuffer(fPadBuffers[channel]);
+        const float* src = in;
+
+        for (uint32_t s=0; s < fStageCount; ++s)
+        {
+            float* const dst(((fStageCount - s) % 2 == 1) ? padBuffer + fPadding : fTmpBuffer);
+            fUp[channel*fStageCount + s].upsample(src, dst, frames << s);
+            src = dst;
+        }
+
+        const uint32_t highFrames(frames*fFactor);
+
+        carla_copyFloats(out, padBuffer, highFrames);
+        std::memmove(padBuffer, padBuffer + highFrames, sizeof(float)*fPadding);
+    }
+
+    // RT-safe, frames*factor high rate samples from 'in' to 'frames' low rate samples of output 'channel'
+    void downsample(const uint32_t channel, const float* const in, float* const out, const uint32_t frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(channel < fChannelsOut,);
+        CARLA_SAFE_ASSERT_RETURN(frames <= fMaxFrames,);
+
+        const float* src = in;
+
+        for (uint32_t s=fStageCount; s-- > 0;)
+        {
+            // in-place is fine for the middle stages, each filter copies its input before writing
+            float* const dst((s == 0) ? out : fTmpBuffer);
+            fDown[channel*fStageCount + s].downsample(src, dst, frames << s);
+            src = dst;
+        }
+    }
+
+    uint32_t getFactor() const noexcept
+    {
+        return fFactor;
+    }
+
+    // round-trip delay, in low rate frames
+    uint32_t getLatency() const noexcept
+    {
+        return fLatency;
+    }
+
+private:
+    uint32_t fFactor;
+    uint32_t fStageCount;
+    uint32_t fChannelsIn;
+    uint32_t fChannelsOut;
+    uint32_t fMaxFrames;
+    uint32_t fLatency;
+    uint32_t fPadding;  // extra high rate delay to round the latency up to whole low rate frames
+
+    CarlaHalfBandFilter* fUp;   // per input channel, one per stage
+    CarlaHalfBandFilter* fDown; // per output channel, one per stage
+    float** fPadBuffers;        // per input channel, padding delay followed by the upsampled data
+    float*  fTmpBuffer;
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaOversampler)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_OVERSAMPLER_HPP_INCLUDED
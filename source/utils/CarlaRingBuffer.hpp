@@ -19,6 +19,7 @@
 #define CARLA_RING_BUFFER_HPP_INCLUDED
 
 #include "CarlaMathUtils.hpp"
+#include "CarlaRtLogUtils.hpp"
 
 // -----------------------------------------------------------------------
 // Buffer structs
@@ -342,7 +343,7 @@ protected:
             if (! fErrorReading)
             {
                 fErrorReading = true;
-                carla_stderr2("CarlaRingBuffer::tryRead(%p, " P_SIZE "): failed, not enough space", buf, size);
+                carla_rt_stderr2("CarlaRingBuffer::tryRead(%p, " P_SIZE "): failed, not enough space", buf, size);
             }
             return false;
         }
@@ -387,7 +388,7 @@ protected:
             if (! fErrorWriting)
             {
                 fErrorWriting = true;
-                carla_stderr2("CarlaRingBuffer::tryWrite(%p, " P_SIZE "): failed, not enough space", buf, size);
+                carla_rt_stderr2("CarlaRingBuffer::tryWrite(%p, " P_SIZE "): failed, not enough space", buf, size);
             }
             fBuffer->invalidateCommit = true;
             return false;
@@ -0,0 +1,303 @@
+/*
+ * Carla RT-safe logging
+ * Copyright (C) 2011-2017 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_RT_LOG_UTILS_HPP_INCLUDED
+#define CARLA_RT_LOG_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include <cstdarg>
+
+// --------------------------------------------------------------------------------------------------------------------
+// RT-safe replacements for carla_stdout, carla_stderr and carla_stderr2.
+//
+// Messages are formatted into a preallocated lock-free queue, and printed later by a non-RT thread calling
+// CarlaRtLog::flush() (the engine thread does so on every tick).
+// Each call site is rate-limited to one message per kRateLimitFlushes, extra messages only increase a counter
+// that is printed together with the next message of the same call site.
+// When nothing is flushing the queue (no engine running), messages are printed right away.
+//
+// These are macros, as each call site needs its own static state.
+
+#define carla_rt_stdout(...)  CARLA_RT_LOG(CarlaRtLog::kStdout,  __VA_ARGS__)
+#define carla_rt_stderr(...)  CARLA_RT_LOG(CarlaRtLog::kStderr,  __VA_ARGS__)
+#define carla_rt_stderr2(...) CARLA_RT_LOG(CarlaRtLog::kStderr2, __VA_ARGS__)
+
+#define CARLA_RT_LOG(stream, ...)                           \
+    do {                                                    \
+        static CarlaRtLogSite _rtLogSite;                   \
+        CarlaRtLog::log(_rtLogSite, stream, __VA_ARGS__);   \
+    } while (false)
+
+// Per call site state, must be zero-initialized (static storage).
+struct CarlaRtLogSite {
+    const char* fmt;
+    CarlaRtLogSite* next;
+    uint32_t lastFlush;  // flush count when the last message was queued
+    uint32_t suppressed; // messages dropped by the rate limit since then
+    int stream;
+    int state;           // 0: unused, 1: being registered, 2: registered
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class CarlaRtLog
+{
+public:
+    enum Stream {
+        kStdout  = 0,
+        kStderr  = 1,
+        kStderr2 = 2
+    };
+
+    // maximum number of queued messages, must be a power of 2
+    static const uint32_t kQueueSize = 256;
+
+    // maximum message length, longer messages are truncated
+    static const uint32_t kMessageSize = 256;
+
+    // minimum number of flush calls between 2 messages from the same call site
+    static const uint32_t kRateLimitFlushes = 40;
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // RT: queue a message, use the carla_rt_* macros instead of calling this directly
+    static void log(CarlaRtLogSite& site, const Stream stream, const char* const fmt, ...) noexcept
+    {
+        Data& data(getData());
+
+        ::va_list args;
+        ::va_start(args, fmt);
+
+        if (__atomic_load_n(&data.flushers, __ATOMIC_ACQUIRE) == 0)
+        {
+            char msg[kMessageSize];
+            std::vsnprintf(msg, kMessageSize, fmt, args);
+            ::va_end(args);
+
+            print(stream, msg, 0);
+            return;
+        }
+
+        const uint32_t flushCount(__atomic_load_n(&data.flushCount, __ATOMIC_RELAXED));
+
+        int state = 0;
+
+        if (__atomic_compare_exchange_n(&site.state, &state, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            // first message of this call site, make it known to flush()
+            site.fmt    = fmt;
+            site.stream = stream;
+
+            CarlaRtLogSite* next(__atomic_load_n(&data.sites, __ATOMIC_RELAXED));
+            do {
+                site.next = next;
+            } while (! __atomic_compare_exchange_n(&data.sites, &next, &site, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+            __atomic_store_n(&site.state, 2, __ATOMIC_RELEASE);
+        }
+        else if (state != 2 || flushCount - __atomic_load_n(&site.lastFlush, __ATOMIC_RELAXED) < kRateLimitFlushes)
+        {
+            __atomic_add_fetch(&site.suppressed, 1, __ATOMIC_RELAXED);
+            ::va_end(args);
+            return;
+        }
+
+        __atomic_store_n(&site.lastFlush, flushCount, __ATOMIC_RELAXED);
+
+        uint32_t pos;
+        Message* const message(data.reserve(pos));
+
+        if (message == nullptr)
+        {
+            __atomic_add_fetch(&data.lost, 1, __ATOMIC_RELAXED);
+            ::va_end(args);
+            return;
+        }
+
+        message->stream     = stream;
+        message->suppressed = __atomic_exchange_n(&site.suppressed, 0, __ATOMIC_RELAXED);
+        std::vsnprintf(message->text, kMessageSize, fmt, args);
+        ::va_end(args);
+
+        data.commit(message, pos);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // non-RT: print all queued messages, and the count of rate-limited ones not followed by a new message since.
+    // 'allSuppressed' prints the count of rate-limited messages without waiting for a new one
+    static void flush(const bool allSuppressed = false) noexcept
+    {
+        Data& data(getData());
+
+        // only one thread at a time can read from the queue
+        int flushing = 0;
+        if (! __atomic_compare_exchange_n(&data.flushing, &flushing, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return;
+
+        while (const Message* const message = data.peek())
+        {
+            print(static_cast<Stream>(message->stream), message->text, message->suppressed);
+            data.pop(message);
+        }
+
+        if (const uint32_t lost = __atomic_exchange_n(&data.lost, 0, __ATOMIC_RELAXED))
+            carla_stderr2("CarlaRtLog::flush() - queue full, %u messages lost", lost);
+
+        const uint32_t flushCount(__atomic_add_fetch(&data.flushCount, 1, __ATOMIC_RELAXED));
+
+        for (CarlaRtLogSite* site = __atomic_load_n(&data.sites, __ATOMIC_ACQUIRE); site != nullptr; site = site->next)
+        {
+            if (__atomic_load_n(&site->suppressed, __ATOMIC_RELAXED) == 0)
+                continue;
+            if (! allSuppressed && flushCount - __atomic_load_n(&site->lastFlush, __ATOMIC_RELAXED) < kRateLimitFlushes)
+                continue;
+
+            if (const uint32_t suppressed = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED))
+            {
+                char msg[kMessageSize];
+                std::snprintf(msg, kMessageSize, "%u similar messages suppressed: \"%s\"", suppressed, site->fmt);
+                print(static_cast<Stream>(site->stream), msg, 0);
+            }
+        }
+
+        __atomic_store_n(&data.flushing, 0, __ATOMIC_RELEASE);
+    }
+
+    // non-RT: register or unregister a thread that calls flush() regularly.
+    // messages are queued only while at least one is registered
+    static void addFlusher() noexcept
+    {
+        __atomic_add_fetch(&getData().flushers, 1, __ATOMIC_ACQ_REL);
+    }
+
+    static void removeFlusher() noexcept
+    {
+        const int flushers(__atomic_sub_fetch(&getData().flushers, 1, __ATOMIC_ACQ_REL));
+        flush(flushers == 0);
+    }
+
+private:
+    struct Message {
+        uint32_t seq;
+        int stream;
+        uint32_t suppressed;
+        char text[kMessageSize];
+    };
+
+    // Bounded multi-producer, single-consumer queue.
+    // Message sequence numbers are stored relative to their index, so zero-initialization is a valid empty state.
+    struct Data {
+        Message messages[kQueueSize];
+        uint32_t writePos;
+        uint32_t readPos;
+        uint32_t flushCount;
+        uint32_t lost;
+        int flushers;
+        int flushing;
+        CarlaRtLogSite* sites;
+
+        Message* reserve(uint32_t& pos) noexcept
+        {
+            pos = __atomic_load_n(&writePos, __ATOMIC_RELAXED);
+
+            for (;;)
+            {
+                const uint32_t index(pos & (kQueueSize-1));
+                Message& message(messages[index]);
+                const int32_t diff(static_cast<int32_t>(__atomic_load_n(&message.seq, __ATOMIC_ACQUIRE) + index - pos));
+
+                if (diff == 0)
+                {
+                    if (__atomic_compare_exchange_n(&writePos, &pos, pos+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                        return &message;
+                }
+                else if (diff < 0)
+                {
+                    // full
+                    return nullptr;
+                }
+                else
+                {
+                    pos = __atomic_load_n(&writePos, __ATOMIC_RELAXED);
+                }
+            }
+        }
+
+        void commit(Message* const message, const uint32_t pos) noexcept
+        {
+            __atomic_store_n(&message->seq, pos + 1 - (pos & (kQueueSize-1)), __ATOMIC_RELEASE);
+        }
+
+        const Message* peek() const noexcept
+        {
+            const uint32_t index(readPos & (kQueueSize-1));
+            const Message& message(messages[index]);
+
+            if (__atomic_load_n(&message.seq, __ATOMIC_ACQUIRE) + index != readPos + 1)
+                return nullptr;
+
+            return &message;
+        }
+
+        void pop(const Message* const message) noexcept
+        {
+            const uint32_t index(readPos & (kQueueSize-1));
+            CARLA_SAFE_ASSERT_RETURN(message == &messages[index],);
+
+            __atomic_store_n(&messages[index].seq, readPos + kQueueSize - index, __ATOMIC_RELEASE);
+            ++readPos;
+        }
+    };
+
+    // plain data with static storage, zero-initialized before any code runs
+    static Data& getData() noexcept
+    {
+        static Data sData;
+        return sData;
+    }
+
+    static void print(const Stream stream, const char* const text, const uint32_t suppressed) noexcept
+    {
+        switch (stream)
+        {
+        case kStdout:
+            if (suppressed != 0)
+                carla_stdout("%s (%u similar messages suppressed)", text, suppressed);
+            else
+                carla_stdout("%s", text);
+            break;
+        case kStderr:
+            if (suppressed != 0)
+                carla_stderr("%s (%u similar messages suppressed)", text, suppressed);
+            else
+                carla_stderr("%s", text);
+            break;
+        case kStderr2:
+            if (suppressed != 0)
+                carla_stderr2("%s (%u similar messages suppressed)", text, suppressed);
+            else
+                carla_stderr2("%s", text);
+            break;
+        }
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_RT_LOG_UTILS_HPP_INCLUDED
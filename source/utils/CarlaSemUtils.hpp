@@ -181,6 +181,29 @@ void carla_sem_post(carla_sem_t& sem, const bool server) noexcept
     return; (void)server;
 }
 
+/*
+ * Try to lock a semaphore without waiting.
+ */
+static inline
+bool carla_sem_trywait(carla_sem_t& sem, const bool server) noexcept
+{
+#if defined(CARLA_OS_WIN)
+    return (::WaitForSingleObject(sem.handle, 0) == WAIT_OBJECT_0);
+#elif defined(CARLA_OS_MAC)
+    const mach_timespec timeout = { 0, 0 };
+
+    try {
+        return (::semaphore_timedwait(server ? sem.sem : sem.sem2, timeout) == KERN_SUCCESS);
+    } CARLA_SAFE_EXCEPTION_RETURN("carla_sem_trywait", false);
+#elif defined(CARLA_USE_FUTEXES)
+    return __sync_bool_compare_and_swap(&sem.count, 1, 0);
+#else
+    return (::sem_trywait(&sem.sem) == 0);
+#endif
+    // may be unused
+    (void)server;
+}
+
 /*
  * Wait for a semaphore (lock).
  */
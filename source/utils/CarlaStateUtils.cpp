@@ -18,6 +18,7 @@
 #include "CarlaStateUtils.hpp"
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaBase64Utils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 
@@ -51,6 +52,40 @@ static void getNewLineSplittedString(MemoryOutputStream& stream, const String& s
     stream << (raw+i);
 }
 
+// same as getNewLineSplittedString(stream, CarlaString::asBase64(data, dataSize)), without the intermediate string
+
+static void getNewLineSplittedBase64(MemoryOutputStream& stream, const void* const data, const std::size_t dataSize)
+{
+    static const std::size_t kLineWidth  = 120;
+    static const std::size_t kLineBytes  = kLineWidth/4*3;
+    static const std::size_t kBlockLines = 32;
+
+    const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+    const std::size_t base64Size = carla_base64_encoded_size(dataSize);
+
+    stream.preallocate(stream.getDataSize() + base64Size + base64Size/kLineWidth + 3);
+
+    char buf[kBlockLines*(kLineWidth+1)];
+
+    for (std::size_t offset = 0; offset < dataSize;)
+    {
+        std::size_t bufSize = 0;
+
+        for (std::size_t line = 0; line < kBlockLines && offset < dataSize; ++line)
+        {
+            const std::size_t size = std::min(kLineBytes, dataSize - offset);
+
+            bufSize += carla_base64_encode(bytes + offset, size, buf + bufSize);
+            offset  += size;
+
+            if (offset < dataSize)
+                buf[bufSize++] = '\n';
+        }
+
+        stream.write(buf, bufSize);
+    }
+}
+
 // -----------------------------------------------------------------------
 // xmlSafeStringFast
 
@@ -200,6 +235,8 @@ CarlaStateSave::CarlaStateSave() noexcept
       currentMidiBank(-1),
       currentMidiProgram(-1),
       chunk(nullptr),
+      rawChunk(nullptr),
+      rawChunkSize(0),
       parameters(),
       customData() {}
 
@@ -241,6 +278,9 @@ void CarlaStateSave::clear() noexcept
         chunk = nullptr;
     }
 
+    rawChunk     = nullptr;
+    rawChunkSize = 0;
+
     uniqueId = 0;
     options  = 0x0;
 
@@ -490,7 +530,7 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
 // -----------------------------------------------------------------------
 // fillXmlStringFromStateSave
 
-void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
+void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content, const bool includeChunk) const
 {
     {
         MemoryOutputStream infoXml;
@@ -665,7 +705,11 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         content << customDataXml;
     }
 
-    if (chunk != nullptr && chunk[0] != '\0')
+    if (! includeChunk)
+    {
+        // stored elsewhere, see CarlaBinaryProjectWriter
+    }
+    else if (chunk != nullptr && chunk[0] != '\0')
     {
         MemoryOutputStream chunkXml, chunkSplt;
         getNewLineSplittedString(chunkSplt, chunk);
@@ -676,6 +720,17 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
 
         content << chunkXml;
     }
+    else if (rawChunk != nullptr && rawChunkSize > 0)
+    {
+        MemoryOutputStream chunkXml, chunkSplt;
+        getNewLineSplittedBase64(chunkSplt, rawChunk, rawChunkSize);
+
+        chunkXml << "\n   <Chunk>\n";
+        chunkXml << chunkSplt;
+        chunkXml << "\n   </Chunk>\n";
+
+        content << chunkXml;
+    }
 
     content << "  </Data>\n";
 }
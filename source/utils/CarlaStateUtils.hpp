@@ -87,6 +87,11 @@ struct CarlaStateSave {
     int32_t     currentMidiProgram;
     const char* chunk;
 
+    // raw chunk data, used instead of the base64 chunk when set.
+    // not owned, points to plugin memory or a mapped binary project file.
+    const void* rawChunk;
+    std::size_t rawChunkSize;
+
     ParameterList parameters;
     CustomDataList customData;
 
@@ -95,7 +100,7 @@ struct CarlaStateSave {
     void clear() noexcept;
 
     bool fillFromXmlElement(const juce::XmlElement* const xmlElement);
-    void dumpToMemoryStream(juce::MemoryOutputStream& stream) const;
+    void dumpToMemoryStream(juce::MemoryOutputStream& stream, const bool includeChunk = true) const;
 
     CARLA_DECLARE_NON_COPY_STRUCT(CarlaStateSave)
 };
@@ -18,6 +18,7 @@
 #ifndef CARLA_STRING_HPP_INCLUDED
 #define CARLA_STRING_HPP_INCLUDED
 
+#include "CarlaBase64Utils.hpp"
 #include "CarlaJuceUtils.hpp"
 #include "CarlaMathUtils.hpp"
 
@@ -575,77 +576,25 @@ public:
     }
 
     // -------------------------------------------------------------------
-    // base64 stuff, based on http://www.adp-gmbh.ch/cpp/common/base64.html
-    // Copyright (C) 2004-2008 René Nyffenegger
+    // base64 stuff
 
     static CarlaString asBase64(const void* const data, const std::size_t dataSize)
     {
-        static const char* const kBase64Chars =
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "abcdefghijklmnopqrstuvwxyz"
-            "0123456789+/";
-
-        const std::size_t kTmpBufSize = std::min(carla_nextPowerOf2(static_cast<uint32_t>(dataSize/3)), 65536U);
-
-        const uchar* bytesToEncode((const uchar*)data);
-
-        uint i=0, j=0;
-        uint charArray3[3], charArray4[4];
-
-        char strBuf[kTmpBufSize+1];
-        strBuf[kTmpBufSize] = '\0';
-        std::size_t strBufIndex = 0;
-
         CarlaString ret;
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr || dataSize == 0, ret);
 
-        for (std::size_t s=0; s<dataSize; ++s)
-        {
-            charArray3[i++] = *(bytesToEncode++);
-
-            if (i == 3)
-            {
-                charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
-                charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
-                charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
-                charArray4[3] =   charArray3[2] & 0x3f;
-
-                for (i=0; i<4; ++i)
-                    strBuf[strBufIndex++] = kBase64Chars[charArray4[i]];
-
-                if (strBufIndex >= kTmpBufSize-7)
-                {
-                    strBuf[strBufIndex] = '\0';
-                    strBufIndex = 0;
-                    ret += strBuf;
-                }
-
-                i = 0;
-            }
-        }
-
-        if (i != 0)
-        {
-            for (j=i; j<3; ++j)
-              charArray3[j] = '\0';
-
-            charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
-            charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
-            charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
-            charArray4[3] =   charArray3[2] & 0x3f;
+        if (dataSize == 0)
+            return ret;
 
-            for (j=0; j<4 && i<3 && j<i+1; ++j)
-                strBuf[strBufIndex++] = kBase64Chars[charArray4[j]];
+        const std::size_t base64Size = carla_base64_encoded_size(dataSize);
 
-            for (; i++ < 3;)
-                strBuf[strBufIndex++] = '=';
-        }
+        char* const strBuf = (char*)std::malloc(base64Size+1);
+        CARLA_SAFE_ASSERT_RETURN(strBuf != nullptr, ret);
 
-        if (strBufIndex != 0)
-        {
-            strBuf[strBufIndex] = '\0';
-            ret += strBuf;
-        }
+        strBuf[carla_base64_encode(data, dataSize, strBuf)] = '\0';
 
+        ret.fBuffer    = strBuf;
+        ret.fBufferLen = base64Size;
         return ret;
     }
 
@@ -0,0 +1,335 @@
+/*
+ * LV2 Atom Shared Memory Channel
+ * Copyright (C) 2012-2016 Filipe Coelho <falktx@falktx.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef LV2_ATOM_SHM_CHANNEL_HPP_INCLUDED
+#define LV2_ATOM_SHM_CHANNEL_HPP_INCLUDED
+
+#include "CarlaPipeUtils.hpp"
+#include "CarlaRingBuffer.hpp"
+#include "CarlaShmUtils.hpp"
+#include "CarlaString.hpp"
+
+#include "lv2/atom.h"
+
+#ifdef CARLA_OS_WIN
+# define LV2_ATOM_SHM_NAMEPREFIX "Global\\carla-ui_shm_atom_"
+#else
+# define LV2_ATOM_SHM_NAMEPREFIX "/crlui_shm_atom_"
+#endif
+
+// -----------------------------------------------------------------------
+// Binary atom channel between a plugin host and its UI bridge.
+//
+// Atoms are written raw into a shared memory ring buffer (one per direction),
+// the pipe only carries the channel setup and wake-up messages:
+//
+//  host -> UI: "atomShm\n<filename>\n"  UI attaches to the shared memory
+//  UI -> host: "atomShm\n"              host can start using the channel
+//  any:        "atomShmData\n<count>\n" atoms are ready to be read
+//
+// The reading side only reads 'count' atoms from the ring buffer when "atomShmData" arrives,
+// so atoms keep their order relative to other pipe messages.
+// Atoms too big for the ring buffer (or written before the channel is ready)
+// fall back to the base64 pipe message.
+
+struct Lv2AtomShmBuffer {
+    static const uint32_t size = 1024*1024; // 1Mb
+    uint32_t head, tail, wrtn;
+    bool     invalidateCommit;
+    uint8_t  buf[size];
+};
+
+struct Lv2AtomShmData {
+    Lv2AtomShmBuffer hostToUi;
+    Lv2AtomShmBuffer uiToHost;
+};
+
+// -----------------------------------------------------------------------
+
+class Lv2AtomShmRingBuffer : public CarlaRingBufferControl<Lv2AtomShmBuffer>
+{
+public:
+    Lv2AtomShmRingBuffer() noexcept
+        : fBuffer(nullptr) {}
+
+    void setBuffer(Lv2AtomShmBuffer* const buffer, const bool reset) noexcept
+    {
+        if (fBuffer == buffer)
+            return;
+
+        fBuffer = buffer;
+        setRingBuffer(buffer, reset);
+    }
+
+    bool put(const uint32_t portIndex, const LV2_Atom* const atom) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, false);
+
+        // check for space first, so a full buffer is not reported as an error
+        if (kHeaderSize + atom->size >= getAvailableDataSize())
+            return false;
+
+        if (! tryWrite(atom, sizeof(LV2_Atom)))
+            return false;
+        if (! tryWrite(&portIndex, sizeof(uint32_t)))
+            return false;
+        if (atom->size > 0 && ! tryWrite(LV2_ATOM_BODY_CONST(atom), atom->size))
+            return false;
+
+        // make sure the data is visible to the other process before head moves
+        __sync_synchronize();
+        return commitWrite();
+    }
+
+    // 'buf' must be at least Lv2AtomShmBuffer::size bytes
+    bool get(uint32_t& portIndex, LV2_Atom* const buf) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, false);
+
+        if (! isDataAvailableForReading())
+            return false;
+
+        __sync_synchronize();
+
+        if (! tryRead(buf, sizeof(LV2_Atom)))
+            return false;
+        if (! tryRead(&portIndex, sizeof(uint32_t)))
+            return false;
+
+        CARLA_SAFE_ASSERT_RETURN(buf->size < Lv2AtomShmBuffer::size - kHeaderSize, false);
+
+        if (buf->size > 0 && ! tryRead(buf + 1, buf->size))
+            return false;
+
+        return true;
+    }
+
+    // bytes written before each atom body
+    static const uint32_t kHeaderSize = sizeof(LV2_Atom) + sizeof(uint32_t);
+
+private:
+    Lv2AtomShmBuffer* fBuffer;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2AtomShmRingBuffer)
+};
+
+// -----------------------------------------------------------------------
+
+class Lv2AtomShmChannel
+{
+public:
+    Lv2AtomShmChannel() noexcept
+        : fData(nullptr),
+          fFilename(),
+          fWriter(),
+          fReader(),
+          fReadBuffer(nullptr),
+          fReady(false),
+          fPendingCount(0)
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+        , fShm(carla_shm_t_INIT) {}
+#else
+    {
+        carla_shm_init(fShm);
+    }
+#endif
+
+    ~Lv2AtomShmChannel() noexcept
+    {
+        clear();
+    }
+
+    // -------------------------------------------------------------------
+
+    // host side, creates the shared memory to be sent to the UI
+    bool initialize() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fData == nullptr, false);
+
+        char tmpFileBase[64];
+        std::sprintf(tmpFileBase, LV2_ATOM_SHM_NAMEPREFIX "XXXXXX");
+
+        fShm = carla_shm_create_temp(tmpFileBase);
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(fShm), false);
+
+        if (! mapData(true))
+            return false;
+
+        fFilename = tmpFileBase;
+        return true;
+    }
+
+    // UI side, attaches to the shared memory created by the host
+    bool attach(const char* const filename) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+        CARLA_SAFE_ASSERT_RETURN(fData == nullptr, false);
+
+        fShm = carla_shm_attach(filename);
+        CARLA_SAFE_ASSERT_RETURN(carla_is_shm_valid(fShm), false);
+
+        if (! mapData(false))
+            return false;
+
+        fFilename = filename;
+        fReady = true;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        fReady = false;
+        fPendingCount = 0;
+        fFilename.clear();
+
+        fWriter.setBuffer(nullptr, false);
+        fReader.setBuffer(nullptr, false);
+
+        if (fData != nullptr)
+        {
+            carla_shm_unmap(fShm, fData);
+            fData = nullptr;
+        }
+
+        if (carla_is_shm_valid(fShm))
+        {
+            carla_shm_close(fShm);
+            carla_shm_init(fShm);
+        }
+
+        if (fReadBuffer != nullptr)
+        {
+            delete[] fReadBuffer;
+            fReadBuffer = nullptr;
+        }
+    }
+
+    const char* getFilename() const noexcept
+    {
+        return fFilename.buffer();
+    }
+
+    bool isReady() const noexcept
+    {
+        return fReady;
+    }
+
+    // host side, called when the UI confirms it attached to the shared memory
+    void setReady() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        fReady = true;
+    }
+
+    // -------------------------------------------------------------------
+
+    // write an atom for the other side, the wake-up message is sent on flush()
+    void writeAtom(const CarlaPipeCommon& pipe, const uint32_t portIndex, const LV2_Atom* const atom) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(atom != nullptr,);
+
+        if (fReady && fWriter.put(portIndex, atom))
+        {
+            ++fPendingCount;
+            return;
+        }
+
+        // atoms already in the ring buffer need to be read first
+        flush(pipe);
+        pipe.writeLv2AtomMessage(portIndex, atom);
+    }
+
+    void flush(const CarlaPipeCommon& pipe) noexcept
+    {
+        if (fPendingCount == 0)
+            return;
+
+        char tmpBuf[0xff+1];
+        tmpBuf[0xff] = '\0';
+        std::snprintf(tmpBuf, 0xff, "%u\n", fPendingCount);
+
+        fPendingCount = 0;
+
+        const CarlaMutexLocker cml(pipe.getPipeLock());
+
+        if (pipe.writeMessage("atomShmData\n", 12) && pipe.writeMessage(tmpBuf))
+            pipe.flushMessages();
+    }
+
+    // read the next atom from the other side, valid until the next call.
+    // must be called once per atom announced by "atomShmData"
+    bool readAtom(uint32_t& portIndex, const LV2_Atom*& atom) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fReadBuffer != nullptr, false);
+
+        LV2_Atom* const buf((LV2_Atom*)fReadBuffer);
+
+        if (! fReader.get(portIndex, buf))
+            return false;
+
+        atom = buf;
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    Lv2AtomShmData* fData;
+    CarlaString fFilename;
+
+    Lv2AtomShmRingBuffer fWriter;
+    Lv2AtomShmRingBuffer fReader;
+    uint8_t* fReadBuffer;
+
+    bool fReady;
+    uint32_t fPendingCount;
+    carla_shm_t fShm;
+
+    bool mapData(const bool isHost) noexcept
+    {
+        if (! carla_shm_map<Lv2AtomShmData>(fShm, fData))
+        {
+            carla_shm_close(fShm);
+            carla_shm_init(fShm);
+            return false;
+        }
+
+        try {
+            fReadBuffer = new uint8_t[Lv2AtomShmBuffer::size];
+        } CARLA_SAFE_EXCEPTION_RETURN("Lv2AtomShmChannel::mapData", false);
+
+        if (isHost)
+        {
+            fWriter.setBuffer(&fData->hostToUi, true);
+            fReader.setBuffer(&fData->uiToHost, true);
+        }
+        else
+        {
+            fWriter.setBuffer(&fData->uiToHost, false);
+            fReader.setBuffer(&fData->hostToUi, false);
+        }
+
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2AtomShmChannel)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // LV2_ATOM_SHM_CHANNEL_HPP_INCLUDED